@@ -16,7 +16,9 @@
 HEADERS += \
 src/connectors/bus.h \
 src/connectors/busshared.h \
+src/connectors/connectivitysnapshot.h \
 src/connectors/connector.h \
+src/connectors/connectorindex.h \
 src/connectors/connectoritem.h \
 src/connectors/nonconnectoritem.h \
 src/connectors/connectorshared.h \
@@ -26,7 +28,9 @@ src/connectors/svgidlayer.h
 SOURCES += \
 src/connectors/bus.cpp \
 src/connectors/busshared.cpp \
+src/connectors/connectivitysnapshot.cpp \
 src/connectors/connector.cpp \
+src/connectors/connectorindex.cpp \
 src/connectors/connectoritem.cpp \
 src/connectors/nonconnectoritem.cpp \
 src/connectors/connectorshared.cpp \
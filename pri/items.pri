@@ -43,6 +43,7 @@ HEADERS += \
     src/items/schematicsubpart.h \
     src/items/screwterminal.h \
     src/items/stripboard.h \
+    src/items/striplattice.h \
     src/items/symbolpaletteitem.h \
     src/items/tracewire.h \
     src/items/via.h \
@@ -80,6 +81,7 @@ SOURCES += \
     src/items/schematicsubpart.cpp \
     src/items/screwterminal.cpp \
     src/items/stripboard.cpp \
+    src/items/striplattice.cpp \
     src/items/symbolpaletteitem.cpp \
     src/items/tracewire.cpp \
     src/items/via.cpp \
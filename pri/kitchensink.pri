@@ -24,6 +24,7 @@ HEADERS += \
     src/processeventblocker.h \
     src/routingstatus.h \
     src/sketchtoolbutton.h \
+    src/undopayload.h \
     src/viewgeometry.h \
     src/viewlayer.h \
     src/waitpushundostack.h
@@ -39,6 +40,7 @@ SOURCES += \
     src/main.cpp \
     src/processeventblocker.cpp \
     src/sketchtoolbutton.cpp \
+    src/undopayload.cpp \
     src/viewgeometry.cpp \
     src/viewlayer.cpp \
     src/waitpushundostack.cpp
@@ -13,15 +13,21 @@
 # along with Fritzing. If not, see <http://www.gnu.org/licenses/>.
 # ********************************************************************/
 HEADERS += \
+    src/model/autosavewriter.h \
     src/model/modelbase.h \
+    src/model/modelnetlist.h \
     src/model/modelpart.h \
     src/model/modelpartshared.h \
+    src/model/netlistwriter.h \
     src/model/palettemodel.h \
     src/model/sketchmodel.h
 
 SOURCES += \
+    src/model/autosavewriter.cpp \
     src/model/modelbase.cpp \
+    src/model/modelnetlist.cpp \
     src/model/modelpart.cpp \
     src/model/modelpartshared.cpp \
+    src/model/netlistwriter.cpp \
     src/model/palettemodel.cpp \
     src/model/sketchmodel.cpp
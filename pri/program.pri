@@ -20,10 +20,10 @@
 
 HEADERS += \
     src/program/highlighter.h \
+    src/program/keywordtable.h \
     src/program/programtab.h \
     src/program/programwindow.h \
     src/program/syntaxer.h \
-    src/program/trienode.h \
     src/program/console.h \
     src/program/consolewindow.h \
     src/program/consolesettings.h \
@@ -34,10 +34,10 @@ HEADERS += \
 
 SOURCES += \
     src/program/highlighter.cpp \
+    src/program/keywordtable.cpp \
     src/program/programtab.cpp \
     src/program/programwindow.cpp \
     src/program/syntaxer.cpp \
-    src/program/trienode.cpp \
     src/program/console.cpp \
     src/program/consolewindow.cpp \
     src/program/consolesettings.cpp \
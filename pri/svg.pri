@@ -17,8 +17,15 @@ HEADERS += src/svg/svgfilesplitter.h \
     src/svg/svgpathgrammar_p.h \
     src/svg/svgpathlexer.h \
     src/svg/svgpathrunner.h \
+    src/svg/svgpathtokenizer.h \
     src/svg/svg2gerber.h \
+    src/svg/drillplanner.h \
     src/svg/svgflattener.h \
+    src/svg/svgfragmentcache.h \
+    src/svg/svgloadcache.h \
+    src/svg/bitmaptracer.h \
+    src/svg/svgoutline.h \
+    src/svg/svgelementindex.h \
     src/svg/gerbergenerator.h \
     src/svg/groundplanegenerator.h \
     src/svg/x2svg.h \
@@ -36,8 +43,15 @@ SOURCES += src/svg/svgfilesplitter.cpp \
     src/svg/svgpathgrammar.cpp \
     src/svg/svgpathlexer.cpp \
     src/svg/svgpathrunner.cpp \
+    src/svg/svgpathtokenizer.cpp \
     src/svg/svg2gerber.cpp \
+    src/svg/drillplanner.cpp \
     src/svg/svgflattener.cpp \
+    src/svg/svgfragmentcache.cpp \
+    src/svg/svgloadcache.cpp \
+    src/svg/bitmaptracer.cpp \
+    src/svg/svgoutline.cpp \
+    src/svg/svgelementindex.cpp \
     src/svg/gerbergenerator.cpp \
     src/svg/groundplanegenerator.cpp \
     src/svg/x2svg.cpp \
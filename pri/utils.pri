@@ -37,9 +37,13 @@ src/utils/folderutils.h \
 src/utils/graphicsutils.h \
 src/utils/graphutils.h \
 src/utils/ratsnestcolors.h \
+src/utils/ratsnesttree.h \
 src/utils/schematicrectconstants.h \
 src/utils/s2s.h \
+src/utils/spatialgrid.h \
 src/utils/textutils.h \
+src/utils/tracer.h \
+src/utils/wireshape.h \
 src/utils/zoomslider.h
 
 SOURCES += \
@@ -62,7 +66,10 @@ src/utils/folderutils.cpp \
 src/utils/graphicsutils.cpp \
 src/utils/graphutils.cpp \
 src/utils/ratsnestcolors.cpp \
+src/utils/ratsnesttree.cpp \
 src/utils/schematicrectconstants.cpp \
 src/utils/s2s.cpp \
 src/utils/textutils.cpp \
+src/utils/tracer.cpp \
+src/utils/wireshape.cpp \
 src/utils/zoomslider.cpp
@@ -80,7 +80,22 @@ TiNewPlane(Tile *tile, int minx, int miny, int maxx, int maxy)
 		 */
 {
 	Plane *newplane;
-	static Tile *infinityTile = (Tile *) NULL;
+
+	/*
+	 * Since the lower left coordinates of the TR and RT
+	 * stitches of a tile are used to determine its upper right,
+	 * we must give the boundary tiles a meaningful TR and RT.
+	 * To make certain that these tiles don't have zero width
+	 * or height, we use a dummy tile at (TINFINITY+1,TINFINITY+1).
+	 * Planes may be created from several threads at once (see Panelizer::bestFitLoop),
+	 * so the dummy tile is created by a thread-safe static initializer.
+	 */
+	static Tile *infinityTile = []() {
+		Tile * tile = TiAlloc();
+		SETLEFT(tile, TINFINITY+1);
+		SETYMIN(tile, TINFINITY+1);
+		return tile;
+	}();
 
 	newplane = new Plane;
 	newplane->pl_top = TiAlloc();
@@ -93,21 +108,6 @@ TiNewPlane(Tile *tile, int minx, int miny, int maxx, int maxy)
 	newplane->maxRect.xmaxi = maxx;
 	newplane->maxRect.ymaxi = maxy;
 
-	/*
-	 * Since the lower left coordinates of the TR and RT
-	 * stitches of a tile are used to determine its upper right,
-	 * we must give the boundary tiles a meaningful TR and RT.
-	 * To make certain that these tiles don't have zero width
-	 * or height, we use a dummy tile at (TINFINITY+1,TINFINITY+1).
-	 */
-
-	if (infinityTile == (Tile *) NULL)
-	{
-		infinityTile = TiAlloc();
-		SETLEFT(infinityTile, TINFINITY+1);
-		SETYMIN(infinityTile, TINFINITY+1);
-	}
-
 	if (tile)
 	{
 		SETRT(tile, newplane->pl_top);
@@ -34,6 +34,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../fsvgrenderer.h"
 #include "../viewlayer.h"
 #include "../processeventblocker.h"
+#include "../utils/tracer.h"
 
 #include <qmath.h>
 #include <QApplication>
@@ -299,6 +300,7 @@ QStringList DRC::start(bool showOkMessage, double keepoutMils) {
 }
 
 bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThing *> & collidingThings, double keepoutMils) {
+	TraceScope trace("drc");
 	bool bothSidesNow = m_sketchWidget->boardLayers() == 2;
 
 	QList<ConnectorItem *> visited;
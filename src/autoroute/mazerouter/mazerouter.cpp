@@ -70,6 +70,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../../fsvgrenderer.h"
 #include "../drc.h"
 #include "../../connectors/svgidlayer.h"
+#include "../../utils/tracer.h"
 
 #include <QApplication>
 #include <QMessageBox>
@@ -610,6 +611,7 @@ MazeRouter::~MazeRouter()
 
 void MazeRouter::start()
 {
+	TraceScope trace("autoroute");
 	if (m_pcbType) {
 		if (!m_board) {
 			QMessageBox::warning(nullptr, QObject::tr("Fritzing"), QObject::tr("Cannot autoroute: no board (or multiple boards) found"));
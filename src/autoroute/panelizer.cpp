@@ -46,6 +46,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <qmath.h>
 #include <limits>
 #include <QPrinter>
+#include <QThread>
+#include <QtConcurrentMap>
 
 static int OutlineLayer = 0;
 static int SilkTopLayer = 0;
@@ -104,7 +106,8 @@ int allObstacles(Tile * tile, UserData userData) {
 	return 0;
 }
 
-static int PlanePairIndex = 0;
+// divisor candidates are evaluated on worker threads, each numbering its own list of PlanePairs
+static thread_local int PlanePairIndex = 0;
 
 int roomOn(Tile * tile, TileRect & tileRect, BestPlace * bestPlace)
 {
@@ -1014,6 +1017,8 @@ bool Panelizer::initPanelParams(QDomElement & root, PanelParams & panelParams)
 		return false;
 	}
 
+	panelParams.writeIntermediates = root.attribute("intermediates").compare("true", Qt::CaseInsensitive) == 0;
+
 	return true;
 
 }
@@ -1778,85 +1783,123 @@ int Panelizer::bestFitLoop(QList<PanelItem *> & refPanelItems, PanelParams & pan
 	}
 
 	QDir intermediates(svgDir);
-	intermediates.mkdir("intermediates");
-	intermediates.cd("intermediates");
-
-	double bestCost = 0;
-	double bestDivisor = 1;
-	bool firstTime = true;
-	for (int divisor = 1; true; divisor++) {
-		QList<PlanePair *> planePairs;
-		QList<PanelItem *> insertPanelItems;
+	if (panelParams.writeIntermediates) {
+		intermediates.mkdir("intermediates");
+		intermediates.cd("intermediates");
+	}
 
-		PlanePairIndex = 0;         // reset to zero for each new list of PlanePairs
+	// each candidate owns its planes, so a batch of divisors can be fitted concurrently;
+	// results are then walked in divisor order, which keeps the outcome identical to a serial search
+	int batchSize = customPartsOnly ? 1 : qMax(1, QThread::idealThreadCount());
 
-		bool stillMoreThanOne = false;
-		foreach (PanelItem * panelItem, refPanelItems) {
-			int count = (panelItem->required + divisor - 1) / divisor;
-			if (count > 1) stillMoreThanOne = true;
-			for (int i = 0; i < count; i++) {
-				PanelItem * copy = new PanelItem(panelItem);
-				insertPanelItems.append(copy);
-			}
+	FitCandidate * best = nullptr;
+	bool done = false;
+	for (int firstDivisor = 1; !done; firstDivisor += batchSize) {
+		QList<int> divisors;
+		for (int divisor = firstDivisor; divisor < firstDivisor + batchSize; divisor++) {
+			divisors << divisor;
 		}
 
-		planePairs << makePlanePair(panelParams, true);
+		EvaluateDivisor evaluate(refPanelItems, panelParams, customPartsOnly);
+		QList<FitCandidate *> candidates = QtConcurrent::blockingMapped<QList<FitCandidate *> >(divisors, evaluate);
 
-		qSort(insertPanelItems.begin(), insertPanelItems.end(), areaGreaterThan);
-		bestFit(insertPanelItems, panelParams, planePairs, customPartsOnly);
-
-		shrinkLastPanel(planePairs, insertPanelItems, panelParams, customPartsOnly);
-
-		double cost = calcCost(panelParams, planePairs, divisor);
-		foreach (PlanePair * planePair, planePairs) {
-			planePair->layoutSVG += "</svg>";
-			QString fname = intermediates.absoluteFilePath(QString("%3.divisor_%4.cost_%1.panel_%2.layout_.svg")
-			                .arg(panelParams.prefix).arg(planePair->index).arg(divisor).arg(cost)
-			                                              );
-			TextUtils::writeUtf8(fname, planePair->layoutSVG);
+		foreach (FitCandidate * candidate, candidates) {
+			if (done) {
+				// fitted speculatively, past the point where the serial search would have stopped
+				deleteCandidate(candidate);
+				continue;
+			}
 
-			// make sure to leave layoutSVG without a trailing </svg> since optionals are added later
-			planePair->layoutSVG.chop(6);
-		}
+			if (panelParams.writeIntermediates) {
+				foreach (PlanePair * planePair, candidate->planePairs) {
+					QString fname = intermediates.absoluteFilePath(QString("%3.divisor_%4.cost_%1.panel_%2.layout_.svg")
+					                .arg(panelParams.prefix).arg(planePair->index).arg(candidate->divisor).arg(candidate->cost)
+					                                              );
+					// leave layoutSVG without a trailing </svg> since optionals are added later
+					TextUtils::writeUtf8(fname, planePair->layoutSVG + "</svg>");
+				}
+			}
 
+			DebugDialog::debug("");
+			DebugDialog::debug(QString("%1 panels, %2 additional copies of each: cost %3").arg(candidate->planePairs.count()).arg(candidate->divisor - 1).arg(candidate->cost));
+			DebugDialog::debug("");
 
-		DebugDialog::debug("");
-		DebugDialog::debug(QString("%1 panels, %2 additional copies of each: cost %3").arg(planePairs.count()).arg(divisor - 1).arg(cost));
-		DebugDialog::debug("");
-		if (firstTime) {
-			bestCost = cost;
-			bestDivisor = 1;
-			returnPlanePairs = planePairs;
-			returnInsertPanelItems = insertPanelItems;
-			firstTime = false;
-		}
-		else {
-			if (cost < bestCost) {
-				bestCost = cost;
-				bestDivisor = divisor;
-				foreach (PlanePair * planePair, returnPlanePairs) {
-					delete planePair;
-				}
-				foreach (PanelItem * panelItem, returnInsertPanelItems) {
-					delete panelItem;
-				}
-				returnPlanePairs.clear();
-				returnInsertPanelItems.clear();
+			if (customPartsOnly || candidate->planePairs.count() == 1 || !candidate->stillMoreThanOne) {
+				done = true;
+			}
 
-				returnPlanePairs = planePairs;
-				returnInsertPanelItems = insertPanelItems;
+			// strictly lower cost, so ties go to the smallest divisor
+			if (best == nullptr || candidate->cost < best->cost) {
+				deleteCandidate(best);
+				best = candidate;
+			}
+			else {
+				deleteCandidate(candidate);
 			}
 		}
+	}
 
-		if (customPartsOnly) break;
-		if (planePairs.count() == 1) break;
-		if (!stillMoreThanOne) break;
+	returnPlanePairs = best->planePairs;
+	returnInsertPanelItems = best->insertPanelItems;
+	int bestDivisor = best->divisor;
+	delete best;
+
+	// optionals may open a new panel; continue numbering after the selected candidate's panels
+	PlanePairIndex = 0;
+	foreach (PlanePair * planePair, returnPlanePairs) {
+		PlanePairIndex = qMax(PlanePairIndex, planePair->index + 1);
 	}
 
 	addOptional(optionalCount, refPanelItems, returnInsertPanelItems, panelParams, returnPlanePairs);
 	return bestDivisor;
 }
 
+FitCandidate * Panelizer::evaluateDivisor(QList<PanelItem *> & refPanelItems, PanelParams & panelParams, bool customPartsOnly, int divisor)
+{
+	// runs on a worker thread: refPanelItems and panelParams are only read
+	FitCandidate * candidate = new FitCandidate;
+	candidate->divisor = divisor;
+
+	PlanePairIndex = 0;         // reset to zero for each new list of PlanePairs
+
+	foreach (PanelItem * panelItem, refPanelItems) {
+		int count = (panelItem->required + divisor - 1) / divisor;
+		if (count > 1) candidate->stillMoreThanOne = true;
+		for (int i = 0; i < count; i++) {
+			PanelItem * copy = new PanelItem(panelItem);
+			candidate->insertPanelItems.append(copy);
+		}
+	}
+
+	candidate->planePairs << makePlanePair(panelParams, true);
+
+	qSort(candidate->insertPanelItems.begin(), candidate->insertPanelItems.end(), areaGreaterThan);
+	bestFit(candidate->insertPanelItems, panelParams, candidate->planePairs, customPartsOnly);
+
+	shrinkLastPanel(candidate->planePairs, candidate->insertPanelItems, panelParams, customPartsOnly);
+
+	candidate->cost = calcCost(panelParams, candidate->planePairs, divisor);
+	return candidate;
+}
+
+FitCandidate * EvaluateDivisor::operator()(const int & divisor)
+{
+	return Panelizer::evaluateDivisor(m_refPanelItems, m_panelParams, m_customPartsOnly, divisor);
+}
+
+void Panelizer::deleteCandidate(FitCandidate * candidate)
+{
+	if (candidate == nullptr) return;
+
+	foreach (PlanePair * planePair, candidate->planePairs) {
+		delete planePair;
+	}
+	foreach (PanelItem * panelItem, candidate->insertPanelItems) {
+		delete panelItem;
+	}
+	delete candidate;
+}
+
 double Panelizer::calcCost(PanelParams & panelParams, QList<PlanePair *> & planePairs, int divisor) {
 	double total = 0;
 	foreach (PlanePair * planePair, planePairs) {
@@ -91,6 +91,15 @@ struct PanelParams
 	double panelSpacing = 0.0;
 	double panelBorder = 0.0;
 	QString prefix;
+	bool writeIntermediates = false;
+};
+
+struct FitCandidate {
+	int divisor = 1;
+	bool stillMoreThanOne = false;
+	double cost = Worst;
+	QList<PlanePair *> planePairs;
+	QList<PanelItem *> insertPanelItems;
 };
 
 struct LayerThing {
@@ -105,8 +114,22 @@ struct LayerThing {
 	}
 };
 
+struct EvaluateDivisor {
+	typedef FitCandidate * result_type;
+
+	EvaluateDivisor(QList<PanelItem *> & refPanelItems, PanelParams & panelParams, bool customPartsOnly)
+		: m_refPanelItems(refPanelItems), m_panelParams(panelParams), m_customPartsOnly(customPartsOnly) { }
+
+	FitCandidate * operator()(const int & divisor);
+
+	QList<PanelItem *> & m_refPanelItems;
+	PanelParams & m_panelParams;
+	bool m_customPartsOnly;
+};
+
 class Panelizer
 {
+	friend struct EvaluateDivisor;
 public:
 	static void panelize(class FApplication *, const QString & panelFilename, bool customPartsOnly);
 	static void inscribe(class FApplication *, const QString & panelFilename, bool drc, bool noMessages);
@@ -129,6 +152,8 @@ protected:
 	static void shrinkLastPanel( QList<PlanePair *> & planePairs, QList<PanelItem *> & insertPanelItems, PanelParams &, bool customPartsOnly);
 	static int bestFitLoop(QList<PanelItem *> & refPanelItems, PanelParams &, bool customPartsOnly, QList<PlanePair *> & returnPlanePairs, QList<PanelItem *> & returnInsertPanelItems, const QDir & svgDir);
 	static double calcCost(PanelParams &, QList<PlanePair *> &, int divisor);
+	static FitCandidate * evaluateDivisor(QList<PanelItem *> & refPanelItems, PanelParams &, bool customPartsOnly, int divisor);
+	static void deleteCandidate(FitCandidate *);
 	static void writePanelizerOutput(const QString & message);
 	static void initPanelizerOutput(const QString & filename, const QString & initialMsg);
 	static void collectFilenames(const QString & filenames);
@@ -27,6 +27,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "items/moduleidnames.h"
 #include "utils/bezier.h"
 
+#include <typeinfo>
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void CommandProgress::setActive(bool active) {
@@ -172,6 +174,14 @@ void BaseCommand::clearProgress() {
 	m_commandProgress.setActive(false);
 }
 
+qint64 BaseCommand::memoryUsage() const {
+	qint64 usage = sizeof(*this) + text().size() * (qint64) sizeof(QChar);
+	foreach (BaseCommand * command, m_commands) {
+		usage += command->memoryUsage();
+	}
+	return usage;
+}
+
 int BaseCommand::totalChildCount(const QUndoCommand * command) {
 	int cc = command->childCount();
 	int tcc = cc;
@@ -181,6 +191,44 @@ int BaseCommand::totalChildCount(const QUndoCommand * command) {
 	return tcc;
 }
 
+bool BaseCommand::reachesViews(const QUndoCommand * command, const QList<SketchWidget *> & sketchWidgets) {
+	// whether pushing the command can change items in any of the given views, either directly or by crossing views.
+	// Crossing for selection and wire/ratsnest clean-up is left out: it only adjusts items that already exist in the other views.
+	// So are property, title, resistance and pin label changes: those are stored on the model part, and a view built
+	// from the model part later picks them up, just as it would after saving and reopening
+	const BaseCommand * baseCommand = dynamic_cast<const BaseCommand *>(command);
+	if (baseCommand) {
+		if (sketchWidgets.contains(baseCommand->sketchWidget())) return true;
+
+		if (baseCommand->crossViewType() == BaseCommand::CrossView) {
+			if (dynamic_cast<const SelectItemCommand *>(command) == nullptr &&
+			        dynamic_cast<const CleanUpWiresCommand *>(command) == nullptr &&
+			        dynamic_cast<const CleanUpRatsnestsCommand *>(command) == nullptr &&
+			        dynamic_cast<const SetPropCommand *>(command) == nullptr &&
+			        dynamic_cast<const SetResistanceCommand *>(command) == nullptr &&
+			        dynamic_cast<const ChangeLabelTextCommand *>(command) == nullptr &&
+			        dynamic_cast<const RenamePinsCommand *>(command) == nullptr)
+			{
+				return true;
+			}
+		}
+
+		for (int i = 0; i < baseCommand->subCommandCount(); i++) {
+			if (reachesViews(baseCommand->subCommand(i), sketchWidgets)) return true;
+		}
+	}
+	else if (typeid(*command) != typeid(QUndoCommand) && dynamic_cast<const TemporaryCommand *>(command) == nullptr) {
+		// not one of ours: assume the worst
+		return true;
+	}
+
+	for (int i = 0; i < command->childCount(); i++) {
+		if (reachesViews(command->child(i), sketchWidgets)) return true;
+	}
+
+	return false;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 AddDeleteItemCommand::AddDeleteItemCommand(SketchWidget* sketchWidget, BaseCommand::CrossViewType crossViewType, QString moduleID, ViewLayer::ViewLayerPlacement viewLayerPlacement, ViewGeometry & viewGeometry, qint64 id, long modelIndex, QUndoCommand *parent)
@@ -1811,15 +1859,19 @@ SetPropCommand::SetPropCommand(SketchWidget * sketchWidget, long itemID, QString
 }
 
 void SetPropCommand::undo() {
-	m_sketchWidget->setProp(m_itemID, m_prop, m_oldValue, m_redraw, true);
+	m_sketchWidget->setProp(m_itemID, m_prop, m_oldValue.value(), m_redraw, true);
 	BaseCommand::undo();
 }
 
 void SetPropCommand::redo() {
-	m_sketchWidget->setProp(m_itemID, m_prop, m_newValue, m_redraw, true);
+	m_sketchWidget->setProp(m_itemID, m_prop, m_newValue.value(), m_redraw, true);
 	BaseCommand::redo();
 }
 
+qint64 SetPropCommand::memoryUsage() const {
+	return BaseCommand::memoryUsage() + m_prop.size() * (qint64) sizeof(QChar) + m_oldValue.memoryUsage() + m_newValue.memoryUsage();
+}
+
 QString SetPropCommand::getParamString() const {
 
 	return QString("SetPropCommand ")
@@ -1827,8 +1879,8 @@ QString SetPropCommand::getParamString() const {
 	       QString(" id:%1 p:%2 o:%3 n:%4")
 	       .arg(m_itemID)
 	       .arg(m_prop)
-	       .arg(m_oldValue)
-	       .arg(m_newValue);
+	       .arg(m_oldValue.value())
+	       .arg(m_newValue.value());
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
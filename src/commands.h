@@ -30,6 +30,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "routingstatus.h"
 #include "utils/misc.h"
 #include "items/itembase.h"
+#include "undopayload.h"
 
 /////////////////////////////////////////////
 
@@ -84,8 +85,10 @@ public:
 	void setSkipFirstRedo();
 	void undo();
 	void redo();
+	virtual qint64 memoryUsage() const;
 
 	static int totalChildCount(const QUndoCommand *);
+	static bool reachesViews(const QUndoCommand *, const QList<SketchWidget *> &);
 	static CommandProgress * initProgress();
 	static void clearProgress();
 
@@ -925,6 +928,7 @@ public:
 	SetPropCommand(class SketchWidget *, long itemID, QString prop, QString oldValue, QString newValue, bool redraw, QUndoCommand * parent);
 	void undo();
 	void redo();
+	qint64 memoryUsage() const;
 
 protected:
 	QString getParamString() const;
@@ -932,8 +936,8 @@ protected:
 protected:
 	bool m_redraw;
 	QString m_prop;
-	QString m_oldValue;
-	QString m_newValue;
+	UndoPayload m_oldValue;
+	UndoPayload m_newValue;
 	long m_itemID;
 };
 
@@ -0,0 +1,341 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "connectivitysnapshot.h"
+
+ConnectivitySnapshot::ConnectivitySnapshot(ViewLayer::ViewID viewID) : m_viewID(viewID)
+{
+}
+
+int ConnectivitySnapshot::addPart(const PartEntry & part) {
+	m_partIndex.insert(part.id, m_parts.count());
+	m_parts.append(part);
+	return m_parts.count() - 1;
+}
+
+int ConnectivitySnapshot::addConnector(const ConnectorEntry & connector) {
+	m_connectors.append(connector);
+	m_busParents.append(-1);
+	m_busSizes.append(0);
+	return m_connectors.count() - 1;
+}
+
+void ConnectivitySnapshot::addConnection(int connector, int connectedTo) {
+	m_pendingConnections.append(qMakePair(connector, connectedTo));
+}
+
+void ConnectivitySnapshot::addBus(const QList<int> & members) {
+	int first = -1;
+	foreach (int member, members) {
+		if (m_busParents.at(member) < 0) {
+			m_busParents[member] = member;
+			m_busSizes[member] = 1;
+			m_busOrder.append(member);
+		}
+
+		if (first < 0) {
+			first = member;
+			continue;
+		}
+
+		int root1 = findBusRoot(first);
+		int root2 = findBusRoot(member);
+		if (root1 == root2) continue;
+
+		if (m_busSizes.at(root1) < m_busSizes.at(root2)) qSwap(root1, root2);
+		m_busParents[root2] = root1;
+		m_busSizes[root1] += m_busSizes.at(root2);
+	}
+}
+
+int ConnectivitySnapshot::findBusRoot(int connector) {
+	while (m_busParents.at(connector) != connector) {
+		m_busParents[connector] = m_busParents.at(m_busParents.at(connector));		// path halving
+		connector = m_busParents.at(connector);
+	}
+	return connector;
+}
+
+void ConnectivitySnapshot::finishBuses() {
+	// number the classes and list their members, both in the order connectors first joined a bus
+	QVector<int> classes(m_connectors.count(), -1);
+	int count = 0;
+	foreach (int connector, m_busOrder) {
+		int root = findBusRoot(connector);
+		if (classes.at(root) < 0) classes[root] = count++;
+		m_connectors[connector].bus = classes.at(root);
+	}
+
+	m_busStart.fill(0, count + 1);
+	foreach (int connector, m_busOrder) {
+		m_busStart[m_connectors.at(connector).bus + 1]++;
+	}
+	for (int b = 0; b < count; b++) {
+		m_busStart[b + 1] += m_busStart.at(b);
+	}
+	m_busMembers.resize(m_busOrder.count());
+	QVector<int> next = m_busStart;
+	foreach (int connector, m_busOrder) {
+		m_busMembers[next[m_connectors.at(connector).bus]++] = connector;
+	}
+
+	m_busParents.clear();
+	m_busParents.squeeze();
+	m_busSizes.clear();
+	m_busSizes.squeeze();
+	m_busOrder.clear();
+	m_busOrder.squeeze();
+}
+
+void ConnectivitySnapshot::setCrossLayer(int connector, int crossLayer) {
+	m_connectors[connector].crossLayer = crossLayer;
+}
+
+void ConnectivitySnapshot::finish() {
+	// counting sort into compressed rows; connections keep the order they were added in
+	m_connectionStart.fill(0, m_connectors.count() + 1);
+	for (int i = 0; i < m_pendingConnections.count(); i++) {
+		m_connectionStart[m_pendingConnections.at(i).first + 1]++;
+	}
+	for (int c = 0; c < m_connectors.count(); c++) {
+		m_connectionStart[c + 1] += m_connectionStart.at(c);
+	}
+	m_connections.resize(m_pendingConnections.count());
+	QVector<int> next = m_connectionStart;
+	for (int i = 0; i < m_pendingConnections.count(); i++) {
+		const QPair<int, int> & connection = m_pendingConnections.at(i);
+		m_connections[next[connection.first]++] = connection.second;
+	}
+	m_pendingConnections.clear();
+	m_pendingConnections.squeeze();
+
+	m_partConnectorStart.fill(0, m_parts.count() + 1);
+	for (int c = 0; c < m_connectors.count(); c++) {
+		m_partConnectorStart[m_connectors.at(c).part + 1]++;
+	}
+	for (int p = 0; p < m_parts.count(); p++) {
+		m_partConnectorStart[p + 1] += m_partConnectorStart.at(p);
+	}
+	m_partConnectors.resize(m_connectors.count());
+	next = m_partConnectorStart;
+	for (int c = 0; c < m_connectors.count(); c++) {
+		m_partConnectors[next[m_connectors.at(c).part]++] = c;
+	}
+
+	finishBuses();
+}
+
+ViewLayer::ViewID ConnectivitySnapshot::viewID() const {
+	return m_viewID;
+}
+
+int ConnectivitySnapshot::partCount() const {
+	return m_parts.count();
+}
+
+const ConnectivitySnapshot::PartEntry & ConnectivitySnapshot::part(int part) const {
+	return m_parts.at(part);
+}
+
+QVector<int> ConnectivitySnapshot::partConnectors(int part) const {
+	return m_partConnectors.mid(m_partConnectorStart.at(part), m_partConnectorStart.at(part + 1) - m_partConnectorStart.at(part));
+}
+
+int ConnectivitySnapshot::partIndex(qint64 id) const {
+	return m_partIndex.value(id, -1);
+}
+
+int ConnectivitySnapshot::connectorCount() const {
+	return m_connectors.count();
+}
+
+const ConnectivitySnapshot::ConnectorEntry & ConnectivitySnapshot::connector(int connector) const {
+	return m_connectors.at(connector);
+}
+
+int ConnectivitySnapshot::findConnector(int part, const QString & connectorID, ViewLayer::ViewLayerID viewLayerID) const {
+	if (part < 0) return -1;
+
+	for (int i = m_partConnectorStart.at(part); i < m_partConnectorStart.at(part + 1); i++) {
+		const ConnectorEntry & connector = m_connectors.at(m_partConnectors.at(i));
+		if (connector.viewLayerID != viewLayerID) continue;
+		if (connector.id.compare(connectorID) != 0) continue;
+
+		return m_partConnectors.at(i);
+	}
+
+	return -1;
+}
+
+QVector<int> ConnectivitySnapshot::connectedTo(int connector) const {
+	return m_connections.mid(m_connectionStart.at(connector), m_connectionStart.at(connector + 1) - m_connectionStart.at(connector));
+}
+
+int ConnectivitySnapshot::busCount() const {
+	return qMax(0, m_busStart.count() - 1);
+}
+
+QVector<int> ConnectivitySnapshot::busMembers(int bus) const {
+	return m_busMembers.mid(m_busStart.at(bus), m_busStart.at(bus + 1) - m_busStart.at(bus));
+}
+
+bool ConnectivitySnapshot::isWire(int connector) const {
+	return m_parts.at(m_connectors.at(connector).part).itemType == ModelPart::Wire;
+}
+
+QList<int> ConnectivitySnapshot::equalPotential(const QList<int> & connectors, bool crossLayers, ViewGeometry::WireFlags skipFlags) const {
+	QVector<int> marks(m_connectors.count(), -1);
+	QVector<int> busMarks(busCount(), -1);
+	return walk(connectors, crossLayers, skipFlags, marks, busMarks, 0);
+}
+
+QList<int> ConnectivitySnapshot::walk(const QList<int> & connectors, bool crossLayers, ViewGeometry::WireFlags skipFlags, QVector<int> & marks, QVector<int> & busMarks, int stamp) const {
+	// mirrors ConnectorItem::collectEqualPotential; marks[c] == stamp means c has been queued on this walk,
+	// busMarks[b] == stamp that bus class b has been taken in, so every other member skips it
+	QList<int> queue;
+	foreach (int c, connectors) {
+		if (marks.at(c) == stamp) continue;
+
+		marks[c] = stamp;
+		queue.append(c);
+	}
+
+	QList<int> result;
+	for (int i = 0; i < queue.count(); i++) {
+		int c = queue.at(i);
+		const ConnectorEntry & connector = m_connectors.at(c);
+		bool fromWire = isWire(c);
+		if (fromWire) {
+			if (m_parts.at(connector.part).wireFlags & skipFlags) {
+				// don't add this kind of wire
+				continue;
+			}
+		}
+		else if (crossLayers && connector.crossLayer >= 0) {
+			if (marks.at(connector.crossLayer) != stamp) {
+				marks[connector.crossLayer] = stamp;
+				queue.append(connector.crossLayer);
+			}
+		}
+
+		result.append(c);
+
+		for (int j = m_connectionStart.at(c); j < m_connectionStart.at(c + 1); j++) {
+			int to = m_connections.at(j);
+			if (marks.at(to) == stamp) continue;
+
+			if ((skipFlags & ViewGeometry::NormalFlag) && !fromWire && !isWire(to)) {
+				// direct (part-to-part) connections not allowed
+				continue;
+			}
+
+			marks[to] = stamp;
+			queue.append(to);
+		}
+
+		if (connector.bus >= 0 && busMarks.at(connector.bus) != stamp) {
+			busMarks[connector.bus] = stamp;
+			for (int j = m_busStart.at(connector.bus); j < m_busStart.at(connector.bus + 1); j++) {
+				int member = m_busMembers.at(j);
+				if (marks.at(member) == stamp) continue;
+
+				marks[member] = stamp;
+				queue.append(member);
+			}
+		}
+	}
+
+	return result;
+}
+
+bool ConnectivitySnapshot::collectsPart(ModelPart::ItemType itemType, bool includeSymbols) {
+	// the item types ConnectorItem::collectParts keeps
+	switch (itemType) {
+	case ModelPart::Symbol:
+	case ModelPart::SchematicSubpart:
+		return includeSymbols;
+	case ModelPart::Jumper:
+	case ModelPart::Part:
+	case ModelPart::CopperFill:
+	case ModelPart::Board:
+	case ModelPart::ResizableBoard:
+	case ModelPart::Via:
+	case ModelPart::Breadboard:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void ConnectivitySnapshot::collectPart(int connector, QList<int> & partConnectors) const {
+	// ConnectorItem::collectPart for ViewLayer::NewTopAndBottom
+	if (partConnectors.contains(connector)) return;
+
+	int crossLayer = m_connectors.at(connector).crossLayer;
+	if (crossLayer >= 0) {
+		if (partConnectors.contains(crossLayer)) return;
+
+		partConnectors.append(crossLayer);
+	}
+
+	partConnectors.append(connector);
+}
+
+QList<ConnectivitySnapshot::Net> ConnectivitySnapshot::nets(bool includeSingletons, bool bothSides, bool includeSymbols) const {
+	// mirrors SketchWidget::collectAllNets as it was written against the scene; marks[c] is the walk that reached c
+	QList<Net> result;
+	QVector<int> marks(m_connectors.count(), -1);
+	QVector<int> busMarks(busCount(), -1);
+	for (int c = 0; c < m_connectors.count(); c++) {
+		if (marks.at(c) >= 0) continue;
+		if (!bothSides && m_connectors.at(c).viewLayerID == ViewLayer::Copper1) continue;
+
+		int stamp = c;
+		QList<int> connectors;
+		connectors.append(c);
+		connectors = walk(connectors, bothSides, ViewGeometry::NoFlag, marks, busMarks, stamp);
+		if (!includeSingletons && connectors.count() <= 1) continue;
+
+		QList<int> partConnectors;
+		foreach (int connector, connectors) {
+			if (m_connectors.at(connector).flags & HybridFlag) continue;
+			if (!collectsPart(m_parts.at(m_connectors.at(connector).part).itemType, includeSymbols)) continue;
+
+			collectPart(connector, partConnectors);
+		}
+
+		for (int i = partConnectors.count() - 1; i >= 0; i--) {
+			if ((m_connectors.at(partConnectors.at(i)).flags & EverVisibleFlag) == 0) {
+				partConnectors.removeAt(i);
+			}
+		}
+
+		if (partConnectors.count() <= 0 || (!includeSingletons && partConnectors.count() <= 1)) continue;
+
+		Net net;
+		net.connectors = partConnectors;
+		foreach (int connector, partConnectors) {
+			net.onNet.append(marks.at(connector) == stamp);
+		}
+		result.append(net);
+	}
+
+	return result;
+}
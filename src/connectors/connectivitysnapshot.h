@@ -0,0 +1,134 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef CONNECTIVITYSNAPSHOT_H
+#define CONNECTIVITYSNAPSHOT_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+
+#include "../viewgeometry.h"
+#include "../viewlayer.h"
+#include "../model/modelpart.h"
+
+// A copy of one view's connectivity that no longer refers to the scene: parts, connectors, connections,
+// bus membership and the per-view flags the net walks look at, all as integer-indexed arrays.
+// SketchWidget::connectivitySnapshot captures it in one pass on the GUI thread; once finished it is
+// never modified, so any number of threads may read it at the same time while the sketch moves on.
+// Connectors are numbered in scene()->items() order, so nets come out in the order SketchWidget::collectAllNets
+// found them over the live items.  A walk reaches the same connectors as ConnectorItem::collectEqualPotential,
+// but not in the same order, since it takes in a whole bus class at once; callers must not rely on the order.
+// Buses are closed over as they are added: every bus list is merged into a union-find, and finish()
+// flattens it into classes of connectors at the same potential, so a walk takes in a whole bus
+// (a breadboard strip, a 100-pin header) at once instead of listing it again from every member.
+
+class ConnectivitySnapshot
+{
+public:
+	enum ConnectorFlag {
+		NoConnectorFlag = 0,
+		EverVisibleFlag = 1,
+		HybridFlag = 2
+	};
+
+	struct PartEntry {
+		qint64 id;
+		long modelIndex;
+		ModelPart::ItemType itemType;
+		QString moduleID;
+		QString instanceTitle;
+		ViewGeometry::WireFlags wireFlags;
+	};
+
+	// layer kin share their chief's part; each copper layer gets its own connector
+	struct ConnectorEntry {
+		int part;
+		QString id;
+		QString name;
+		ViewLayer::ViewLayerID viewLayerID;
+		int flags;
+		int crossLayer;
+		int bus;					// bus class, -1 if none; set by finish()
+	};
+
+	// the part connectors of one net, as ConnectorItem::collectParts lists them;
+	// when walking a single side, a cross-layer partner is listed without being on the net
+	struct Net {
+		QList<int> connectors;
+		QList<bool> onNet;
+	};
+
+public:
+	ConnectivitySnapshot(ViewLayer::ViewID);
+
+	// building; only before the snapshot is shared
+	int addPart(const PartEntry &);
+	int addConnector(const ConnectorEntry &);
+	void addConnection(int connector, int connectedTo);
+	void addBus(const QList<int> & members);
+	void setCrossLayer(int connector, int crossLayer);
+	void finish();
+
+	ViewLayer::ViewID viewID() const;
+	int partCount() const;
+	const PartEntry & part(int) const;
+	QVector<int> partConnectors(int part) const;
+	int partIndex(qint64 id) const;
+	int connectorCount() const;
+	const ConnectorEntry & connector(int) const;
+	int findConnector(int part, const QString & connectorID, ViewLayer::ViewLayerID) const;
+	QVector<int> connectedTo(int connector) const;
+	int busCount() const;
+	QVector<int> busMembers(int bus) const;
+	bool isWire(int connector) const;
+
+	QList<int> equalPotential(const QList<int> & connectors, bool crossLayers, ViewGeometry::WireFlags skipFlags) const;
+	QList<Net> nets(bool includeSingletons, bool bothSides, bool includeSymbols) const;
+
+public:
+	static bool collectsPart(ModelPart::ItemType, bool includeSymbols);
+
+protected:
+	QList<int> walk(const QList<int> & connectors, bool crossLayers, ViewGeometry::WireFlags skipFlags, QVector<int> & marks, QVector<int> & busMarks, int stamp) const;
+	void collectPart(int connector, QList<int> & partConnectors) const;
+	int findBusRoot(int connector);
+	void finishBuses();
+
+protected:
+	ViewLayer::ViewID m_viewID;
+	QVector<PartEntry> m_parts;
+	QHash<qint64, int> m_partIndex;
+	QVector<ConnectorEntry> m_connectors;
+	QVector<int> m_partConnectorStart;
+	QVector<int> m_partConnectors;
+	QVector<int> m_connectionStart;
+	QVector<int> m_connections;
+	QVector<QPair<int, int> > m_pendingConnections;
+	QVector<int> m_busParents;
+	QVector<int> m_busSizes;
+	QVector<int> m_busOrder;
+	QVector<int> m_busStart;
+	QVector<int> m_busMembers;
+};
+
+#endif
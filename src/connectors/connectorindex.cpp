@@ -0,0 +1,142 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "connectorindex.h"
+#include "connectoritem.h"
+#include "../items/itembase.h"
+
+#include <QPainterPath>
+
+// a breadboard row is 0.1 inch, 9 pixels at 90 dpi
+static const double CellSize = 36;
+
+ConnectorIndex::ConnectorIndex() : m_grid(CellSize)
+{
+}
+
+void ConnectorIndex::itemChanged(ItemBase * itemBase) {
+	m_dirty.insert(itemBase);
+}
+
+void ConnectorIndex::itemRemoved(ItemBase * itemBase) {
+	m_dirty.remove(itemBase);
+	unindexItem(itemBase);
+}
+
+void ConnectorIndex::connectorRemoved(ConnectorItem * connectorItem) {
+	m_grid.remove(connectorItem);
+	auto it = m_indexed.find(connectorItem->attachedTo());
+	if (it != m_indexed.end()) {
+		it->removeOne(connectorItem);
+	}
+}
+
+void ConnectorIndex::clear() {
+	m_grid.clear();
+	m_indexed.clear();
+	m_dirty.clear();
+}
+
+void ConnectorIndex::flush() {
+	if (m_dirty.isEmpty()) return;
+
+	foreach (ItemBase * itemBase, m_dirty) {
+		unindexItem(itemBase);
+		if (itemBase->scene() == nullptr) continue;
+
+		indexItem(itemBase);
+	}
+
+	m_dirty.clear();
+}
+
+void ConnectorIndex::indexItem(ItemBase * itemBase) {
+	QList<ConnectorItem *> connectorItems;
+	foreach (QGraphicsItem * childItem, itemBase->childItems()) {
+		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(childItem);
+		if (connectorItem) connectorItems.append(connectorItem);
+	}
+
+	if (connectorItems.isEmpty()) return;
+
+	m_indexed.insert(itemBase, connectorItems);
+	foreach (ConnectorItem * connectorItem, connectorItems) {
+		m_grid.insert(connectorItem, connectorItem->sceneBoundingRect());
+	}
+}
+
+void ConnectorIndex::unindexItem(ItemBase * itemBase) {
+	auto it = m_indexed.find(itemBase);
+	if (it == m_indexed.end()) return;
+
+	foreach (ConnectorItem * connectorItem, *it) {
+		m_grid.remove(connectorItem);
+	}
+
+	m_indexed.erase(it);
+}
+
+bool ConnectorIndex::passes(ConnectorItem * connectorItem, int typeFilter) {
+	if (typeFilter != AllFilter) {
+		if (((1 << connectorItem->connectorType()) & typeFilter) == 0) return false;
+	}
+
+	// scene()->items() skips hidden and fully transparent items
+	if (!connectorItem->isVisible()) return false;
+	if (connectorItem->effectiveOpacity() < 0.001) return false;
+
+	return true;
+}
+
+QList<ConnectorItem *> ConnectorIndex::connectorItemsAt(const QPointF & scenePos, int typeFilter) {
+	flush();
+
+	QList<ConnectorItem *> candidates = m_grid.query(scenePos);
+
+	QList<ConnectorItem *> result;
+	foreach (ConnectorItem * connectorItem, candidates) {
+		if (!passes(connectorItem, typeFilter)) continue;
+		if (!connectorItem->contains(connectorItem->mapFromScene(scenePos))) continue;
+
+		result.append(connectorItem);
+	}
+
+	return result;
+}
+
+QList<ConnectorItem *> ConnectorIndex::connectorItemsIn(const QPolygonF & scenePolygon, int typeFilter) {
+	flush();
+
+	QList<ConnectorItem *> candidates = m_grid.query(scenePolygon.boundingRect());
+
+	QPainterPath path;
+	path.addPolygon(scenePolygon);
+	path.closeSubpath();
+
+	QList<ConnectorItem *> result;
+	foreach (ConnectorItem * connectorItem, candidates) {
+		if (!passes(connectorItem, typeFilter)) continue;
+		if (!connectorItem->collidesWithPath(connectorItem->mapFromScene(path), Qt::IntersectsItemShape)) continue;
+
+		result.append(connectorItem);
+	}
+
+	return result;
+}
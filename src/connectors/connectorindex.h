@@ -0,0 +1,75 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef CONNECTORINDEX_H
+#define CONNECTORINDEX_H
+
+#include <QList>
+#include <QSet>
+#include <QHash>
+#include <QPolygonF>
+
+#include "../utils/spatialgrid.h"
+
+class ConnectorItem;
+class ItemBase;
+
+// Per-scene index of connector scene rects, so drag-time hit testing doesn't have to sweep scene()->items().
+// Items report position, transform and child changes (see ItemBase::itemChange); wires also report setLine()
+// and connectors report rect and rubber-band leg changes (see ItemBase::connectorGeometryChanged).  Changed items
+// are re-indexed lazily on the next query, so a query only visits the cells under it.
+// Queries return what scene()->items() would return for connectors, in no particular order; findConnectorUnder sorts them by stacking order.
+
+class ConnectorIndex
+{
+public:
+	enum TypeFilter {
+		MaleFilter = 1,
+		FemaleFilter = 2,
+		WireFilter = 4,
+		PadFilter = 8,
+		UnknownFilter = 16,
+		AllFilter = 31
+	};
+
+public:
+	ConnectorIndex();
+
+	void itemChanged(ItemBase *);
+	void itemRemoved(ItemBase *);
+	void connectorRemoved(ConnectorItem *);
+	void clear();
+
+	QList<ConnectorItem *> connectorItemsAt(const QPointF & scenePos, int typeFilter = AllFilter);
+	QList<ConnectorItem *> connectorItemsIn(const QPolygonF & scenePolygon, int typeFilter = AllFilter);
+
+protected:
+	void flush();
+	void indexItem(ItemBase *);
+	void unindexItem(ItemBase *);
+	static bool passes(ConnectorItem *, int typeFilter);
+
+protected:
+	SpatialGrid<ConnectorItem *> m_grid;
+	QHash<ItemBase *, QList<ConnectorItem *> > m_indexed;
+	QSet<ItemBase *> m_dirty;
+};
+
+#endif
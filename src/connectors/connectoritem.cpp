@@ -210,8 +210,11 @@ parts editor support
 #include <QBitmap>
 #include <QApplication>
 #include <qmath.h>
+#include <functional>
+#include <algorithm>
 
 #include "../sketch/infographicsview.h"
+#include "../sketch/fgraphicsscene.h"
 #include "../debugdialog.h"
 #include "bus.h"
 #include "../items/wire.h"
@@ -240,11 +243,53 @@ const QList<ConnectorItem *> ConnectorItem::emptyConnectorItemList;
 
 static double MAX_DOUBLE = std::numeric_limits<double>::max();
 
+// true if item1 is drawn over item2: compares the z of the two items' ancestors just below their common ancestor,
+// then the order the siblings were added in, which is how QGraphicsScene::items() sorts
+static bool stacksAbove(QGraphicsItem * item1, QGraphicsItem * item2)
+{
+	QList<QGraphicsItem *> chain1;
+	QList<QGraphicsItem *> chain2;
+	for (QGraphicsItem * item = item1; item; item = item->parentItem()) chain1.prepend(item);
+	for (QGraphicsItem * item = item2; item; item = item->parentItem()) chain2.prepend(item);
+
+	int i = 0;
+	while (i < chain1.count() && i < chain2.count() && chain1.at(i) == chain2.at(i)) i++;
+
+	if (i == chain1.count()) {
+		// item1 is item2 or one of its ancestors
+		return (i < chain2.count()) && (chain2.at(i)->flags() & QGraphicsItem::ItemStacksBehindParent);
+	}
+	if (i == chain2.count()) {
+		return !(chain1.at(i)->flags() & QGraphicsItem::ItemStacksBehindParent);
+	}
+
+	QGraphicsItem * sibling1 = chain1.at(i);
+	QGraphicsItem * sibling2 = chain2.at(i);
+	if (sibling1->zValue() != sibling2->zValue()) {
+		return sibling1->zValue() > sibling2->zValue();
+	}
+
+	if (i > 0) {
+		// childItems() is in stacking order, bottom first
+		QList<QGraphicsItem *> siblings = chain1.at(i - 1)->childItems();
+		return siblings.indexOf(sibling1) > siblings.indexOf(sibling2);
+	}
+
+	// top-level items with the same z: the newer one was added later
+	ItemBase * itemBase1 = dynamic_cast<ItemBase *>(sibling1);
+	ItemBase * itemBase2 = dynamic_cast<ItemBase *>(sibling2);
+	if (itemBase1 && itemBase2) {
+		return itemBase1->id() > itemBase2->id();
+	}
+
+	return false;
+}
+
 bool wireLessThan(ConnectorItem * c1, ConnectorItem * c2)
 {
 	if (c1->connectorType() == c2->connectorType()) {
 		// if they're the same type return the topmost
-		return c1->zValue() > c2->zValue();
+		return stacksAbove(c1, c2);
 	}
 	if (c1->connectorType() == Connector::Female) {
 		// choose the female first
@@ -272,7 +317,7 @@ bool wireLessThan(ConnectorItem * c1, ConnectorItem * c2)
 	}
 
 	// Connector::Wire last
-	return c1->zValue() > c2->zValue();
+	return stacksAbove(c1, c2);
 }
 
 QColor addColor(QColor & color, int offset)
@@ -338,6 +383,18 @@ ConnectorItem::~ConnectorItem() {
 		this->connector()->removeViewItem(this);
 	}
 	clearCurves();
+
+	FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+	if (fscene) {
+		fscene->connectorIndex()->connectorRemoved(this);
+	}
+}
+
+void ConnectorItem::setConnectorRect(const QRectF & rect) {
+	setRect(rect);
+	if (m_attachedTo) {
+		m_attachedTo->connectorGeometryChanged();
+	}
 }
 
 void ConnectorItem::hoverEnterEvent ( QGraphicsSceneHoverEvent * event ) {
@@ -1321,6 +1378,11 @@ void ConnectorItem::collectEqualPotential(QList<ConnectorItem *> &connectorItems
 	QList<ConnectorItem *> tempItems = connectorItems;
 	connectorItems.clear();
 
+	// membership tests on the working list, and the buses already taken in: all members of a bus
+	// are queued the first time one of them is kept, so the others need not list the bus again
+	QSet<ConnectorItem *> queued = tempItems.toSet();
+	QSet< QPair<ItemBase *, Bus *> > expandedBuses;
+
 	for (int i = 0; i < tempItems.count(); i++) {
 		ConnectorItem *connectorItem = tempItems[i];
 
@@ -1336,7 +1398,8 @@ void ConnectorItem::collectEqualPotential(QList<ConnectorItem *> &connectorItems
 			if (crossLayers) {
 				ConnectorItem *crossConnectorItem = connectorItem->getCrossLayerConnectorItem();
 				if (crossConnectorItem) {
-					if (!tempItems.contains(crossConnectorItem)) {
+					if (!queued.contains(crossConnectorItem)) {
+						queued.insert(crossConnectorItem);
 						tempItems.append(crossConnectorItem);
 					}
 				}
@@ -1347,7 +1410,7 @@ void ConnectorItem::collectEqualPotential(QList<ConnectorItem *> &connectorItems
 		connectorItems.append(connectorItem);
 
 		foreach (ConnectorItem *cto, connectorItem->connectedToItems()) {
-			if (tempItems.contains(cto)) {
+			if (queued.contains(cto)) {
 				continue;
 			}
 
@@ -1359,13 +1422,15 @@ void ConnectorItem::collectEqualPotential(QList<ConnectorItem *> &connectorItems
 			}
 
 			// add `approved` connected items to the list being processed
+			queued.insert(cto);
 			tempItems.append(cto);
 		} // end foreach (ConnectorItem *cto, connectorItem->connectedToItems())
 
 		// When the kept connector item is part of a bus, include all of the other
 		// connectors on the bus in the list being processed
 		Bus *bus = connectorItem->bus();
-		if (bus) {
+		if (bus && !expandedBuses.contains(qMakePair(connectorItem->attachedTo(), bus))) {
+			expandedBuses.insert(qMakePair(connectorItem->attachedTo(), bus));
 			QList<ConnectorItem *> busConnectedItems;
 			connectorItem->attachedTo()->busConnectorItems(bus, connectorItem, busConnectedItems);
 #ifndef QT_NO_DEBUG
@@ -1376,7 +1441,8 @@ void ConnectorItem::collectEqualPotential(QList<ConnectorItem *> &connectorItems
 			}
 #endif
 			foreach (ConnectorItem *busConnectedItem, busConnectedItems) {
-				if (!tempItems.contains(busConnectedItem)) {
+				if (!queued.contains(busConnectedItem)) {
+					queued.insert(busConnectedItem);
 					tempItems.append(busConnectedItem);
 				}
 			}
@@ -1813,31 +1879,57 @@ bool ConnectorItem::connectedToWires() {
 	return false;
 }
 
+static ConnectorItem * ratsnestEnd(ConnectorItem * connectorItem) {
+	// either layer of a two-layer connector stands for the same ratsnest end
+	ConnectorItem * crossConnectorItem = connectorItem->getCrossLayerConnectorItem();
+	if (crossConnectorItem && std::less<ConnectorItem *>()(crossConnectorItem, connectorItem)) return crossConnectorItem;
+
+	return connectorItem;
+}
+
+static QPair<ConnectorItem *, ConnectorItem *> ratsnestKey(ConnectorItem * c1, ConnectorItem * c2) {
+	c1 = ratsnestEnd(c1);
+	c2 = ratsnestEnd(c2);
+	if (std::less<ConnectorItem *>()(c2, c1)) qSwap(c1, c2);
+	return QPair<ConnectorItem *, ConnectorItem *>(c1, c2);
+}
+
 void ConnectorItem::displayRatsnest(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags myFlag) {
 	bool formerColorWasNamed = false;
 	bool gotFormerColor = false;
 	QColor formerColor;
 
-	VirtualWire * vw = nullptr;
+	// the existing ratsnest is the starting point: wires for edges that survive are kept
+	QHash< QPair<ConnectorItem *, ConnectorItem *>, VirtualWire *> existing;
+	ConnectorPairHash previous;
 	foreach (ConnectorItem * fromConnectorItem, partConnectorItems) {
 		foreach (ConnectorItem * toConnectorItem, fromConnectorItem->connectedToItems()) {
-			vw = qobject_cast<VirtualWire *>(toConnectorItem->attachedTo());
-			if (vw) break;
-		}
-		if (vw) break;
-	}
+			VirtualWire * vw = qobject_cast<VirtualWire *>(toConnectorItem->attachedTo());
+			if (vw == nullptr) continue;
 
-	if (vw) {
-		formerColorWasNamed = vw->colorWasNamed();
-		formerColor = vw->color();
-		gotFormerColor = true;
-		clearRatsnestDisplay(partConnectorItems);
+			if (!gotFormerColor) {
+				formerColorWasNamed = vw->colorWasNamed();
+				formerColor = vw->color();
+				gotFormerColor = true;
+			}
+
+			ConnectorItem * c1 = vw->connector0()->firstConnectedToIsh();
+			ConnectorItem * c2 = vw->connector1()->firstConnectedToIsh();
+			if (c1 == nullptr || c2 == nullptr) continue;
+
+			QPair<ConnectorItem *, ConnectorItem *> key = ratsnestKey(c1, c2);
+			if (existing.contains(key)) continue;			// seen from the other end, or a duplicate left for the cleanup below
+
+			existing.insert(key, vw);
+			previous.insert(c1, c2);
+		}
 	}
 
 	InfoGraphicsView * infoGraphicsView = InfoGraphicsView::getInfoGraphicsView(this);
-	if (!infoGraphicsView) return;
-
-	if (partConnectorItems.count() < 2) return;
+	if (!infoGraphicsView || partConnectorItems.count() < 2) {
+		if (gotFormerColor) clearRatsnestDisplay(partConnectorItems);
+		return;
+	}
 
 	QStringList connectorNames;
 	ConnectorItem::collectConnectorNames(partConnectorItems, connectorNames);
@@ -1853,16 +1945,55 @@ void ConnectorItem::displayRatsnest(QList<ConnectorItem *> & partConnectorItems,
 	}
 
 	ConnectorPairHash result;
-	GraphUtils::chooseRatsnestGraph(&partConnectorItems, (ViewGeometry::RatsnestFlag | ViewGeometry::NormalFlag | ViewGeometry::PCBTraceFlag | ViewGeometry::SchematicTraceFlag) ^ myFlag, result);
+	ViewGeometry::WireFlags flags = (ViewGeometry::RatsnestFlag | ViewGeometry::NormalFlag | ViewGeometry::PCBTraceFlag | ViewGeometry::SchematicTraceFlag) ^ myFlag;
+	RatsnestMemory * ratsnestMemory = infoGraphicsView->ratsnestMemory();
+	if (ratsnestMemory) {
+		GraphUtils::updateRatsnestGraph(&partConnectorItems, flags, previous, *ratsnestMemory, result);
+	}
+	else {
+		GraphUtils::chooseRatsnestGraph(&partConnectorItems, flags, result);
+	}
 
+	QSet<VirtualWire *> keep;
 	foreach (ConnectorItem * key, result.uniqueKeys()) {
 		foreach (ConnectorItem * value, result.values(key)) {
-			VirtualWire * vw = infoGraphicsView->makeOneRatsnestWire(key, value, false, color, false);
+			VirtualWire * vw = existing.value(ratsnestKey(key, value), nullptr);
 			if (vw) {
+				keep.insert(vw);
+				ConnectorItem * c1 = vw->connector0()->firstConnectedToIsh();
+				ConnectorItem * c2 = vw->connector1()->firstConnectedToIsh();
+				QPointF p1 = c1->sceneAdjustedTerminalPoint(nullptr);
+				QPointF p2 = c2->sceneAdjustedTerminalPoint(nullptr);
+				QLineF line(0, 0, p2.x() - p1.x(), p2.y() - p1.y());
+				if (vw->pos() != p1 || vw->line() != line) {
+					vw->setLineAnd(line, p1, true);
+				}
+				if (vw->color() != color) {
+					vw->setColor(color, vw->opacity());
+				}
 				vw->setColorWasNamed(colorWasNamed);
+				continue;
 			}
+
+			vw = infoGraphicsView->makeOneRatsnestWire(key, value, false, color, false);
+			if (vw) {
+				vw->setColorWasNamed(colorWasNamed);
+			}
+		}
+	}
+
+	QList<VirtualWire *> obsolete;
+	foreach (ConnectorItem * fromConnectorItem, partConnectorItems) {
+		foreach (ConnectorItem * toConnectorItem, fromConnectorItem->connectedToItems()) {
+			VirtualWire * vw = qobject_cast<VirtualWire *>(toConnectorItem->attachedTo());
+			if (vw == nullptr || keep.contains(vw) || obsolete.contains(vw)) continue;
+
+			obsolete.append(vw);
 		}
 	}
+	foreach (VirtualWire * vw, obsolete) {
+		removeRatsnestWire(vw);
+	}
 }
 
 void ConnectorItem::clearRatsnestDisplay(QList<ConnectorItem *> & connectorItems) {
@@ -1880,22 +2011,26 @@ void ConnectorItem::clearRatsnestDisplay(QList<ConnectorItem *> & connectorItems
 	}
 
 	foreach (VirtualWire * vw, ratsnests.values()) {
-		ConnectorItem * c1 = vw->connector0()->firstConnectedToIsh();
-		if (c1) {
-			vw->connector0()->tempRemove(c1, false);
-			c1->tempRemove(vw->connector0(), false);
-		}
+		removeRatsnestWire(vw);
+	}
+}
 
-		ConnectorItem * c2 = vw->connector1()->firstConnectedToIsh();
-		if (c2) {
-			vw->connector1()->tempRemove(c2, false);
-			c2->tempRemove(vw->connector1(), false);
-		}
+void ConnectorItem::removeRatsnestWire(VirtualWire * vw) {
+	ConnectorItem * c1 = vw->connector0()->firstConnectedToIsh();
+	if (c1) {
+		vw->connector0()->tempRemove(c1, false);
+		c1->tempRemove(vw->connector0(), false);
+	}
 
-		//vw->debugInfo("removing rat 1");
-		vw->scene()->removeItem(vw);
-		delete vw;
+	ConnectorItem * c2 = vw->connector1()->firstConnectedToIsh();
+	if (c2) {
+		vw->connector1()->tempRemove(c2, false);
+		c2->tempRemove(vw->connector1(), false);
 	}
+
+	//vw->debugInfo("removing rat 1");
+	vw->scene()->removeItem(vw);
+	delete vw;
 }
 
 
@@ -1964,16 +2099,28 @@ double ConnectorItem::minDimension() {
 
 ConnectorItem * ConnectorItem::findConnectorUnder(bool useTerminalPoint, bool allowAlready, const QList<ConnectorItem *> & exclude, bool displayDragTooltip, ConnectorItem * other)
 {
-	QList<QGraphicsItem *> items = useTerminalPoint
-	                               ? this->scene()->items(this->sceneAdjustedTerminalPoint(nullptr))
-	                               : this->scene()->items(mapToScene(this->rect()));  // only wires use rect
+	QList<ConnectorItem *> under;
+	FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(this->scene());
+	if (fscene) {
+		under = useTerminalPoint
+		        ? fscene->connectorIndex()->connectorItemsAt(this->sceneAdjustedTerminalPoint(nullptr))
+		        : fscene->connectorIndex()->connectorItemsIn(mapToScene(this->rect()));  // only wires use rect
+	}
+	else {
+		QList<QGraphicsItem *> items = useTerminalPoint
+		                               ? this->scene()->items(this->sceneAdjustedTerminalPoint(nullptr))
+		                               : this->scene()->items(mapToScene(this->rect()));
+		foreach (QGraphicsItem * item, items) {
+			ConnectorItem * connectorItemUnder = dynamic_cast<ConnectorItem *>(item);
+			if (connectorItemUnder) under.append(connectorItemUnder);
+		}
+	}
+
 	QList<ConnectorItem *> candidates;
 	// for the moment, take the topmost ConnectorItem that doesn't belong to me
-	foreach (QGraphicsItem * item, items) {
-		ConnectorItem * connectorItemUnder = dynamic_cast<ConnectorItem *>(item);
-		if (!connectorItemUnder) continue;
+	foreach (ConnectorItem * connectorItemUnder, under) {
 		if (!connectorItemUnder->connector()) continue;  // shouldn't happen
-		if (attachedTo()->childItems().contains(connectorItemUnder)) continue;  // don't use own connectors
+		if (connectorItemUnder->parentItem() == attachedTo()) continue;  // don't use own connectors
 		if (!this->connectionIsAllowed(connectorItemUnder)) {
 			continue;
 		}
@@ -1993,7 +2140,7 @@ ConnectorItem * ConnectorItem::findConnectorUnder(bool useTerminalPoint, bool al
 		candidate = candidates[0];
 	}
 	else if (candidates.count() > 0) {
-		qSort(candidates.begin(), candidates.end(), wireLessThan);
+		std::stable_sort(candidates.begin(), candidates.end(), wireLessThan);
 		candidate = candidates[0];
 	}
 
@@ -2301,6 +2448,11 @@ void ConnectorItem::repoly(const QPolygonF & poly, bool relative)
 
 void ConnectorItem::calcConnectorEnd()
 {
+	// every change to the leg ends up here; the connector index re-reads the leg's extent on its next query
+	if (m_attachedTo) {
+		m_attachedTo->connectorGeometryChanged();
+	}
+
 	if (m_legPolygon.count() < 2) {
 		m_connectorDrawEnd = m_connectorDetectEnd = QPointF(0,0);
 		return;
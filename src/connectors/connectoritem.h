@@ -52,6 +52,8 @@ public:
 	ConnectorItem(Connector *, ItemBase* attachedTo);
 	~ConnectorItem();
 
+	void setConnectorRect(const QRectF &);			// not setRect(), which doesn't tell the connector index
+
 	Connector * connector();
 	void connectorHover(ItemBase *, bool hovering);
 	bool connectorHovering();
@@ -105,6 +107,7 @@ public:
 	ConnectorItem * getCrossLayerConnectorItem();
 	void displayRatsnest(QList<ConnectorItem *> & partsConnectorItems, ViewGeometry::WireFlags myFlag);
 	void clearRatsnestDisplay(QList<ConnectorItem *> & connectorItems);
+	static void removeRatsnestWire(class VirtualWire *);
 	double calcClipRadius();
 	bool isEffectivelyCircular();
 	void paint( QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget = 0 );
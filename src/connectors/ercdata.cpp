@@ -150,3 +150,59 @@ void ErcData::writeVoltage(QDomElement & parent, QDomDocument & doc) {
 	}
 }
 
+
+bool ErcData::writeToStream(QXmlStreamWriter & streamWriter) {
+	// same output as writeToElement, for exporters that stream their xml
+	if (m_eType != Ground && m_eType != VCC) return false;
+
+	streamWriter.writeStartElement("erc");
+	streamWriter.writeAttribute("etype", m_eType == Ground ? "ground" : "VCC");
+	writeCurrent(streamWriter);
+	if (m_eType == VCC) {
+		writeVoltage(streamWriter);
+	}
+	streamWriter.writeEndElement();
+	return true;
+}
+
+void ErcData::writeCurrent(QXmlStreamWriter & streamWriter) {
+	if (m_current || m_currentMin || m_currentMax || m_currentFlow != UnknownFlow) {
+		streamWriter.writeStartElement("current");
+		if (m_current) {
+			streamWriter.writeAttribute("value", QString::number(m_current.value()));
+		}
+		if (m_currentMin) {
+			streamWriter.writeAttribute("valueMin", QString::number(m_currentMin.value()));
+		}
+		if (m_currentMax) {
+			streamWriter.writeAttribute("valueMax", QString::number(m_currentMax.value()));
+		}
+		switch (m_currentFlow) {
+		case Source:
+			streamWriter.writeAttribute("flow", "source");
+			break;
+		case Sink:
+			streamWriter.writeAttribute("flow", "sink");
+			break;
+		default:
+			break;
+		}
+		streamWriter.writeEndElement();
+	}
+}
+
+void ErcData::writeVoltage(QXmlStreamWriter & streamWriter) {
+	if (m_voltage || m_voltageMin || m_voltageMax) {
+		streamWriter.writeStartElement("voltage");
+		if (m_voltage) {
+			streamWriter.writeAttribute("value", QString::number(m_voltage.value()));
+		}
+		if (m_voltageMin) {
+			streamWriter.writeAttribute("valueMin", QString::number(m_voltageMin.value()));
+		}
+		if (m_voltageMax) {
+			streamWriter.writeAttribute("valueMax", QString::number(m_voltageMax.value()));
+		}
+		streamWriter.writeEndElement();
+	}
+}
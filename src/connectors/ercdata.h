@@ -25,6 +25,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDomElement>
 #include <QHash>
 #include <QList>
+#include <QXmlStreamWriter>
 
 class ValidReal {
 public:
@@ -66,6 +67,7 @@ public:
 	ErcData(const QDomElement & ercElement);
 
 	bool writeToElement(QDomElement & ercElement, QDomDocument & doc);
+	bool writeToStream(QXmlStreamWriter &);
 	constexpr EType eType() const noexcept { return m_eType; }
 	constexpr Ignore ignore() const noexcept { return m_ignore; }
 
@@ -74,6 +76,8 @@ protected:
 	void readCurrent(QDomElement &);
 	void writeVoltage(QDomElement &, QDomDocument &);
 	void writeCurrent(QDomElement &, QDomDocument &);
+	void writeVoltage(QXmlStreamWriter &);
+	void writeCurrent(QXmlStreamWriter &);
 
 protected:
 	EType m_eType;
@@ -29,9 +29,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDir>
 #include <QtDebug>
 #include <QIcon>
+#include <QMutex>
+#include <QMutexLocker>
 
 DebugDialog* DebugDialog::singleton = NULL;
 QFile DebugDialog::m_file;
+static QMutex DebugMutex;			// debug() is also called from worker threads
 
 #ifdef QT_NO_DEBUG
 bool DebugDialog::m_enabled = false;
@@ -132,6 +135,7 @@ void DebugDialog::debug(QString message, DebugLevel debugLevel, QObject * ancest
 
 	if (!m_enabled) return;
 
+	QMutexLocker locker(&DebugMutex);
 
 	if (singleton == NULL) {
 		new DebugDialog();
@@ -22,6 +22,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "debugdialog.h"
 #include "utils/misc.h"
 #include "mainwindow/mainwindow.h"
+#include "model/autosavewriter.h"
 #include "fsplashscreen.h"
 #include "version/version.h"
 #include "dialogs/prefsdialog.h"
@@ -50,8 +51,11 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "svg/kicadmodule2svg.h"
 #include "svg/kicadschematic2svg.h"
 #include "svg/gerbergenerator.h"
+#include "model/modelnetlist.h"
 #include "installedfonts.h"
 #include "items/pinheader.h"
+#include "items/symbolpaletteitem.h"
+#include "items/stripboard.h"
 #include "items/partfactory.h"
 #include "items/propertydef.h"
 #include "dialogs/recoverydialog.h"
@@ -59,9 +63,16 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "autoroute/panelizer.h"
 #include "sketch/sketchwidget.h"
 #include "sketch/pcbsketchwidget.h"
+#include "sketch/fgraphicsscene.h"
+#include "connectors/connectorindex.h"
+#include "connectors/connectoritem.h"
+#include "connectors/connectivitysnapshot.h"
 #include "help/firsttimehelpdialog.h"
 #include "help/aboutbox.h"
 #include "version/partschecker.h"
+#include "utils/tracer.h"
+#include "utils/s2s.h"
+#include "svg/svgloadcache.h"
 
 // dependency injection :P
 #include "referencemodel/sqlitereferencemodel.h"
@@ -77,11 +88,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMessageBox>
 #include <QTextStream>
 #include <QFontDatabase>
+#include <QElapsedTimer>
 #include <QtDebug>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QMultiHash>
 #include <QTemporaryFile>
+#include <QTemporaryDir>
+#include <QBuffer>
 #include <QDir>
 #include <time.h>
 
@@ -349,6 +363,9 @@ int FApplication::init() {
 
 	m_serviceType = NoService;
 
+	// picks up FRITZING_TRACE on the gui thread, before any worker threads start
+	Tracer::enabled();
+
 	QList<int> toRemove;
 	for (int i = 0; i < m_arguments.length(); i++) {
 		if ((m_arguments[i].compare("-h", Qt::CaseInsensitive) == 0) ||
@@ -453,6 +470,14 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-s2s", Qt::CaseInsensitive) == 0) ||
+		        (m_arguments[i].compare("--s2s", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = S2SService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
 		if ((m_arguments[i].compare("-svg", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("--svg", Qt::CaseInsensitive) == 0)) {
 			m_serviceType = SvgService;
@@ -461,6 +486,22 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-netlist", Qt::CaseInsensitive) == 0) ||
+		        (m_arguments[i].compare("--netlist", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = NetlistService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-benchmark", Qt::CaseInsensitive) == 0) ||
+		        (m_arguments[i].compare("--benchmark", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = BenchmarkService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
 		if ((m_arguments[i].compare("-port", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("--port", Qt::CaseInsensitive) == 0)) {
 			DebugDialog::setEnabled(true);
@@ -774,6 +815,7 @@ bool FApplication::loadReferenceModel(const QString & databaseName, bool fullLoa
 
 bool FApplication::loadReferenceModel(const QString &  databaseName, bool fullLoad, ReferenceModel * referenceModel)
 {
+	TraceScope trace("load parts", databaseName);
 	QDir dir = FolderUtils::getAppPartsSubFolder("");
 	QString dbPath = dir.absoluteFilePath("parts.db");
 
@@ -853,6 +895,10 @@ int FApplication::serviceStartup() {
 		runKicadSchematicService();
 		return 0;
 
+	case S2SService:
+		runS2SService();
+		return 0;
+
 	case GerberService:
 		runGerberService();
 		return 0;
@@ -861,6 +907,14 @@ int FApplication::serviceStartup() {
 		runSvgService();
 		return 0;
 
+	case NetlistService:
+		runNetlistService();
+		return 0;
+
+	case BenchmarkService:
+		runBenchmarkService();
+		return 0;
+
 	case PanelizerService:
 		runPanelizerService();
 		return 0;
@@ -951,6 +1005,479 @@ void FApplication::runSvgServiceAux()
 	}
 }
 
+void FApplication::runNetlistService()
+{
+	// no fonts and no windows: the sketches are only loaded into a model
+	createUserDataStoreFolderStructures();
+	FMessageBox::BlockMessages = true;
+	loadReferenceModel("", false);
+	runNetlistServiceAux();
+}
+
+void FApplication::runNetlistServiceAux()
+{
+	QDir dir(m_outputFolder);
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = dir.entryList(filters, QDir::Files);
+
+	QElapsedTimer timer;
+	timer.start();
+	int exported = 0;
+	qint64 connectors = 0;
+	foreach (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		QFileInfo info(filepath);
+		m_started = true;
+
+		ModelNetlist netlist;
+		QString error;
+		if (!netlist.loadBundle(filepath, m_referenceModel, error)) {
+			DebugDialog::debug(QString("netlist export failed %1: %2").arg(filepath).arg(error));
+			continue;
+		}
+
+		QFile xmlFile(dir.absoluteFilePath(info.completeBaseName() + "_netlist.xml"));
+		if (xmlFile.open(QIODevice::WriteOnly)) {
+			netlist.writeNetlist(&xmlFile, info.fileName());
+			xmlFile.close();
+		}
+
+		QFile spiceFile(dir.absoluteFilePath(info.completeBaseName() + "_spice.cir"));
+		if (spiceFile.open(QIODevice::WriteOnly)) {
+			netlist.writeSpiceNetlist(&spiceFile, info.completeBaseName());
+			spiceFile.close();
+		}
+
+		QFile bomFile(dir.absoluteFilePath(info.completeBaseName() + "_bom.csv"));
+		if (bomFile.open(QIODevice::WriteOnly)) {
+			netlist.writeBom(&bomFile);
+			bomFile.close();
+		}
+
+		exported++;
+		connectors += netlist.connectorCount();
+	}
+
+	double seconds = qMax((qint64) 1, timer.elapsed()) / 1000.0;
+	DebugDialog::debug(QString("netlist export: %1 of %2 sketches, %3 connectors in %4s (%5 sketches/s)")
+	                   .arg(exported).arg(filenames.count()).arg(connectors)
+	                   .arg(seconds, 0, 'f', 2).arg(exported / seconds, 0, 'f', 1));
+}
+
+static int checkConnectivitySnapshot(SketchWidget * sketchWidget, int & walks) {
+	// walks the snapshot captured from the scene and the live items side by side; returns how many walks differ.
+	// The snapshot takes in whole bus classes, so only the sets are compared, not the order
+	QList<ConnectorItem *> connectorItems;
+	QSharedPointer<const ConnectivitySnapshot> snapshot = sketchWidget->connectivitySnapshot(&connectorItems);
+	QHash<ConnectorItem *, int> indexes;
+	for (int c = 0; c < connectorItems.count(); c++) {
+		indexes.insert(connectorItems.at(c), c);
+	}
+
+	const bool crossLayers[] = { true, false, true };
+	const ViewGeometry::WireFlags skipFlags[] = { ViewGeometry::NoFlag, ViewGeometry::NormalFlag, ViewGeometry::RatsnestFlag | ViewGeometry::PCBTraceFlag };
+	int differ = 0;
+	for (int mode = 0; mode < 3; mode++) {
+		for (int c = 0; c < connectorItems.count(); c++) {
+			QList<ConnectorItem *> live;
+			live.append(connectorItems.at(c));
+			ConnectorItem::collectEqualPotential(live, crossLayers[mode], skipFlags[mode]);
+			QSet<int> expected;
+			foreach (ConnectorItem * connectorItem, live) {
+				expected.insert(indexes.value(connectorItem, -1));
+			}
+
+			QList<int> start;
+			start.append(c);
+			walks++;
+			if (snapshot->equalPotential(start, crossLayers[mode], skipFlags[mode]).toSet() == expected) continue;
+
+			if (differ++ < 5) {
+				DebugDialog::debug(QString("benchmark: %1 view, walk from %2 %3 differs from the live walk")
+				                   .arg(ViewLayer::viewIDName(sketchWidget->viewID()))
+				                   .arg(connectorItems.at(c)->attachedToInstanceTitle())
+				                   .arg(connectorItems.at(c)->connectorSharedID()));
+			}
+		}
+	}
+
+	return differ;
+}
+
+static int checkBusRoutingStatus(SketchWidget * sketchWidget, int & changes) {
+	// a voltage or net label change moves a symbol to another bus without connecting or disconnecting anything;
+	// after each one the incremental routing status has to come out the same as a full rescan.  Returns how many differ
+	QList<SymbolPaletteItem *> symbols;
+	foreach (QGraphicsItem * item, sketchWidget->scene()->items()) {
+		SymbolPaletteItem * symbol = qobject_cast<SymbolPaletteItem *>(dynamic_cast<ItemBase *>(item));
+		if (symbol == NULL) continue;
+		if (symbol->moduleID().compare("ground symbol", Qt::CaseInsensitive) == 0) continue;
+
+		symbols.append(symbol);
+	}
+	if (symbols.isEmpty()) return 0;
+
+	RoutingStatus routingStatus;
+	routingStatus.zero();
+	sketchWidget->updateRoutingStatus(routingStatus, true);
+
+	int differ = 0;
+	foreach (SymbolPaletteItem * symbol, symbols) {
+		bool netLabel = symbol->isOnlyNetLabel();
+		QString original = netLabel ? symbol->getLabel() : QString::number(symbol->voltage());
+
+		// off on its own, onto another symbol's bus, and back
+		QStringList values;
+		values << (netLabel ? "__benchmark__" : "-123.25");
+		foreach (SymbolPaletteItem * other, symbols) {
+			if (other->isOnlyNetLabel() != netLabel) continue;
+
+			QString value = netLabel ? other->getLabel() : QString::number(other->voltage());
+			if (value == original) continue;
+
+			values << value;
+			break;
+		}
+		values << original;
+
+		foreach (QString value, values) {
+			if (netLabel) symbol->setLabel(value);
+			else symbol->setVoltage(value.toDouble());
+
+			RoutingStatus incremental;
+			incremental.zero();
+			sketchWidget->updateRoutingStatus(incremental, false);
+			RoutingStatus full;
+			full.zero();
+			sketchWidget->updateRoutingStatus(full, true);
+			changes++;
+			if (!(incremental != full)) continue;
+
+			if (differ++ < 5) {
+				DebugDialog::debug(QString("benchmark: %1 view, %2 set to %3: incremental routing status %4 nets %5 routed, full rescan %6 nets %7 routed")
+				                   .arg(ViewLayer::viewIDName(sketchWidget->viewID()))
+				                   .arg(symbol->instanceTitle()).arg(value)
+				                   .arg(incremental.m_netCount).arg(incremental.m_netRoutedCount)
+				                   .arg(full.m_netCount).arg(full.m_netRoutedCount));
+			}
+		}
+	}
+
+	return differ;
+}
+
+void FApplication::runBenchmarkService()
+{
+	// spans are collected even without FRITZING_TRACE, so the totals can be reported
+	Tracer::start(QString::fromLocal8Bit(qgetenv("FRITZING_TRACE")));
+	Tracer::clear();
+
+	QElapsedTimer timer;
+	timer.start();
+	initService();
+	DebugDialog::debug(QString("benchmark: startup %1 ms").arg(timer.elapsed()));
+
+	runBenchmarkServiceAux();
+}
+
+void FApplication::runBenchmarkServiceAux()
+{
+	// a fixed set, so runs are comparable; m_outputFolder is normally sketches/core
+	QStringList filenames;
+	filenames << "Photocell.fzz" << "Button.fzz" << "Melody.fzz" << "Countdown.fzz" << "LCD.fzz"
+	          << "Shift_Register_2x.fzz" << "Stepper_Motor.fzz" << "Barebones Arduino (stripboard).fzz";
+
+	QDir dir(m_outputFolder);
+	QTemporaryDir outputDir;
+	if (!outputDir.isValid()) {
+		DebugDialog::debug("benchmark: unable to create output folder");
+		return;
+	}
+
+	QList<ViewLayer::ViewID> ids;
+	ids << ViewLayer::BreadboardView << ViewLayer::SchematicView << ViewLayer::PCBView;
+
+	// what tracing costs: the first sketch opened with span recording paused and running, in turns, after
+	// a warm-up open that loads its parts.  The fastest of each is reported
+	QString first = dir.absoluteFilePath(filenames.first());
+	if (QFileInfo(first).exists()) {
+		m_started = true;
+		timeBenchmarkOpen(first);
+		const int OpenRounds = 3;
+		qint64 untraced = -1;
+		qint64 traced = -1;
+		int spans = 0;
+		for (int round = 0; round < OpenRounds; round++) {
+			Tracer::pause(true);
+			qint64 elapsed = timeBenchmarkOpen(first);
+			if (untraced < 0 || (elapsed >= 0 && elapsed < untraced)) untraced = elapsed;
+			Tracer::pause(false);
+
+			Tracer::clear();
+			elapsed = timeBenchmarkOpen(first);
+			if (traced < 0 || (elapsed >= 0 && elapsed < traced)) traced = elapsed;
+			spans = 0;
+			foreach (Tracer::Total t, Tracer::totals()) {
+				spans += t.count;
+			}
+		}
+		Tracer::clear();
+		DebugDialog::debug(QString("benchmark: %1 open untraced %2 ms, traced %3 ms (%4 spans), best of %5")
+		                   .arg(filenames.first()).arg(untraced).arg(traced).arg(spans).arg(OpenRounds));
+	}
+
+	QElapsedTimer total;
+	total.start();
+	foreach (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		if (!QFileInfo(filepath).exists()) {
+			DebugDialog::debug(QString("benchmark: %1 not found").arg(filepath));
+			continue;
+		}
+
+		QElapsedTimer timer;
+		timer.start();
+		MainWindow * mainWindow = openWindowForService(false, 3);
+		if (mainWindow == NULL) continue;
+
+		m_started = true;
+		mainWindow->setCloseSilently(true);
+		FolderUtils::setOpenSaveFolderAux(outputDir.path());
+		if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+			DebugDialog::debug(QString("benchmark: failed to load %1").arg(filepath));
+			mainWindow->close();
+			continue;
+		}
+
+		qint64 openTime = timer.restart();
+		QString name = QFileInfo(filepath).completeBaseName();
+		foreach (ViewLayer::ViewID id, ids) {
+			QString fn = QString("%1_%2.svg").arg(name).arg(ViewLayer::viewIDNaturalName(id));
+			mainWindow->setCurrentView(id);
+			mainWindow->exportSvg(GraphicsUtils::StandardFritzingDPI, false, false, QDir(outputDir.path()).absoluteFilePath(fn));
+		}
+
+		qint64 svgTime = timer.restart();
+		GerberGenerator::exportToGerber(name, outputDir.path(), NULL, mainWindow->pcbView(), false);
+		qint64 gerberTime = timer.restart();
+
+		// the stages below walk every view, including any still deferred from loading
+		mainWindow->materializeViews();
+		timer.restart();
+
+		// select every part in every view, as someone clicking through the sketch would; the second pass is warm
+		int selected = 0;
+		qint64 inspectorTimes[2];
+		for (int pass = 0; pass < 2; pass++) {
+			foreach (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+				QSet<ItemBase *> chiefs;
+				foreach (QGraphicsItem * item, sketchWidget->scene()->items()) {
+					ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
+					if (itemBase == NULL) continue;
+
+					chiefs.insert(itemBase->layerKinChief());
+				}
+				foreach (ItemBase * itemBase, chiefs) {
+					sketchWidget->viewItemInfoNow(itemBase);
+				}
+				if (pass == 0) selected += chiefs.count();
+			}
+			inspectorTimes[pass] = timer.restart();
+		}
+
+		// look up what is under every connector, as findConnectorUnder does for each pin on every mouse move of a drag
+		int hitTests = 0;
+		int hits = 0;
+		foreach (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+			FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(sketchWidget->scene());
+			if (fscene == NULL) continue;
+
+			foreach (QGraphicsItem * item, fscene->items()) {
+				ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
+				if (connectorItem == NULL) continue;
+
+				hitTests++;
+				hits += fscene->connectorIndex()->connectorItemsAt(connectorItem->sceneAdjustedTerminalPoint(NULL)).count();
+			}
+		}
+		qint64 hitTestTime = timer.restart();
+
+		// drag latency: carry the part with the most connectors across its view in small steps.  Each step moves the part,
+		// so the index re-grids it, and looks up what is under each of its connectors, as a mouse move during a drag does
+		const int DragSteps = 100;
+		int dragMoves = 0;
+		QHash<ItemBase *, QPointF> dragged;
+		foreach (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+			ItemBase * part = NULL;
+			foreach (QGraphicsItem * item, sketchWidget->scene()->items()) {
+				ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
+				if (itemBase == NULL || qobject_cast<Wire *>(itemBase) || itemBase->layerKinChief() != itemBase) continue;
+				if (part && part->cachedConnectorItems().count() >= itemBase->cachedConnectorItems().count()) continue;
+
+				part = itemBase;
+			}
+			if (part == NULL) continue;
+
+			QPointF origin = part->pos();
+			dragged.insert(part, origin);
+			QRectF sceneRect = sketchWidget->scene()->itemsBoundingRect();
+			for (int step = 1; step <= DragSteps; step++) {
+				part->setPos(origin + QPointF(sceneRect.width() * step / DragSteps, sceneRect.height() * step / DragSteps / 2));
+				foreach (ConnectorItem * connectorItem, part->cachedConnectorItems()) {
+					connectorItem->findConnectorUnder(true, false, ConnectorItem::emptyConnectorItemList, false, NULL);
+				}
+				dragMoves++;
+			}
+		}
+		qint64 dragTime = timer.restart();
+		foreach (ItemBase * part, dragged.keys()) {
+			part->setPos(dragged.value(part));
+			foreach (ConnectorItem * connectorItem, part->cachedConnectorItems()) {
+				connectorItem->findConnectorUnder(true, false, ConnectorItem::emptyConnectorItemList, false, NULL);
+			}
+		}
+		timer.restart();
+
+		DebugDialog::debug(QString("benchmark: %1 open %2 ms, svg %3 ms, gerber %4 ms, inspector %5 parts %6 ms (warm %7 ms), hit test %8 connectors %9 ms (%10 hits), drag %11 moves %12 ms (%13 ms per move)")
+		                   .arg(filename).arg(openTime).arg(svgTime).arg(gerberTime)
+		                   .arg(selected).arg(inspectorTimes[0]).arg(inspectorTimes[1])
+		                   .arg(hitTests).arg(hitTestTime).arg(hits)
+		                   .arg(dragMoves).arg(dragTime).arg(dragTime / (double) qMax(1, dragMoves), 0, 'f', 2));
+
+		// strip cuts on every stripboard: each cut rebuilds the board's buses over all of its hole ConnectorItems,
+		// as letting go of the mouse after cutting does, so this is the latency someone cutting strips sees
+		const int StripCuts = 50;
+		int boards = 0;
+		int holes = 0;
+		int holeItems = 0;
+		int latticeBytes = 0;
+		int stripCuts = 0;
+		qint64 stripTime = 0;
+		QList<Stripboard *> stripboards;
+		foreach (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+			if (sketchWidget->viewID() != ViewLayer::BreadboardView) continue;		// strips are only cut in breadboard view
+
+			foreach (QGraphicsItem * item, sketchWidget->scene()->items()) {
+				Stripboard * stripboard = qobject_cast<Stripboard *>(dynamic_cast<ItemBase *>(item));
+				if (stripboard) stripboards.append(stripboard);
+			}
+		}
+		foreach (Stripboard * stripboard, stripboards) {
+			StripLattice & lattice = stripboard->lattice();
+			if (lattice.columns() < 2 || lattice.rows() < 1) continue;
+
+			boards++;
+			holes += lattice.columns() * lattice.rows();
+			holeItems += stripboard->cachedConnectorItems().count();
+			latticeBytes += lattice.memoryUsage();
+			QString original = lattice.cutString();
+			timer.restart();
+			for (int i = 0; i < StripCuts; i++) {
+				int x = (i * 37) % (lattice.columns() - 1);
+				int y = (i * 91) % lattice.rows();
+				lattice.setCut(x, y, true, !lattice.isCut(x, y, true));
+				stripboard->reinitBuses(false);
+				stripCuts++;
+			}
+			stripTime += timer.elapsed();
+			lattice.setCutString(original);
+			stripboard->reinitBuses(false);
+		}
+		if (boards > 0) {
+			DebugDialog::debug(QString("benchmark: %1 stripboard %2 boards, %3 holes, %4 connector items, lattice %5 bytes, %6 cuts %7 ms (%8 ms per cut)")
+			                   .arg(filename).arg(boards).arg(holes).arg(holeItems).arg(latticeBytes)
+			                   .arg(stripCuts).arg(stripTime).arg(stripTime / (double) qMax(1, stripCuts), 0, 'f', 2));
+		}
+
+		// not timed: a check that the snapshot the net walks run on matches the scene it was taken from
+		int walks = 0;
+		int differ = 0;
+		foreach (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+			differ += checkConnectivitySnapshot(sketchWidget, walks);
+		}
+		DebugDialog::debug(QString("benchmark: %1 connectivity snapshot %2 walks, %3 differ").arg(filename).arg(walks).arg(differ));
+
+		// not timed either: bus-only net changes reach the incremental routing status
+		int busChanges = 0;
+		int busDiffer = 0;
+		foreach (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+			busDiffer += checkBusRoutingStatus(sketchWidget, busChanges);
+		}
+		DebugDialog::debug(QString("benchmark: %1 routing status after %2 bus changes, %3 differ").arg(filename).arg(busChanges).arg(busDiffer));
+
+		mainWindow->close();
+	}
+
+	DebugDialog::debug(QString("benchmark: total %1 ms").arg(total.elapsed()));
+
+	// the headless writers on the same sketches, no views involved: load the model once, then write each format
+	// a few times into memory so the disk doesn't figure in
+	const int WriterRounds = 10;
+	qint64 netlistTimes[4] = { 0, 0, 0, 0 };
+	qint64 netlistBytes[3] = { 0, 0, 0 };
+	int netlistSketches = 0;
+	foreach (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		if (!QFileInfo(filepath).exists()) continue;
+
+		QElapsedTimer timer;
+		timer.start();
+		ModelNetlist netlist;
+		QString error;
+		if (!netlist.loadBundle(filepath, m_referenceModel, error)) {
+			DebugDialog::debug(QString("benchmark: netlist load failed %1: %2").arg(filepath).arg(error));
+			continue;
+		}
+		netlistTimes[0] += timer.restart();
+
+		QString name = QFileInfo(filepath).completeBaseName();
+		for (int writer = 0; writer < 3; writer++) {
+			for (int round = 0; round < WriterRounds; round++) {
+				QBuffer buffer;
+				buffer.open(QIODevice::WriteOnly);
+				if (writer == 0) netlist.writeNetlist(&buffer, filename);
+				else if (writer == 1) netlist.writeSpiceNetlist(&buffer, name);
+				else netlist.writeBom(&buffer);
+				if (round == 0) netlistBytes[writer] += buffer.size();
+			}
+			netlistTimes[writer + 1] += timer.restart();
+		}
+		netlistSketches++;
+	}
+	if (netlistSketches > 0) {
+		QStringList writers;
+		writers << "xml" << "spice" << "bom";
+		QStringList results;
+		for (int writer = 0; writer < 3; writer++) {
+			double ms = netlistTimes[writer + 1] / (double) WriterRounds;
+			results << QString("%1 %2 ms, %3 KB (%4 MB/s)").arg(writers.at(writer)).arg(ms, 0, 'f', 2)
+			           .arg(netlistBytes[writer] / 1024.0, 0, 'f', 1)
+			           .arg(netlistBytes[writer] / (1024.0 * 1024.0) / qMax(0.001, ms / 1000), 0, 'f', 1);
+		}
+		DebugDialog::debug(QString("benchmark: netlist writers on %1 sketches: model load %2 ms, %3")
+		                   .arg(netlistSketches).arg(netlistTimes[0]).arg(results.join(", ")));
+	}
+	foreach (Tracer::Total t, Tracer::totals()) {
+		DebugDialog::debug(QString("benchmark: %1 x%2 %3 ms").arg(t.name, -16).arg(t.count).arg(t.microseconds / 1000.0, 0, 'f', 1));
+	}
+}
+
+qint64 FApplication::timeBenchmarkOpen(const QString & filepath)
+{
+	// milliseconds to open the sketch in a new window, or -1 if it doesn't load
+	QElapsedTimer timer;
+	timer.start();
+	MainWindow * mainWindow = openWindowForService(false, 3);
+	if (mainWindow == NULL) return -1;
+
+	mainWindow->setCloseSilently(true);
+	bool loaded = mainWindow->loadWhich(filepath, false, false, false, "");
+	qint64 elapsed = timer.elapsed();
+	mainWindow->close();
+	return loaded ? elapsed : -1;
+}
+
 void FApplication::runDatabaseService()
 {
 	createUserDataStoreFolderStructures();
@@ -1118,6 +1645,36 @@ void FApplication::runKicadSchematicService() {
 	}
 }
 
+void FApplication::runS2SService() {
+	// parts/core/*.fzp draw their schematics from parts/svg/core/schematic/*.svg
+	QDir fzpDir(m_outputFolder);
+	QDir oldSvgDir(fzpDir);
+	if (!oldSvgDir.cd("../svg/" + fzpDir.dirName())) {
+		oldSvgDir = fzpDir;
+	}
+	QDir newSvgDir(fzpDir.absoluteFilePath("s2s"));
+	if (!newSvgDir.mkpath(".")) {
+		DebugDialog::debug("s2s: unable to create " + newSvgDir.absolutePath());
+		return;
+	}
+
+	registerFonts();
+
+	QStringList filters;
+	filters << "*.fzp";
+	QStringList fzpFilePaths;
+	foreach (QString filename, fzpDir.entryList(filters, QDir::Files)) {
+		fzpFilePaths << fzpDir.absoluteFilePath(filename);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	QList<S2SResult> results = S2S::batch(fzpFilePaths, oldSvgDir, newSvgDir, false);
+	foreach (QString line, S2S::summary(results, timer.elapsed())) {
+		DebugDialog::debug(line);
+	}
+}
+
 int FApplication::startup()
 {
 	//DebugDialog::setEnabled(true);
@@ -1450,6 +2007,16 @@ void FApplication::createUserDataStoreFolderStructures() {
 	FolderUtils::copyBin(BinManager::MyPartsBinLocation, BinManager::MyPartsBinTemplateLocation);
 	FolderUtils::copyBin(BinManager::SearchBinLocation, BinManager::SearchBinTemplateLocation);
 	PartFactory::initFolder();
+
+	// one folder per release, since the svg fix-up code may have changed in between
+	QDir svgCacheDir(FolderUtils::getTopLevelUserDataStorePath() + "/svgcache");
+	foreach (QString folder, svgCacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+		if (folder == Version::versionString()) continue;
+
+		QDir dir(svgCacheDir.absoluteFilePath(folder));
+		FolderUtils::rmdir(dir);
+	}
+	SvgLoadCache::setFolder(svgCacheDir.absoluteFilePath(Version::versionString()));
 }
 
 
@@ -1714,8 +2281,14 @@ QList<MainWindow *> FApplication::recoverBackups()
 	for (int i = backupList.size() - 1; i >=0; i--) {
 		QFileInfo fileInfo = backupList.at(i);
 		if (!fileInfo.fileName().endsWith(FritzingSketchExtension)) {
+			// a journal whose backup file is gone can never be replayed
+			AutosaveWriter::removeOrphanedJournal(fileInfo.absoluteFilePath());
 			backupList.removeAt(i);
+			continue;
 		}
+
+		// fold any autosave journal into the backup file
+		AutosaveWriter::consolidate(fileInfo.absoluteFilePath());
 	}
 
 	QList<MainWindow*> recoveredSketches;
@@ -2044,6 +2617,8 @@ void FApplication::regenerateDatabaseFinished() {
 	RegenerateDatabaseThread * thread = qobject_cast<RegenerateDatabaseThread *>(sender());
 	if (thread == NULL) return;
 
+	SvgLoadCache::clear();
+
 	QDialog * progressDialog = thread->progressDialog();
 	if (progressDialog == m_updateDialog) {
 		m_updateDialog->installFinished(thread->error());
@@ -165,10 +165,16 @@ protected:
 	void runDatabaseService();
 	void runKicadFootprintService();
 	void runKicadSchematicService();
+	void runS2SService();
 	void runGerberService();
 	void runGerberServiceAux();
 	void runSvgService();
 	void runSvgServiceAux();
+	void runNetlistService();
+	void runNetlistServiceAux();
+	void runBenchmarkService();
+	void runBenchmarkServiceAux();
+	qint64 timeBenchmarkOpen(const QString & filepath);
 	void runPanelizerService();
 	void runInscriptionService();
 	void runExampleService();
@@ -199,6 +205,9 @@ protected:
 		SvgService,
 		PortService,
 		DRCService,
+		NetlistService,
+		BenchmarkService,
+		S2SService,
 		NoService
 	};
 
@@ -21,9 +21,11 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "fsvgrenderer.h"
 #include "debugdialog.h"
 #include "svg/svgfilesplitter.h"
+#include "svg/svgloadcache.h"
 #include "utils/textutils.h"
 #include "utils/graphicsutils.h"
 #include "utils/folderutils.h"
+#include "utils/tracer.h"
 #include "connectors/svgidlayer.h"
 
 #include <QRegExp>
@@ -31,6 +33,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QPainter>
 #include <QCoreApplication>
 #include <QGraphicsSvgItem>
+#include <QPixmapCache>
+#include <QCryptographicHash>
 #include <qnumeric.h>
 
 /////////////////////////////////////////////
@@ -61,6 +65,13 @@ void FSvgRenderer::clearConnectorInfoHash(QHash<QString, ConnectorInfo *> & hash
 	hash.clear();
 }
 
+void FSvgRenderer::restoreConnectorInfoHash(const QHash<QString, ConnectorInfo> & source, QHash<QString, ConnectorInfo *> & hash) {
+	clearConnectorInfoHash(hash);
+	foreach (QString id, source.keys()) {
+		hash.insert(id, new ConnectorInfo(source.value(id)));
+	}
+}
+
 void FSvgRenderer::cleanup() {
 
 }
@@ -113,6 +124,49 @@ QByteArray FSvgRenderer::loadSvg(const QByteArray & contents, const LoadInfo & l
 
 QByteArray FSvgRenderer::loadAux(const QByteArray & theContents, const LoadInfo & loadInfo)
 {
+	TraceScope trace("load svg", loadInfo.filename);
+
+	// generated svg has no file behind it and is only cached in memory
+	bool persistent = !loadInfo.filename.isEmpty();
+	QByteArray key = SvgLoadCache::makeKey(theContents, loadInfo);
+	SvgLoadEntry entry;
+	if (SvgLoadCache::lookup(key, entry, persistent)) {
+		if (loadInfo.connectorIDs.count() > 0) {
+			restoreConnectorInfoHash(entry.connectorInfo, m_connectorInfoHash);
+		}
+		if (loadInfo.findNonConnectors) {
+			restoreConnectorInfoHash(entry.nonConnectorInfo, m_nonConnectorInfoHash);
+		}
+	}
+	else {
+		if (!prepare(theContents, loadInfo, entry)) return QByteArray();
+
+		SvgLoadCache::insert(key, entry, persistent);
+	}
+
+	return finalLoad(entry.contents, loadInfo.filename);
+}
+
+bool FSvgRenderer::prefetch(const QByteArray & contents, const LoadInfo & loadInfo)
+{
+	// must stay free of GUI and scene access: SketchWidget calls it from worker threads while a sketch loads
+	TraceScope trace("prefetch svg", loadInfo.filename);
+
+	bool persistent = !loadInfo.filename.isEmpty();
+	QByteArray key = SvgLoadCache::makeKey(contents, loadInfo);
+	SvgLoadEntry entry;
+	if (SvgLoadCache::lookup(key, entry, persistent)) return true;
+
+	FSvgRenderer renderer;
+	if (!renderer.prepare(contents, loadInfo, entry)) return false;
+
+	SvgLoadCache::insert(key, entry, persistent);
+	return true;
+}
+
+bool FSvgRenderer::prepare(const QByteArray & theContents, const LoadInfo & loadInfo, SvgLoadEntry & entry)
+{
+	// everything loadAux does short of handing the bytes to QSvgRenderer
 	QByteArray cleanContents(theContents);
 	bool cleaned = false;
 
@@ -161,22 +215,24 @@ QByteArray FSvgRenderer::loadAux(const QByteArray & theContents, const LoadInfo
 		}
 	}
 
+	//DebugDialog::debug(cleanContents.data());
 
-	/*
-	cleanContents = doc.toByteArray();
-
-	//QFile file("all.txt");
-	//if (file.open(QIODevice::Append)) {
-		//QTextStream t(&file);
-		//t << cleanContents;
-		//file.close();
-	//}
-
-	*/
+	QXmlStreamReader xml(cleanContents);
+	if (!determineDefaultSize(xml)) return false;
 
-	//DebugDialog::debug(cleanContents.data());
+	entry.contents = cleanContents;
+	if (loadInfo.connectorIDs.count() > 0) {
+		foreach (QString id, m_connectorInfoHash.keys()) {
+			entry.connectorInfo.insert(id, *m_connectorInfoHash.value(id));
+		}
+	}
+	if (loadInfo.findNonConnectors) {
+		foreach (QString id, m_nonConnectorInfoHash.keys()) {
+			entry.nonConnectorInfo.insert(id, *m_nonConnectorInfoHash.value(id));
+		}
+	}
 
-	return finalLoad(cleanContents, loadInfo.filename);
+	return true;
 }
 
 QByteArray FSvgRenderer::finalLoad(QByteArray & cleanContents, const QString & filename) {
@@ -190,6 +246,7 @@ QByteArray FSvgRenderer::finalLoad(QByteArray & cleanContents, const QString & f
 	result = QSvgRenderer::load(cleanContents);
 	if (result) {
 		m_filename = filename;
+		setPixmapKey(cleanContents);
 		return cleanContents;
 	}
 
@@ -197,17 +254,34 @@ QByteArray FSvgRenderer::finalLoad(QByteArray & cleanContents, const QString & f
 }
 
 bool FSvgRenderer::fastLoad(const QByteArray & contents) {
-	return QSvgRenderer::load(contents);
+	bool result = QSvgRenderer::load(contents);
+	if (result) setPixmapKey(contents);
+	return result;
+}
+
+void FSvgRenderer::setPixmapKey(const QByteArray & contents) {
+	// instances of a part share a key unless their svg has been customized (resistor bands, labels, ...)
+	m_pixmapKey = QString::fromLatin1(QCryptographicHash::hash(contents, QCryptographicHash::Md5).toHex());
 }
 
 QPixmap * FSvgRenderer::getPixmap(QSvgRenderer * renderer, QSize size)
 {
+	// the Inspector asks for the same icons every time a part is selected
+	QString key;
+	FSvgRenderer * frenderer = qobject_cast<FSvgRenderer *>(renderer);
+	if (frenderer && !frenderer->m_pixmapKey.isEmpty()) {
+		key = QString("fsvg:%1:%2x%3").arg(frenderer->m_pixmapKey).arg(size.width()).arg(size.height());
+		QPixmap cached;
+		if (QPixmapCache::find(key, &cached)) {
+			return new QPixmap(cached);
+		}
+	}
+
 	QPixmap *pixmap = new QPixmap(size);
 	pixmap->fill(Qt::transparent);
 	QPainter painter(pixmap);
 	// preserve aspect ratio
 	QSizeF def = renderer->defaultSize();
-	FSvgRenderer * frenderer = qobject_cast<FSvgRenderer *>(renderer);
 	if (frenderer) {
 		def = frenderer->defaultSizeF();
 	}
@@ -221,6 +295,10 @@ QPixmap * FSvgRenderer::getPixmap(QSvgRenderer * renderer, QSize size)
 	renderer->render(&painter, bounds);
 	painter.end();
 
+	if (!key.isEmpty()) {
+		QPixmapCache::insert(key, *pixmap);
+	}
+
 	return pixmap;
 }
 
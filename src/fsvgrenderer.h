@@ -46,6 +46,8 @@ struct ConnectorInfo {
 
 typedef QHash<ViewLayer::ViewLayerID, class FSvgRenderer *> RendererHash;
 
+struct SvgLoadEntry;
+
 struct LoadInfo {
 	QString filename;
 	QStringList connectorIDs;
@@ -85,10 +87,12 @@ public:
 	static QSizeF parseForWidthAndHeight(QXmlStreamReader &);
 	static QPixmap * getPixmap(QSvgRenderer * renderer, QSize size);
 	static void initNames();
+	static bool prefetch(const QByteArray & contents, const LoadInfo &);		// fills SvgLoadCache; safe on worker threads
 
 protected:
 	bool determineDefaultSize(QXmlStreamReader &);
 	QByteArray loadAux (const QByteArray & contents, const LoadInfo &);
+	bool prepare(const QByteArray & contents, const LoadInfo &, SvgLoadEntry &);
 	bool initConnectorInfo(QDomDocument &, const LoadInfo &);
 	ConnectorInfo * initConnectorInfoStruct(QDomElement & connectorElement, const QString & filename, bool parsePaths);
 	bool initConnectorInfoStructAux(QDomElement &, ConnectorInfo * connectorInfo, const QString & filename, bool parsePaths);
@@ -104,10 +108,13 @@ protected:
 	void calcLeg(SvgIdLayer *, const QRectF & viewBox, ConnectorInfo * connectorInfo);
 	ConnectorInfo * getConnectorInfo(const QString & connectorID);
 	void clearConnectorInfoHash(QHash<QString, ConnectorInfo *> & hash);
+	void setPixmapKey(const QByteArray & contents);
+	void restoreConnectorInfoHash(const QHash<QString, ConnectorInfo> & source, QHash<QString, ConnectorInfo *> & hash);
 
 protected:
 	QString m_filename;
 	QSizeF m_defaultSizeF;
+	QString m_pixmapKey;
 	QHash<QString, ConnectorInfo *> m_connectorInfoHash;
 	QHash<QString, ConnectorInfo *> m_nonConnectorInfoHash;
 
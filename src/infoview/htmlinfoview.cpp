@@ -348,6 +348,10 @@ void HtmlInfoView::viewItemInfo(InfoGraphicsView *, ItemBase* item, bool swappin
 	m_setContentTimer.start();
 }
 
+void HtmlInfoView::flush() {
+	if (m_setContentTimer.isActive()) setContent();
+}
+
 void HtmlInfoView::hoverEnterItem(InfoGraphicsView *, QGraphicsSceneHoverEvent *, ItemBase * item, bool swappingEnabled) {
 	m_setContentTimer.stop();
 	m_pendingItemBase = item;
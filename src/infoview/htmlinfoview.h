@@ -71,6 +71,7 @@ public:
 	void reloadContent(class InfoGraphicsView *);
 
 	void viewItemInfo(class InfoGraphicsView *, ItemBase* item, bool swappingEnabled);
+	void flush();
 	void updateLocation(ItemBase *);
 	void updateRotation(ItemBase *);
 
@@ -162,7 +162,7 @@ void GroundPlane::setSvgAux(const QString & svg) {
 		resetRenderer(svg);
 		if (m_connector0) {
 			QPainterPath painterPath = splitter.painterPath(GraphicsUtils::SVGDPI, GroundPlaneGenerator::ConnectorName);
-			m_connector0->setRect(painterPath.boundingRect());
+			m_connector0->setConnectorRect(painterPath.boundingRect());
 			m_connector0->setShape(painterPath);
 		}
 		//QPainterPath painterPath = splitter.painterPath(GraphicsUtils::SVGDPI, xmlName);
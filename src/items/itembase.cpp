@@ -26,6 +26,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../connectors/connectoritem.h"
 #include "../connectors/connectorshared.h"
 #include "../sketch/infographicsview.h"
+#include "../sketch/fgraphicsscene.h"
+#include "../connectors/connectorindex.h"
 #include "../connectors/connector.h"
 #include "../connectors/bus.h"
 #include "partlabel.h"
@@ -33,6 +35,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../fsvgrenderer.h"
 #include "../svg/svgfilesplitter.h"
 #include "../svg/svgflattener.h"
+#include "../svg/svgoutline.h"
 #include "../utils/folderutils.h"
 #include "../utils/textutils.h"
 #include "../utils/graphicsutils.h"
@@ -50,6 +53,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QBitmap>
 #include <QApplication>
 #include <QClipboard>
+#include <QPixmapCache>
 #include <qmath.h>
 
 /////////////////////////////////
@@ -147,6 +151,11 @@ ItemBase::~ItemBase() {
 		delete m_fsvgRenderer;
 	}
 
+	FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+	if (fscene) {
+		fscene->itemLeaving(this);
+	}
+
 }
 
 void ItemBase::setTooltip() {
@@ -1178,6 +1187,30 @@ QVariant ItemBase::itemChange(QGraphicsItem::GraphicsItemChange change, const QV
 			m_partLabel->ownerSelected(value.toBool());
 		}
 
+		break;
+	case QGraphicsItem::ItemPositionHasChanged:
+	case QGraphicsItem::ItemTransformHasChanged:
+	case QGraphicsItem::ItemRotationHasChanged:
+	case QGraphicsItem::ItemScaleHasChanged:
+	case QGraphicsItem::ItemChildAddedChange:
+	case QGraphicsItem::ItemChildRemovedChange:
+		connectorGeometryChanged();
+		break;
+	case QGraphicsItem::ItemSceneHasChanged:
+		{
+			FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+			if (fscene) {
+				fscene->itemArrived(this);
+			}
+		}
+		break;
+	case QGraphicsItem::ItemSceneChange:
+		{
+			FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+			if (fscene) {
+				fscene->itemLeaving(this);
+			}
+		}
 		break;
 	default:
 		break;
@@ -1186,6 +1219,14 @@ QVariant ItemBase::itemChange(QGraphicsItem::GraphicsItemChange change, const QV
 	return QGraphicsSvgItem::itemChange(change, value);
 }
 
+void ItemBase::connectorGeometryChanged() {
+	// the connector index re-reads this item's connectors on its next query
+	FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+	if (fscene) {
+		fscene->connectorIndex()->itemChanged(this);
+	}
+}
+
 void ItemBase::cleanup() {
 }
 
@@ -1308,6 +1349,61 @@ FSvgRenderer * ItemBase::setUpImage(ModelPart * modelPart, LayerAttributes & lay
 	}
 
 	LoadInfo loadInfo;
+	initLoadInfo(modelPartShared, layerAttributes, loadInfo);
+
+	QDomDocument flipDoc;
+	getFlipDoc(modelPart, filename, layerAttributes.viewLayerID, layerAttributes.viewLayerPlacement, flipDoc, layerAttributes.orientation);
+	QString layerName;
+	if ((layerAttributes.viewID != ViewLayer::IconView) && modelPartShared->hasMultipleLayers(layerAttributes.viewID)) {
+		layerName = ViewLayer::viewLayerXmlNameFromID(layerAttributes.viewLayerID);
+	}
+	bool hasText = true;
+	QByteArray bytesToLoad = layerSvg(filename, layerAttributes.viewLayerID, layerName, flipDoc, hasText);
+	if (!hasText) {
+		return nullptr;
+	}
+
+	FSvgRenderer * newRenderer = new FSvgRenderer();
+	QByteArray resultBytes;
+	if (!bytesToLoad.isEmpty()) {
+		if (makeLocalModifications(bytesToLoad, filename)) {
+			if (layerAttributes.viewLayerID == ViewLayer::Schematic) {
+				bytesToLoad = SvgFileSplitter::hideText2(bytesToLoad);
+			}
+			else if (layerAttributes.viewLayerID == ViewLayer::SchematicText) {
+				bool hasText;
+				bytesToLoad = SvgFileSplitter::showText2(bytesToLoad, hasText);
+			}
+		}
+
+		loadInfo.filename = filename;
+		resultBytes = newRenderer->loadSvg(bytesToLoad, loadInfo);
+	}
+
+	layerAttributes.setLoaded(resultBytes);
+
+#ifndef QT_NO_DEBUG
+//	DebugDialog::debug(QString("set up image elapsed (2.3) %1").arg(t.elapsed()) );
+#endif
+
+	if (resultBytes.isEmpty()) {
+		delete newRenderer;
+		layerAttributes.error = tr("unable to create renderer for svg %1").arg(filename);
+		newRenderer = nullptr;
+	}
+	//DebugDialog::debug(QString("set up image elapsed (3) %1").arg(t.elapsed()) );
+
+	if (newRenderer) {
+		layerAttributes.setFilename(newRenderer->filename());
+		if (layerAttributes.createShape) {
+			createShape(layerAttributes);
+		}
+	}
+
+	return newRenderer;
+}
+
+void ItemBase::initLoadInfo(ModelPartShared * modelPartShared, const LayerAttributes & layerAttributes, LoadInfo & loadInfo) {
 	switch (layerAttributes.viewID) {
 	case ViewLayer::PCBView:
 		loadInfo.colorElementID = ViewLayer::viewLayerXmlNameFromID(layerAttributes.viewLayerID);
@@ -1339,23 +1435,20 @@ FSvgRenderer * ItemBase::setUpImage(ModelPart * modelPart, LayerAttributes & lay
 		// don't need connectorIDs() for schematic view since these parts do not have bendable legs or connectors with drill holes
 		break;
 	}
+}
 
-	FSvgRenderer * newRenderer = new FSvgRenderer();
-	QDomDocument flipDoc;
-	getFlipDoc(modelPart, filename, layerAttributes.viewLayerID, layerAttributes.viewLayerPlacement, flipDoc, layerAttributes.orientation);
+QByteArray ItemBase::layerSvg(const QString & filename, ViewLayer::ViewLayerID viewLayerID, const QString & layerName, const QDomDocument & flipDoc, bool & hasText) {
+	// only reads the file and the flip doc, so SketchWidget can also call it from worker threads
+	hasText = true;
 	QByteArray bytesToLoad;
-	if (layerAttributes.viewLayerID == ViewLayer::Schematic) {
+	if (viewLayerID == ViewLayer::Schematic) {
 		bytesToLoad = SvgFileSplitter::hideText(filename);
 	}
-	else if (layerAttributes.viewLayerID == ViewLayer::SchematicText) {
-		bool hasText = false;
+	else if (viewLayerID == ViewLayer::SchematicText) {
+		hasText = false;
 		bytesToLoad = SvgFileSplitter::showText(filename, hasText);
-		if (!hasText) {
-			return nullptr;
-		}
 	}
-	else if ((layerAttributes.viewID != ViewLayer::IconView) && modelPartShared->hasMultipleLayers(layerAttributes.viewID)) {
-		QString layerName = ViewLayer::viewLayerXmlNameFromID(layerAttributes.viewLayerID);
+	else if (!layerName.isEmpty()) {
 		// need to treat create "virtual" svg file for each layer
 		SvgFileSplitter svgFileSplitter;
 		bool result;
@@ -1382,43 +1475,7 @@ FSvgRenderer * ItemBase::setUpImage(ModelPart * modelPart, LayerAttributes & lay
 		}
 	}
 
-	QByteArray resultBytes;
-	if (!bytesToLoad.isEmpty()) {
-		if (makeLocalModifications(bytesToLoad, filename)) {
-			if (layerAttributes.viewLayerID == ViewLayer::Schematic) {
-				bytesToLoad = SvgFileSplitter::hideText2(bytesToLoad);
-			}
-			else if (layerAttributes.viewLayerID == ViewLayer::SchematicText) {
-				bool hasText;
-				bytesToLoad = SvgFileSplitter::showText2(bytesToLoad, hasText);
-			}
-		}
-
-		loadInfo.filename = filename;
-		resultBytes = newRenderer->loadSvg(bytesToLoad, loadInfo);
-	}
-
-	layerAttributes.setLoaded(resultBytes);
-
-#ifndef QT_NO_DEBUG
-//	DebugDialog::debug(QString("set up image elapsed (2.3) %1").arg(t.elapsed()) );
-#endif
-
-	if (resultBytes.isEmpty()) {
-		delete newRenderer;
-		layerAttributes.error = tr("unable to create renderer for svg %1").arg(filename);
-		newRenderer = nullptr;
-	}
-	//DebugDialog::debug(QString("set up image elapsed (3) %1").arg(t.elapsed()) );
-
-	if (newRenderer) {
-		layerAttributes.setFilename(newRenderer->filename());
-		if (layerAttributes.createShape) {
-			createShape(layerAttributes);
-		}
-	}
-
-	return newRenderer;
+	return bytesToLoad;
 }
 
 void ItemBase::updateConnectionsAux(bool includeRatsnest, QList<ConnectorItem *> & already) {
@@ -1948,6 +2005,7 @@ void ItemBase::killRubberBandLeg() {
 	foreach (ConnectorItem * connectorItem, cachedConnectorItems()) {
 		connectorItem->killRubberBandLeg();
 	}
+	connectorGeometryChanged();
 }
 
 ViewGeometry::WireFlags ItemBase::wireFlags() const {
@@ -2100,6 +2158,13 @@ QPixmap * ItemBase::getPixmap(ViewLayer::ViewID vid, bool swappingEnabled, QSize
 		return nullptr;
 	}
 
+	// the parts editor can overwrite a file, hence the timestamp
+	QString key = QString("file:%1:%2:%3x%4").arg(filename).arg(QFileInfo(filename).lastModified().toMSecsSinceEpoch()).arg(size.width()).arg(size.height());
+	QPixmap cached;
+	if (QPixmapCache::find(key, &cached)) {
+		return new QPixmap(cached);
+	}
+
 	QSvgRenderer renderer(filename);
 
 	QPixmap * pixmap = new QPixmap(size);
@@ -2117,6 +2182,7 @@ QPixmap * ItemBase::getPixmap(ViewLayer::ViewID vid, bool swappingEnabled, QSize
 	renderer.render(&painter, bounds);
 	painter.end();
 
+	QPixmapCache::insert(key, *pixmap);
 	return pixmap;
 }
 
@@ -2272,38 +2338,9 @@ void ItemBase::createShape(LayerAttributes & layerAttributes) {
 
 	if (!isEverVisible()) return;
 
-	QString errorStr;
-	int errorLine;
-	int errorColumn;
-	QDomDocument doc;
-	if (!doc.setContent(layerAttributes.loaded(), &errorStr, &errorLine, &errorColumn)) {
-		return;
-	}
-
-	QDomElement root = doc.documentElement();
-
-	QRectF viewBox;
-	double w, h;
-	TextUtils::ensureViewBox(doc, 1, viewBox, true, w, h, true);
-	double svgDPI = viewBox.width() / w;
+	// selection margin in pixels
 	int selectionExtra = layerAttributes.viewID == ViewLayer::SchematicView ? 20 : 10;
-	SvgFileSplitter::forceStrokeWidth(root, svgDPI * selectionExtra / GraphicsUtils::SVGDPI, "#000000", true, false);
-
-	double imageDPI = GraphicsUtils::SVGDPI;
-	QRectF sourceRes(0, 0, w * imageDPI, h * imageDPI);
-	QSize imgSize(qCeil(sourceRes.width()), qCeil(sourceRes.height()));
-	QImage image(imgSize, QImage::Format_Mono);
-	image.fill(0xffffffff);
-	renderOne(&doc, &image, sourceRes);
-	QBitmap bitmap = QBitmap::fromImage(image);
-	QRegion region(bitmap);
-	m_selectionShape.addRegion(region);
-
-#ifndef QT_NODEBUG
-	//QFileInfo info(layerAttributes.filename());
-	//bitmap.save(FolderUtils::getUserDataStorePath("") + "/bitmap." + info.completeBaseName() + "." + QString::number(layerAttributes.viewLayerID) + ".png");
-	//image.save(FolderUtils::getUserDataStorePath("") + "/image." + info.completeBaseName() + "." + QString::number(layerAttributes.viewLayerID) + ".png");
-#endif
+	m_selectionShape = SvgOutline::selectionShape(layerAttributes.loaded(), selectionExtra);
 }
 
 const QPainterPath & ItemBase::selectionShape() {
@@ -41,6 +41,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 class ConnectorItem;
 class ModelPart;
 class FSvgRenderer;
+struct LoadInfo;
 class ModelPartShared;
 class Bus;
 class Wire;
@@ -211,6 +212,7 @@ public:
 	void killRubberBandLeg();
 	bool sceneEvent(QEvent *event);
 	void clearConnectorItemCache();
+	void connectorGeometryChanged();
 	const QList<ConnectorItem *> & cachedConnectorItems();
 	const QList<ConnectorItem *> & cachedConnectorItemsConst() const;
 	bool inHover();
@@ -319,6 +321,8 @@ public:
 	static bool zLessThan(ItemBase * & p1, ItemBase * & p2);
 	static qint64 getNextID();
 	static qint64 getNextID(qint64 fromIndex);
+	static void initLoadInfo(ModelPartShared *, const LayerAttributes &, LoadInfo &);
+	static QByteArray layerSvg(const QString & filename, ViewLayer::ViewLayerID, const QString & layerName, const QDomDocument & flipDoc, bool & hasText);
 
 protected:
 	void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
@@ -272,16 +272,16 @@ void JumperItem::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 	this->setPos(myPos);
 	QRectF r = m_otherItem->rect();
 	r.moveTo(mapFromScene(m_otherPos));
-	m_otherItem->setRect(r);
+	m_otherItem->setConnectorRect(r);
 	ConnectorItem * cross = m_otherItem->getCrossLayerConnectorItem();
-	if (cross) cross->setRect(r);
+	if (cross) cross->setConnectorRect(r);
 
 	r = m_dragItem->rect();
 	r.moveTo(mapFromScene(p));
-	m_dragItem->setRect(r);
+	m_dragItem->setConnectorRect(r);
 
 	cross = m_dragItem->getCrossLayerConnectorItem();
-	if (cross) cross->setRect(r);
+	if (cross) cross->setConnectorRect(r);
 
 	resize();
 	QList<ConnectorItem *> already;
@@ -414,15 +414,15 @@ void JumperItem::resizeAux(double r0x, double r0y, double r1x, double r1y) {
 	QPointF c1 = r1.center();
 	r0.translate(r0x - c0.x(), r0y - c0.y());
 	r1.translate(r1x - c1.x(), r1y - c1.y());
-	m_connector0->setRect(r0);
-	m_connector1->setRect(r1);
+	m_connector0->setConnectorRect(r0);
+	m_connector1->setConnectorRect(r1);
 	ConnectorItem * cc0 = m_connector0->getCrossLayerConnectorItem();
 	if (cc0) {
-		cc0->setRect(r0);
+		cc0->setConnectorRect(r0);
 	}
 	ConnectorItem * cc1 = m_connector1->getCrossLayerConnectorItem();
 	if (cc1) {
-		cc1->setRect(r1);
+		cc1->setConnectorRect(r1);
 	}
 	resize();
 }
@@ -498,11 +498,11 @@ void JumperItem::addedToScene(bool temporary) {
 
 	ConnectorItem * cc0 = m_connector0->getCrossLayerConnectorItem();
 	if (cc0) {
-		cc0->setRect(m_connector0->rect());
+		cc0->setConnectorRect(m_connector0->rect());
 	}
 	ConnectorItem * cc1 = m_connector1->getCrossLayerConnectorItem();
 	if (cc1) {
-		cc1->setRect(m_connector1->rect());
+		cc1->setConnectorRect(m_connector1->rect());
 	}
 
 	PaletteItem::addedToScene(temporary);
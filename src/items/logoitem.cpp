@@ -28,7 +28,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../svg/svgfilesplitter.h"
 #include "../svg/gerbergenerator.h"
 #include "moduleidnames.h"
-#include "../svg/groundplanegenerator.h"
+#include "../svg/bitmaptracer.h"
 #include "../utils/cursormaster.h"
 #include "../debugdialog.h"
 
@@ -432,11 +432,10 @@ void LogoItem::loadImage(const QString & fileName, bool addName)
 
 		double res = image.dotsPerMeterX() / GraphicsUtils::InchesPerMeter;
 		if (this->m_standardizeColors) {
-			GroundPlaneGenerator gpg;
-			gpg.setLayerName(layerName());
-			gpg.setMinRunSize(1, 1);
-			gpg.scanImage(image, image.width(), image.height(), 1, res, colorString(), false, false, QSizeF(0, 0), 0, QPointF(0, 0));
-			if (gpg.newSVGs().count() < 1) {
+			// one traced path rather than a polygon per run of pixels
+			BitmapTracer tracer(BitmapTracer::savedTolerance());
+			QString d = tracer.pathData(image);
+			if (d.isEmpty()) {
 				FMessageBox::information(
 				    NULL,
 				    tr("Unable to display"),
@@ -445,7 +444,13 @@ void LogoItem::loadImage(const QString & fileName, bool addName)
 				return;
 			}
 
-			svg = gpg.mergeSVGs("", layerName());
+			svg = TextUtils::makeSVGHeader(res, res, image.width(), image.height());
+			svg += QString("<g id='%1'>\n<path fill='%2' stroke='none' stroke-width='0' fill-rule='evenodd' d='%3'/>\n</g>\n</svg>\n")
+			       .arg(layerName()).arg(colorString()).arg(d);
+
+			const BitmapTracer::Stats & stats = tracer.stats();
+			DebugDialog::debug(QString("logo traced: %1 pixel runs to %2 outlines (%3 lines, %4 curves), %5 bytes")
+			                   .arg(stats.runs).arg(stats.contours).arg(stats.lines).arg(stats.curves).arg(svg.length()));
 		}
 		else {
 			svg = TextUtils::makeSVGHeader(res, res, image.width(), image.height());
@@ -731,7 +731,7 @@ void PaletteItem::resetConnectors() {
 		QPointF p(bounds.left() * size.width() / viewBox.width(), bounds.top() * size.height() / viewBox.height());
 		QRectF r = connectorItem->rect();
 		r.moveTo(p.x(), p.y());
-		connectorItem->setRect(r);
+		connectorItem->setConnectorRect(r);
 	}
 }
 
@@ -776,7 +776,7 @@ void PaletteItem::resetConnector(ItemBase * itemBase, SvgIdLayer * svgIdLayer)
 	foreach (ConnectorItem * connectorItem, itemBase->cachedConnectorItems()) {
 		//DebugDialog::debug(QString("via set rect %1").arg(itemBase->viewID()), svgIdLayer->m_rect);
 
-		connectorItem->setRect(svgIdLayer->rect(viewLayerPlacement()));
+		connectorItem->setConnectorRect(svgIdLayer->rect(viewLayerPlacement()));
 		connectorItem->setTerminalPoint(svgIdLayer->point(viewLayerPlacement()));
 		connectorItem->setRadius(svgIdLayer->m_radius, svgIdLayer->m_strokeWidth);
 		connectorItem->setIsPath(svgIdLayer->m_path);
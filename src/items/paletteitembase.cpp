@@ -469,7 +469,7 @@ void PaletteItemBase::setUpConnectors(FSvgRenderer * renderer, bool ignoreTermin
 		ConnectorItem * connectorItem = newConnectorItem(connector);
 
 		connectorItem->setHybrid(svgIdLayer->m_hybrid);
-		connectorItem->setRect(svgIdLayer->rect(viewLayerPlacement()));
+		connectorItem->setConnectorRect(svgIdLayer->rect(viewLayerPlacement()));
 		connectorItem->setTerminalPoint(svgIdLayer->point(viewLayerPlacement()));
 		connectorItem->setRadius(svgIdLayer->m_radius, svgIdLayer->m_strokeWidth);
 		connectorItem->setIsPath(svgIdLayer->m_path);
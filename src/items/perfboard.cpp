@@ -29,6 +29,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../debugdialog.h"
 #include "moduleidnames.h"
 #include "partlabel.h"
+#include "striplattice.h"
 
 #include <qmath.h>
 #include <QRegExpValidator>
@@ -92,8 +93,8 @@ void Perfboard::setProp(const QString & prop, const QString & value)
 
 QString Perfboard::makeBreadboardSvg(const QString & size)
 {
-	QString BreadboardLayerTemplate = "";
-	QString ConnectorTemplate = "";
+	static QString BreadboardLayerTemplate;
+	static QString ConnectorTemplate;
 
 	if (BreadboardLayerTemplate.isEmpty()) {
 		QFile file(":/resources/templates/perfboard_boardLayerTemplate.txt");
@@ -113,6 +114,8 @@ QString Perfboard::makeBreadboardSvg(const QString & size)
 
 	QString middle;
 	QString holes;
+	middle.reserve(x * y * (ConnectorTemplate.length() + 16));
+	holes.reserve(x * y * (OneHole.length() + 16));
 	double radius = 17.5;
 	int sweepflag = 0;
 
@@ -148,8 +151,8 @@ QString Perfboard::makeBreadboardSvg(const QString & size)
 
 QString Perfboard::genFZP(const QString & moduleid)
 {
-	QString ConnectorFzpTemplate = "";
-	QString FzpTemplate = "";
+	static QString ConnectorFzpTemplate;
+	static QString FzpTemplate;
 
 	if (ConnectorFzpTemplate.isEmpty()) {
 		QFile file(":/resources/templates/perfboard_connectorFzpTemplate.txt");
@@ -346,17 +349,8 @@ QString Perfboard::genModuleID(QMap<QString, QString> & currPropsMap)
 
 bool Perfboard::getXY(int & x, int & y, const QString & s)
 {
-	QRegExp re("(\\d+)\\.(\\d+)");
-
-	int ix = re.indexIn(s);
-	if (ix < 0) return false;
-
-	bool ok;
-	x = re.cap(1).toInt(&ok);
-	if (!ok) return false;
-
-	y = re.cap(2).toInt(&ok);
-	return ok;
+	// called once per connector on big boards, so skip the regular expression
+	return StripLattice::parseXY(s, x, y);
 }
 
 bool Perfboard::rotation45Allowed() {
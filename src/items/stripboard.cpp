@@ -33,6 +33,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QCursor>
 #include <QBitmap>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsSceneMouseEvent>
+#include <qmath.h>
 
 
 //////////////////////////////////////////////////
@@ -61,8 +65,7 @@ static QString VerticalString("vertical strips");
 
 /////////////////////////////////////////////////////////////////////
 
-Stripbit::Stripbit(const QPainterPath & path, int x, int y, bool horizontal, QGraphicsItem * parent = 0)
-	: QGraphicsPathItem(path, parent)
+StripLayer::StripLayer(Stripboard * board) : QGraphicsItem(board)
 {
 	if (SpotFaceCutterCursor == NULL) {
 		QBitmap bitmap(":resources/images/cursor/spot_face_cutter.bmp");
@@ -76,47 +79,122 @@ Stripbit::Stripbit(const QPainterPath & path, int x, int y, bool horizontal, QGr
 		MagicWandCursor = new QCursor(bitmap, bitmapm, 0, 0);
 	}
 
+	m_board = board;
 	setZValue(-999);			// beneath connectorItems
 
-	setPen(Qt::NoPen);
-	// TODO: don't hardcode this color
-	setBrush(QColor(0xbc, 0x94, 0x51));							// QColor(0xc4, 0x9c, 0x59)
-
-
-	m_horizontal = horizontal;
-	m_x = x;
-	m_y = y;
-	m_inHover = m_removed = false;
-
 	setAcceptHoverEvents(true);
 	setAcceptedMouseButtons(Qt::LeftButton);
-	setFlag(QGraphicsItem::ItemIsMovable, true);
 	setFlag(QGraphicsItem::ItemIsSelectable, false);
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+}
 
+StripLayer::~StripLayer() {
 }
 
-Stripbit::~Stripbit() {
+void StripLayer::setGeometry(const QPointF & origin, double dx, double dy, const QRectF & firstRect) {
+	prepareGeometryChange();
+	m_origin = origin;
+	m_dx = dx;
+	m_dy = dy;
+	m_firstRect = firstRect;
 }
 
-void Stripbit::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-	double newOpacity = 1;
-	if (m_removed) {
-		if (m_inHover) newOpacity = 0.50;
-		else newOpacity = 0.00;
-	}
-	else {
-		if (m_inHover) newOpacity = 0.40;
-		else newOpacity = 1.00;
+QRectF StripLayer::boundingRect() const {
+	const StripLattice & lattice = m_board->lattice();
+	if (lattice.columns() == 0 || lattice.rows() == 0) return QRectF();
+
+	QRectF last = m_firstRect.translated((lattice.columns() - 1) * m_dx, (lattice.rows() - 1) * m_dy);
+	return m_firstRect.united(last);
+}
+
+QPointF StripLayer::linkPos(int x, int y, bool horizontal) const {
+	QRectF r = m_firstRect.translated(x * m_dx, y * m_dy);
+	if (horizontal) return QPointF(r.center().x(), r.top());
+
+	return QPointF(r.left(), r.center().y());
+}
+
+bool StripLayer::linkAt(const QPointF & point, int & x, int & y, bool & horizontal) const {
+	if (m_dx <= 0 || m_dy <= 0) return false;
+
+	// vertical segments used to be stacked above horizontal ones, so they win where the two overlap
+	const StripLattice & lattice = m_board->lattice();
+	double fx = (point.x() - m_origin.x()) / m_dx;
+	double fy = (point.y() - m_origin.y()) / m_dy;
+	for (int pass = 0; pass < 2; pass++) {
+		bool h = (pass == 1);
+		int cx = h ? qFloor(fx) : qRound(fx);
+		int cy = h ? qRound(fy) : qFloor(fy);
+		if (!lattice.hasLink(cx, cy, h)) continue;
+
+		const QPainterPath & path = h ? HPath : VPath;
+		if (!path.contains(point - linkPos(cx, cy, h))) continue;
+
+		x = cx;
+		y = cy;
+		horizontal = h;
+		return true;
 	}
 
-	double opacity = painter->opacity();
-	painter->setOpacity(newOpacity);
-	QGraphicsPathItem::paint(painter, option, widget);
-	painter->setOpacity(opacity);
+	return false;
+}
 
+bool StripLayer::contains(const QPointF & point) const {
+	int x, y;
+	bool horizontal;
+	return linkAt(point, x, y, horizontal);
 }
 
-void Stripbit::mousePressEvent(QGraphicsSceneMouseEvent *event)
+bool StripLayer::collidesWithPath(const QPainterPath & path, Qt::ItemSelectionMode mode) const {
+	// point lookups arrive as a tiny rect; anything bigger (a rubber band) just uses the bounding rect
+	QRectF r = path.boundingRect();
+	if (r.width() <= 1 && r.height() <= 1) return contains(r.center());
+
+	return QGraphicsItem::collidesWithPath(path, mode);
+}
+
+void StripLayer::updateLink(int x, int y, bool horizontal) {
+	const QPainterPath & path = horizontal ? HPath : VPath;
+	update(path.boundingRect().translated(linkPos(x, y, horizontal)));
+}
+
+void StripLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+	Q_UNUSED(widget);
+	if (m_dx <= 0 || m_dy <= 0) return;
+
+	const StripLattice & lattice = m_board->lattice();
+	QRectF exposed = option->exposedRect;
+	int x0 = qMax(0, qFloor((exposed.left() - m_origin.x()) / m_dx) - 1);
+	int x1 = qMin(lattice.columns() - 1, qCeil((exposed.right() - m_origin.x()) / m_dx) + 1);
+	int y0 = qMax(0, qFloor((exposed.top() - m_origin.y()) / m_dy) - 1);
+	int y1 = qMin(lattice.rows() - 1, qCeil((exposed.bottom() - m_origin.y()) / m_dy) + 1);
+
+	double opacity = painter->opacity();
+	painter->setPen(Qt::NoPen);
+	// TODO: don't hardcode this color
+	painter->setBrush(QColor(0xbc, 0x94, 0x51));				// QColor(0xc4, 0x9c, 0x59)
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			for (int pass = 0; pass < 2; pass++) {
+				bool horizontal = (pass == 0);
+				if (!lattice.hasLink(x, y, horizontal)) continue;
+
+				bool cut = lattice.isCut(x, y, horizontal);
+				bool inHover = (x == m_hoverX && y == m_hoverY && horizontal == m_hoverHorizontal);
+				if (cut && !inHover) continue;
+
+				if (inHover) painter->setOpacity(opacity * (cut ? 0.50 : 0.40));
+				QPointF p = linkPos(x, y, horizontal);
+				painter->translate(p);
+				painter->drawPath(horizontal ? HPath : VPath);
+				painter->translate(-p);
+				if (inHover) painter->setOpacity(opacity);
+			}
+		}
+	}
+}
+
+void StripLayer::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
 	InfoGraphicsView * infoGraphicsView = InfoGraphicsView::getInfoGraphicsView(this);
 	if (infoGraphicsView && infoGraphicsView->spaceBarIsPressed()) {
@@ -124,12 +202,19 @@ void Stripbit::mousePressEvent(QGraphicsSceneMouseEvent *event)
 		return;
 	}
 
-	if (!event->buttons() && Qt::LeftButton) {
+	if (!(event->buttons() & Qt::LeftButton)) {
 		event->ignore();
 		return;
 	}
 
-	if (dynamic_cast<ItemBase *>(this->parentItem())->moveLock()) {
+	if (m_board->moveLock()) {
+		event->ignore();
+		return;
+	}
+
+	int x, y;
+	bool horizontal;
+	if (!linkAt(event->pos(), x, y, horizontal)) {
 		event->ignore();
 		return;
 	}
@@ -141,33 +226,27 @@ void Stripbit::mousePressEvent(QGraphicsSceneMouseEvent *event)
 	}
 
 	event->accept();
-	dynamic_cast<Stripboard *>(this->parentItem())->initCutting(this);
-	m_removed = !m_removed;
-	m_inHover = false;
-	m_changed = true;
-	update();
-
-
-	//DebugDialog::debug("got press");
+	m_board->initCutting();
+	m_cutting = !m_board->lattice().isCut(x, y, horizontal);
+	m_board->lattice().setCut(x, y, horizontal, m_cutting);
+	m_hoverX = m_hoverY = -1;
+	updateLink(x, y, horizontal);
 }
 
-void Stripbit::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+void StripLayer::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 {
 	Q_UNUSED(event);
-	dynamic_cast<Stripboard *>(this->parentItem())->reinitBuses(true);
+	m_board->reinitBuses(true);
 }
 
-void Stripbit::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
+void StripLayer::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
-	if (!event->buttons() && Qt::LeftButton) return;
+	if (!(event->buttons() & Qt::LeftButton)) return;
 
 	if (ShiftDown && !(event->modifiers() & Qt::ShiftModifier)) {
 		ShiftDown = false;
 	}
 
-	//DebugDialog::debug("got move");
-
-	Stripbit * other = NULL;
 	QPointF p = event->scenePos();
 	if (ShiftDown) {
 		if (ShiftX) {
@@ -190,36 +269,26 @@ void Stripbit::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 		}
 	}
 
-
 	if (!ShiftDown && (event->modifiers() & Qt::ShiftModifier)) {
 		ShiftDown = true;
 		ShiftX = ShiftY = false;
 		OriginalShiftPos = event->scenePos();
 	}
 
-	foreach (QGraphicsItem * item, scene()->items(p)) {
-		other = dynamic_cast<Stripbit *>(item);
-		if (other) break;
-	}
-
-	if (!other) return;
-
-	//DebugDialog::debug("got other");
-
-	if (other->removed() == m_removed) return;
+	int x, y;
+	bool horizontal;
+	if (!linkAt(mapFromScene(p), x, y, horizontal)) return;
 
-	//DebugDialog::debug("change other");
-
-	other->setRemoved(m_removed);
-	other->setChanged(true);
-	other->update();
-	dynamic_cast<Stripboard *>(this->parentItem())->restoreRowColors(other);
+	StripLattice & lattice = m_board->lattice();
+	if (lattice.isCut(x, y, horizontal) == m_cutting) return;
 
+	lattice.setCut(x, y, horizontal, m_cutting);
+	updateLink(x, y, horizontal);
 }
 
-void Stripbit::hoverEnterEvent( QGraphicsSceneHoverEvent * event )
+void StripLayer::hoverMoveEvent( QGraphicsSceneHoverEvent * event )
 {
-	if (dynamic_cast<ItemBase *>(this->parentItem())->moveLock()) return;
+	if (m_board->moveLock()) return;
 
 	InfoGraphicsView * infoGraphicsView = InfoGraphicsView::getInfoGraphicsView(this);
 	if (infoGraphicsView && infoGraphicsView->spaceBarIsPressed()) {
@@ -228,64 +297,46 @@ void Stripbit::hoverEnterEvent( QGraphicsSceneHoverEvent * event )
 	}
 
 	SpaceBarWasPressed = false;
-	setCursor(m_removed ? *MagicWandCursor : *SpotFaceCutterCursor);
-	Q_UNUSED(event);
-	m_inHover = true;
-	update();
+	int x, y;
+	bool horizontal;
+	if (linkAt(event->pos(), x, y, horizontal)) {
+		setHover(x, y, horizontal);
+	}
+	else {
+		clearHover();
+	}
 }
 
-void Stripbit::hoverLeaveEvent ( QGraphicsSceneHoverEvent * event )
+void StripLayer::hoverLeaveEvent ( QGraphicsSceneHoverEvent * event )
 {
-	if (dynamic_cast<ItemBase *>(this->parentItem())->moveLock()) return;
-	if (SpaceBarWasPressed) return;
-
-	unsetCursor();
 	Q_UNUSED(event);
-	m_inHover = false;
-	update();
-}
-
-
-
-bool Stripbit::horizontal() {
-	return m_horizontal;
-}
-
-void Stripbit::setRemoved(bool removed) {
-	m_removed = removed;
-}
-
-bool Stripbit::removed() {
-	return m_removed;
-}
+	if (m_board->moveLock()) return;
+	if (SpaceBarWasPressed) return;
 
-void Stripbit::setChanged(bool changed) {
-	m_changed = changed;
+	clearHover();
 }
 
-bool Stripbit::changed() {
-	return m_changed;
-}
+void StripLayer::setHover(int x, int y, bool horizontal) {
+	if (x == m_hoverX && y == m_hoverY && horizontal == m_hoverHorizontal) return;
 
-int Stripbit::y() {
-	return m_y;
+	clearHover();
+	m_hoverX = x;
+	m_hoverY = y;
+	m_hoverHorizontal = horizontal;
+	setCursor(m_board->lattice().isCut(x, y, horizontal) ? *MagicWandCursor : *SpotFaceCutterCursor);
+	updateLink(x, y, horizontal);
 }
 
-int Stripbit::x() {
-	return m_x;
-}
+void StripLayer::clearHover() {
+	if (m_hoverX < 0) return;
 
-QString Stripbit::makeRemovedString() {
-	return QString("%1.%2%3 ").arg(m_x).arg(m_y).arg(m_horizontal ? 'h' : 'v');
+	updateLink(m_hoverX, m_hoverY, m_hoverHorizontal);
+	m_hoverX = m_hoverY = -1;
+	unsetCursor();
 }
 
 /////////////////////////////////////////////////////////////////////
 
-StripConnector::StripConnector() {
-	down = right = NULL;
-	connectorItem = NULL;
-}
-
 struct StripLayout {
 	QString name;
 	int rows;
@@ -324,11 +375,6 @@ Stripboard::Stripboard( ModelPart * modelPart, ViewLayer::ViewID viewID, const V
 }
 
 Stripboard::~Stripboard() {
-	foreach (StripConnector * sc, m_strips) {
-		delete sc;
-	}
-
-	m_strips.clear();
 }
 
 QString Stripboard::retrieveSvg(ViewLayer::ViewLayerID viewLayerID, QHash<QString, QString> & svgHash, bool blackOnly, double dpi, double & factor)
@@ -349,23 +395,29 @@ QString Stripboard::retrieveSvg(ViewLayer::ViewLayerID viewLayerID, QHash<QStrin
 	*/
 
 	QString stripSvg;
-	foreach(QGraphicsItem * item, childItems()) {
-		Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-		if (stripbit == NULL) continue;
-		if (stripbit->removed()) continue;
-
-		QPointF p = stripbit->pos();
-		QRectF r = stripbit->boundingRect();
-
-		stripSvg += QString("<path stroke='none' stroke-width='0' fill='%6' "
-		                    "d='m%1,%2 %3,0 0,%4 -%3,0z m0,%4a%5,%5  0,1,0 0,-%4z  m%3,-%4a%5,%5 0,1,0 0,%4z'/>\n")
-		            .arg(p.x() * dpi / GraphicsUtils::SVGDPI)
-		            .arg(p.y() * dpi / GraphicsUtils::SVGDPI)
-		            .arg(r.width() * dpi / GraphicsUtils::SVGDPI )
-		            .arg(r.height() * dpi / GraphicsUtils::SVGDPI)
-		            .arg(r.height() * dpi * .5 / GraphicsUtils::SVGDPI)
-		            .arg(blackOnly ? "black" : "#c49c59")
-		            ;
+	if (m_stripLayer) {
+		for (int y = 0; y < m_lattice.rows(); y++) {
+			for (int x = 0; x < m_lattice.columns(); x++) {
+				for (int pass = 0; pass < 2; pass++) {
+					bool horizontal = (pass == 0);
+					if (!m_lattice.hasLink(x, y, horizontal)) continue;
+					if (m_lattice.isCut(x, y, horizontal)) continue;
+
+					QPointF p = m_stripLayer->linkPos(x, y, horizontal);
+					QRectF r = (horizontal ? HPath : VPath).boundingRect();
+
+					stripSvg += QString("<path stroke='none' stroke-width='0' fill='%6' "
+					                    "d='m%1,%2 %3,0 0,%4 -%3,0z m0,%4a%5,%5  0,1,0 0,-%4z  m%3,-%4a%5,%5 0,1,0 0,%4z'/>\n")
+					            .arg(p.x() * dpi / GraphicsUtils::SVGDPI)
+					            .arg(p.y() * dpi / GraphicsUtils::SVGDPI)
+					            .arg(r.width() * dpi / GraphicsUtils::SVGDPI )
+					            .arg(r.height() * dpi / GraphicsUtils::SVGDPI)
+					            .arg(r.height() * dpi * .5 / GraphicsUtils::SVGDPI)
+					            .arg(blackOnly ? "black" : "#c49c59")
+					            ;
+				}
+			}
+		}
 	}
 
 	svg.truncate(svg.lastIndexOf("</g>"));
@@ -403,15 +455,34 @@ void Stripboard::addedToScene(bool temporary)
 	if (temporary) return;
 	if (m_viewID != ViewLayer::BreadboardView) return;
 
-	QList<QGraphicsItem *> items = childItems();
-
 	if (HPath.isEmpty()) {
 		makeInitialPath();
 	}
 
-	int count = m_x * m_y;
-	for (int i = 0; i < count; i++) {
-		m_strips.append(new StripConnector);
+	m_lattice.resize(m_x, m_y);
+	m_holes.fill(nullptr, m_x * m_y);
+	foreach (ConnectorItem * ci, cachedConnectorItems()) {
+		int cx, cy;
+		if (!getXY(cx, cy, ci->connectorSharedName())) continue;
+		if (cx >= m_x || cy >= m_y) continue;
+
+		m_holes[(cy * m_x) + cx] = ci;
+	}
+
+	ConnectorItem * ciFirst = m_holes.value(0);
+	if (ciFirst) {
+		QRectF r1 = ciFirst->rect();
+		ConnectorItem * ciNextH = m_x > 1 ? m_holes.at(1) : nullptr;
+		ConnectorItem * ciNextV = m_y > 1 ? m_holes.at(m_x) : nullptr;
+		double dx = ciNextH ? ciNextH->rect().center().x() - r1.center().x() : 0;
+		double dy = ciNextV ? ciNextV->rect().center().y() - r1.center().y() : 0;
+		if (dx <= 0) dx = dy;
+		if (dy <= 0) dy = dx;
+
+		if (m_stripLayer == nullptr) {
+			m_stripLayer = new StripLayer(this);
+		}
+		m_stripLayer->setGeometry(r1.center(), dx, dy, r1);
 	}
 
 	bool oldStyle = false;
@@ -422,61 +493,14 @@ void Stripboard::addedToScene(bool temporary)
 	}
 
 	QString config = prop("buses");
-	QString additionalConfig;
-
-	foreach (ConnectorItem * ci, cachedConnectorItems()) {
-		int cx, cy;
-		getXY(cx, cy, ci->connectorSharedName());
-		StripConnector * sc =  getStripConnector(cx, cy);
-		sc->connectorItem = ci;
-
-		if (cx < m_x - 1) {
-			Stripbit * stripbit = new Stripbit(HPath, cx, cy, true, this);
-			QRectF r = ci->rect();
-			stripbit->setPos(r.center().x(), r.top());
-			stripbit->setVisible(true);
-			sc->right = stripbit;
-			if (!oldStyle) {
-				additionalConfig += stripbit->makeRemovedString();
-			}
-		}
-
-		if (cy < m_y - 1) {
-			Stripbit * stripbit = new Stripbit(VPath, cx, cy, false, this);
-			QRectF r = ci->rect();
-			stripbit->setPos(r.left(), r.center().y());
-			stripbit->setVisible(true);
-			sc->down = stripbit;
-			if (oldStyle) {
-				additionalConfig += stripbit->makeRemovedString();
-			}
-		}
-	}
-
 	if (config.isEmpty() || oldStyle) {
-		config += additionalConfig;
-		setProp("buses", config);
+		// new style boards start with vertical strips, old style with horizontal ones
+		config += m_lattice.linkString(!oldStyle);
 	}
 
 	if (m_layout.isEmpty()) m_layout = VerticalString;
 
-	QStringList removed = config.split(" ", QString::SkipEmptyParts);
-
-	foreach (QString name, removed) {
-		int cx, cy;
-		if (getXY(cx, cy, name)) {
-			StripConnector * sc = getStripConnector(cx, cy);
-			bool vertical = name.contains("v");
-			if (vertical) {
-				if (sc->down) sc->down->setRemoved(true);
-			}
-			else {
-				if (sc->right) sc->right->setRemoved(true);
-			}
-		}
-	}
-
-	reinitBuses(false);
+	setProp("buses", config);
 }
 
 QString Stripboard::genModuleID(QMap<QString, QString> & currPropsMap)
@@ -485,43 +509,18 @@ QString Stripboard::genModuleID(QMap<QString, QString> & currPropsMap)
 	return size + ModuleIDNames::Stripboard2ModuleIDName;
 }
 
-void Stripboard::initCutting(Stripbit *)
+void Stripboard::initCutting()
 {
-	m_beforeCut.clear();
-	foreach (QGraphicsItem * item, childItems()) {
-		Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-		if (stripbit == NULL) continue;
-
-		stripbit->setChanged(false);
-		if (stripbit->removed()) {
-			m_beforeCut += stripbit->makeRemovedString();
-		}
-	}
-}
-
-void appendConnectors(QList<ConnectorItem *> & connectorItems, ConnectorItem * connectorItem) {
-	if (connectorItem == NULL) return;
-
-	foreach (ConnectorItem * ci, connectorItem->connectedToItems()) {
-		connectorItems.append(ci);
-	}
+	m_beforeCut = m_lattice.cutString();
 }
 
 void Stripboard::reinitBuses(bool triggerUndo)
 {
 	if (triggerUndo) {
-		QString afterCut;
+		QString afterCut = m_lattice.cutString();
 		QSet<ConnectorItem *> affectedConnectors;
 		int changeCount = 0;
 		bool connect = true;
-		foreach (QGraphicsItem * item, childItems()) {
-			Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-			if (stripbit == NULL) continue;
-
-			if (stripbit->removed()) {
-				afterCut += stripbit->makeRemovedString();
-			}
-		}
 
 		collectTo(affectedConnectors);
 
@@ -540,47 +539,25 @@ void Stripboard::reinitBuses(bool triggerUndo)
 	foreach (BusShared * busShared, m_buses) delete busShared;
 	m_buses.clear();
 
-	foreach (QGraphicsItem * item, childItems()) {
-		Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-		if (stripbit == NULL) {
-			ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
-			if (connectorItem == NULL) continue;
-
-			connectorItem->connector()->connectorShared()->setBus(NULL);
-			connectorItem->connector()->setBus(NULL);
-			continue;
-		}
-
+	foreach (ConnectorItem * connectorItem, cachedConnectorItems()) {
+		connectorItem->connector()->connectorShared()->setBus(NULL);
+		connectorItem->connector()->setBus(NULL);
 	}
 
-	QString busPropertyString;
-	foreach (QGraphicsItem * item, childItems()) {
-		Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-		if (stripbit == NULL) continue;
-
-		if (stripbit->removed()) {
-			busPropertyString += stripbit->makeRemovedString();
-		}
+	int groupCount = 0;
+	QVector<int> groups = m_lattice.groups(groupCount);
+	QVector< QList<ConnectorItem *> > connected(groupCount);
+	for (int i = 0; i < groups.count(); i++) {
+		ConnectorItem * connectorItem = m_holes.value(i);
+		if (connectorItem) connected[groups.at(i)].append(connectorItem);
 	}
-
-	QList<ConnectorItem *> visited;
-	for (int iy = 0; iy < m_y; iy++) {
-		for (int ix = 0; ix < m_x; ix++) {
-			StripConnector * sc = getStripConnector(ix, iy);
-			if (visited.contains(sc->connectorItem)) continue;
-
-			QList<ConnectorItem *> connected;
-			collectConnected(ix, iy, connected);
-			visited.append(connected);
-			nextBus(connected);
-		}
+	for (int g = 0; g < groupCount; g++) {
+		nextBus(connected[g]);
 	}
 
 	modelPart()->clearBuses();
 	modelPart()->initBuses();
-	modelPart()->setLocalProp("buses",  busPropertyString);
-
-
+	modelPart()->setLocalProp("buses",  m_lattice.cutString());
 
 	QList<ConnectorItem *> visited2;
 	foreach (ConnectorItem * connectorItem, cachedConnectorItems()) {
@@ -590,31 +567,6 @@ void Stripboard::reinitBuses(bool triggerUndo)
 	update();
 }
 
-void Stripboard::collectConnected(int ix, int iy, QList<ConnectorItem *> & connected) {
-	StripConnector * sc = getStripConnector(ix, iy);
-	if (connected.contains(sc->connectorItem)) return;
-
-	connected << sc->connectorItem;
-
-	if (sc->right && !sc->right->removed()) {
-		collectConnected(ix + 1, iy, connected);
-
-	}
-	if (sc->down && !sc->down->removed()) {
-		collectConnected(ix, iy + 1, connected);
-	}
-
-	StripConnector * left = ix > 0 ? getStripConnector(ix - 1, iy) : NULL;
-	if (left && left->right && !left->right->removed()) {
-		collectConnected(ix - 1, iy, connected);
-	}
-
-	StripConnector * up = iy > 0 ? getStripConnector(ix, iy - 1) : NULL;
-	if (up && up->down && !up->down->removed()) {
-		collectConnected(ix, iy - 1, connected);
-	}
-}
-
 void Stripboard::nextBus(QList<ConnectorItem *> & soFar)
 {
 	if (soFar.count() > 1) {
@@ -630,19 +582,8 @@ void Stripboard::nextBus(QList<ConnectorItem *> & soFar)
 void Stripboard::setProp(const QString & prop, const QString & value)
 {
 	if (prop.compare("buses") == 0) {
-		QStringList removed = value.split(" ", QString::SkipEmptyParts);
-		foreach (QGraphicsItem * item, childItems()) {
-			Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-			if (stripbit == NULL) continue;
-
-			QString removedString = stripbit->makeRemovedString();
-			removedString.chop(1);          // remove trailing space
-			bool remove = removed.contains(removedString);
-			stripbit->setRemoved(remove);
-			if (remove) {
-				removed.removeOne(removedString);
-			}
-		}
+		m_lattice.setCutString(value);
+		if (m_stripLayer) m_stripLayer->update();
 
 		reinitBuses(false);
 		return;
@@ -660,15 +601,8 @@ void Stripboard::getConnectedColor(ConnectorItem * ci, QBrush &brush, QPen &pen,
 	opacity *= .66667;
 }
 
-void Stripboard::restoreRowColors(Stripbit * stripbit)
-{
-	// TODO: find a quick way to update the buses (and connectorItem colors) in just the row...
-	Q_UNUSED(stripbit);
-	//int y = stripbit->y();
-	//stripbit = m_firstColumn.at(y);
-
-
-	//ci->restoreColor(false, 0, false);
+StripLattice & Stripboard::lattice() {
+	return m_lattice;
 }
 
 QString Stripboard::getRowLabel() {
@@ -739,10 +673,6 @@ void Stripboard::makeInitialPath() {
 	VPath.arcTo(rv, 0, 180);
 }
 
-StripConnector * Stripboard::getStripConnector(int ix, int iy) {
-	return m_strips.at((iy * m_x) + ix);
-}
-
 void Stripboard::swapEntry(const QString & text) {
 
 	FamilyPropertyComboBox * comboBox = qobject_cast<FamilyPropertyComboBox *>(sender());
@@ -754,24 +684,10 @@ void Stripboard::swapEntry(const QString & text) {
 
 		QString afterCut;
 		if (text.compare(HorizontalString, Qt::CaseInsensitive) == 0) {
-			foreach (QGraphicsItem * item, childItems()) {
-				Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-				if (stripbit == NULL) continue;
-
-				if (!stripbit->horizontal()) {
-					afterCut += stripbit->makeRemovedString();
-				}
-			}
+			afterCut = m_lattice.linkString(false);
 		}
 		else if (text.compare(VerticalString, Qt::CaseInsensitive) == 0) {
-			foreach (QGraphicsItem * item, childItems()) {
-				Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-				if (stripbit == NULL) continue;
-
-				if (stripbit->horizontal()) {
-					afterCut += stripbit->makeRemovedString();
-				}
-			}
+			afterCut = m_lattice.linkString(true);
 		}
 		else {
 			for (int i = 0; i < StripLayouts.count(); i++) {
@@ -792,7 +708,7 @@ void Stripboard::swapEntry(const QString & text) {
 		}
 
 		if (!afterCut.isEmpty()) {
-			initCutting(NULL);
+			initCutting();
 			QString changeText = tr("%1 layout").arg(text);
 			QSet<ConnectorItem *> affectedConnectors;
 			collectTo(affectedConnectors);
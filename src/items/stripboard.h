@@ -23,49 +23,52 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QRectF>
 #include <QPainterPath>
-#include <QGraphicsPathItem>
+#include <QGraphicsItem>
+#include <QVector>
 
 #include "perfboard.h"
+#include "striplattice.h"
 
 class ConnectorItem;
+class Stripboard;
 
-class Stripbit : public QGraphicsPathItem
+// Paints and hit-tests every strip segment of one board, so a 199 x 199 board costs one graphics item
+// instead of one per segment.  The segments themselves live in the board's StripLattice.
+class StripLayer : public QGraphicsItem
 {
 public:
-	Stripbit(const QPainterPath & path, int x, int y, bool horizontal, QGraphicsItem * parent);
-	~Stripbit();
-
-	bool horizontal();
-	void setRemoved(bool);
-	bool removed();
-	void setChanged(bool);
-	bool changed();
-	int y();
-	int x();
-	QString makeRemovedString();
+	StripLayer(Stripboard * board);
+	~StripLayer();
+
+	void setGeometry(const QPointF & origin, double dx, double dy, const QRectF & firstRect);
+	QRectF boundingRect() const;
+	bool contains(const QPointF & point) const;
+	bool collidesWithPath(const QPainterPath & path, Qt::ItemSelectionMode mode = Qt::IntersectsItemShape) const;
+	QPointF linkPos(int x, int y, bool horizontal) const;
 
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 	void mousePressEvent(QGraphicsSceneMouseEvent *event);
 	void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
 	void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
-	void hoverEnterEvent( QGraphicsSceneHoverEvent * event );
+	void hoverMoveEvent( QGraphicsSceneHoverEvent * event );
 	void hoverLeaveEvent( QGraphicsSceneHoverEvent * event );
 
 protected:
-	bool m_removed;
-	bool m_inHover;
-	int m_x;
-	int m_y;
-	bool m_changed;
-	bool m_horizontal;
-};
+	bool linkAt(const QPointF & point, int & x, int & y, bool & horizontal) const;
+	void setHover(int x, int y, bool horizontal);
+	void clearHover();
+	void updateLink(int x, int y, bool horizontal);
 
-struct StripConnector {
-	ConnectorItem * connectorItem;
-	Stripbit * down;
-	Stripbit * right;
-
-	StripConnector();
+protected:
+	Stripboard * m_board;
+	QPointF m_origin;			// center of hole 0.0
+	double m_dx = 0;
+	double m_dy = 0;
+	QRectF m_firstRect;
+	int m_hoverX = -1;
+	int m_hoverY = -1;
+	bool m_hoverHorizontal = false;
+	bool m_cutting = false;		// whether a drag cuts or restores
 };
 
 class Stripboard : public Perfboard
@@ -82,9 +85,9 @@ public:
 	void addedToScene(bool temporary);
 	void setProp(const QString & prop, const QString & value);
 	void reinitBuses(bool triggerUndo);
-	void initCutting(Stripbit *);
+	void initCutting();
 	void getConnectedColor(ConnectorItem *, QBrush &, QPen &, double & opacity, double & negativePenWidth, bool & negativeOffsetRect);
-	void restoreRowColors(Stripbit * stripbit);
+	StripLattice & lattice();
 	void swapEntry(const QString & text);
 	QStringList collectValues(const QString & family, const QString & prop, QString & value);
 
@@ -93,8 +96,6 @@ protected:
 	QString getRowLabel();
 	QString getColumnLabel();
 	void makeInitialPath();
-	void collectConnected(int x, int y, QList<ConnectorItem *> & connected);
-	StripConnector * getStripConnector(int x, int y);
 	void collectTo(QSet<ConnectorItem *> &);
 	void initStripLayouts();
 
@@ -103,7 +104,9 @@ public:
 	static QString genModuleID(QMap<QString, QString> & currPropsMap);
 
 protected:
-	QList<StripConnector *> m_strips;
+	StripLattice m_lattice;
+	QVector<ConnectorItem *> m_holes;			// by lattice index; every hole still has its own ConnectorItem
+	StripLayer * m_stripLayer = nullptr;
 	QList<class BusShared *> m_buses;
 	QString m_beforeCut;
 	int m_x = 0;
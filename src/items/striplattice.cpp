@@ -0,0 +1,231 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "striplattice.h"
+
+StripLattice::StripLattice()
+{
+}
+
+void StripLattice::resize(int columns, int rows) {
+	m_columns = qMax(0, columns);
+	m_rows = qMax(0, rows);
+	int count = m_columns * m_rows;
+	m_hCut.fill(false, count);
+	m_vCut.fill(false, count);
+	m_runs.resize(m_rows);
+	m_runsDirty.fill(true, m_rows);
+}
+
+int StripLattice::columns() const {
+	return m_columns;
+}
+
+int StripLattice::rows() const {
+	return m_rows;
+}
+
+int StripLattice::index(int x, int y) const {
+	return (y * m_columns) + x;
+}
+
+bool StripLattice::hasLink(int x, int y, bool horizontal) const {
+	if (x < 0 || y < 0) return false;
+
+	if (horizontal) return x < m_columns - 1 && y < m_rows;
+	return x < m_columns && y < m_rows - 1;
+}
+
+bool StripLattice::isCut(int x, int y, bool horizontal) const {
+	if (!hasLink(x, y, horizontal)) return false;
+
+	return horizontal ? m_hCut.testBit(index(x, y)) : m_vCut.testBit(index(x, y));
+}
+
+void StripLattice::setCut(int x, int y, bool horizontal, bool cut) {
+	if (!hasLink(x, y, horizontal)) return;
+
+	if (horizontal) {
+		m_hCut.setBit(index(x, y), cut);
+		m_runsDirty.setBit(y);
+	}
+	else {
+		m_vCut.setBit(index(x, y), cut);
+	}
+}
+
+void StripLattice::setAllCut(bool horizontal, bool cut) {
+	for (int y = 0; y < m_rows; y++) {
+		for (int x = 0; x < m_columns; x++) {
+			setCut(x, y, horizontal, cut);
+		}
+	}
+}
+
+void StripLattice::appendLink(QString & s, int x, int y, bool horizontal) {
+	s += QString::number(x);
+	s += QLatin1Char('.');
+	s += QString::number(y);
+	s += QLatin1Char(horizontal ? 'h' : 'v');
+	s += QLatin1Char(' ');
+}
+
+QString StripLattice::cutString() const {
+	QString s;
+	for (int y = 0; y < m_rows; y++) {
+		for (int x = 0; x < m_columns; x++) {
+			if (isCut(x, y, true)) appendLink(s, x, y, true);
+			if (isCut(x, y, false)) appendLink(s, x, y, false);
+		}
+	}
+	return s;
+}
+
+QString StripLattice::linkString(bool horizontal) const {
+	QString s;
+	for (int y = 0; y < m_rows; y++) {
+		for (int x = 0; x < m_columns; x++) {
+			if (hasLink(x, y, horizontal)) appendLink(s, x, y, horizontal);
+		}
+	}
+	return s;
+}
+
+void StripLattice::setCutString(const QString & value) {
+	m_hCut.fill(false);
+	m_vCut.fill(false);
+	m_runsDirty.fill(true);
+
+	foreach (QString token, value.split(" ", QString::SkipEmptyParts)) {
+		int x, y;
+		bool horizontal;
+		if (parseLink(token, x, y, horizontal)) {
+			setCut(x, y, horizontal, true);
+		}
+	}
+}
+
+bool StripLattice::parseLink(const QString & token, int & x, int & y, bool & horizontal) {
+	if (!parseXY(token, x, y)) return false;
+
+	horizontal = !token.contains('v');
+	return true;
+}
+
+bool StripLattice::parseXY(const QString & s, int & x, int & y) {
+	// same as matching (\d+)\.(\d+), without building a regular expression per call
+	int length = s.length();
+	int i = 0;
+	while (i < length) {
+		if (!s.at(i).isDigit()) {
+			i++;
+			continue;
+		}
+
+		int start = i;
+		while (i < length && s.at(i).isDigit()) i++;
+		if (i + 1 >= length || s.at(i) != '.' || !s.at(i + 1).isDigit()) continue;
+
+		int dot = i++;
+		while (i < length && s.at(i).isDigit()) i++;
+
+		bool ok;
+		x = s.midRef(start, dot - start).toInt(&ok);
+		if (!ok) return false;
+
+		y = s.midRef(dot + 1, i - dot - 1).toInt(&ok);
+		return ok;
+	}
+
+	return false;
+}
+
+const QVector<StripLattice::Run> & StripLattice::runs(int row) const {
+	if (m_runsDirty.testBit(row)) {
+		QVector<Run> & runs = m_runs[row];
+		runs.clear();
+		Run run;
+		run.first = 0;
+		for (int x = 0; x < m_columns; x++) {
+			if (x == m_columns - 1 || m_hCut.testBit(index(x, row))) {
+				run.last = x;
+				runs.append(run);
+				run.first = x + 1;
+			}
+		}
+		m_runsDirty.clearBit(row);
+	}
+
+	return m_runs.at(row);
+}
+
+static int findRoot(QVector<int> & parents, int i) {
+	while (parents.at(i) != i) {
+		parents[i] = parents.at(parents.at(i));
+		i = parents.at(i);
+	}
+	return i;
+}
+
+QVector<int> StripLattice::groups(int & groupCount) const {
+	QVector<int> runOf(m_columns * m_rows);
+	QVector<int> parents;
+	for (int y = 0; y < m_rows; y++) {
+		foreach (Run run, runs(y)) {
+			int id = parents.count();
+			parents.append(id);
+			for (int x = run.first; x <= run.last; x++) {
+				runOf[index(x, y)] = id;
+			}
+		}
+	}
+
+	for (int y = 0; y < m_rows - 1; y++) {
+		for (int x = 0; x < m_columns; x++) {
+			int i = index(x, y);
+			if (m_vCut.testBit(i)) continue;
+
+			int a = findRoot(parents, runOf.at(i));
+			int b = findRoot(parents, runOf.at(i + m_columns));
+			if (a != b) parents[qMax(a, b)] = qMin(a, b);
+		}
+	}
+
+	// number the groups in the order of their first hole
+	QVector<int> groupOfRoot(parents.count(), -1);
+	groupCount = 0;
+	for (int i = 0; i < runOf.count(); i++) {
+		int root = findRoot(parents, runOf.at(i));
+		if (groupOfRoot.at(root) < 0) groupOfRoot[root] = groupCount++;
+		runOf[i] = groupOfRoot.at(root);
+	}
+
+	return runOf;
+}
+
+int StripLattice::memoryUsage() const {
+	int bytes = sizeof(StripLattice);
+	bytes += (m_hCut.size() + m_vCut.size() + m_runsDirty.size()) / 8;
+	for (int y = 0; y < m_runs.count(); y++) {
+		bytes += sizeof(QVector<Run>) + m_runs.at(y).capacity() * sizeof(Run);
+	}
+	return bytes;
+}
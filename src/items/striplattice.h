@@ -0,0 +1,77 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef STRIPLATTICE_H
+#define STRIPLATTICE_H
+
+#include <QString>
+#include <QVector>
+#include <QBitArray>
+
+// The strips of a stripboard as plain arrays: one bit per link between neighboring holes, and for each row
+// the runs of holes that intact horizontal links join.  Holes are indexed (y * columns) + x.
+// Grouping holes into buses unions those runs along the intact vertical links, without recursion,
+// so it stays linear in the number of holes even on a 199 x 199 board.
+
+class StripLattice
+{
+public:
+	struct Run {
+		int first;
+		int last;
+	};
+
+public:
+	StripLattice();
+
+	void resize(int columns, int rows);				// every link intact
+	int columns() const;
+	int rows() const;
+
+	bool hasLink(int x, int y, bool horizontal) const;
+	bool isCut(int x, int y, bool horizontal) const;
+	void setCut(int x, int y, bool horizontal, bool cut);
+	void setAllCut(bool horizontal, bool cut);
+
+	QString cutString() const;						// the "buses" property: "x.yh x.yv " for every cut link
+	void setCutString(const QString &);
+	QString linkString(bool horizontal) const;		// every link running one way, in the same format
+	static bool parseLink(const QString & token, int & x, int & y, bool & horizontal);
+	static bool parseXY(const QString & s, int & x, int & y);		// first "x.y" in the string
+
+	const QVector<Run> & runs(int row) const;
+	QVector<int> groups(int & groupCount) const;	// group per hole
+	int memoryUsage() const;
+
+protected:
+	int index(int x, int y) const;
+	static void appendLink(QString & s, int x, int y, bool horizontal);
+
+protected:
+	int m_columns = 0;
+	int m_rows = 0;
+	QBitArray m_hCut;								// (x, y) to (x + 1, y)
+	QBitArray m_vCut;								// (x, y) to (x, y + 1)
+	mutable QVector< QVector<Run> > m_runs;
+	mutable QBitArray m_runsDirty;
+};
+
+#endif
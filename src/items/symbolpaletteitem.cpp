@@ -28,6 +28,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/focusoutcombobox.h"
 #include "../utils/graphicsutils.h"
 #include "../sketch/infographicsview.h"
+#include "../sketch/fgraphicsscene.h"
 #include "partlabel.h"
 #include "partfactory.h"
 #include "layerkinpaletteitem.h"
@@ -225,6 +226,15 @@ void SymbolPaletteItem::busConnectorItems(Bus * bus, ConnectorItem * fromConnect
 	}
 }
 
+void SymbolPaletteItem::busChanged() {
+	// the connectors now share a bus with other symbols without any wire being connected or disconnected,
+	// so tell the scene which nets the routing status has to rescore
+	FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+	if (fscene) {
+		fscene->connectorsChanged(this);
+	}
+}
+
 double SymbolPaletteItem::voltage() {
 	return m_voltage;
 }
@@ -250,6 +260,7 @@ void SymbolPaletteItem::setLabel(const QString & label) {
 	foreach (ConnectorItem * connectorItem, cachedConnectorItems()) {
 		LocalNetLabels.insert(label, connectorItem);
 	}
+	busChanged();
 
 	QTransform  transform = untransform();
 
@@ -288,6 +299,7 @@ void SymbolPaletteItem::setVoltage(double v) {
 			}
 		}
 	}
+	busChanged();
 
 	if (m_viewID == ViewLayer::SchematicView) {
 		if (m_voltageReference || m_isNetLabel) {
@@ -84,6 +84,7 @@ public slots:
 
 protected:
 	void removeMeFromBus(double voltage);
+	void busChanged();
 	double useVoltage(ConnectorItem * connectorItem);
 	virtual QString makeSvg(ViewLayer::ViewLayerID);
 	QString replaceTextElement(QString svg);
@@ -121,7 +121,7 @@ bool VirtualWire::colorWasNamed() {
 	return m_colorWasNamed;
 }
 
-QPainterPath VirtualWire::shape() const
+double VirtualWire::shapeWidth() const
 {
-	return shapeAux(m_hoverStrokeWidth);
+	return m_hoverStrokeWidth;
 }
@@ -36,9 +36,9 @@ public:
 	void tempRemoveAllConnections();
 	void setColorWasNamed(bool);
 	bool colorWasNamed();
-	QPainterPath shape() const;
 
 protected:
+	double shapeWidth() const;
 	void paint (QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget );
 	void mousePressEvent(QGraphicsSceneMouseEvent *event);
 	void connectionChange(ConnectorItem * onMe, ConnectorItem * onIt, bool connect);
@@ -157,6 +157,7 @@ Wire::Wire( ModelPart * modelPart, ViewLayer::ViewID viewID,  const ViewGeometry
 	m_partLabel = initLabel ? new PartLabel(this, NULL) : NULL;
 	m_canChainMultiple = false;
 	setFlag(QGraphicsItem::ItemIsSelectable, true );
+	setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);		// so moves reach the connector index
 	m_connectorHover = NULL;
 	m_opacity = 1.0;
 	m_ignoreSelectionChange = false;
@@ -373,25 +374,52 @@ QPainterPath Wire::hoverShape() const
 
 QPainterPath Wire::shape() const
 {
-	return shapeAux(m_pen.widthF());
+	return shapeAux(shapeWidth());
+}
+
+double Wire::shapeWidth() const
+{
+	return m_pen.widthF();
 }
 
 QPainterPath Wire::shapeAux(double width) const
 {
-	QPainterPath path;
 	if (m_line == QLineF()) {
-		return path;
+		return QPainterPath();
 	}
 
-	path.moveTo(m_line.p1());
+	// the scene asks for shapes far more often than wires change, so the stroked paths are kept
+	updateWireShape();
+	//DebugDialog::debug(QString("using hoverstrokewidth %1 %2").arg(m_id).arg(m_hoverStrokeWidth));
+	return m_wireShape.stroke(width);
+}
+
+void Wire::updateWireShape() const
+{
 	if (m_bezier == NULL || m_bezier->isEmpty()) {
-		path.lineTo(m_line.p2());
+		m_wireShape.setGeometry(m_line, false, QPointF(), QPointF(), m_pen);
 	}
 	else {
-		path.cubicTo(m_bezier->cp0(), m_bezier->cp1(), m_line.p2());
+		m_wireShape.setGeometry(m_line, true, m_bezier->cp0(), m_bezier->cp1(), m_pen);
 	}
-	//DebugDialog::debug(QString("using hoverstrokewidth %1 %2").arg(m_id).arg(m_hoverStrokeWidth));
-	return GraphicsUtils::shapeFromPath(path, m_pen, width, false);
+}
+
+bool Wire::contains(const QPointF & point) const
+{
+	// hover and clicks: most points can be turned away by their distance from the centerline
+	updateWireShape();
+	return m_wireShape.contains(point, shapeWidth());
+}
+
+bool Wire::collidesWithPath(const QPainterPath & path, Qt::ItemSelectionMode mode) const
+{
+	// rubber-band selection and collidingItems
+	if (mode != Qt::IntersectsItemShape || path.isEmpty()) {
+		return ItemBase::collidesWithPath(path, mode);
+	}
+
+	updateWireShape();
+	return m_wireShape.intersects(path, shapeWidth());
 }
 
 QRectF Wire::boundingRect() const
@@ -712,7 +740,7 @@ void Wire::setConnector0Rect() {
 	QRectF rect = m_connector0->rect();
 	rect.moveTo(0 - (rect.width()  / 2.0),
 	            0 - (rect.height()  / 2.0) );
-	m_connector0->setRect(rect);
+	m_connector0->setConnectorRect(rect);
 
 	//debugCompare(this);
 
@@ -728,7 +756,7 @@ void Wire::setConnector1Rect() {
 	QRectF rect = m_connector1->rect();
 	rect.moveTo(this->line().dx() - (rect.width()  / 2.0),
 	            this->line().dy() - (rect.height()  / 2.0) );
-	m_connector1->setRect(rect);
+	m_connector1->setConnectorRect(rect);
 
 	//debugCompare(this);
 
@@ -1037,7 +1065,7 @@ FSvgRenderer * Wire::setUpConnectors(ModelPart * modelPart, ViewLayer::ViewID vi
 		if (!result) continue;
 
 		ConnectorItem * connectorItem = newConnectorItem(connector);
-		connectorItem->setRect(svgIdLayer->rect(viewLayerPlacement()));
+		connectorItem->setConnectorRect(svgIdLayer->rect(viewLayerPlacement()));
 		connectorItem->setTerminalPoint(svgIdLayer->point(viewLayerPlacement()));
 		m_originalConnectorRect = svgIdLayer->rect(viewLayerPlacement());
 
@@ -1740,7 +1768,7 @@ void Wire::setConnectorDimensionsAux(ConnectorItem * connectorItem, double width
 {
 	QPointF p = connectorItem->rect().center();
 	QRectF r(p.x() - (width / 2), p.y() - (height / 2), width, height);
-	connectorItem->setRect(r);
+	connectorItem->setConnectorRect(r);
 	connectorItem->setTerminalPoint(r.center() - r.topLeft());
 	//debugCompare(connectorItem->attachedTo());
 }
@@ -1789,6 +1817,7 @@ void Wire::setLine(const QLineF &line)
 		return;
 	prepareGeometryChange();
 	m_line = line;
+	connectorGeometryChanged();
 	update();
 }
 
@@ -34,6 +34,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "itembase.h"
 #include "../utils/cursormaster.h"
+#include "../utils/wireshape.h"
 
 class WireAction : public QAction {
 	Q_OBJECT
@@ -142,6 +143,8 @@ public:
 	double hoverStrokeWidth();
 	QPainterPath hoverShape() const;
 	QPainterPath shape() const;
+	bool contains(const QPointF & point) const;
+	bool collidesWithPath(const QPainterPath & path, Qt::ItemSelectionMode mode = Qt::IntersectsItemShape) const;
 	QRectF boundingRect() const;
 	virtual const QLineF & getPaintLine();
 	bool canHaveCurve();
@@ -210,6 +213,8 @@ protected:
 	void setConnectorDimensionsAux(ConnectorItem *, double width, double height);
 	bool isBendpoint(ConnectorItem * connectorItem);
 	QPainterPath shapeAux(double width) const;
+	virtual double shapeWidth() const;
+	void updateWireShape() const;
 	void hoverLeaveEvent( QGraphicsSceneHoverEvent * event );
 	void hoverEnterEvent( QGraphicsSceneHoverEvent * event );
 	void contextMenuEvent(QGraphicsSceneContextMenuEvent *event);
@@ -247,6 +252,7 @@ protected:
 	bool m_displayBendpointCursor;
 	bool m_banded;
 	bool m_colorByLength;
+	mutable WireShape m_wireShape;
 
 public:
 	static QStringList colorNames;
@@ -136,6 +136,7 @@ int main(int argc, char *argv[])
 			     "  -h, -help                     print this help message\n"
 			     "  -kicad FOLDER                 convert all Kicad footprint (.mod) files in FOLDER to Fritzing SVGs\n"
 			     "  -kicadschematic FOLDER        convert all Kicad schematic (.lib) files in FOLDER to Fritzing SVGs\n"
+			     "  -netlist FOLDER               export netlist, SPICE netlist and BOM of all sketches in FOLDER, in the same folder\n"
 			     "  -port NUMBER                  run Fritzing as a server process on port NUMBER\n"
 			     "  -svg FOLDER                   export all sketches in FOLDER to SVGs of all views, in the same folder\n"
 			     "\n"
@@ -143,14 +144,18 @@ int main(int argc, char *argv[])
 			     "  -db, -database FILE           rebuild the internal parts database FILE\n"
 			     "\n"
 			     "Developer options:\n"
+			     "  -benchmark FOLDER             open a fixed set of the sketches in FOLDER (usually sketches/core), export them and report timings\n"
 			     "  -e, -examples FOLDER          prepare all sketches in FOLDER to be included as examples\n"
 			     "  -ep FILE                      add menu item for external process using executable FILE\n"
 			     "  -eparg ARGS                   with -ep, external process arguments ARGS\n"
 			     "  -epname NAME                  with -ep, external process menu item NAME\n"
+			     "  -s2s FOLDER                   regenerate the schematic SVGs of all parts (.fzp) in FOLDER into FOLDER/s2s, in parallel\n"
 			     "\n"
-			     "The -geda, -kicad, -kicadschematic, -gerber SVG options all exit Fritzing after the conversion process is complete;\n"
+			     "The -geda, -kicad, -kicadschematic, -gerber, -netlist, -benchmark, -s2s and SVG options all exit Fritzing after the conversion process is complete;\n"
 			     "these options are mutually exclusive.\n"
 			     "\n"
+			     "Set the environment variable FRITZING_TRACE to a file name to record a Chrome trace of loading, rendering and export.\n"
+			     "\n"
 #ifndef PKGDATADIR
 			     "Usually, the Fritzing executable is stored in the same folder that contains the parts/bins/sketches/translations folders,\n"
 			     "or the executable is in a child folder of the p/b/s/t folder.\n"
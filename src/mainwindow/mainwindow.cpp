@@ -47,6 +47,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "fdockwidget.h"
 #include "../infoview/htmlinfoview.h"
 #include "../waitpushundostack.h"
+#include "../model/autosavewriter.h"
 #include "../layerattributes.h"
 #include "../sketch/breadboardsketchwidget.h"
 #include "../sketch/schematicsketchwidget.h"
@@ -339,9 +340,12 @@ MainWindow::MainWindow(ReferenceModel *referenceModel, QWidget * parent) :
 	resize(MainWindowDefaultWidth, MainWindowDefaultHeight);
 
 	m_backupFileNameAndPath = MainWindow::BackupFolder + "/" + TextUtils::getRandText() + FritzingSketchExtension;
+	m_autosaveWriter = new AutosaveWriter(m_backupFileNameAndPath, this);
 	// Connect the undoStack to our autosave stuff
 	connect(m_undoStack, SIGNAL(indexChanged(int)), this, SLOT(autosaveNeeded(int)));
 	connect(m_undoStack, SIGNAL(cleanChanged(bool)), this, SLOT(undoStackCleanChanged(bool)));
+	connect(m_undoStack, SIGNAL(memoryUsageChanged(qint64)), this, SLOT(undoMemoryUsageChanged(qint64)));
+	connect(m_undoStack, SIGNAL(aboutToPush(const QUndoCommand *)), this, SLOT(materializeViewsFor(const QUndoCommand *)), Qt::DirectConnection);
 
 	// Create dot icons
 	m_dotIcon = QIcon(":/resources/images/dot.png");
@@ -553,7 +557,12 @@ void MainWindow::init(ReferenceModel *referenceModel, bool lockFiles) {
 MainWindow::~MainWindow()
 {
 	// Delete backup of this sketch if one exists.
-	QFile::remove(m_backupFileNameAndPath);
+	if (m_autosaveWriter) {
+		m_autosaveWriter->discard();
+	}
+	else {
+		QFile::remove(m_backupFileNameAndPath);
+	}
 
 	delete m_sketchModel;
 
@@ -1140,6 +1149,9 @@ void MainWindow::tabWidget_currentChanged(int index) {
 	if (m_pcbGraphicsView) m_pcbGraphicsView->setCurrent(false);
 
 	SketchWidget *widget = qobject_cast<SketchWidget *>(widgetParent->contentView());
+	if (widget) {
+		materializeView(widget);
+	}
 
 	if(m_currentGraphicsView) {
 		m_currentGraphicsView->saveZoom(m_zoomSlider->value());
@@ -2268,6 +2280,8 @@ void MainWindow::swapLayers(ItemBase * itemBase, int layers, const QString & msg
 }
 
 void MainWindow::swapSelectedAux(ItemBase * itemBase, const QString & moduleID, bool useViewLayerPlacement, ViewLayer::ViewLayerPlacement overrideViewLayerPlacement,  QMap<QString, QString> & propsMap) {
+	// the swap is assembled from the items in all three views
+	materializeViews();
 
 	QUndoCommand* parentCommand = new QUndoCommand(tr("Swapped %1 with module %2").arg(itemBase->instanceTitle()).arg(moduleID));
 	new CleanUpWiresCommand(m_breadboardGraphicsView, CleanUpWiresCommand::UndoOnly, parentCommand);
@@ -2586,9 +2600,12 @@ void  MainWindow::backupSketch() {
 		ProcessEventBlocker::processEvents();
 		m_backingUp = true;
 		connectStartSave(true);
-		m_sketchModel->save(m_backupFileNameAndPath, false);
+		// only serialize into memory here; writing and journaling happen on a worker thread
+		SketchSnapshot snapshot;
+		m_sketchModel->snapshot(m_backupFileNameAndPath, snapshot);
 		connectStartSave(false);
 		m_backingUp = false;
+		m_autosaveWriter->write(snapshot);
 	}
 }
 
@@ -2611,10 +2628,22 @@ void MainWindow::autosaveNeeded(int index) {
 void MainWindow::undoStackCleanChanged(bool isClean) {
 	// DebugDialog::debug(QString("Clean status changed to %1").arg(isClean));
 	if (isClean) {
-		QFile::remove(m_backupFileNameAndPath);
+		m_autosaveWriter->discard();
 	}
 }
 
+/**
+ * show how much memory the undo history holds in the undo history dock title.
+ */
+void MainWindow::undoMemoryUsageChanged(qint64 bytes) {
+	if (m_undoView == NULL) return;
+
+	QDockWidget * dock = qobject_cast<QDockWidget *>(m_undoView->parentWidget());
+	if (dock == NULL) return;
+
+	dock->setWindowTitle(tr("Undo History (%1 MB)").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1));
+}
+
 void MainWindow::setAutosavePeriod(int minutes) {
 	setAutosave(minutes, AutosaveEnabled);
 }
@@ -2836,6 +2865,7 @@ void MainWindow::filenameIfSlot(QString & filename)
 
 QList<SketchWidget *> MainWindow::sketchWidgets()
 {
+	// views deferred at load may still be empty; callers that walk their items should call materializeViews() first
 	QList<SketchWidget *> list;
 	list << m_breadboardGraphicsView << m_schematicGraphicsView << m_pcbGraphicsView;
 	return list;
@@ -2847,6 +2877,7 @@ void MainWindow::setCloseSilently(bool cs)
 }
 
 PCBSketchWidget * MainWindow::pcbView() {
+	materializeView(m_pcbGraphicsView);
 	return m_pcbGraphicsView;
 }
 
@@ -3052,6 +3083,8 @@ void MainWindow::updatePartsBin(const QString & moduleID) {
 bool MainWindow::hasCustomBoardShape() {
 	if (m_pcbGraphicsView == NULL) return false;
 
+	materializeView(m_pcbGraphicsView);
+
 	return m_pcbGraphicsView->hasCustomBoardShape();
 }
 
@@ -3096,6 +3129,7 @@ void MainWindow::fireQuote() {
 	m_fireQuoteTimer.stop();
 	if (!QuoteDialog::quoteSucceeded()) return;
 
+	materializeView(m_pcbGraphicsView);
 	m_rolloverQuoteDialog = m_pcbGraphicsView->quoteDialog(m_pcbWidget);
 	if (m_rolloverQuoteDialog == NULL) return;
 
@@ -202,6 +202,7 @@ public:
 	ProgramWindow * programmingWidget();
 	void setCloseSilently(bool);
 	class PCBSketchWidget * pcbView();
+	void materializeViews();
 	void noBackup();
 	void swapSelectedAux(ItemBase * itemBase, const QString & moduleID, bool useViewLayerPlacement, ViewLayer::ViewLayerPlacement, QMap<QString, QString> & propsMap);
 	void swapLayers(ItemBase * itemBase, int layers, const QString & msg, int delay);
@@ -270,6 +271,7 @@ public slots:
 protected slots:
 	void mainLoad();
 	void revert();
+	void materializeViewsFor(const QUndoCommand *);
 	void openRecentOrExampleFile();
 	void openRecentOrExampleFile(const QString & filename, const QString & actionText);
 	void print();
@@ -425,6 +427,7 @@ protected slots:
 	bool saveAs();
 	virtual void backupSketch();
 	void undoStackCleanChanged(bool isClean);
+	void undoMemoryUsageChanged(qint64 bytes);
 	void autosaveNeeded(int index = 0);
 	void changeTraceLayer();
 	void routingStatusLabelMousePress(QMouseEvent*);
@@ -462,6 +465,8 @@ protected slots:
 
 protected:
 	void initSketchWidget(SketchWidget *);
+	void materializeView(SketchWidget *);
+	void convertObsoleteSMDOrientation();
 	virtual void initProgrammingWidget();
 
 	virtual void createActions();
@@ -917,6 +922,7 @@ protected:
 	QPointer<class ProgramWindow> m_programView;
 	QList<LinkedFile *>  m_linkedProgramFiles;
 	QString m_backupFileNameAndPath;
+	class AutosaveWriter * m_autosaveWriter = nullptr;
 	QTimer m_autosaveTimer;
 	QTimer m_fireQuoteTimer;
 	bool m_autosaveNeeded = false;
@@ -946,6 +952,8 @@ protected:
 	bool m_dontKeepMargins = false;
 	QPointer<QDialog> m_rolloverQuoteDialog;
 	bool m_obsoleteSMDOrientation = false;
+	QList<SketchWidget *> m_deferredViews;			// not built from the model since loading; saved from the loaded xml until then. See materializeView()
+	QList<ModelPart *> m_deferredModelParts;
 	QWidget * m_orderFabButton = nullptr;
 	int m_fireQuoteDelay = 0;
 
@@ -60,6 +60,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 #include "../connectors/ercdata.h"
 #include "../items/moduleidnames.h"
+#include "../model/modelnetlist.h"
 #include "../utils/zoomslider.h"
 #include "../dock/layerpalette.h"
 #include "../program/programwindow.h"
@@ -167,6 +168,8 @@ void MainWindow::exportEtchable() {
 
 void MainWindow::exportEtchable(bool wantPDF, bool wantSVG)
 {
+	materializeView(m_pcbGraphicsView);
+
 	int boardCount;
 	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
 	if (boardCount == 0) {
@@ -843,16 +846,14 @@ void MainWindow::saveAsShareable(const QString & path, bool saveModel)
 {
 	QString filename = path;
 	QHash<QString, ModelPart *> saveParts;
-	foreach (QGraphicsItem * item, m_pcbGraphicsView->scene()->items()) {
-		ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
-		if (itemBase == NULL) continue;
-		if (itemBase->modelPart() == NULL) {
-			continue;
-		}
-		if (itemBase->modelPart()->isCore()) continue;
-		if (itemBase->moduleID().contains(PartFactory::OldSchematicPrefix)) continue;
+	// taken from the model rather than a view, since pcb view may not have been built yet
+	QList<ModelPart *> modelParts;
+	m_sketchModel->root()->collectInstances(modelParts);
+	foreach (ModelPart * modelPart, modelParts) {
+		if (modelPart->isCore()) continue;
+		if (modelPart->moduleID().contains(PartFactory::OldSchematicPrefix)) continue;
 
-		saveParts.insert(itemBase->moduleID(), itemBase->modelPart());
+		saveParts.insert(modelPart->moduleID(), modelPart);
 	}
 	if(alreadyHasExtension(filename, FritzingSketchExtension)) {
 		saveBundledNonAtomicEntity(filename, FritzingSketchExtension, this, saveParts.values(), false, m_fzzFolder, saveModel, true);
@@ -1058,6 +1059,7 @@ void MainWindow::exportToEagle() {
 
 	QMessageBox::information(this, tr("Fritzing"), text);
 
+	materializeView(m_pcbGraphicsView);
 	Fritzing2Eagle eagle = Fritzing2Eagle(m_pcbGraphicsView);
 
 	/*
@@ -1293,6 +1295,8 @@ void MainWindow::exportBOM() {
 void MainWindow::exportSpiceNetlist() {
 	if (m_schematicGraphicsView == NULL) return;
 
+	materializeView(m_schematicGraphicsView);
+
 	// examples:
 	// http://www.allaboutcircuits.com/vol_5/chpt_7/8.html
 	// http://cutler.eecs.berkeley.edu/classes/icbook/spice/UserGuide/elements_fr.html
@@ -1431,48 +1435,7 @@ void MainWindow::exportSpiceNetlist() {
 		output += "\n";
 	}
 
-	QString incl = ".include";
-	if (output.contains(incl, Qt::CaseInsensitive)) {
-		QStringList lines = output.split("\n");
-		QList<QDir > paths;
-		paths << FolderUtils::getAppPartsSubFolder("");
-		paths << QDir(FolderUtils::getUserPartsPath());
-
-		QString output2;
-		foreach (QString line, lines) {
-			int ix = line.toLower().indexOf(incl);
-			if (ix < 0) {
-				output2 += line + "\n";
-				continue;
-			}
-
-			QString temp = line;
-			temp.replace(ix, incl.length(), "");
-			QString filename = temp.trimmed();
-
-			bool gotOne = false;
-			foreach (QDir dir, paths) {
-				foreach (QString folder, ModelPart::possibleFolders()) {
-					QDir sub(dir);
-					sub.cd(folder);
-					sub.cd("spicemodels");
-					if (QFile::exists(sub.absoluteFilePath(filename))) {
-						output2 += incl.toUpper() + " " + QDir::toNativeSeparators(sub.absoluteFilePath(filename)) + "\n";
-						gotOne = true;
-						break;
-					}
-				}
-				if (gotOne) break;
-			}
-
-			// can't find the include file, so just restore the original line
-			if (!gotOne) {
-				output2 += line + "\n";
-			}
-		}
-
-		output = output2;
-	}
+	output = ModelNetlist::resolveSpiceIncludes(output);
 
 	output += ".TRAN 1ms 100ms\n";
 	output += "* .AC DEC 100 100 1MEG\n";
@@ -1645,6 +1608,7 @@ void MainWindow::exportToGerber() {
 
 	//NOTE: this assumes just one board per sketch
 
+	materializeView(m_pcbGraphicsView);
 	int boardCount;
 	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
 
@@ -72,6 +72,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../processeventblocker.h"
 #include "../sketchtoolbutton.h"
 #include "../help/firsttimehelpdialog.h"
+#include "../utils/tracer.h"
 
 ////////////////////////////////////////////////////////
 
@@ -294,6 +295,7 @@ MainWindow * MainWindow::revertAux()
 
 bool MainWindow::loadWhich(const QString & fileName, bool setAsLastOpened, bool addToRecent, bool checkObsolete, const QString & displayName)
 {
+	TraceScope trace("open sketch", fileName);
 	if (!QFileInfo(fileName).exists()) {
 		FMessageBox::warning(NULL, tr("Fritzing"), tr("File '%1' not found").arg(fileName));
 		return false;
@@ -382,67 +384,73 @@ void MainWindow::mainLoad(const QString & fileName, const QString & displayName,
 	disconnect(m_sketchModel, SIGNAL(obsoleteSMDOrientationSignal()),
 	           this, SLOT(obsoleteSMDOrientationSlot()));
 
-	ProcessEventBlocker::processEvents();
-	if (m_fileProgressDialog) {
-		m_fileProgressDialog->setValue(155);
-		m_fileProgressDialog->setMessage(tr("loading %1 (breadboard)").arg(displayName2));
+	// only the view that is showing is built now, so opening a sketch is faster.  The others are built from
+	// the same model parts the first time they are shown, when an export needs them, or when an edit adds,
+	// removes, moves or connects items in them (see materializeViewsFor).  Until then saving writes them
+	// out as they were loaded, and property changes wait on the model parts
+	m_deferredModelParts = modelParts;
+	m_deferredViews.clear();
+	if (m_currentGraphicsView) {
+		if (m_currentGraphicsView != m_breadboardGraphicsView) m_deferredViews << m_breadboardGraphicsView;
+		if (m_currentGraphicsView != m_pcbGraphicsView) m_deferredViews << m_pcbGraphicsView;
+		// schematic conversion happens right after loading, so it can't wait
+		if (m_currentGraphicsView != m_schematicGraphicsView && !m_convertedSchematic && !m_useOldSchematic) m_deferredViews << m_schematicGraphicsView;
+	}
+	foreach (SketchWidget * sketchWidget, m_deferredViews) {
+		foreach (ModelPart * modelPart, modelParts) {
+			modelPart->setViewDeferred(sketchWidget->viewID(), true);
+		}
 	}
 
+	ProcessEventBlocker::processEvents();
 	QList<long> newIDs;
-	m_breadboardGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
+	if (!m_deferredViews.contains(m_breadboardGraphicsView)) {
+		if (m_fileProgressDialog) {
+			m_fileProgressDialog->setValue(155);
+			m_fileProgressDialog->setMessage(tr("loading %1 (breadboard)").arg(displayName2));
+		}
 
-	ProcessEventBlocker::processEvents();
-	if (m_fileProgressDialog) {
-		m_fileProgressDialog->setValue(170);
-		m_fileProgressDialog->setMessage(tr("loading %1 (pcb)").arg(displayName2));
+		m_breadboardGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
+		ProcessEventBlocker::processEvents();
 	}
 
-	newIDs.clear();
-	m_pcbGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
-
+	if (!m_deferredViews.contains(m_pcbGraphicsView)) {
+		if (m_fileProgressDialog) {
+			m_fileProgressDialog->setValue(170);
+			m_fileProgressDialog->setMessage(tr("loading %1 (pcb)").arg(displayName2));
+		}
 
-	ProcessEventBlocker::processEvents();
-	if (m_fileProgressDialog) {
-		m_fileProgressDialog->setValue(185);
-		m_fileProgressDialog->setMessage(tr("loading %1 (schematic)").arg(displayName2));
+		newIDs.clear();
+		m_pcbGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
+		ProcessEventBlocker::processEvents();
 	}
 
-	newIDs.clear();
-	m_schematicGraphicsView->setConvertSchematic(m_convertedSchematic);
-	m_schematicGraphicsView->setOldSchematic(this->m_useOldSchematic);
-	m_schematicGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
-	m_schematicGraphicsView->setConvertSchematic(false);
+	if (!m_deferredViews.contains(m_schematicGraphicsView)) {
+		if (m_fileProgressDialog) {
+			m_fileProgressDialog->setValue(185);
+			m_fileProgressDialog->setMessage(tr("loading %1 (schematic)").arg(displayName2));
+		}
+
+		newIDs.clear();
+		m_schematicGraphicsView->setConvertSchematic(m_convertedSchematic);
+		m_schematicGraphicsView->setOldSchematic(this->m_useOldSchematic);
+		m_schematicGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
+		m_schematicGraphicsView->setConvertSchematic(false);
+		ProcessEventBlocker::processEvents();
+	}
 
 	if (m_sketchModel->checkForReversedWires()) {
-		m_pcbGraphicsView->checkForReversedWires();
-		m_schematicGraphicsView->checkForReversedWires();
-		m_breadboardGraphicsView->checkForReversedWires();
+		if (!m_deferredViews.contains(m_pcbGraphicsView)) m_pcbGraphicsView->checkForReversedWires();
+		if (!m_deferredViews.contains(m_schematicGraphicsView)) m_schematicGraphicsView->checkForReversedWires();
+		if (!m_deferredViews.contains(m_breadboardGraphicsView)) m_breadboardGraphicsView->checkForReversedWires();
 	}
 
-	ProcessEventBlocker::processEvents();
 	if (m_fileProgressDialog) {
 		m_fileProgressDialog->setValue(198);
 	}
 
-	if (m_obsoleteSMDOrientation) {
-		QSet<ItemBase *> toConvert;
-		foreach (QGraphicsItem * item, m_pcbGraphicsView->items()) {
-			ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
-			if (itemBase == NULL) continue;
-
-			itemBase = itemBase->layerKinChief();
-			if (itemBase->modelPart()->flippedSMD() && itemBase->viewLayerPlacement() == ViewLayer::NewBottom) {
-				toConvert.insert(itemBase);
-			}
-		}
-
-		QList<ConnectorItem *> already;
-		foreach (ItemBase * itemBase, toConvert) {
-			PaletteItem * paletteItem = qobject_cast<PaletteItem *>(itemBase);
-			if (paletteItem == NULL) continue;          // shouldn't happen
-
-			paletteItem->rotateItem(180, true);
-		}
+	if (m_obsoleteSMDOrientation && !m_deferredViews.contains(m_pcbGraphicsView)) {
+		convertObsoleteSMDOrientation();
 	}
 
 	if (m_programView) {
@@ -451,8 +459,10 @@ void MainWindow::mainLoad(const QString & fileName, const QString & displayName,
 	}
 
 	if (!m_useOldSchematic && checkObsolete) {
-		if (m_pcbGraphicsView) {
-			QList<ItemBase *> items = m_pcbGraphicsView->selectAllObsolete();
+		// every view has the same parts, so there is no need to build pcb just for this
+		SketchWidget * sketchWidget = m_deferredViews.contains(m_pcbGraphicsView) ? m_currentGraphicsView : m_pcbGraphicsView;
+		if (sketchWidget) {
+			QList<ItemBase *> items = sketchWidget->selectAllObsolete();
 			if (items.count() > 0) {
 				checkSwapObsolete(items, true);
 			}
@@ -463,6 +473,73 @@ void MainWindow::mainLoad(const QString & fileName, const QString & displayName,
 
 }
 
+void MainWindow::convertObsoleteSMDOrientation() {
+	QSet<ItemBase *> toConvert;
+	foreach (QGraphicsItem * item, m_pcbGraphicsView->items()) {
+		ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == NULL) continue;
+
+		itemBase = itemBase->layerKinChief();
+		if (itemBase->modelPart()->flippedSMD() && itemBase->viewLayerPlacement() == ViewLayer::NewBottom) {
+			toConvert.insert(itemBase);
+		}
+	}
+
+	foreach (ItemBase * itemBase, toConvert) {
+		PaletteItem * paletteItem = qobject_cast<PaletteItem *>(itemBase);
+		if (paletteItem == NULL) continue;          // shouldn't happen
+
+		paletteItem->rotateItem(180, true);
+	}
+}
+
+void MainWindow::materializeView(SketchWidget * sketchWidget) {
+	if (!m_deferredViews.removeOne(sketchWidget)) return;
+
+	TraceScope trace("build view", ViewLayer::viewIDName(sketchWidget->viewID()));
+	foreach (ModelPart * modelPart, m_deferredModelParts) {
+		modelPart->setViewDeferred(sketchWidget->viewID(), false);
+	}
+	QList<long> newIDs;
+	sketchWidget->loadFromModelParts(m_deferredModelParts, BaseCommand::SingleView, NULL, false, NULL, false, newIDs);
+	if (m_sketchModel->checkForReversedWires()) {
+		sketchWidget->checkForReversedWires();
+	}
+	if (sketchWidget == m_pcbGraphicsView && m_obsoleteSMDOrientation) {
+		convertObsoleteSMDOrientation();
+	}
+
+	// pick up the selection from the view the user has been working in
+	if (m_currentGraphicsView && m_currentGraphicsView != sketchWidget) {
+		foreach (QGraphicsItem * item, m_currentGraphicsView->scene()->selectedItems()) {
+			ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
+			if (itemBase == NULL) continue;
+
+			sketchWidget->selectItem(itemBase->id(), true, false, false);
+		}
+	}
+
+	if (m_deferredViews.isEmpty()) {
+		m_deferredModelParts.clear();
+	}
+}
+
+void MainWindow::materializeViews() {
+	foreach (SketchWidget * sketchWidget, m_deferredViews) {
+		materializeView(sketchWidget);
+	}
+}
+
+void MainWindow::materializeViewsFor(const QUndoCommand * command) {
+	// edits confined to the current view (moves, for instance) can be pushed without building the others,
+	// and so can property changes, which are kept on the model parts the others will be built from.
+	// Anything else builds them first
+	if (m_deferredViews.isEmpty()) return;
+	if (!BaseCommand::reachesViews(command, m_deferredViews)) return;
+
+	materializeViews();
+}
+
 void MainWindow::copy() {
 	if (m_currentGraphicsView == NULL) return;
 	m_currentGraphicsView->copy();
@@ -485,6 +562,9 @@ void MainWindow::pasteAux(bool pasteInPlace)
 {
 	if (m_currentGraphicsView == NULL) return;
 
+	// the paste commands for each view are built against that view's scene
+	materializeViews();
+
 	QClipboard *clipboard = QApplication::clipboard();
 	if (clipboard == NULL) {
 		// shouldn't happen
@@ -3474,7 +3554,14 @@ void MainWindow::startSaveInstancesSlot(const QString & fileName, ModelPart *, Q
 		streamWriter.writeTextElement("originalFileName", m_fwFilename);
 	}
 
-	if (m_pcbGraphicsView) {
+	if (m_pcbGraphicsView && m_deferredViews.contains(m_pcbGraphicsView)) {
+		// pcb view hasn't been built, so its boards are still the ones that were loaded
+		if (m_deferredModelParts.count() > 0) {
+			QDomElement boards = m_deferredModelParts.first()->instanceDomElement().ownerDocument().documentElement().firstChildElement("boards");
+			if (!boards.isNull()) ModelPart::writeElement(streamWriter, boards);
+		}
+	}
+	else if (m_pcbGraphicsView) {
 		QList<ItemBase *> boards = m_pcbGraphicsView->findBoard();
 		if (boards.count()) {
 			streamWriter.writeStartElement("boards");
@@ -3799,6 +3886,7 @@ void MainWindow::selectAllObsolete() {
 }
 
 QList<ItemBase *> MainWindow::selectAllObsolete(bool displayFeedback) {
+	materializeView(m_pcbGraphicsView);
 	QList<ItemBase *> items = m_pcbGraphicsView->selectAllObsolete();
 	if (!displayFeedback) return items;
 
@@ -4415,6 +4503,7 @@ void MainWindow::hidePartSilkscreen()
 }
 
 void MainWindow::fabQuote() {
+	materializeView(m_pcbGraphicsView);
 	if (m_pcbGraphicsView) m_pcbGraphicsView->fabQuote();
 }
 
@@ -0,0 +1,351 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "autosavewriter.h"
+#include "../debugdialog.h"
+
+#include <QtConcurrentRun>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QElapsedTimer>
+
+const quint32 AutosaveWriter::JournalMagic = 0x465a4a4c;		// "FZJL"
+const qint32 AutosaveWriter::JournalVersion = 2;
+const int AutosaveWriter::MaxDeltas = 20;
+
+static QByteArray hashOf(const QByteArray & bytes) {
+	return QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+}
+
+static void writeRecord(QDataStream & stream, quint8 type, qint64 index, const QByteArray & payload) {
+	stream << type << index << qCompress(payload);
+}
+
+static QByteArray orderBytes(const QList<qint64> & order) {
+	QByteArray bytes;
+	QDataStream stream(&bytes, QIODevice::WriteOnly);
+	stream << order;
+	return bytes;
+}
+
+///////////////////////////////////////////////
+
+QByteArray SketchSnapshot::assemble(QList<qint64> * offsets) const {
+	QByteArray result = header;
+	result += "\n<instances>\n";
+	foreach (qint64 index, order) {
+		if (offsets) offsets->append(result.size());
+		result += instances.value(index);
+		result += "\n";
+	}
+	result += "</instances>\n</module>\n";
+	return result;
+}
+
+///////////////////////////////////////////////
+
+AutosaveWriter::AutosaveWriter(const QString & backupPath, QObject * parent) : QObject(parent),
+	m_backupPath(backupPath)
+{
+	connect(&m_watcher, SIGNAL(finished()), this, SLOT(finishedSlot()));
+}
+
+AutosaveWriter::~AutosaveWriter() {
+	m_hasPending = false;
+	m_watcher.waitForFinished();
+}
+
+QString AutosaveWriter::journalPath(const QString & backupPath) {
+	return backupPath + ".journal";
+}
+
+void AutosaveWriter::removeOrphanedJournal(const QString & path) {
+	QString suffix = journalPath("");
+	if (!path.endsWith(suffix)) return;
+
+	QString backupPath = path.left(path.length() - suffix.length());
+	if (!QFile::exists(backupPath)) {
+		QFile::remove(path);
+	}
+}
+
+bool AutosaveWriter::busy() const {
+	return m_watcher.isRunning();
+}
+
+void AutosaveWriter::waitForFinished() {
+	m_watcher.waitForFinished();
+	if (m_hasPending) {
+		// run the coalesced snapshot synchronously
+		m_hasPending = false;
+		writeAux(m_pending);
+		m_pending = SketchSnapshot();
+	}
+}
+
+void AutosaveWriter::write(const SketchSnapshot & snapshot) {
+	if (busy()) {
+		// only the latest snapshot matters
+		m_pending = snapshot;
+		m_hasPending = true;
+		return;
+	}
+
+	start(snapshot);
+}
+
+void AutosaveWriter::start(const SketchSnapshot & snapshot) {
+	m_watcher.setFuture(QtConcurrent::run(this, &AutosaveWriter::writeAux, snapshot));
+}
+
+void AutosaveWriter::finishedSlot() {
+	qint64 bytes = m_watcher.result();
+	if (bytes >= 0) {
+		emit written(m_backupPath, bytes, m_lastWasFull);
+	}
+
+	if (m_hasPending) {
+		m_hasPending = false;
+		SketchSnapshot snapshot = m_pending;
+		m_pending = SketchSnapshot();
+		start(snapshot);
+	}
+}
+
+void AutosaveWriter::discard() {
+	m_hasPending = false;
+	m_pending = SketchSnapshot();
+	m_watcher.waitForFinished();
+
+	QFile::remove(m_backupPath);
+	QFile::remove(journalPath(m_backupPath));
+	m_headerHash.clear();
+	m_order.clear();
+	m_instanceHashes.clear();
+	m_baseBytes = m_journalBytes = 0;
+	m_deltaCount = 0;
+	m_haveBase = false;
+}
+
+qint64 AutosaveWriter::writeAux(const SketchSnapshot & snapshot) {
+	QElapsedTimer elapsedTimer;
+	elapsedTimer.start();
+
+	bool full = !m_haveBase || m_deltaCount >= MaxDeltas || m_journalBytes > m_baseBytes;
+	qint64 bytes = full ? writeFull(snapshot) : appendJournal(snapshot);
+	m_lastWasFull = full;
+	if (bytes < 0) {
+		// start over with a full snapshot next time
+		m_haveBase = false;
+		return bytes;
+	}
+
+	m_headerHash = hashOf(snapshot.header);
+	m_order = snapshot.order;
+	m_instanceHashes.clear();
+	foreach (qint64 index, snapshot.order) {
+		m_instanceHashes.insert(index, hashOf(snapshot.instances.value(index)));
+	}
+
+	DebugDialog::debug(QString("autosave %1: %2 bytes %3 in %4 ms")
+	                   .arg(full ? "snapshot" : "journal")
+	                   .arg(bytes)
+	                   .arg(m_backupPath)
+	                   .arg(elapsedTimer.elapsed()));
+	return bytes;
+}
+
+qint64 AutosaveWriter::writeFull(const SketchSnapshot & snapshot) {
+	QList<qint64> offsets;
+	QByteArray xml = snapshot.assemble(&offsets);
+	QSaveFile saveFile(m_backupPath);
+	if (!saveFile.open(QIODevice::WriteOnly)) return -1;
+
+	saveFile.write(xml);
+	if (!saveFile.commit()) return -1;
+
+	// the journal restarts from the file just written: its base record only says where each instance sits in it,
+	// so the deltas that follow can be replayed on top of it.  Any older journal is replaced here.
+	QByteArray base;
+	QDataStream baseStream(&base, QIODevice::WriteOnly);
+	QList<qint64> lengths;
+	foreach (qint64 index, snapshot.order) {
+		lengths.append(snapshot.instances.value(index).size());
+	}
+	baseStream << hashOf(xml) << qint64(snapshot.header.size()) << snapshot.order << offsets << lengths;
+
+	QFile journal(journalPath(m_backupPath));
+	if (!journal.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		QFile::remove(journalPath(m_backupPath));
+		return -1;
+	}
+
+	QDataStream stream(&journal);
+	stream << JournalMagic << JournalVersion;
+	writeRecord(stream, BaseRecord, 0, base);
+	writeRecord(stream, CommitRecord, 0, QByteArray());
+	journal.close();
+	if (stream.status() != QDataStream::Ok) {
+		QFile::remove(journalPath(m_backupPath));
+		return -1;
+	}
+
+	m_baseBytes = xml.size();
+	m_journalBytes = 0;
+	m_deltaCount = 0;
+	m_haveBase = true;
+	return xml.size();
+}
+
+qint64 AutosaveWriter::appendJournal(const SketchSnapshot & snapshot) {
+	QFile journal(journalPath(m_backupPath));
+	if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) return -1;
+
+	qint64 before = journal.size();
+	QDataStream stream(&journal);
+	if (hashOf(snapshot.header) != m_headerHash) {
+		writeRecord(stream, HeaderRecord, 0, snapshot.header);
+	}
+	if (snapshot.order != m_order) {
+		writeRecord(stream, OrderRecord, 0, orderBytes(snapshot.order));
+	}
+	foreach (qint64 index, snapshot.order) {
+		const QByteArray & fragment = snapshot.instances.value(index);
+		if (m_instanceHashes.value(index) != hashOf(fragment)) {
+			writeRecord(stream, InstanceRecord, index, fragment);
+		}
+	}
+	foreach (qint64 index, m_instanceHashes.keys()) {
+		if (!snapshot.instances.contains(index)) {
+			writeRecord(stream, RemoveRecord, index, QByteArray());
+		}
+	}
+	writeRecord(stream, CommitRecord, 0, QByteArray());
+	journal.close();
+	if (stream.status() != QDataStream::Ok) return -1;
+
+	qint64 bytes = journal.size() - before;
+	m_journalBytes += bytes;
+	m_deltaCount++;
+	return bytes;
+}
+
+bool AutosaveWriter::readBase(const QString & backupPath, const QByteArray & base, SketchSnapshot & snapshot) {
+	QFile file(backupPath);
+	if (!file.open(QIODevice::ReadOnly)) return false;
+
+	QByteArray xml = file.readAll();
+	file.close();
+
+	QDataStream stream(base);
+	QByteArray hash;
+	qint64 headerSize;
+	QList<qint64> order, offsets, lengths;
+	stream >> hash >> headerSize >> order >> offsets >> lengths;
+	if (stream.status() != QDataStream::Ok) return false;
+	if (hash != hashOf(xml)) return false;
+	if (order.count() != offsets.count() || order.count() != lengths.count()) return false;
+
+	snapshot.header = xml.left(headerSize);
+	snapshot.order = order;
+	snapshot.instances.clear();
+	for (int i = 0; i < order.count(); i++) {
+		snapshot.instances.insert(order.at(i), xml.mid(offsets.at(i), lengths.at(i)));
+	}
+	return true;
+}
+
+bool AutosaveWriter::consolidate(const QString & backupPath) {
+	QFile journal(journalPath(backupPath));
+	if (!journal.exists()) return true;
+
+	if (!journal.open(QIODevice::ReadOnly)) return false;
+
+	QDataStream stream(&journal);
+	quint32 magic;
+	qint32 version;
+	stream >> magic >> version;
+	if (magic != JournalMagic || version != JournalVersion) {
+		journal.close();
+		journal.remove();
+		return false;
+	}
+
+	SketchSnapshot working, committed;
+	bool gotCommit = false;
+	while (!stream.atEnd()) {
+		quint8 type;
+		qint64 index;
+		QByteArray payload;
+		stream >> type >> index >> payload;
+		if (stream.status() != QDataStream::Ok) break;			// torn write when the app went down
+
+		QByteArray data = qUncompress(payload);
+		switch (type) {
+		case BaseRecord:
+			if (!readBase(backupPath, data, working)) {
+				// the journal was not written against this backup file
+				journal.close();
+				journal.remove();
+				return false;
+			}
+			break;
+		case HeaderRecord:
+			working.header = data;
+			break;
+		case OrderRecord: {
+			QDataStream orderStream(data);
+			working.order.clear();
+			orderStream >> working.order;
+			break;
+		}
+		case InstanceRecord:
+			working.instances.insert(index, data);
+			break;
+		case RemoveRecord:
+			working.instances.remove(index);
+			break;
+		case CommitRecord:
+			committed = working;
+			gotCommit = true;
+			break;
+		default:
+			break;
+		}
+	}
+	journal.close();
+
+	if (!gotCommit || committed.header.isEmpty()) {
+		// the backup file written with the last full snapshot is the best we have
+		journal.remove();
+		return false;
+	}
+
+	QSaveFile saveFile(backupPath);
+	if (!saveFile.open(QIODevice::WriteOnly)) return false;
+
+	saveFile.write(committed.assemble());
+	if (!saveFile.commit()) return false;
+
+	journal.remove();
+	return true;
+}
@@ -0,0 +1,108 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef AUTOSAVEWRITER_H
+#define AUTOSAVEWRITER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QFutureWatcher>
+
+// An immutable in-memory copy of a sketch: the xml up to <instances>, then one xml fragment per instance.
+// It is built on the GUI thread by ModelBase::snapshot() and can be handed to another thread.
+
+struct SketchSnapshot {
+	QByteArray header;
+	QList<qint64> order;
+	QHash<qint64, QByteArray> instances;
+
+	QByteArray assemble(QList<qint64> * offsets = nullptr) const;
+};
+
+// AutosaveWriter writes snapshots on a worker thread.  Every so often the full sketch is written to the backup file;
+// in between, only the instances that changed since the previous autosave are appended to a compressed journal
+// next to the backup file.  The journal starts with a record pointing into that backup file rather than a second
+// copy of the sketch.  consolidate() folds the journal back into the backup file before recovery.
+
+class AutosaveWriter : public QObject
+{
+	Q_OBJECT
+
+public:
+	AutosaveWriter(const QString & backupPath, QObject * parent = nullptr);
+	~AutosaveWriter();
+
+	void write(const SketchSnapshot &);
+	bool busy() const;
+	void waitForFinished();
+	void discard();
+
+public:
+	static bool consolidate(const QString & backupPath);
+	static QString journalPath(const QString & backupPath);
+	static void removeOrphanedJournal(const QString & journalPath);
+
+signals:
+	void written(const QString & backupPath, qint64 bytes, bool full);
+
+protected slots:
+	void finishedSlot();
+
+protected:
+	qint64 writeAux(const SketchSnapshot &);
+	qint64 writeFull(const SketchSnapshot &);
+	qint64 appendJournal(const SketchSnapshot &);
+	void start(const SketchSnapshot &);
+
+	static bool readBase(const QString & backupPath, const QByteArray & base, SketchSnapshot &);
+
+	enum RecordType {
+		HeaderRecord = 1,
+		OrderRecord,
+		InstanceRecord,
+		RemoveRecord,
+		CommitRecord,
+		BaseRecord
+	};
+
+protected:
+	QString m_backupPath;
+	QFutureWatcher<qint64> m_watcher;
+	SketchSnapshot m_pending;
+	bool m_hasPending = false;
+	bool m_lastWasFull = false;
+
+	// only touched by the job in flight
+	QByteArray m_headerHash;
+	QList<qint64> m_order;
+	QHash<qint64, QByteArray> m_instanceHashes;
+	qint64 m_baseBytes = 0;
+	qint64 m_journalBytes = 0;
+	int m_deltaCount = 0;
+	bool m_haveBase = false;
+
+	static const quint32 JournalMagic;
+	static const qint32 JournalVersion;
+	static const int MaxDeltas;
+};
+
+#endif
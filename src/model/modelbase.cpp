@@ -471,6 +471,10 @@ void ModelBase::save(const QString & fileName, QXmlStreamWriter & streamWriter,
 	}
 }
 
+void ModelBase::snapshot(const QString & fileName, SketchSnapshot & snapshot) {
+	m_root->snapshotInstances(fileName, snapshot);
+}
+
 bool ModelBase::paste(ModelBase * referenceModel, QByteArray & data, QList<ModelPart *> & modelParts, QHash<QString, QRectF> & boundingRects, bool preserveIndex)
 {
 	m_referenceModel = referenceModel;
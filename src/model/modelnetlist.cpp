@@ -0,0 +1,602 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "modelnetlist.h"
+#include "sketchmodel.h"
+#include "modelpart.h"
+#include "modelpartshared.h"
+#include "netlistwriter.h"
+#include "../referencemodel/referencemodel.h"
+#include "../connectors/connectorshared.h"
+#include "../connectors/busshared.h"
+#include "../items/moduleidnames.h"
+#include "../items/striplattice.h"
+#include "../items/symbolpaletteitem.h"
+#include "../utils/folderutils.h"
+#include "../utils/textutils.h"
+#include "../utils/misc.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QRegExp>
+
+// see SymbolPaletteItem
+#define VOLTAGE_HASH_CONVERSION 1000000
+#define FROMVOLTAGE(v) ((long) (v * VOLTAGE_HASH_CONVERSION))
+
+static QRegExp LabelNumber("([^\\d]+)(.*)");
+
+/////////////////////////////////////////////////////////////////////
+
+static bool isGrounded(ConnectorShared * connectorShared) {
+	// same test as ConnectorItem::isGrounded
+	const QString & name = connectorShared->sharedName();
+	return ((name.compare("gnd", Qt::CaseInsensitive) == 0) ||
+	        (name.compare("vss", Qt::CaseInsensitive) == 0) ||
+	        (name.compare("ground", Qt::CaseInsensitive) == 0)
+	       );
+}
+
+static bool byInstanceTitle(ModelPart * mp1, ModelPart * mp2) {
+	// same ordering as the bom export in MainWindow
+	bool result = mp1->instanceTitle().toLower() < mp2->instanceTitle().toLower();
+
+	int ix1 = LabelNumber.indexIn(mp1->instanceTitle());
+	if (ix1 < 0) return result;
+
+	QString label1 = LabelNumber.cap(1);
+	QString number1 = LabelNumber.cap(2);
+
+	int ix2 = LabelNumber.indexIn(mp2->instanceTitle());
+	if (ix2 < 0) return result;
+
+	QString label2 = LabelNumber.cap(1);
+	QString number2 = LabelNumber.cap(2);
+	if (label2.compare(label1, Qt::CaseInsensitive) != 0) return result;
+
+	bool ok;
+	double d1 = number1.toDouble(&ok);
+	if (!ok) return result;
+
+	double d2 = number2.toDouble(&ok);
+	if (!ok) return result;
+
+	return d1 < d2;
+}
+
+static QString csvField(const QString & s) {
+	if (!s.contains(QRegExp("[\",\\n\\r]"))) return s;
+
+	QString result = s;
+	result.replace("\"", "\"\"");
+	return "\"" + result + "\"";
+}
+
+/////////////////////////////////////////////////////////////////////
+
+ModelNetlist::ModelNetlist() : m_sketchModel(NULL)
+{
+}
+
+ModelNetlist::~ModelNetlist()
+{
+	clear();
+}
+
+void ModelNetlist::clear() {
+	m_modelParts.clear();
+	m_nodes.clear();
+	m_firstNode.clear();
+	m_parents.clear();
+	m_sizes.clear();
+	m_nodeIndex.clear();
+	if (m_sketchModel) {
+		delete m_sketchModel;
+		m_sketchModel = NULL;
+	}
+}
+
+int ModelNetlist::partCount() const {
+	return m_modelParts.count();
+}
+
+int ModelNetlist::connectorCount() const {
+	return m_nodes.count();
+}
+
+bool ModelNetlist::loadBundle(const QString & fzzPath, ReferenceModel * referenceModel, QString & error) {
+	QDir dir = QDir::temp();
+	FolderUtils::createFolderAndCdIntoIt(dir, TextUtils::getRandText());
+	QString unzipPath = dir.path();
+
+	bool result = false;
+	if (FolderUtils::unzipTo(fzzPath, unzipPath, error)) {
+		// parts that came with the sketch only need their fzp: connectors and buses are all we look at
+		QStringList filters;
+		filters << "*" + FritzingPartExtension;
+		foreach (QFileInfo fzpInfo, dir.entryInfoList(filters, QDir::Files)) {
+			QFile file(fzpInfo.absoluteFilePath());
+			if (!file.open(QFile::ReadOnly)) continue;
+
+			QString moduleID = TextUtils::parseForModuleID(file.readAll());
+			file.close();
+			if (moduleID.isEmpty()) continue;
+			if (referenceModel->retrieveModelPart(moduleID)) continue;
+
+			ModelPart * modelPart = referenceModel->loadPart(fzpInfo.absoluteFilePath(), false);
+			if (modelPart) modelPart->setFzz(true);
+		}
+
+		filters.clear();
+		filters << "*" + FritzingSketchExtension;
+		QFileInfoList sketches = dir.entryInfoList(filters, QDir::Files);
+		if (sketches.count() == 0) {
+			error = QObject::tr("No Sketch found in '%1'").arg(fzzPath);
+		}
+		else {
+			result = loadSketch(sketches.first().absoluteFilePath(), referenceModel, error);
+		}
+	}
+
+	FolderUtils::rmdir(unzipPath);
+	return result;
+}
+
+bool ModelNetlist::loadSketch(const QString & fzPath, ReferenceModel * referenceModel, QString & error) {
+	clear();
+
+	m_sketchModel = new SketchModel(true);
+	m_sketchModel->setReportMissingModules(false);
+	if (!m_sketchModel->loadFromFile(fzPath, referenceModel, m_modelParts, false)) {
+		error = QObject::tr("Unable to load '%1'").arg(fzPath);
+		clear();
+		return false;
+	}
+
+	build();
+	return true;
+}
+
+void ModelNetlist::build() {
+	addParts();
+
+	QHash<QString, int> symbolNets;
+	for (int part = 0; part < m_modelParts.count(); part++) {
+		ModelPart * modelPart = m_modelParts.at(part);
+		addConnections(part);
+
+		switch (modelPart->itemType()) {
+		case ModelPart::Wire:
+			unite(node(modelPart->modelIndex(), "connector0"), node(modelPart->modelIndex(), "connector1"));
+			break;
+		case ModelPart::Symbol:
+			addBuses(part);
+			addSymbol(part, symbolNets);
+			break;
+		default:
+			if (modelPart->moduleID().endsWith(ModuleIDNames::StripboardModuleIDName) ||
+			        modelPart->moduleID().endsWith(ModuleIDNames::Stripboard2ModuleIDName))
+			{
+				addStrips(part);
+			}
+			else {
+				addBuses(part);
+			}
+			break;
+		}
+	}
+}
+
+void ModelNetlist::addParts() {
+	int count = 0;
+	foreach (ModelPart * modelPart, m_modelParts) {
+		count += modelPart->modelPartShared()->connectorsShared().count();
+	}
+
+	m_nodes.reserve(count);
+	m_parents.reserve(count);
+	m_sizes.reserve(count);
+	m_nodeIndex.reserve(count);
+	m_firstNode.reserve(m_modelParts.count() + 1);
+
+	for (int part = 0; part < m_modelParts.count(); part++) {
+		ModelPart * modelPart = m_modelParts.at(part);
+		m_firstNode.append(m_nodes.count());
+		foreach (ConnectorShared * connectorShared, modelPart->modelPartShared()->connectorsShared()) {
+			if (connectorShared == NULL) continue;
+
+			Node n;
+			n.part = part;
+			n.connectorShared = connectorShared;
+			m_nodeIndex.insert(qMakePair(modelPart->modelIndex(), connectorShared->id()), m_nodes.count());
+			m_parents.append(m_nodes.count());
+			m_sizes.append(1);
+			m_nodes.append(n);
+		}
+	}
+	m_firstNode.append(m_nodes.count());
+}
+
+void ModelNetlist::addConnections(int part) {
+	// the connections of every view: wires drawn in one view are ratsnests in the others
+	ModelPart * modelPart = m_modelParts.at(part);
+	QDomElement views = modelPart->instanceDomElement().firstChildElement("views");
+	QDomElement view = views.firstChildElement();
+	while (!view.isNull()) {
+		QDomElement connector = view.firstChildElement("connectors").firstChildElement("connector");
+		while (!connector.isNull()) {
+			int from = node(modelPart->modelIndex(), connector.attribute("connectorId"));
+			if (from >= 0) {
+				QDomElement connect = connector.firstChildElement("connects").firstChildElement("connect");
+				while (!connect.isNull()) {
+					bool ok;
+					long modelIndex = connect.attribute("modelIndex").toLong(&ok);
+					if (ok) {
+						int to = node(modelIndex, connect.attribute("connectorId"));
+						if (to >= 0) unite(from, to);
+					}
+					connect = connect.nextSiblingElement("connect");
+				}
+			}
+			connector = connector.nextSiblingElement("connector");
+		}
+		view = view.nextSiblingElement();
+	}
+}
+
+void ModelNetlist::addBuses(int part) {
+	QHash<BusShared *, int> busNodes;
+	for (int n = m_firstNode.at(part); n < m_firstNode.at(part + 1); n++) {
+		BusShared * busShared = m_nodes.at(n).connectorShared->bus();
+		if (busShared == NULL) continue;
+
+		int first = busNodes.value(busShared, -1);
+		if (first < 0) {
+			busNodes.insert(busShared, n);
+		}
+		else {
+			unite(first, n);
+		}
+	}
+}
+
+void ModelNetlist::addStrips(int part) {
+	// mirrors Stripboard::addedToScene and Stripboard::reinitBuses
+	ModelPart * modelPart = m_modelParts.at(part);
+	int x, y;
+	if (!StripLattice::parseXY(partProperty(part, "size"), x, y)) return;
+	if (x <= 0 || y <= 0) return;
+
+	StripLattice lattice;
+	lattice.resize(x, y);
+	QVector<int> holes(x * y, -1);
+	for (int n = m_firstNode.at(part); n < m_firstNode.at(part + 1); n++) {
+		int cx, cy;
+		if (!StripLattice::parseXY(m_nodes.at(n).connectorShared->sharedName(), cx, cy)) continue;
+		if (cx >= x || cy >= y) continue;
+
+		holes[(cy * x) + cx] = n;
+	}
+
+	bool oldStyle = modelPart->moduleID().endsWith(ModuleIDNames::StripboardModuleIDName) ||
+	                !modelPart->properties().value("oldstyle", "").isEmpty();
+	QString config = modelPart->localProp("buses").toString();
+	if (config.isEmpty() || oldStyle) {
+		config += lattice.linkString(!oldStyle);
+	}
+	lattice.setCutString(config);
+
+	int groupCount = 0;
+	QVector<int> groups = lattice.groups(groupCount);
+	QVector<int> groupNodes(groupCount, -1);
+	for (int i = 0; i < groups.count(); i++) {
+		int n = holes.at(i);
+		if (n < 0) continue;
+
+		int & first = groupNodes[groups.at(i)];
+		if (first < 0) {
+			first = n;
+		}
+		else {
+			unite(first, n);
+		}
+	}
+}
+
+void ModelNetlist::addSymbol(int part, QHash<QString, int> & symbolNets) {
+	// symbols with the same net label, and power symbols with the same voltage, are connected (see SymbolPaletteItem)
+	ModelPart * modelPart = m_modelParts.at(part);
+	bool isNetLabel = modelPart->moduleID().endsWith(ModuleIDNames::NetLabelModuleIDName);
+	double voltage = 0;
+	if (!isNetLabel) {
+		isNetLabel = modelPart->moduleID().endsWith(ModuleIDNames::PowerLabelModuleIDName);
+		bool ok;
+		double temp = modelPart->localProp("voltage").toDouble(&ok);
+		if (ok) {
+			voltage = temp;
+		}
+		else {
+			modelPart->properties().value("voltage").toDouble(&ok);
+			if (ok) {
+				voltage = SymbolPaletteItem::DefaultVoltage;
+			}
+		}
+	}
+
+	for (int n = m_firstNode.at(part); n < m_firstNode.at(part + 1); n++) {
+		ConnectorShared * connectorShared = m_nodes.at(n).connectorShared;
+		QString key;
+		if (isNetLabel) {
+			key = "label " + partProperty(part, "label");
+		}
+		else if (isGrounded(connectorShared)) {
+			key = "ground";
+		}
+		else {
+			double v = (connectorShared->sharedName().compare("GND", Qt::CaseInsensitive) == 0) ? 0 : voltage;
+			key = QString("voltage %1").arg(FROMVOLTAGE(v));
+		}
+
+		int first = symbolNets.value(key, -1);
+		if (first < 0) {
+			symbolNets.insert(key, n);
+		}
+		else {
+			unite(first, n);
+		}
+	}
+}
+
+int ModelNetlist::node(long modelIndex, const QString & connectorID) const {
+	return m_nodeIndex.value(qMakePair(modelIndex, connectorID), -1);
+}
+
+int ModelNetlist::find(int n) {
+	while (m_parents.at(n) != n) {
+		m_parents[n] = m_parents.at(m_parents.at(n));		// path halving
+		n = m_parents.at(n);
+	}
+	return n;
+}
+
+void ModelNetlist::unite(int node1, int node2) {
+	if (node1 < 0 || node2 < 0) return;
+
+	int root1 = find(node1);
+	int root2 = find(node2);
+	if (root1 == root2) return;
+
+	if (m_sizes.at(root1) < m_sizes.at(root2)) qSwap(root1, root2);
+	m_parents[root2] = root1;
+	m_sizes[root1] += m_sizes.at(root2);
+}
+
+bool ModelNetlist::exported(int part, bool includeSymbols) const {
+	// the same item types ConnectorItem::collectParts keeps
+	switch (m_modelParts.at(part)->itemType()) {
+	case ModelPart::Part:
+	case ModelPart::Jumper:
+	case ModelPart::CopperFill:
+	case ModelPart::Board:
+	case ModelPart::ResizableBoard:
+	case ModelPart::Via:
+	case ModelPart::Breadboard:
+		return true;
+	case ModelPart::Symbol:
+	case ModelPart::SchematicSubpart:
+		return includeSymbols;
+	default:
+		return false;
+	}
+}
+
+QList< QList<int> > ModelNetlist::collectNets(bool includeSymbols) {
+	// nets come out in the order of their first connector, which follows the order of the sketch file
+	QList< QList<int> > nets;
+	QHash<int, int> netIndexes;
+	for (int n = 0; n < m_nodes.count(); n++) {
+		if (!exported(m_nodes.at(n).part, includeSymbols)) continue;
+
+		int root = find(n);
+		int index = netIndexes.value(root, -1);
+		if (index < 0) {
+			index = nets.count();
+			netIndexes.insert(root, index);
+			nets.append(QList<int>());
+		}
+		nets[index].append(n);
+	}
+
+	return nets;
+}
+
+QString ModelNetlist::partProperty(int part, const QString & name) const {
+	ModelPart * modelPart = m_modelParts.at(part);
+	QVariant variant = modelPart->localProp(name);
+	if (variant.isNull()) {
+		return modelPart->properties().value(name, "");
+	}
+
+	return variant.toString();
+}
+
+QString ModelNetlist::bomProperties(int part) const {
+	QStringList keys = m_modelParts.at(part)->properties().keys();
+	keys.sort();
+
+	QString pString;
+	foreach (QString key, keys) {
+		if (key.compare("family") == 0) continue;
+
+		QString value = partProperty(part, key);
+		if (value.isEmpty()) continue;
+
+		pString += key + " " + value + "; ";
+	}
+
+	if (pString.length() > 2) pString.chop(2);
+
+	return pString;
+}
+
+bool ModelNetlist::writeNetlist(QIODevice * device, const QString & sketchName) {
+	QList< QList<int> > nets = collectNets(false);
+
+	XmlNetlistWriter writer(device, sketchName);
+	foreach (QList<int> net, nets) {
+		QList<XmlNetlistWriter::Connector> connectors;
+		foreach (int n, net) {
+			const Node & netNode = m_nodes.at(n);
+			ModelPart * modelPart = m_modelParts.at(netNode.part);
+			XmlNetlistWriter::Connector connector;
+			connector.id = netNode.connectorShared->id();
+			connector.name = netNode.connectorShared->sharedName();
+			connector.partID = QString::number(modelPart->modelIndex() * ModelPart::indexMultiplier);
+			connector.partLabel = modelPart->instanceTitle();
+			connector.partTitle = modelPart->title();
+			connector.ercData = netNode.connectorShared->ercData();
+			connectors.append(connector);
+		}
+		writer.writeNet(connectors);
+	}
+
+	return writer.finish();
+}
+
+bool ModelNetlist::writeSpiceNetlist(QIODevice * device, const QString & sketchName) {
+	// spice comes from the schematic view, which counts symbols as parts
+	QList< QList<int> > nets = collectNets(true);
+
+	QList<int> parts;
+	int ground = -1;
+	for (int i = 0; i < nets.count(); i++) {
+		const QList<int> & net = nets.at(i);
+		if (net.count() < 2) continue;
+
+		foreach (int n, net) {
+			if (isGrounded(m_nodes.at(n).connectorShared)) {
+				ground = i;
+			}
+			if (!parts.contains(m_nodes.at(n).part)) parts.append(m_nodes.at(n).part);
+		}
+	}
+
+	if (ground >= 0) {
+		// make sure ground is index zero
+		nets.move(ground, 0);
+	}
+
+	QHash<int, int> netIndexes;
+	for (int i = 0; i < nets.count(); i++) {
+		foreach (int n, nets.at(i)) {
+			netIndexes.insert(n, i);
+		}
+	}
+
+	SpiceNetlistWriter writer(device, sketchName, spiceModelFolders());
+	foreach (int part, parts) {
+		ModelPart * modelPart = m_modelParts.at(part);
+		QString spice = modelPart->spice();
+		if (spice.isEmpty()) continue;
+
+		QHash<QString, int> connectorNets;
+		for (int n = m_firstNode.at(part); n < m_firstNode.at(part + 1); n++) {
+			QString id = m_nodes.at(n).connectorShared->id().toLower();
+			if (!connectorNets.contains(id)) connectorNets.insert(id, netIndexes.value(n, -1));
+		}
+
+		writer.write(SpiceNetlistWriter::expand(spice, modelPart->instanceTitle(), connectorNets, [this, part](const QString & name) {
+			return partProperty(part, name);
+		}));
+	}
+
+	writer.write("\n");
+
+	// remove redundant models
+	QStringList models;
+	foreach (int part, parts) {
+		QString spiceModel = m_modelParts.at(part)->spiceModel();
+		if (spiceModel.isEmpty()) continue;
+		if (models.contains(spiceModel, Qt::CaseInsensitive)) continue;
+
+		models.append(spiceModel);
+		writer.write(spiceModel + "\n");
+	}
+
+	return writer.finish();
+}
+
+bool ModelNetlist::writeBom(QIODevice * device) {
+	QList<ModelPart *> modelParts;
+	QHash<ModelPart *, int> partIndexes;
+	for (int part = 0; part < m_modelParts.count(); part++) {
+		ModelPart * modelPart = m_modelParts.at(part);
+		if (modelPart->itemType() != ModelPart::Part) continue;
+
+		modelParts.append(modelPart);
+		partIndexes.insert(modelPart, part);
+	}
+
+	qSort(modelParts.begin(), modelParts.end(), byInstanceTitle);
+
+	QTextStream stream(device);
+	stream.setCodec("UTF-8");
+	stream << "Label,Part Type,Properties\n";
+	foreach (ModelPart * modelPart, modelParts) {
+		stream << csvField(modelPart->instanceTitle()) << ","
+		       << csvField(modelPart->title()) << ","
+		       << csvField(bomProperties(partIndexes.value(modelPart))) << "\n";
+	}
+
+	stream.flush();
+	return stream.status() == QTextStream::Ok;
+}
+
+QList<QDir> ModelNetlist::spiceModelFolders() {
+	QList<QDir> paths;
+	paths << FolderUtils::getAppPartsSubFolder("");
+	paths << QDir(FolderUtils::getUserPartsPath());
+
+	QList<QDir> folders;
+	foreach (QDir dir, paths) {
+		foreach (QString folder, ModelPart::possibleFolders()) {
+			QDir sub(dir);
+			sub.cd(folder);
+			sub.cd("spicemodels");
+			folders << sub;
+		}
+	}
+
+	return folders;
+}
+
+QString ModelNetlist::resolveSpiceIncludes(const QString & spice) {
+	if (!spice.contains(".include", Qt::CaseInsensitive)) return spice;
+
+	QList<QDir> folders = spiceModelFolders();
+	bool include = false;
+	QString output;
+	foreach (QString line, spice.split("\n")) {
+		output += SpiceNetlistWriter::resolveInclude(line, folders, include) + "\n";
+	}
+
+	return output;
+}
@@ -0,0 +1,96 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef MODELNETLIST_H
+#define MODELNETLIST_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QDir>
+#include <QIODevice>
+
+class ModelPart;
+class ModelBase;
+class ReferenceModel;
+class SketchModel;
+class ConnectorShared;
+
+// Computes nets straight from a loaded sketch model, without constructing any views:
+// connections, wire ends, fzp buses, stripboard strips and schematic symbols are merged in one
+// union-find pass, so the cost is linear in the number of connectors and connections.
+// Used by the headless netlist service; the writers produce the same formats as the
+// corresponding MainWindow exports, streamed through XmlNetlistWriter and SpiceNetlistWriter.
+
+class ModelNetlist
+{
+public:
+	ModelNetlist();
+	~ModelNetlist();
+
+	bool loadBundle(const QString & fzzPath, ReferenceModel *, QString & error);
+	bool loadSketch(const QString & fzPath, ReferenceModel *, QString & error);
+	void clear();
+
+	int partCount() const;
+	int connectorCount() const;
+
+	bool writeNetlist(QIODevice *, const QString & sketchName);
+	bool writeSpiceNetlist(QIODevice *, const QString & sketchName);
+	bool writeBom(QIODevice *);
+
+public:
+	static QString resolveSpiceIncludes(const QString & spice);
+	static QList<QDir> spiceModelFolders();
+
+protected:
+	struct Node {
+		int part;
+		ConnectorShared * connectorShared;
+	};
+
+	void build();
+	void addParts();
+	void addConnections(int part);
+	void addBuses(int part);
+	void addStrips(int part);
+	void addSymbol(int part, QHash<QString, int> & symbolNets);
+	int node(long modelIndex, const QString & connectorID) const;
+	int find(int node);
+	void unite(int node1, int node2);
+	QList< QList<int> > collectNets(bool includeSymbols);
+	bool exported(int part, bool includeSymbols) const;
+	QString partProperty(int part, const QString & name) const;
+	QString bomProperties(int part) const;
+
+protected:
+	SketchModel * m_sketchModel;
+	QList<ModelPart *> m_modelParts;
+	QVector<Node> m_nodes;
+	QVector<int> m_firstNode;
+	QVector<int> m_parents;
+	QVector<int> m_sizes;
+	QHash<QPair<long, QString>, int> m_nodeIndex;
+};
+
+#endif
@@ -28,9 +28,11 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 #include "../items/itembase.h"
 #include "../items/partfactory.h"
+#include "autosavewriter.h"
 
 #include <QDomElement>
 #include <QBitArray>
+#include <QBuffer>
 
 long ModelPart::m_nextIndex = 0;
 const int ModelPart::indexMultiplier = 10;
@@ -192,25 +194,7 @@ ItemBase * ModelPart::viewItem(ViewLayer::ViewID viewID) {
 
 void ModelPart::saveInstances(const QString & fileName, QXmlStreamWriter & streamWriter, bool startDocument) {
 	if (startDocument) {
-		streamWriter.writeStartDocument();
-		streamWriter.writeStartElement("module");
-		streamWriter.writeAttribute("fritzingVersion", Version::versionString());
-		ModelPartSharedRoot * root = modelPartSharedRoot();
-		if (root) {
-			if (!root->icon().isEmpty()) {
-				streamWriter.writeAttribute("icon", root->icon());
-			}
-			if (!root->searchTerm().isEmpty()) {
-				streamWriter.writeAttribute("search", root->searchTerm());
-			}
-		}
-		QString title = this->title();
-		if(!title.isNull() && !title.isEmpty()) {
-			streamWriter.writeTextElement("title",title);
-		}
-
-		emit startSaveInstances(fileName, this, streamWriter);
-
+		saveInstancesStart(fileName, streamWriter);
 		streamWriter.writeStartElement("instances");
 	}
 
@@ -239,6 +223,73 @@ void ModelPart::saveInstances(const QString & fileName, QXmlStreamWriter & strea
 	}
 }
 
+void ModelPart::saveInstancesStart(const QString & fileName, QXmlStreamWriter & streamWriter) {
+	streamWriter.writeStartDocument();
+	streamWriter.writeStartElement("module");
+	streamWriter.writeAttribute("fritzingVersion", Version::versionString());
+	ModelPartSharedRoot * root = modelPartSharedRoot();
+	if (root) {
+		if (!root->icon().isEmpty()) {
+			streamWriter.writeAttribute("icon", root->icon());
+		}
+		if (!root->searchTerm().isEmpty()) {
+			streamWriter.writeAttribute("search", root->searchTerm());
+		}
+	}
+	QString title = this->title();
+	if(!title.isNull() && !title.isEmpty()) {
+		streamWriter.writeTextElement("title",title);
+	}
+
+	emit startSaveInstances(fileName, this, streamWriter);
+}
+
+void ModelPart::collectInstances(QList<ModelPart *> & modelParts) {
+	// same order as saveInstances()
+	if (parent() != nullptr) {
+		modelParts.append(this);
+	}
+
+	QList<QObject *> children = this->children();
+	if(m_orderedChildren.count() > 0) {
+		children = m_orderedChildren;
+	}
+
+	foreach (QObject * child, children) {
+		ModelPart* mp = qobject_cast<ModelPart *>(child);
+		if (mp == nullptr) continue;
+
+		mp->collectInstances(modelParts);
+	}
+}
+
+void ModelPart::snapshotInstances(const QString & fileName, SketchSnapshot & snapshot) {
+	// serializes into memory only; the snapshot is written out by AutosaveWriter on a worker thread
+	QBuffer headerBuffer(&snapshot.header);
+	headerBuffer.open(QIODevice::WriteOnly);
+	QXmlStreamWriter headerWriter(&headerBuffer);
+	headerWriter.setAutoFormatting(true);
+	saveInstancesStart(fileName, headerWriter);
+	headerWriter.writeCharacters("");			// flush the pending start tag
+	headerBuffer.close();
+
+	QList<ModelPart *> modelParts;
+	collectInstances(modelParts);
+	foreach (ModelPart * mp, modelParts) {
+		QByteArray fragment;
+		QBuffer buffer(&fragment);
+		buffer.open(QIODevice::WriteOnly);
+		QXmlStreamWriter streamWriter(&buffer);
+		streamWriter.setAutoFormatting(true);
+		mp->saveInstance(streamWriter);
+		buffer.close();
+		if (fragment.isEmpty()) continue;			// ratsnest
+
+		snapshot.order.append(mp->modelIndex());
+		snapshot.instances.insert(mp->modelIndex(), fragment);
+	}
+}
+
 void ModelPart::saveInstance(QXmlStreamWriter & streamWriter)
 {
 	if (localProp("ratsnest").toBool()) {
@@ -302,10 +353,32 @@ void ModelPart::saveInstance(QXmlStreamWriter & streamWriter)
 	foreach (ItemBase * itemBase, m_viewItems) {
 		itemBase->saveInstance(streamWriter);
 	}
+	if (m_deferredViews.count() > 0) {
+		QDomElement views = m_instanceDomElement.firstChildElement("views");
+		foreach (ViewLayer::ViewID viewID, m_deferredViews) {
+			QDomElement view = views.firstChildElement(ViewLayer::viewIDXmlName(viewID));
+			if (!view.isNull()) writeElement(streamWriter, view);
+		}
+	}
 	streamWriter.writeEndElement();		// views
 	streamWriter.writeEndElement();		//instance
 }
 
+void ModelPart::writeElement(QXmlStreamWriter & streamWriter, const QDomElement & element) {
+	streamWriter.writeStartElement(element.tagName());
+	QDomNamedNodeMap attributes = element.attributes();
+	for (int i = 0; i < attributes.count(); i++) {
+		QDomAttr attribute = attributes.item(i).toAttr();
+		streamWriter.writeAttribute(attribute.name(), attribute.value());
+	}
+	for (QDomNode node = element.firstChild(); !node.isNull(); node = node.nextSibling()) {
+		if (node.isElement()) writeElement(streamWriter, node.toElement());
+		else if (node.isCDATASection()) streamWriter.writeCDATA(node.nodeValue());
+		else if (node.isText()) streamWriter.writeCharacters(node.nodeValue());
+	}
+	streamWriter.writeEndElement();
+}
+
 void ModelPart::writeTag(QXmlStreamWriter & streamWriter, QString tagName, QString tagValue) {
 	if(!tagValue.isEmpty()) {
 		streamWriter.writeTextElement(tagName,tagValue);
@@ -507,6 +580,12 @@ const QDomElement & ModelPart::instanceDomElement() {
 	return m_instanceDomElement;
 }
 
+void ModelPart::setViewDeferred(ViewLayer::ViewID viewID, bool deferred) {
+	// a deferred view has no item for this part yet; until it does, the view is saved as it was loaded
+	m_deferredViews.removeAll(viewID);
+	if (deferred) m_deferredViews.append(viewID);
+}
+
 const QString & ModelPart::fritzingVersion() {
 
 	if (m_modelPartShared != nullptr) return m_modelPartShared->fritzingVersion();
@@ -87,6 +87,8 @@ public:
 	ModelPartSharedRoot * modelPartSharedRoot();
 	void setModelPartShared(ModelPartShared *modelPartShared);
 	void saveInstances(const QString & fileName, QXmlStreamWriter & streamWriter, bool startDocument);
+	void snapshotInstances(const QString & fileName, struct SketchSnapshot &);
+	void collectInstances(QList<ModelPart *> &);
 	void saveAsPart(QXmlStreamWriter & streamWriter, bool startDocument);
 	void addViewItem(class ItemBase *);
 	void removeViewItem(class ItemBase *);
@@ -101,6 +103,7 @@ public:
 	void setModelIndexFromMultiplied(long multipliedIndex);
 	void setInstanceDomElement(const QDomElement &);
 	const QDomElement & instanceDomElement();
+	void setViewDeferred(ViewLayer::ViewID, bool deferred);
 	Connector * getConnector(const QString & id);
 
 	const QString & fritzingVersion();
@@ -196,6 +199,7 @@ public:
 	static void updateIndex(long index);
 	static const int indexMultiplier;
 	static const QStringList & possibleFolders();
+	static void writeElement(QXmlStreamWriter & streamWriter, const QDomElement &);
 
 signals:
 	void startSaveInstances(const QString & fileName, ModelPart *, QXmlStreamWriter &);
@@ -207,6 +211,7 @@ protected:
 
 	void commonInit(ItemType type);
 	void saveInstance(QXmlStreamWriter & streamWriter);
+	void saveInstancesStart(const QString & fileName, QXmlStreamWriter & streamWriter);
 	QList< QPointer<ModelPart> > * ensureInstanceTitleIncrements(const QString & prefix);
 	void clearOldInstanceTitle(const QString & title);
 	bool setSubpartInstanceTitle();
@@ -219,7 +224,8 @@ protected:
 	QHash<QString, QPointer<Connector> > m_connectorHash;
 	QHash<QString, QPointer<Bus> > m_busHash;
 	long m_index;						// only used at save time to identify model parts in the xml
-	QDomElement m_instanceDomElement;	// only used at load time (so far)
+	QDomElement m_instanceDomElement;	// used at load time, and to save views that haven't been built since
+	QList<ViewLayer::ViewID> m_deferredViews;
 
 	LocationFlags m_locationFlags;
 	bool m_indexSynched;
@@ -0,0 +1,135 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "netlistwriter.h"
+#include "../connectors/ercdata.h"
+#include "../utils/textutils.h"
+
+#include <QDateTime>
+#include <QFile>
+
+static const QString Include(".include");
+
+/////////////////////////////////////////////////////////////////////
+
+XmlNetlistWriter::XmlNetlistWriter(QIODevice * device, const QString & sketchName) : m_streamWriter(device)
+{
+	m_streamWriter.setAutoFormatting(true);
+	m_streamWriter.writeStartDocument();
+	m_streamWriter.writeComment(" " + TextUtils::CreatedWithFritzingString + " ");
+	m_streamWriter.writeStartElement("netlist");
+	m_streamWriter.writeAttribute("sketch", sketchName);
+	m_streamWriter.writeAttribute("date", QDateTime::currentDateTime().toString());
+}
+
+void XmlNetlistWriter::writeNet(QList<Connector> net) {
+	// same 'ignore' filtering as MainWindow::exportNetlist
+	for (int i = net.count() - 1; i >= 0; i--) {
+		ErcData * ercData = net.at(i).ercData;
+		if (ercData == NULL) continue;
+
+		if (ercData->ignore() == ErcData::Always) {
+			net.removeAt(i);
+		}
+		else if ((ercData->ignore() == ErcData::IfUnconnected) && (net.count() == 1)) {
+			net.removeAt(i);
+		}
+	}
+	if (net.isEmpty()) return;
+
+	m_streamWriter.writeStartElement("net");
+	foreach (Connector connector, net) {
+		m_streamWriter.writeStartElement("connector");
+		m_streamWriter.writeAttribute("id", connector.id);
+		m_streamWriter.writeAttribute("name", connector.name);
+		m_streamWriter.writeStartElement("part");
+		m_streamWriter.writeAttribute("id", connector.partID);
+		m_streamWriter.writeAttribute("label", connector.partLabel);
+		m_streamWriter.writeAttribute("title", connector.partTitle);
+		m_streamWriter.writeEndElement();
+		if (connector.ercData) {
+			connector.ercData->writeToStream(m_streamWriter);
+		}
+		m_streamWriter.writeEndElement();
+	}
+	m_streamWriter.writeEndElement();
+}
+
+bool XmlNetlistWriter::finish() {
+	m_streamWriter.writeEndElement();
+	m_streamWriter.writeEndDocument();
+	return !m_streamWriter.hasError();
+}
+
+/////////////////////////////////////////////////////////////////////
+
+SpiceNetlistWriter::SpiceNetlistWriter(QIODevice * device, const QString & sketchName, const QList<QDir> & modelFolders)
+	: m_stream(device), m_modelFolders(modelFolders), m_include(false)
+{
+	m_stream.setCodec("UTF-8");
+	write(sketchName + "\n");
+}
+
+void SpiceNetlistWriter::write(const QString & text) {
+	// includes are resolved a whole line at a time, and a part's spice need not end its last line
+	m_pending += text;
+	int start = 0;
+	while (true) {
+		int newline = m_pending.indexOf('\n', start);
+		if (newline < 0) break;
+
+		m_stream << resolveInclude(m_pending.mid(start, newline - start), m_modelFolders, m_include) << "\n";
+		start = newline + 1;
+	}
+	m_pending.remove(0, start);
+}
+
+bool SpiceNetlistWriter::finish() {
+	// ModelNetlist::resolveSpiceIncludes ends every line once the text has an include, the last one too
+	m_stream << m_pending;
+	if (m_include) m_stream << "\n";
+	m_pending.clear();
+
+	m_stream << ".TRAN 1ms 100ms\n";
+	m_stream << "* .AC DEC 100 100 1MEG\n";
+	m_stream << ".END\n";
+	m_stream.flush();
+	return m_stream.status() == QTextStream::Ok;
+}
+
+QString SpiceNetlistWriter::resolveInclude(const QString & line, const QList<QDir> & modelFolders, bool & include) {
+	int ix = line.indexOf(Include, 0, Qt::CaseInsensitive);
+	if (ix < 0) return line;
+
+	include = true;
+	QString temp = line;
+	temp.replace(ix, Include.length(), "");
+	QString filename = temp.trimmed();
+
+	foreach (QDir dir, modelFolders) {
+		if (QFile::exists(dir.absoluteFilePath(filename))) {
+			return Include.toUpper() + " " + QDir::toNativeSeparators(dir.absoluteFilePath(filename));
+		}
+	}
+
+	// can't find the include file, so just keep the original line
+	return line;
+}
@@ -0,0 +1,118 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef NETLISTWRITER_H
+#define NETLISTWRITER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QDir>
+#include <QRegExp>
+#include <QIODevice>
+#include <QTextStream>
+#include <QXmlStreamWriter>
+
+class ErcData;
+
+// The xml and spice formats of MainWindow's netlist exports, written a net or a line at a time
+// so the headless netlist service never holds a whole file in memory. The writers know nothing
+// about models or items: ModelNetlist hands them plain connector records and spice text.
+
+class XmlNetlistWriter
+{
+public:
+	struct Connector {
+		QString id;
+		QString name;
+		QString partID;
+		QString partLabel;
+		QString partTitle;
+		ErcData * ercData;
+	};
+
+public:
+	XmlNetlistWriter(QIODevice *, const QString & sketchName);
+
+	void writeNet(QList<Connector> net);
+	bool finish();
+
+protected:
+	QXmlStreamWriter m_streamWriter;
+};
+
+class SpiceNetlistWriter
+{
+public:
+	SpiceNetlistWriter(QIODevice *, const QString & sketchName, const QList<QDir> & modelFolders);
+
+	void write(const QString & text);
+	bool finish();
+
+public:
+	static QString resolveInclude(const QString & line, const QList<QDir> & modelFolders, bool & include);
+	template <class Property>
+	static QString expand(QString spice, const QString & instanceTitle, const QHash<QString, int> & connectorNets, Property property);
+
+protected:
+	QTextStream m_stream;
+	QList<QDir> m_modelFolders;
+	QString m_pending;
+	bool m_include;
+};
+
+template <class Property>
+QString SpiceNetlistWriter::expand(QString spice, const QString & instanceTitle, const QHash<QString, int> & connectorNets, Property property)
+{
+	// connectorNets is keyed by lower case connector id; property(name) looks up a part property
+	QRegExp curlies("\\{([^\\}]*)\\}");
+	while (true) {
+		int ix = curlies.indexIn(spice);
+		if (ix < 0) break;
+
+		QString token = curlies.cap(1).toLower();
+		QString replacement;
+		if (token == "instancetitle") {
+			replacement = instanceTitle;
+			if (ix > 0 && !replacement.isEmpty() && replacement.at(0).toLower() == spice.at(ix - 1).toLower()) {
+				// if the type letter is repeated
+				replacement = replacement.mid(1);
+			}
+			replacement.replace(" ", "_");
+		}
+		else if (token.startsWith("net ")) {
+			QString cname = token.mid(4).trimmed();
+			if (connectorNets.contains(cname)) {
+				replacement = QString::number(connectorNets.value(cname));
+			}
+		}
+		else {
+			replacement = property(token);
+		}
+
+		spice.replace(ix, curlies.cap(0).count(), replacement);
+	}
+
+	return spice;
+}
+
+#endif
@@ -34,6 +34,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 #include "../items/moduleidnames.h"
 #include "../items/partfactory.h"
+#include "../utils/tracer.h"
 
 QString PaletteModel::s_fzpOverrideFolder;
 
@@ -107,6 +108,7 @@ bool PaletteModel::containsModelPart(const QString & moduleID) {
 }
 
 void PaletteModel::loadParts(bool dbExists) {
+	TraceScope trace("load part files");
 	QStringList nameFilters;
 	nameFilters << "*" + FritzingPartExtension;
 
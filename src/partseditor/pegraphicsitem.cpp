@@ -28,6 +28,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QColor>
 #include <QGraphicsScene>
 #include <QPainter>
+#include <QHash>
 
 
 static QVector<qreal> Dashes;
@@ -42,6 +43,9 @@ static const double MinMouseMove = 2;
 static const QColor NormalColor(0, 0, 255);
 static const QColor PickColor(255, 0, 255);
 
+// at most one item per scene is highlighted; tracking it saves a sweep of the scene on every hover
+static QHash<QGraphicsScene *, PEGraphicsItem *> Highlighted;
+
 
 ////////////////////////////////////////////////
 
@@ -64,6 +68,11 @@ PEGraphicsItem::PEGraphicsItem(double x, double y, double w, double h, ItemBase
 }
 
 PEGraphicsItem::~PEGraphicsItem() {
+	QMutableHashIterator<QGraphicsScene *, PEGraphicsItem *> i(Highlighted);
+	while (i.hasNext()) {
+		i.next();
+		if (i.value() == this) i.remove();
+	}
 	m_element.clear();
 }
 
@@ -148,19 +157,19 @@ void PEGraphicsItem::setHighlighted(bool highlighted) {
 	if (highlighted) {
 		m_highlighted = true;
 		setOpacity(0.4);
-		foreach (QGraphicsItem * item, scene()->items()) {
-			PEGraphicsItem * pegi = dynamic_cast<PEGraphicsItem *>(item);
-			if (pegi == NULL) continue;
-			if (pegi == this) continue;
-			if (!pegi->highlighted()) continue;
-
+		PEGraphicsItem * pegi = Highlighted.value(scene(), NULL);
+		if (pegi != NULL && pegi != this && pegi->highlighted()) {
 			pegi->setHighlighted(false);
 		}
+		Highlighted.insert(scene(), this);
 		emit highlightSignal(this);
 	}
 	else {
 		m_highlighted = false;
 		setOpacity(0.001);
+		if (Highlighted.value(scene(), NULL) == this) {
+			Highlighted.remove(scene());
+		}
 	}
 	update();
 }
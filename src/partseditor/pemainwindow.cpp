@@ -456,6 +456,7 @@ void PEMainWindow::initSketchWidgets(bool whatever)
 		viewThing->sketchWidget->setChainDrag(false);				// no bendpoints
 		viewThing->firstTime = true;
 		viewThing->everZoomed = true;
+		viewThing->sketchWidget->viewport()->installEventFilter(this);
 		connect(viewThing->sketchWidget, SIGNAL(newWireSignal(Wire *)), this, SLOT(newWireSlot(Wire *)));
 		connect(viewThing->sketchWidget, SIGNAL(showing(SketchWidget *)), this, SLOT(showing(SketchWidget *)));
 		connect(viewThing->sketchWidget, SIGNAL(itemMovedSignal(ItemBase *)), this, SLOT(itemMovedSlot(ItemBase *)));
@@ -1344,10 +1345,8 @@ void PEMainWindow::initSvgTree(SketchWidget * sketchWidget, ItemBase * itemBase,
 		}
 	}
 
-	int z = PegiZ;
-
-	FSvgRenderer tempRenderer;
-	QByteArray rendered = tempRenderer.loadSvg(tempSvgDoc.toByteArray(), "", false);
+	FSvgRenderer renderer;
+	QByteArray rendered = renderer.loadSvg(tempSvgDoc.toByteArray(), "", false);
 	// cleans up the svg
 	if (!svgDocument.setContent(rendered, true, &errorStr, &errorLine, &errorColumn)) {
 		DebugDialog::debug(QString("unable to parse svg (2): %1 %2 %3").arg(errorStr).arg(errorLine).arg(errorColumn));
@@ -1355,65 +1354,50 @@ void PEMainWindow::initSvgTree(SketchWidget * sketchWidget, ItemBase * itemBase,
 	}
 
 	TextUtils::gornTree(svgDocument);
-	FSvgRenderer renderer;
-	renderer.loadSvg(svgDocument.toByteArray(), "", false);
 
-	QHash<QString, PEGraphicsItem *> pegiHash;
-
-	QList<QDomElement> traverse;
-	traverse << svgDocument.documentElement();
-	while (traverse.count() > 0) {
-		QDomElement element = traverse.takeFirst();
-
-		// depth first
-		QList<QDomElement> next;
-		QDomElement child = element.firstChildElement();
-		while (!child.isNull()) {
-			next << child;
-			child = child.nextSiblingElement();
-		}
-		while (next.count() > 0) {
-			traverse.push_front(next.takeLast());
-		}
-
-		bool isG = false;
-		bool isSvg = false;
-		QString tagName = element.tagName();
-		if      (tagName.compare("rect") == 0);
-		else if (tagName.compare("g") == 0) {
-			isG = true;
-		}
-		else if (tagName.compare("svg") == 0) {
-			isSvg = true;
-		}
-		else if (tagName.compare("circle") == 0);
-		else if (tagName.compare("ellipse") == 0);
-		else if (tagName.compare("path") == 0);
-		else if (tagName.compare("line") == 0);
-		else if (tagName.compare("polyline") == 0);
-		else if (tagName.compare("polygon") == 0);
-		else if (tagName.compare("text") == 0);
-		else continue;
-
-		QRectF bounds = getPixelBounds(renderer, element);
-		// known Qt bug: boundsOnElement returns zero width and height for text elements.
-		if (bounds.width() > 0 && bounds.height() > 0) {
-			PEGraphicsItem * pegi = makePegi(bounds.size(), bounds.topLeft(), itemBase, element, z++);
-			pegiHash.insert(element.attribute("id"), pegi);
-
-			/*
-			QString string;
-			QTextStream stream(&string);
-			element.save(stream, 0);
-			DebugDialog::debug("........");
-			DebugDialog::debug(string);
-			*/
-		}
-	}
+	// bounds for every element in one pass, rather than a renderer lookup apiece;
+	// gornTree doesn't change the geometry, so the first load supplies the size and viewBox
+	ViewThing * viewThing = m_viewThings.value(sketchWidget->viewID());
+	QSizeF defaultSizeF = renderer.defaultSizeF();
+	QRectF viewBox = renderer.viewBoxF();
+	SvgElementIndex & elementIndex = viewThing->elementIndex;
+	elementIndex.build(svgDocument.documentElement(), defaultSizeF.width() / viewBox.width(), defaultSizeF.height() / viewBox.height());
+	viewThing->pegiShift = QPointF(0, 0);
 
+	QSet<QString> candidateIDs;
 	QDomElement root = m_fzpDocument.documentElement();
 	QDomElement connectors = root.firstChildElement("connectors");
 	QDomElement connector = connectors.firstChildElement("connector");
+	while (!connector.isNull()) {
+		QString svgID, terminalID;
+		if (ViewLayer::getConnectorSvgIDs(connector, sketchWidget->viewID(), svgID, terminalID)) {
+			candidateIDs << svgID;
+			if (!terminalID.isEmpty()) candidateIDs << terminalID;
+		}
+		connector = connector.nextSiblingElement("connector");
+	}
+
+	// with tens of thousands of elements, a PEGraphicsItem apiece takes minutes, so only connectors
+	// (assigned, or named like one) get theirs now; the rest are made under the cursor (see makePegisAt)
+	QHash<QString, PEGraphicsItem *> pegiHash;
+	for (int i = 0; i < elementIndex.count(); i++) {
+		QDomElement element = elementIndex.entry(i).element;
+		QString oldid = element.attribute("oldid");
+		if (!oldid.isEmpty()) {
+			element.setAttribute("id", oldid);
+			element.removeAttribute("oldid");
+		}
+
+		QRectF bounds = elementIndex.entry(i).bounds;
+		if (bounds.width() <= 0 || bounds.height() <= 0) continue;
+
+		QString id = element.attribute("id");
+		if (!candidateIDs.contains(id) && !id.startsWith("connector")) continue;
+
+		pegiHash.insert(id, makeIndexedPegi(viewThing, i));
+	}
+
+	connector = connectors.firstChildElement("connector");
 	while (!connector.isNull()) {
 		QString svgID, terminalID;
 		bool ok = ViewLayer::getConnectorSvgIDs(connector, sketchWidget->viewID(), svgID, terminalID);
@@ -1892,6 +1876,7 @@ void PEMainWindow::busModeChanged(bool state) {
 		// items on pegiList no longer exist after reload so get them now
 		pegiList = getPegiList(viewThing->sketchWidget);
 		viewThing->sketchWidget->hideConnectors(true);
+		viewThing->busMode = true;
 		foreach (PEGraphicsItem * pegi, pegiList) {
 			pegi->setVisible(false);
 		}
@@ -2613,25 +2598,37 @@ PEGraphicsItem * PEMainWindow::makePegi(QSizeF size, QPointF topLeft, ItemBase *
 	return pegiItem;
 }
 
-QRectF PEMainWindow::getPixelBounds(FSvgRenderer & renderer, QDomElement & element)
+PEGraphicsItem * PEMainWindow::makeIndexedPegi(ViewThing * viewThing, int index)
 {
-	QSizeF defaultSizeF = renderer.defaultSizeF();
-	QRectF viewBox = renderer.viewBoxF();
+	SvgElementIndex::Entry & entry = viewThing->elementIndex.entry(index);
+	entry.materialized = true;
 
-	QString id = element.attribute("id");
-	QRectF r = renderer.boundsOnElement(id);
-	QMatrix matrix = renderer.matrixForElement(id);
-	QString oldid = element.attribute("oldid");
-	if (!oldid.isEmpty()) {
-		element.setAttribute("id", oldid);
-		element.removeAttribute("oldid");
+	// z follows document order, whenever the item happens to be made
+	PEGraphicsItem * pegi = makePegi(entry.bounds.size(), entry.bounds.topLeft(), viewThing->itemBase, entry.element, PegiZ + index);
+	// match the offset showing() gave the items made up front
+	pegi->setOffset(pegi->offset() + viewThing->pegiShift);
+	if (m_inPickMode && viewThing->sketchWidget == m_currentGraphicsView) {
+		pegi->setPickAppearance(true);
+	}
+	return pegi;
+}
+
+void PEMainWindow::makePegisAt(QObject * viewport, const QPoint & pos)
+{
+	foreach (ViewThing * viewThing, m_viewThings.values()) {
+		if (viewThing->sketchWidget == nullptr) continue;
+		if (viewThing->sketchWidget->viewport() != viewport) continue;
+		if (viewThing->itemBase == nullptr) return;
+		if (viewThing->busMode) return;			// pegis stay hidden
+
+		QPointF local = viewThing->sketchWidget->mapToScene(pos) - viewThing->itemBase->pos();
+		foreach (int index, viewThing->elementIndex.entriesAt(local)) {
+			if (viewThing->elementIndex.entry(index).materialized) continue;
+
+			makeIndexedPegi(viewThing, index);
+		}
+		return;
 	}
-	QRectF bounds = matrix.mapRect(r);
-	bounds.setRect(bounds.x() * defaultSizeF.width() / viewBox.width(),
-	               bounds.y() * defaultSizeF.height() / viewBox.height(),
-	               bounds.width() * defaultSizeF.width() / viewBox.width(),
-	               bounds.height() * defaultSizeF.height() / viewBox.height());
-	return bounds;
 }
 
 bool PEMainWindow::canSave() {
@@ -2757,6 +2754,8 @@ void PEMainWindow::killPegi() {
 			PEGraphicsItem * pegi = dynamic_cast<PEGraphicsItem *>(item);
 			if (pegi) delete pegi;
 		}
+
+		viewThing->elementIndex.clear();
 	}
 }
 
@@ -3248,6 +3247,19 @@ bool PEMainWindow::event(QEvent * e) {
 
 bool PEMainWindow::eventFilter(QObject *object, QEvent *event)
 {
+	// before the view hands the event to the scene, so the new items get the hover or the wheel
+	switch (event->type()) {
+	case QEvent::MouseMove:
+	case QEvent::MouseButtonPress:
+		makePegisAt(object, static_cast<QMouseEvent *>(event)->pos());
+		break;
+	case QEvent::Wheel:
+		makePegisAt(object, static_cast<QWheelEvent *>(event)->pos());
+		break;
+	default:
+		break;
+	}
+
 	if (m_inPickMode) {
 		switch (event->type()) {
 		case QEvent::MouseButtonPress:
@@ -3810,6 +3822,7 @@ void PEMainWindow::showing(SketchWidget * sketchWidget) {
 				pegi->setPos(pegi->pos() + offset);
 				pegi->setOffset(pegi->offset() + offset);
 			}
+			viewThing->pegiShift += offset;
 		}
 	}
 }
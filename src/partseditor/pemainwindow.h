@@ -26,6 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../mainwindow/mainwindow.h"
 #include "../model/modelpartshared.h"
 #include "../sketch/sketchwidget.h"
+#include "../svg/svgelementindex.h"
 #include "peconnectorsview.h"
 
 class IconSketchWidget : public SketchWidget
@@ -48,6 +49,8 @@ struct ViewThing {
 	QString originalSvgPath;
 	bool firstTime = false;
 	bool busMode = false;
+	SvgElementIndex elementIndex;		// PEGraphicsItems are only made as needed from here
+	QPointF pegiShift;
 };
 
 class ReferenceModel;
@@ -157,7 +160,8 @@ protected:
 	void showInOS(QWidget *parent, const QString &pathIn);
 	void switchedConnector(int, SketchWidget *);
 	PEGraphicsItem * makePegi(QSizeF size, QPointF topLeft, ItemBase * itemBase, QDomElement & element, double z);
-	QRectF getPixelBounds(FSvgRenderer & renderer, QDomElement & element);
+	PEGraphicsItem * makeIndexedPegi(ViewThing *, int index);
+	void makePegisAt(QObject * viewport, const QPoint & pos);
 	bool canSave();
 	bool saveAs(bool overWrite);
 	void setBeforeClosingText(const QString & filename, QMessageBox & messageBox);
@@ -23,13 +23,6 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "../debugdialog.h"
 
-#include <QRegExp>
-#include <stdlib.h>
-
-#define STRINGOFFSET 10
-#define COMMENTOFFSET 100
-static const QChar CEscapeChar('\\');
-
 QHash <QString, QTextCharFormat *> Highlighter::m_styleFormats;
 
 Highlighter::Highlighter(QTextEdit * textEdit) : QSyntaxHighlighter(textEdit)
@@ -37,6 +30,11 @@ Highlighter::Highlighter(QTextEdit * textEdit) : QSyntaxHighlighter(textEdit)
 	m_syntaxer = NULL;
 }
 
+Highlighter::Highlighter(QTextDocument * textDocument) : QSyntaxHighlighter(textDocument)
+{
+	m_syntaxer = NULL;
+}
+
 Highlighter::~Highlighter()
 {
 }
@@ -87,6 +85,14 @@ void Highlighter::loadStyles(const QString & filename) {
 
 void Highlighter::setSyntaxer(Syntaxer * syntaxer) {
 	m_syntaxer = syntaxer;
+
+	// resolve list -> style once, rather than for every keyword in every block
+	m_listFormats.clear();
+	if (syntaxer) {
+		foreach (QString list, syntaxer->listNames()) {
+			m_listFormats.append(m_styleFormats.value(Syntaxer::formatFromList(list), NULL));
+		}
+	}
 }
 
 Syntaxer * Highlighter::syntaxer() {
@@ -97,121 +103,22 @@ void Highlighter::highlightBlock(const QString &text)
 {
 	if (!m_syntaxer) return;
 
-	if (text.isEmpty()) {
-		setCurrentBlockState(previousBlockState());
-		return;
-	}
-
-	setCurrentBlockState(0);
-	int startCommentIndex = -1;
-	int startStringIndex = -1;
-	const CommentInfo * currentCommentInfo = NULL;
-	int pbs = previousBlockState();
-	if (pbs <= 0) {
-		m_syntaxer->matchCommentStart(text, 0, startCommentIndex, currentCommentInfo);
-	}
-	else if (pbs >= COMMENTOFFSET) {
-		currentCommentInfo = m_syntaxer->getCommentInfo(previousBlockState() - COMMENTOFFSET);
-		startCommentIndex = 0;
-	}
-	else if (pbs == STRINGOFFSET) {
-		startStringIndex = 0;
-	}
-
-	QString noComment = text;
-
-	while (startCommentIndex >= 0) {
-		int endIndex = currentCommentInfo->m_multiLine ? text.indexOf(currentCommentInfo->m_end, startCommentIndex, currentCommentInfo->m_caseSensitive) : text.length();
-		int commentLength;
-		if (endIndex == -1) {
-			setCurrentBlockState(currentCommentInfo->m_index + COMMENTOFFSET);
-			commentLength = text.length() - startCommentIndex;
-		}
-		else {
-			commentLength = endIndex - startCommentIndex + currentCommentInfo->m_end.length();
+	setCurrentBlockState(m_syntaxer->highlight(text, previousBlockState(), m_spans));
+	foreach (const SyntaxSpan & span, m_spans) {
+		QTextCharFormat * tcf = spanFormat(span);
+		if (tcf) {
+			setFormat(span.start, span.length, *tcf);
 		}
-		noComment.replace(startCommentIndex, commentLength, QString(commentLength, ' '));
-		QTextCharFormat * cf = m_styleFormats.value("Comment", NULL);
-		if (cf) {
-			setFormat(startCommentIndex, commentLength, *cf);
-		}
-		m_syntaxer->matchCommentStart(text, startCommentIndex + commentLength, startCommentIndex, currentCommentInfo);
 	}
-
-	highlightStrings(startStringIndex, noComment);
-	highlightTerms(noComment);
 }
 
-void Highlighter::highlightStrings(int startStringIndex, QString & text) {
-	if (startStringIndex < 0) {
-		startStringIndex = m_syntaxer->matchStringStart(text, 0);
+QTextCharFormat * Highlighter::spanFormat(const SyntaxSpan & span) {
+	switch (span.list) {
+	case Syntaxer::CommentSpan:
+		return m_styleFormats.value("Comment", NULL);
+	case Syntaxer::StringSpan:
+		return m_styleFormats.value("String", NULL);
+	default:
+		return m_listFormats.value(span.list, NULL);
 	}
-
-	// TODO: not handling "" as a way to escape-quote
-	while (startStringIndex >= 0) {
-		int endIndex = -1;
-		int ssi = startStringIndex;
-		while (true) {
-			endIndex = m_syntaxer->matchStringEnd(text, ssi + 1);
-			if (!m_syntaxer->hlCStringChar()) {
-				// only some languages use \ to escape
-				break;
-			}
-
-			if (endIndex == -1) {
-				break;
-			}
-
-			// TODO: escape char is backslash only; are there others in other compilers?
-			if (text.at(endIndex - 1) != CEscapeChar) {
-				break;
-			}
-			ssi = endIndex;
-		}
-		int stringLength;
-		if (endIndex == -1) {
-			setCurrentBlockState(STRINGOFFSET);
-			stringLength = text.length() - startStringIndex;
-		}
-		else {
-			stringLength = endIndex - startStringIndex + 1;
-		}
-		text.replace(startStringIndex, stringLength, QString(stringLength, ' '));
-		QTextCharFormat * sf = m_styleFormats.value("String", NULL);
-		if (sf) {
-			setFormat(startStringIndex, stringLength, *sf);
-		}
-		startStringIndex = m_syntaxer->matchStringStart(text, startStringIndex + stringLength);
-	}
-}
-
-void Highlighter::highlightTerms(const QString & text) {
-	int lastWordBreak = 0;
-	int textLength = text.length();
-	int b;
-	while (lastWordBreak < textLength) {
-		for (b = lastWordBreak; b < textLength; b++) {
-			if (!isWordChar(text.at(b))) break;
-		}
-
-		if (b > lastWordBreak) {
-			TrieLeaf * leaf = NULL;
-			if (m_syntaxer->matches(text.mid(lastWordBreak, b - lastWordBreak), leaf)) {
-				SyntaxerTrieLeaf * stl = dynamic_cast<SyntaxerTrieLeaf *>(leaf);
-				if (stl) {
-					QString format = Syntaxer::formatFromList(stl->name());
-					QTextCharFormat * tcf = m_styleFormats.value(format, NULL);
-					if (tcf) {
-						setFormat(lastWordBreak, b - lastWordBreak, *tcf);
-					}
-				}
-			}
-		}
-
-		lastWordBreak = b + 1;
-	}
-}
-
-bool Highlighter::isWordChar(QChar c) {
-	return c.isLetterOrNumber() || c == '#' || c == '_';
 }
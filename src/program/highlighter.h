@@ -27,6 +27,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QPointer>
 #include <QString>
 #include <QChar>
+#include <QVector>
+
+#include "syntaxer.h"
 
 class Highlighter : public QSyntaxHighlighter
 {
@@ -34,6 +37,7 @@ class Highlighter : public QSyntaxHighlighter
 
 public:
 	Highlighter(QTextEdit * parent);
+	Highlighter(QTextDocument * parent);
 	~Highlighter();
 
 	void setSyntaxer(class Syntaxer *);
@@ -44,12 +48,12 @@ public:
 
 protected:
 	void highlightBlock(const QString & text);
-	bool isWordChar(QChar c);
-	void highlightTerms(const QString & text);
-	void highlightStrings(int startStringIndex, QString & text);
+	QTextCharFormat * spanFormat(const SyntaxSpan &);
 
 protected:
 	QPointer<class Syntaxer> m_syntaxer;
+	QVector<QTextCharFormat *> m_listFormats;
+	QVector<SyntaxSpan> m_spans;
 
 	static QHash<QString, QTextCharFormat *> m_styleFormats;
 };
@@ -0,0 +1,123 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "keywordtable.h"
+
+#include <string.h>
+#include <limits.h>
+
+KeywordTable::KeywordTable()
+{
+	clear();
+}
+
+void KeywordTable::clear() {
+	m_slots.clear();
+	m_words.clear();
+	m_hashes.clear();
+	m_values.clear();
+	m_mask = 0;
+	m_minLength = INT_MAX;
+	m_maxLength = 0;
+}
+
+int KeywordTable::count() const {
+	return m_words.count();
+}
+
+uint KeywordTable::hash(const QChar * word, int length) {
+	// FNV-1a over the utf-16 code units
+	uint h = 2166136261u;
+	for (int i = 0; i < length; i++) {
+		h ^= word[i].unicode();
+		h *= 16777619u;
+	}
+	return h;
+}
+
+void KeywordTable::insert(const QString & word, int value) {
+	if (word.isEmpty()) return;
+
+	int existing = -1;
+	uint h = hash(word.constData(), word.length());
+	if (!m_slots.isEmpty()) {
+		for (uint s = h & m_mask; m_slots.at(s) >= 0; s = (s + 1) & m_mask) {
+			int ix = m_slots.at(s);
+			if (m_hashes.at(ix) == h && m_words.at(ix) == word) {
+				existing = ix;
+				break;
+			}
+		}
+	}
+
+	if (existing >= 0) {
+		m_values[existing] = value;
+		return;
+	}
+
+	m_words.append(word);
+	m_hashes.append(h);
+	m_values.append(value);
+	m_minLength = qMin(m_minLength, word.length());
+	m_maxLength = qMax(m_maxLength, word.length());
+
+	// keep the table at most half full so probe chains stay short
+	if (m_words.count() * 2 > m_slots.count()) {
+		rehash(qMax(64, m_slots.count() * 2));
+		return;
+	}
+
+	uint s = h & m_mask;
+	while (m_slots.at(s) >= 0) s = (s + 1) & m_mask;
+	m_slots[s] = m_words.count() - 1;
+}
+
+void KeywordTable::rehash(int capacity) {
+	m_slots.fill(-1, capacity);
+	m_mask = capacity - 1;
+	for (int ix = 0; ix < m_words.count(); ix++) {
+		uint s = m_hashes.at(ix) & m_mask;
+		while (m_slots.at(s) >= 0) s = (s + 1) & m_mask;
+		m_slots[s] = ix;
+	}
+}
+
+int KeywordTable::value(const QChar * word, int length) const {
+	if (length < m_minLength || length > m_maxLength) return -1;
+
+	uint h = hash(word, length);
+	for (uint s = h & m_mask; m_slots.at(s) >= 0; s = (s + 1) & m_mask) {
+		int ix = m_slots.at(s);
+		if (m_hashes.at(ix) != h) continue;
+
+		const QString & candidate = m_words.at(ix);
+		if (candidate.length() != length) continue;
+		if (memcmp(candidate.constData(), word, length * sizeof(QChar)) != 0) continue;
+
+		return m_values.at(ix);
+	}
+
+	return -1;
+}
+
+int KeywordTable::value(const QString & word) const {
+	return value(word.constData(), word.length());
+}
@@ -0,0 +1,57 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef KEYWORDTABLE_H_
+#define KEYWORDTABLE_H_
+
+#include <QString>
+#include <QVector>
+
+// Maps the keywords of a syntax file to small integers (the index of their list).
+// Built once when the syntax is loaded; a lookup hashes the word in place and probes an
+// open-addressed table, so no substrings are made while scanning a block.
+
+class KeywordTable
+{
+public:
+	KeywordTable();
+
+	void clear();
+	void insert(const QString & word, int value);		// a word inserted twice keeps the later value
+	int value(const QChar * word, int length) const;	// -1 if not a keyword
+	int value(const QString & word) const;
+	int count() const;
+
+protected:
+	static uint hash(const QChar * word, int length);
+	void rehash(int capacity);
+
+protected:
+	QVector<int> m_slots;				// index into m_words, or -1
+	QVector<QString> m_words;
+	QVector<uint> m_hashes;
+	QVector<int> m_values;
+	uint m_mask;
+	int m_minLength;
+	int m_maxLength;
+};
+
+#endif /* KEYWORDTABLE_H_ */
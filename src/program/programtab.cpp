@@ -399,8 +399,11 @@ void ProgramTab::setPlatform(Platform * newPlatform, bool updateLink) {
 	m_platform = newPlatform;
 	m_platformComboBox->setCurrentIndex(m_platformComboBox->findText(newPlatform->getName()));
 	Syntaxer * syntaxer = m_platform->getSyntaxer();
-	m_highlighter->setSyntaxer(syntaxer);
-	m_highlighter->rehighlight();
+	if (syntaxer != m_highlighter->syntaxer()) {
+		// a full pass over the document: only when the language really changes
+		m_highlighter->setSyntaxer(syntaxer);
+		m_highlighter->rehighlight();
+	}
 	updateMenu();
 	QSettings settings;
 	settings.setValue("programwindow/platform", newPlatform->getName());
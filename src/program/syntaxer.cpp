@@ -19,22 +19,23 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 ********************************************************************/
 
 #include "syntaxer.h"
-#include "../debugdialog.h"
 #include "../utils/textutils.h"
 
 #include <QRegExp>
 #include <QXmlStreamReader>
 
+// block states, as seen by QSyntaxHighlighter: 0 for a block that ends in normal text
+static const int StringOffset = 10;
+static const int CommentOffset = 100;
+static const QChar CEscapeChar('\\');
+
 QHash<QString, QString> Syntaxer::m_listsToFormats;
 
 Syntaxer::Syntaxer() : QObject() {
-	m_trieRoot = NULL;
 }
 
 Syntaxer::~Syntaxer() {
-	if (m_trieRoot) {
-		delete m_trieRoot;
-	}
+	qDeleteAll(m_commentInfo);
 }
 
 bool Syntaxer::loadSyntax(const QString &filename)
@@ -96,7 +97,8 @@ bool Syntaxer::loadSyntax(const QString &filename)
 		m_extensionString += ")";
 	}
 
-	m_trieRoot = new TrieNode('\0');
+	m_keywords.clear();
+	m_listNames.clear();
 
 	QDomElement list = highlighting.firstChildElement("list");
 	while (!list.isNull()) {
@@ -112,6 +114,14 @@ bool Syntaxer::loadSyntax(const QString &filename)
 			CommentInfo * commentInfo = new CommentInfo(comment.attribute("start"), comment.attribute("end"), caseSensitivity);
 			commentInfo->m_index = m_commentInfo.count();
 			m_commentInfo.append(commentInfo);
+			if (!commentInfo->m_start.isEmpty()) {
+				QChar c = commentInfo->m_start.at(0);
+				m_commentStartChars.append(c);
+				if (caseSensitivity == Qt::CaseInsensitive) {
+					m_commentStartChars.append(c.toLower());
+					m_commentStartChars.append(c.toUpper());
+				}
+			}
 			comment = comment.nextSiblingElement("comment");
 		}
 	}
@@ -142,51 +152,138 @@ QString Syntaxer::parseForName(const QString & filename)
 }
 
 void Syntaxer::loadList(QDomElement & list) {
-	QString name = list.attribute("name");
-	SyntaxerTrieLeaf * stf = new SyntaxerTrieLeaf(name);
+	int listIndex = m_listNames.count();
+	m_listNames.append(list.attribute("name"));
 	QDomElement item = list.firstChildElement("item");
 	while (!item.isNull()) {
 		QString text;
 		if (TextUtils::findText(item, text)) {
-			QString s = text.trimmed();
-			m_trieRoot->addString(s, false, stf);
+			m_keywords.insert(text.trimmed(), listIndex);
 		}
 		item = item.nextSiblingElement("item");
 	}
 }
 
-bool Syntaxer::matches(const QString & string, TrieLeaf * & leaf) {
-	if (m_trieRoot == NULL) return false;
+int Syntaxer::keywordList(const QString & word) const {
+	return m_keywords.value(word);
+}
 
-	QString temp = string;
-	return m_trieRoot->matches(temp, leaf);
+const QStringList & Syntaxer::listNames() const {
+	return m_listNames;
 }
 
-const CommentInfo * Syntaxer::getCommentInfo(int ix) {
-	return m_commentInfo.at(ix);
+int Syntaxer::highlight(const QString & text, int previousState, QVector<SyntaxSpan> & spans) const {
+	// one pass over the block; the returned state only depends on the text and previousState,
+	// so QSyntaxHighlighter stops rehighlighting at the first block whose state is unchanged
+	spans.clear();
+	if (text.isEmpty()) return previousState;
+
+	int state = 0;
+	int i = 0;
+	if (previousState >= CommentOffset && previousState - CommentOffset < m_commentInfo.count()) {
+		i = endComment(text, 0, 0, m_commentInfo.at(previousState - CommentOffset), spans, state);
+	}
+	else if (previousState == StringOffset) {
+		i = endString(text, 0, 0, spans, state);
+	}
+
+	const QChar * data = text.constData();
+	int length = text.length();
+	while (i < length) {
+		QChar c = data[i];
+		if (m_commentStartChars.contains(c)) {
+			const CommentInfo * commentInfo = commentStartAt(text, i);
+			if (commentInfo) {
+				i = endComment(text, i, i + commentInfo->m_start.length(), commentInfo, spans, state);
+				continue;
+			}
+		}
+
+		if (!m_stringDelimiter.isNull() && c == m_stringDelimiter) {
+			i = endString(text, i, i + 1, spans, state);
+			continue;
+		}
+
+		if (!isWordChar(c)) {
+			i++;
+			continue;
+		}
+
+		int start = i++;
+		while (i < length && isWordChar(data[i])) {
+			// comments start anywhere, even inside a word
+			if (m_commentStartChars.contains(data[i]) && commentStartAt(text, i)) break;
+			i++;
+		}
+
+		int list = m_keywords.value(data + start, i - start);
+		if (list >= 0) {
+			SyntaxSpan span = { start, i - start, list };
+			spans.append(span);
+		}
+	}
+
+	return state;
 }
 
-bool Syntaxer::matchCommentStart(const QString & text, int offset, int & result, const CommentInfo * & resultCommentInfo) {
-	result = -1;
+const CommentInfo * Syntaxer::commentStartAt(const QString & text, int offset) const {
 	foreach (CommentInfo * commentInfo, m_commentInfo) {
-		int si = text.indexOf(commentInfo->m_start, offset, commentInfo->m_caseSensitive);
-		if (si >= 0 && (result < 0 || si < result)) {
-			result = si;
-			resultCommentInfo = commentInfo;
+		if (commentInfo->m_start.isEmpty()) continue;
+
+		if (text.midRef(offset, commentInfo->m_start.length()).compare(commentInfo->m_start, commentInfo->m_caseSensitive) == 0) {
+			return commentInfo;
 		}
 	}
 
-	return (result >= offset);
+	return NULL;
 }
 
-int Syntaxer::matchStringStart(const QString & text, int offset) {
-	if (m_stringDelimiter.isNull()) return -1;
+int Syntaxer::endComment(const QString & text, int start, int from, const CommentInfo * commentInfo, QVector<SyntaxSpan> & spans, int & state) const {
+	int end = text.length();
+	if (commentInfo->m_multiLine) {
+		int ix = text.indexOf(commentInfo->m_end, from, commentInfo->m_caseSensitive);
+		if (ix < 0) {
+			state = commentInfo->m_index + CommentOffset;
+		}
+		else {
+			end = ix + commentInfo->m_end.length();
+		}
+	}
+
+	SyntaxSpan span = { start, end - start, CommentSpan };
+	spans.append(span);
+	return end;
+}
+
+int Syntaxer::endString(const QString & text, int start, int from, QVector<SyntaxSpan> & spans, int & state) const {
+	// TODO: not handling "" as a way to escape-quote
+	const QChar * data = text.constData();
+	int length = text.length();
+	int end = -1;
+	for (int i = from; i < length; i++) {
+		if (m_hlCStringChar && data[i] == CEscapeChar) {
+			// only some languages use \ to escape
+			i++;
+			continue;
+		}
+		if (data[i] == m_stringDelimiter) {
+			end = i + 1;
+			break;
+		}
+	}
+
+	if (end < 0) {
+		state = StringOffset;
+		end = length;
+	}
 
-	return text.indexOf(m_stringDelimiter, offset);
+	SyntaxSpan span = { start, end - start, StringSpan };
+	spans.append(span);
+	return end;
 }
 
-int Syntaxer::matchStringEnd(const QString & text, int offset) {
-	return matchStringStart(text, offset);
+bool Syntaxer::isWordChar(QChar c) {
+	return c.isLetterOrNumber() || c == '#' || c == '_';
 }
 
 const QStringList & Syntaxer::extensions() {
@@ -239,21 +336,6 @@ bool Syntaxer::canProgram() {
 }
 
 
-//////////////////////////////////////////////
-
-SyntaxerTrieLeaf::SyntaxerTrieLeaf(QString name) {
-	m_name = name;
-}
-
-SyntaxerTrieLeaf::~SyntaxerTrieLeaf()
-{
-}
-
-const QString & SyntaxerTrieLeaf::name()
-{
-	return m_name;
-}
-
 //////////////////////////////////////////////
 
 CommentInfo::CommentInfo(const QString & start, const QString & end, Qt::CaseSensitivity caseSensitive) {
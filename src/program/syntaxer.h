@@ -26,8 +26,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QHash>
 #include <QStringList>
+#include <QVector>
 
-#include "trienode.h"
+#include "keywordtable.h"
 
 class CommentInfo
 {
@@ -42,21 +43,32 @@ public:
 	Qt::CaseSensitivity m_caseSensitive;
 };
 
+struct SyntaxSpan
+{
+	int start;
+	int length;
+	int list;		// index of the keyword list, or Syntaxer::StringSpan, Syntaxer::CommentSpan
+};
+
 class Syntaxer : public QObject
 {
 	Q_OBJECT
 
 
+public:
+	enum SpanType {
+		StringSpan = -1,
+		CommentSpan = -2
+	};
+
 public:
 	Syntaxer();
 	virtual ~Syntaxer();
 
 	bool loadSyntax(const QString & filename);
-	bool matches(const QString & string, TrieLeaf * & leaf);
-	const CommentInfo * getCommentInfo(int ix);
-	bool matchCommentStart(const QString & text, int offset, int & result, const CommentInfo * & resultCommentInfo);
-	int matchStringStart(const QString & text, int offset);
-	int matchStringEnd(const QString & text, int offset);
+	int keywordList(const QString & word) const;
+	const QStringList & listNames() const;
+	int highlight(const QString & text, int previousState, QVector<SyntaxSpan> & spans) const;
 	const QString & extensionString();
 	const QStringList & extensions();
 	bool hlCStringChar();
@@ -65,9 +77,13 @@ public:
 public:
 	static QString parseForName(const QString & filename);
 	static QString formatFromList(const QString & list);
+	static bool isWordChar(QChar c);
 
 protected:
 	void loadList(QDomElement & list);
+	const CommentInfo * commentStartAt(const QString & text, int offset) const;
+	int endComment(const QString & text, int start, int from, const CommentInfo *, QVector<SyntaxSpan> & spans, int & state) const;
+	int endString(const QString & text, int start, int from, QVector<SyntaxSpan> & spans, int & state) const;
 	QChar getStringDelimiter(QDomElement & context);
 	void initListsToFormats(QDomElement & context);
 
@@ -75,26 +91,16 @@ protected:
 	static QHash<QString, QString> m_listsToFormats;
 
 protected:
-	TrieNode * m_trieRoot = nullptr;
+	KeywordTable m_keywords;
+	QStringList m_listNames;
 	QString m_name;
 	QString m_extensionString;
 	QStringList m_extensions;
 	QList<CommentInfo *> m_commentInfo;
+	QString m_commentStartChars;
 	QChar m_stringDelimiter = 0;
 	bool m_hlCStringChar = false;
 	bool m_canProgram = false;
 };
 
-class SyntaxerTrieLeaf : public TrieLeaf
-{
-public:
-	SyntaxerTrieLeaf(QString name);
-	~SyntaxerTrieLeaf();
-
-	const QString & name();
-
-protected:
-	QString m_name;
-};
-
 #endif /* SYNTAXER_H_ */
@@ -99,6 +99,7 @@ void noSwappingMessage(int n)
 SqliteReferenceModel::SqliteReferenceModel() {
 	m_swappingEnabled = false;
 	m_lastWasExactMatch = true;
+	m_facetsValid = false;
 }
 
 bool SqliteReferenceModel::loadAll(const QString & databaseName, bool fullLoad, bool dbExists)
@@ -181,6 +182,7 @@ bool SqliteReferenceModel::loadFromDB(const QString & databaseName)
 	*/
 
 	m_swappingEnabled = loadFromDB(m_database, db);
+	m_facetsValid = false;
 	if (db.isOpen()) db.close();
 	if (!m_swappingEnabled) {
 		killParts();
@@ -851,6 +853,7 @@ bool SqliteReferenceModel::removePartFromDataBase(const QString & moduleId) {
 	qulonglong partId = this->partId(moduleId);
 	if(partId == NO_ID) return false;
 
+	m_facetsValid = false;
 	removePart(partId);
 	removeProperties(partId);
 	removeViewImages(partId);
@@ -885,6 +888,7 @@ bool SqliteReferenceModel::updatePart(ModelPart * newModel) {
 
 bool SqliteReferenceModel::insertPart(ModelPart * modelPart, bool fullLoad) {
 	DebugModelPart = modelPart;
+	m_facetsValid = false;
 
 	QHash<QString, QString> properties = modelPart->properties();
 	QSqlQuery query;
@@ -1136,6 +1140,11 @@ bool SqliteReferenceModel::insertConnectorLayer(const SvgIdLayer * svgIdLayer, q
 }
 
 QStringList SqliteReferenceModel::propValues(const QString &family, const QString &propName, bool distinct) {
+	if (distinct) {
+		if (!m_facetsValid) buildFacets();
+		return m_facets.value(family.toLower().trimmed()).value(propName.toLower().trimmed());
+	}
+
 	QStringList retval;
 
 	QSqlQuery query;
@@ -1160,6 +1169,38 @@ QStringList SqliteReferenceModel::propValues(const QString &family, const QStrin
 	return retval;
 }
 
+void SqliteReferenceModel::buildFacets() {
+	// the Inspector asks for the values of every property of every part it shows;
+	// one pass over the properties table answers all of those from memory
+	m_facets.clear();
+	m_facetsValid = true;
+
+	QSqlQuery query;
+	query.setForwardOnly(true);
+	if (!query.exec("SELECT DISTINCT part.family, prop.name, prop.value FROM properties prop JOIN parts part ON part.id = prop.part_id \n"
+	                "ORDER BY part.family, prop.name, prop.value")) {
+		debugExec("couldn't retrieve facets", query);
+		m_swappingEnabled = false;
+		return;
+	}
+
+	QString lastFamily, lastName;
+	QStringList * values = NULL;
+	while (query.next()) {
+		QString value = query.value(2).toString();
+		if (value.isEmpty()) continue;
+
+		QString family = query.value(0).toString();
+		QString name = query.value(1).toString();
+		if (values == NULL || family != lastFamily || name != lastName) {
+			lastFamily = family;
+			lastName = name;
+			values = &m_facets[family][name];
+		}
+		values->append(value);
+	}
+}
+
 QMultiHash<QString, QString> SqliteReferenceModel::allPropValues(const QString &family, const QString &propName) {
 	QMultiHash<QString, QString> retval;
 
@@ -1353,6 +1394,13 @@ void SqliteReferenceModel::createMoreIndexes(QSqlDatabase & db)
 
 	query = db.exec("CREATE INDEX idx_part_family ON parts (family ASC)");
 	debugError(query.isActive(), query);
+
+	// covers the family/property lookups in propValues, allPropValues and the swap matching
+	query = db.exec("CREATE INDEX idx_property_name_part_id ON properties (name ASC, part_id ASC, value ASC)");
+	debugError(query.isActive(), query);
+
+	query = db.exec("CREATE INDEX idx_part_family_id ON parts (family ASC, id ASC)");
+	debugError(query.isActive(), query);
 }
 
 void SqliteReferenceModel::setSha(const QString & sha) {
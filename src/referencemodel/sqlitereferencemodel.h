@@ -90,6 +90,7 @@ protected:
 	bool insertSubpartConnector(const ConnectorShared * cs, qulonglong id);
 	void createIndexes();
 	void createMoreIndexes(QSqlDatabase &);
+	void buildFacets();
 	bool removeViewImages(qulonglong partId);
 	bool removeConnectors(qulonglong partId);
 	bool removeBuses(qulonglong partId);
@@ -107,6 +108,8 @@ protected:
 	QSqlDatabase m_database;
 	QMultiHash<QString /*name*/, QString /*value*/> m_recordedProperties;
 	QString m_sha;
+	QHash<QString /*family*/, QHash<QString /*name*/, QStringList /*sorted distinct values*/> > m_facets;
+	bool m_facetsValid;
 };
 
 #endif /* SQLITEREFERENCEMODEL_H_ */
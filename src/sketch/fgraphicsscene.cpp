@@ -90,3 +90,61 @@ QList<ItemBase *> FGraphicsScene::lockedSelectedItems() {
 	}
 	return items;
 }
+
+ConnectorIndex * FGraphicsScene::connectorIndex() {
+	return &m_connectorIndex;
+}
+
+// past this many pending changes a full rescan is cheaper than replaying them
+static const int MaxNetChanges = 100000;
+
+void FGraphicsScene::itemArrived(ItemBase * itemBase) {
+	m_connectorIndex.itemChanged(itemBase);
+	connectorsChanged(itemBase);
+}
+
+void FGraphicsScene::connectorsChanged(ItemBase * itemBase) {
+	foreach (QGraphicsItem * childItem, itemBase->childItems()) {
+		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(childItem);
+		if (connectorItem) m_touchedConnectors.append(connectorItem);
+	}
+
+	if (m_touchedConnectors.count() > MaxNetChanges) {
+		m_netChangesOverflowed = true;
+		m_touchedConnectors.clear();
+	}
+}
+
+void FGraphicsScene::itemLeaving(ItemBase * itemBase) {
+	m_connectorIndex.itemRemoved(itemBase);
+
+	foreach (QGraphicsItem * childItem, itemBase->childItems()) {
+		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(childItem);
+		if (connectorItem == NULL) continue;
+
+		m_removedConnectors.append(connectorItem);
+		foreach (ConnectorItem * toConnectorItem, connectorItem->connectedToItems()) {
+			m_touchedConnectors.append(toConnectorItem);
+		}
+	}
+
+	if (m_removedConnectors.count() + m_touchedConnectors.count() > MaxNetChanges) {
+		m_netChangesOverflowed = true;
+		m_removedConnectors.clear();
+		m_touchedConnectors.clear();
+	}
+}
+
+bool FGraphicsScene::takeNetChanges(QList<ConnectorItem *> & removed, QList<ConnectorItem *> & touched) {
+	removed = m_removedConnectors;
+	m_removedConnectors.clear();
+
+	foreach (ConnectorItem * connectorItem, m_touchedConnectors) {
+		if (connectorItem) touched.append(connectorItem);
+	}
+	m_touchedConnectors.clear();
+
+	bool overflowed = m_netChangesOverflowed;
+	m_netChangesOverflowed = false;
+	return !overflowed;
+}
@@ -24,7 +24,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QGraphicsScene>
 #include <QPainter>
 #include <QGraphicsSceneHelpEvent>
+#include <QPointer>
 #include "../items/itembase.h"
+#include "../connectors/connectorindex.h"
 
 class FGraphicsScene : public QGraphicsScene
 {
@@ -38,10 +40,21 @@ public:
 	void setDisplayHandles(bool);
 	bool displayHandles();
 	QList<ItemBase *> lockedSelectedItems();
+	ConnectorIndex * connectorIndex();
+	void itemArrived(ItemBase *);
+	void itemLeaving(ItemBase *);
+	void connectorsChanged(ItemBase *);
+	bool takeNetChanges(QList<ConnectorItem *> & removed, QList<ConnectorItem *> & touched);
 
 protected:
 	QPointF m_lastContextMenuPos;
 	bool m_displayHandles;
+	ConnectorIndex m_connectorIndex;
+
+	// connectors that came or went since the last routing status update; removed ones are only used as keys
+	QList<ConnectorItem *> m_removedConnectors;
+	QList< QPointer<ConnectorItem> > m_touchedConnectors;
+	bool m_netChangesOverflowed = false;
 
 };
 
@@ -41,6 +41,14 @@ void InfoGraphicsView::viewItemInfo(ItemBase * item) {
 	m_infoView->viewItemInfo(this, item ? item->layerKinChief() : item, swappingEnabled(item));
 }
 
+void InfoGraphicsView::viewItemInfoNow(ItemBase * item) {
+	// skips the timer that coalesces rapid selection changes
+	if (m_infoView == NULL) return;
+
+	m_infoView->viewItemInfo(this, item ? item->layerKinChief() : item, swappingEnabled(item));
+	m_infoView->flush();
+}
+
 void InfoGraphicsView::hoverEnterItem(QGraphicsSceneHoverEvent * event, ItemBase * itemBase) {
 	if (m_infoView == NULL) return;
 
@@ -285,6 +293,11 @@ void InfoGraphicsView::getRatsnestColor(QColor & color)
 	Q_UNUSED(color);
 }
 
+RatsnestMemory * InfoGraphicsView::ratsnestMemory()
+{
+	return NULL;
+}
+
 void InfoGraphicsView::changeBus(ItemBase *, bool connect, const QString & oldBus, const QString & newBus, QList<ConnectorItem *> &, const QString & message, const QString & oldLayout, const QString & newLayout)
 {
 	Q_UNUSED(connect);
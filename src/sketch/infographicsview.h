@@ -37,6 +37,7 @@ public:
 	InfoGraphicsView(QWidget* parent = 0);
 
 	virtual void viewItemInfo(ItemBase *);
+	void viewItemInfoNow(ItemBase *);
 	virtual void hoverEnterItem(QGraphicsSceneHoverEvent * event, ItemBase *);
 	virtual void hoverLeaveItem(QGraphicsSceneHoverEvent * event, ItemBase *);
 	void updateRotation(ItemBase *);
@@ -78,6 +79,7 @@ public:
 	virtual void setBoardLayers(int, bool redraw);
 	virtual class VirtualWire * makeOneRatsnestWire(ConnectorItem * source, ConnectorItem * dest, bool routed, QColor, bool force);
 	virtual void getRatsnestColor(QColor &);
+	virtual class RatsnestMemory * ratsnestMemory();
 
 	virtual void changeBus(ItemBase *, bool connect, const QString & oldBus, const QString & newBus, QList<ConnectorItem *> &, const QString & message, const QString & oldLayout, const QString & newLayout);
 	virtual const QString & filenameIf();
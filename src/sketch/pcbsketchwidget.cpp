@@ -827,6 +827,7 @@ ViewLayer::ViewLayerPlacement PCBSketchWidget::wireViewLayerPlacement(ConnectorI
 
 void PCBSketchWidget::setBoardLayers(int layers, bool redraw) {
 	SketchWidget::setBoardLayers(layers, redraw);
+	invalidateNetIndex();			// connectors come and go on copper1
 
 	QList <ViewLayer::ViewLayerID> viewLayerIDs;
 	viewLayerIDs << ViewLayer::Copper1 << ViewLayer::Copper1Trace;
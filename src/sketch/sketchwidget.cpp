@@ -40,6 +40,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QClipboard>
 #include <QScrollBar>
 #include <QStatusBar>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QtConcurrentMap>
 
 #include <limits>
 
@@ -56,6 +60,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/layerkinpaletteitem.h"
 #include "sketchwidget.h"
 #include "../connectors/connectoritem.h"
+#include "../connectors/connectivitysnapshot.h"
 #include "../connectors/svgidlayer.h"
 #include "../items/jumperitem.h"
 #include "../items/stripboard.h"
@@ -70,6 +75,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/note.h"
 #include "../svg/svgfilesplitter.h"
 #include "../svg/svgflattener.h"
+#include "../svg/svgfragmentcache.h"
 #include "../infoview/htmlinfoview.h"
 #include "../items/resizableboard.h"
 #include "../utils/graphicsutils.h"
@@ -89,36 +95,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/schematicframe.h"
 #include "../utils/graphutils.h"
 #include "../utils/ratsnestcolors.h"
+#include "../utils/tracer.h"
+#include "../processeventblocker.h"
 #include "../utils/cursormaster.h"
 
 /////////////////////////////////////////////////////////////////////
 
-bool hideTerminalID(QDomDocument & doc, const QString & terminalID) {
-	QDomElement root = doc.documentElement();
-	QDomElement terminal = TextUtils::findElementWithAttribute(root, "id", terminalID);
-	if (terminal.isNull()) return false;
-
-	terminal.setTagName("g");
-	return true;
-}
-
-bool ensureStrokeWidth(QDomDocument & doc, const QString & connectorID, double factor) {
-	QDomElement root = doc.documentElement();
-	QDomElement connector = TextUtils::findElementWithAttribute(root, "id", connectorID);
-	if (connector.isNull()) return false;
-
-	QString stroke = connector.attribute("stroke");
-	if (stroke.isEmpty()) return false;
-
-	QString strokeWidth = connector.attribute("stroke-width");
-	if (!strokeWidth.isEmpty()) return false;
-
-	TextUtils::getStrokeWidth(connector, factor);       // default stroke width is 1, multiplied by factor
-	return true;
-}
-
-/////////////////////////////////////////////////////////////////////
-
 enum ConnectionStatus {
 	IN_,
 	OUT_,
@@ -129,6 +111,10 @@ enum ConnectionStatus {
 static constexpr double CloseEnough = 0.5;  // in pixels, for swapping into the breadboard
 
 static constexpr int AutoRepeatDelay = 750;
+
+static constexpr int LoadBatchSize = 50;		// items placed between repaints while a sketch loads
+static constexpr int LoadPaintTime = 20;		// ms
+
 bool SketchWidget::m_blockUI = false;
 
 /////////////////////////////////////////////////////////////////////
@@ -140,6 +126,33 @@ bool zLessThan(QGraphicsItem * & p1, QGraphicsItem * & p2)
 
 /////////////////////////////////////////////////////////////////////
 
+// Plain data for warming SvgLoadCache ahead of item creation: ItemBase::setUpImage then only has
+// to hand prepared bytes to QSvgRenderer.  Jobs are built on the gui thread; prefetchJob runs on workers.
+
+struct SvgPrefetchJob {
+	QString filename;
+	QString layerName;
+	ViewLayer::ViewLayerID viewLayerID;
+	LoadInfo loadInfo;
+};
+
+static void prefetchJob(SvgPrefetchJob & job) {
+	bool hasText;
+	QByteArray bytes = ItemBase::layerSvg(job.filename, job.viewLayerID, job.layerName, QDomDocument(), hasText);
+	if (!hasText || bytes.isEmpty()) return;
+
+	FSvgRenderer::prefetch(bytes, job.loadInfo);
+}
+
+static void paintWhileLoading() {
+	// repaint the progress dialog and whatever has been placed so far, but don't let the user edit a half-loaded sketch
+	ProcessEventBlocker::block();
+	QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents, LoadPaintTime);
+	ProcessEventBlocker::unblock();
+}
+
+/////////////////////////////////////////////////////////////////////
+
 SketchWidget::SketchWidget(ViewLayer::ViewID viewID, QWidget *parent, int size, int minSize)
 	: InfoGraphicsView(parent), m_viewID(viewID)
 {
@@ -246,9 +259,18 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 		sceneCorner.setY(sceneCenter.y() - (boundingRect->height() / 2));
 	}
 
+	QElapsedTimer loadTimer;
+	loadTimer.start();
+	if (!parentCommand) {
+		prefetchPartSvgs(modelParts);
+	}
+	qint64 prefetchTime = loadTimer.restart();
+
 	QHash<ItemBase *, long> superparts;
 	QHash<long, long> superparts2;
 	QList<ModelPart *> zeroLength;
+	int placed = 0;
+	qint64 itemsStart = Tracer::enabled() ? Tracer::now() : -1;
 	// make parts
 	foreach (ModelPart * mp, modelParts) {
 		QDomElement instance = mp->instanceDomElement();
@@ -349,6 +371,10 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 				if (itemBase->itemType() != ModelPart::Wire) {
 					itemBase->restorePartLabel(labelGeometry, getLabelViewLayerID(itemBase));
 				}
+
+				if (++placed % LoadBatchSize == 0) {
+					paintWhileLoading();
+				}
 			}
 		}
 		else {
@@ -437,6 +463,12 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 		}
 	}
 
+	if (itemsStart >= 0) {
+		Tracer::addSpan("load items", itemsStart, Tracer::now() - itemsStart, ViewLayer::viewIDName(m_viewID));
+	}
+	qint64 itemsTime = loadTimer.restart();
+	TraceScope connectTrace("load connections", ViewLayer::viewIDName(m_viewID));
+
 	foreach (ModelPart * mp, zeroLength) {
 		modelParts.removeOne(mp);
 		mp->killViewItems();
@@ -596,6 +628,78 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 
 	setIgnoreSelectionChangeEvents(false);
 	m_pasteOffset = QPointF(0,0);
+
+	if (!parentCommand) {
+		DebugDialog::debug(QString("loaded %1 items in %2: prefetch %3 ms, items %4 ms, connections %5 ms")
+		                   .arg(placed).arg(ViewLayer::viewIDName(m_viewID))
+		                   .arg(prefetchTime).arg(itemsTime).arg(loadTimer.elapsed()));
+	}
+}
+
+void SketchWidget::prefetchPartSvgs(QList<ModelPart *> & modelParts) {
+	// the svg work behind each item is done on worker threads first, so that creating the items
+	// on the gui thread mostly hits the cache.  Anything that ends up loading different bytes
+	// (flipped or locally modified parts) simply misses and is loaded as before.
+	TraceScope trace("load prefetch", ViewLayer::viewIDName(m_viewID));
+
+	QString viewName = ViewLayer::viewIDXmlName(m_viewID);
+	QSet<QString> already;
+	QList<SvgPrefetchJob> jobs;
+	foreach (ModelPart * mp, modelParts) {
+		if (mp->itemType() != ModelPart::Part) continue;
+		if (mp->flippedSMD()) continue;
+
+		ModelPartShared * modelPartShared = mp->modelPartShared();
+		if (modelPartShared == nullptr) continue;
+
+		QDomElement instance = mp->instanceDomElement();
+		QDomElement view = instance.firstChildElement("views").firstChildElement(viewName);
+		QDomElement geometry = view.firstChildElement("geometry");
+		if (geometry.isNull()) continue;
+
+		ViewGeometry viewGeometry(geometry);
+		ViewLayer::ViewLayerPlacement viewLayerPlacement = getViewLayerPlacement(mp, instance, view, viewGeometry);
+		if (viewLayerPlacement == ViewLayer::NewBottom) continue;
+
+		bool multipleLayers = modelPartShared->hasMultipleLayers(m_viewID);
+		foreach (ViewLayer::ViewLayerID viewLayerID, m_viewLayers.keys()) {
+			if (!mp->hasViewFor(m_viewID, viewLayerID)) continue;
+
+			QString key = mp->moduleID() + "." + QString::number(viewLayerID);
+			if (already.contains(key)) continue;
+
+			already.insert(key);
+			QString filename = PartFactory::getSvgFilename(mp, modelPartShared->imageFileName(m_viewID, viewLayerID), true, true);
+			if (filename.isEmpty()) continue;
+
+			LayerAttributes layerAttributes;
+			layerAttributes.viewID = m_viewID;
+			layerAttributes.viewLayerID = viewLayerID;
+			layerAttributes.viewLayerPlacement = viewLayerPlacement;
+
+			SvgPrefetchJob job;
+			job.filename = filename;
+			job.viewLayerID = viewLayerID;
+			if (multipleLayers) job.layerName = ViewLayer::viewLayerXmlNameFromID(viewLayerID);
+			ItemBase::initLoadInfo(modelPartShared, layerAttributes, job.loadInfo);
+			job.loadInfo.filename = filename;
+			jobs.append(job);
+		}
+	}
+
+	if (jobs.isEmpty()) return;
+
+	// wait in an event loop rather than blocking, so the window keeps painting
+	QFutureWatcher<void> watcher;
+	QEventLoop loop;
+	connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+	watcher.setFuture(QtConcurrent::map(jobs, prefetchJob));
+	if (!watcher.isFinished()) {
+		ProcessEventBlocker::block();
+		loop.exec(QEventLoop::ExcludeUserInputEvents);
+		ProcessEventBlocker::unblock();
+	}
+	watcher.waitForFinished();
 }
 
 void SketchWidget::handleConnect(QDomElement & connect, ModelPart * mp, const QString & fromConnectorID, ViewLayer::ViewLayerID fromViewLayerID,
@@ -2299,8 +2403,8 @@ void SketchWidget::mousePressEvent(QMouseEvent *event)
 		return;
 	}
 
-	Stripbit * stripbit = dynamic_cast<Stripbit *>(item);
-	if (stripbit) return;
+	StripLayer * stripLayer = dynamic_cast<StripLayer *>(item);
+	if (stripLayer) return;
 
 	ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
 	if (itemBase) {
@@ -6639,82 +6743,66 @@ void SketchWidget::updateRoutingStatus(RoutingStatus & routingStatus, bool manua
 	//	.arg(m_ratsnestUpdateDisconnect.count())
 	//	);
 
-	// TODO: think about ways to optimize this...
+	// Each net's contribution to the routing status is remembered, along with which net every connector is in.
+	// Only nets touched by a connect/disconnect, or by a part arriving in or leaving the scene, are rescored;
+	// manual updates (and anything the scene could not keep track of) rescan the whole scene.
 
 	QList< QPointer<VirtualWire> > ratsToDelete;
-
 	QList< QList<ConnectorItem *> > ratnestsToUpdate;
-	QList<ConnectorItem *> visited;
-	foreach (QGraphicsItem * item, scene()->items()) {
-		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
-		if (!connectorItem) continue;
-		if (visited.contains(connectorItem)) continue;
-
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//    connectorItem->debugInfo("testing urs");
-		//}
-
-		VirtualWire * vw = qobject_cast<VirtualWire *>(connectorItem->attachedTo());
-		if (vw) {
-			if (vw->connector0()->connectionsCount() == 0 || vw->connector1()->connectionsCount() == 0) {
-				ratsToDelete.append(vw);
-			}
-			visited << vw->connector0() << vw->connector1();
-			continue;
-		}
-
-
-		QList<ConnectorItem *> connectorItems;
-		connectorItems.append(connectorItem);
-		ConnectorItem::collectEqualPotential(connectorItems, true, ViewGeometry::RatsnestFlag);
-		visited.append(connectorItems);
-
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//	DebugDialog::debug("________________________");
-		//	foreach (ConnectorItem * ci, connectorItems) ci->debugInfo("cep");
-		//}
-
-		bool doRatsnest = manual || checkUpdateRatsnest(connectorItems);
-		if (!doRatsnest && connectorItems.count() <= 1) continue;
 
-		QList<ConnectorItem *> partConnectorItems;
-		ConnectorItem::collectParts(connectorItems, partConnectorItems, includeSymbols(), ViewLayer::NewTopAndBottom);
-		if (partConnectorItems.count() < 1) continue;
-		if (!doRatsnest && partConnectorItems.count() <= 1) continue;
+	QList<ConnectorItem *> removed;
+	QList<ConnectorItem *> touched;
+	FGraphicsScene * fscene = qobject_cast<FGraphicsScene *>(scene());
+	bool tracked = fscene && fscene->takeNetChanges(removed, touched);
 
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//    DebugDialog::debug("________________________");
-		//    foreach (ConnectorItem * pci, partConnectorItems) {
-		//		pci->debugInfo("pc 1");
-		//	}
-		//}
+	if (manual || !tracked || !m_netIndexValid) {
+		m_netRecords.clear();
+		m_netOf.clear();
+		m_netTotals.zero();
 
-		for (int i = partConnectorItems.count() - 1; i >= 0; i--) {
-			ConnectorItem * ci = partConnectorItems[i];
+		foreach (QGraphicsItem * item, scene()->items()) {
+			ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
+			if (!connectorItem) continue;
 
-			if (!ci->attachedTo()->isEverVisible()) {
-				partConnectorItems.removeAt(i);
-			}
+			scoreNet(connectorItem, manual, touched, ratsToDelete, ratnestsToUpdate);
 		}
 
-		if (partConnectorItems.count() < 1) continue;
+		m_netIndexValid = true;
+	}
+	else {
+		foreach (ConnectorItem * connectorItem, m_ratsnestUpdateConnect) {
+			if (connectorItem) touched.append(connectorItem);
+		}
+		foreach (ConnectorItem * connectorItem, m_ratsnestUpdateDisconnect) {
+			if (connectorItem) touched.append(connectorItem);
+		}
 
-		if (doRatsnest) {
-			ratnestsToUpdate.append(partConnectorItems);
+		// drop the nets that may have changed; whatever is left of them is rescored below
+		QSet<int> dirtyNets;
+		foreach (ConnectorItem * connectorItem, removed) {
+			int netID = m_netOf.value(connectorItem, -1);
+			if (netID >= 0) dirtyNets.insert(netID);
+		}
+		foreach (ConnectorItem * connectorItem, touched) {
+			int netID = m_netOf.value(connectorItem, -1);
+			if (netID >= 0) dirtyNets.insert(netID);
 		}
 
-		if (partConnectorItems.count() <= 1) continue;
+		QList<ConnectorItem *> seeds(touched);
+		foreach (int netID, dirtyNets) {
+			dropNet(netID, seeds);
+		}
 
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//    DebugDialog::debug("________________________");
-		//    foreach (ConnectorItem * pci, partConnectorItems) {
-		//		pci->debugInfo("pc 2");
-		//	}
-		//}
+		// seeds can grow while scoring; see scoreNet
+		for (int i = 0; i < seeds.count(); i++) {
+			ConnectorItem * connectorItem = seeds.at(i);
+			if (connectorItem->scene() != scene()) continue;
 
-		GraphUtils::scoreOneNet(partConnectorItems, this->getTraceFlag(), routingStatus);
+			scoreNet(connectorItem, manual, seeds, ratsToDelete, ratnestsToUpdate);
+		}
 	}
 
+	routingStatus += m_netTotals;
 	routingStatus.m_jumperItemCount /= 4;			// since we counted each connector twice on two layers (4 connectors per jumper item)
 
 	// can't do this in the above loop since VirtualWires and ConnectorItems are added and deleted
@@ -6751,6 +6839,82 @@ void SketchWidget::updateRoutingStatus(RoutingStatus & routingStatus, bool manua
 }
 
 
+void SketchWidget::dropNet(int netID, QList<ConnectorItem *> & seeds)
+{
+	NetRecord netRecord = m_netRecords.take(netID);
+	m_netTotals -= netRecord.routingStatus;
+	foreach (ConnectorItem * connectorItem, netRecord.keys) {
+		m_netOf.remove(connectorItem);
+	}
+	foreach (ConnectorItem * connectorItem, netRecord.members) {
+		if (connectorItem) seeds.append(connectorItem);
+	}
+}
+
+void SketchWidget::scoreNet(ConnectorItem * connectorItem, bool manual, QList<ConnectorItem *> & seeds, QList< QPointer<VirtualWire> > & ratsToDelete, QList< QList<ConnectorItem *> > & ratnestsToUpdate)
+{
+	if (m_netOf.contains(connectorItem)) return;			// already scored as part of another net
+
+	VirtualWire * vw = qobject_cast<VirtualWire *>(connectorItem->attachedTo());
+	if (vw) {
+		if (vw->connector0()->connectionsCount() == 0 || vw->connector1()->connectionsCount() == 0) {
+			if (!ratsToDelete.contains(vw)) ratsToDelete.append(vw);
+		}
+		return;
+	}
+
+	QList<ConnectorItem *> connectorItems;
+	connectorItems.append(connectorItem);
+	ConnectorItem::collectEqualPotential(connectorItems, true, ViewGeometry::RatsnestFlag);
+
+	// a connector still filed under an older net means that net was joined without anyone saying so:
+	// drop it and rescore what is left of it
+	foreach (ConnectorItem * ci, connectorItems) {
+		int oldNetID = m_netOf.value(ci, -1);
+		if (oldNetID >= 0) dropNet(oldNetID, seeds);
+	}
+
+	int netID = m_nextNetID++;
+	NetRecord & netRecord = m_netRecords[netID];
+	netRecord.routingStatus.zero();
+	foreach (ConnectorItem * ci, connectorItems) {
+		m_netOf.insert(ci, netID);
+		netRecord.keys.append(ci);
+		netRecord.members.append(ci);
+	}
+
+	bool doRatsnest = manual || checkUpdateRatsnest(connectorItems);
+	if (!doRatsnest && connectorItems.count() <= 1) return;
+
+	QList<ConnectorItem *> partConnectorItems;
+	ConnectorItem::collectParts(connectorItems, partConnectorItems, includeSymbols(), ViewLayer::NewTopAndBottom);
+	if (partConnectorItems.count() < 1) return;
+	if (!doRatsnest && partConnectorItems.count() <= 1) return;
+
+	for (int i = partConnectorItems.count() - 1; i >= 0; i--) {
+		ConnectorItem * ci = partConnectorItems[i];
+
+		if (!ci->attachedTo()->isEverVisible()) {
+			partConnectorItems.removeAt(i);
+		}
+	}
+
+	if (partConnectorItems.count() < 1) return;
+
+	if (doRatsnest) {
+		ratnestsToUpdate.append(partConnectorItems);
+	}
+
+	if (partConnectorItems.count() <= 1) return;
+
+	GraphUtils::scoreOneNet(partConnectorItems, this->getTraceFlag(), netRecord.routingStatus);
+	m_netTotals += netRecord.routingStatus;
+}
+
+void SketchWidget::invalidateNetIndex() {
+	m_netIndexValid = false;
+}
+
 void SketchWidget::ensureLayerVisible(ViewLayer::ViewLayerID viewLayerID)
 {
 	ViewLayer * viewLayer = m_viewLayers.value(viewLayerID, nullptr);
@@ -7240,6 +7404,7 @@ QString translateSVG(QString & svg, QPointF loc, double dpi, double printerScale
 
 QString SketchWidget::renderToSVG(RenderThing & renderThing, QList<QGraphicsItem *> & itemsAndLabels)
 {
+	TraceScope trace("render svg", ViewLayer::viewIDName(m_viewID));
 	renderThing.empty = true;
 
 	double width = renderThing.itemsBoundingRect.width();
@@ -7260,7 +7425,53 @@ QString SketchWidget::renderToSVG(RenderThing & renderThing, QList<QGraphicsItem
 	// put them in z order
 	qSort(itemsAndLabels.begin(), itemsAndLabels.end(), zLessThan);
 
-	QList<ItemBase *> gotLabel;
+	// first pass: gather what each part needs from the scene; normalizing the svg is cached and
+	// independent per part, so cache misses are processed in parallel
+	QList<SvgFragmentJob> jobs;
+	QHash<ItemBase *, int> jobIndexes;
+	QHash<ItemBase *, QString> legSvgs;
+	foreach (QGraphicsItem * item, itemsAndLabels) {
+		ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
+		if (!itemBase) continue;
+		if (itemBase->itemType() == ModelPart::Wire) continue;
+
+		SvgFragmentJob job;
+		job.itemSvg = itemBase->retrieveSvg(itemBase->viewLayerID(), svgHash, renderThing.blackOnly, renderThing.dpi, job.factor);
+		if (job.itemSvg.isEmpty()) continue;
+
+		if (renderThing.renderBlocker) {
+			Pad * pad = qobject_cast<Pad *>(itemBase);
+			job.opaqueRects = (pad && pad->copperBlocker());
+		}
+
+		QString legSvg;
+		foreach (ConnectorItem * ci, itemBase->cachedConnectorItems()) {
+			SvgIdLayer * svgIdLayer = ci->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
+			if (renderThing.hideTerminalPoints && !svgIdLayer->m_terminalId.isEmpty()) {
+				job.hideIDs.append(svgIdLayer->m_terminalId);
+			}
+			job.strokeIDs.append(svgIdLayer->m_svgId);
+
+			if (!ci->hasRubberBandLeg()) continue;
+
+			// at the moment, the legs don't get a partID, but since there are no legs in PCB view, we don't care
+			legSvg.append(ci->makeLegSvg(offset, renderThing.dpi, renderThing.printerScale, renderThing.blackOnly));
+		}
+		if (!legSvg.isEmpty()) legSvgs.insert(itemBase, legSvg);
+
+		job.transform = itemBase->transform();
+		jobIndexes.insert(itemBase, jobs.count());
+		jobs.append(job);
+	}
+
+	SvgFragmentCache::process(jobs);
+
+	int reserve = outputSVG.size() + 64;
+	foreach (const SvgFragmentJob & job, jobs) {
+		reserve += job.fragment.size() + 64;
+	}
+	outputSVG.reserve(reserve);
+
 	foreach (QGraphicsItem * item, itemsAndLabels) {
 		ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
 		if (!itemBase) {
@@ -7279,55 +7490,19 @@ QString SketchWidget::renderToSVG(RenderThing & renderThing, QList<QGraphicsItem
 		}
 
 		if (itemBase->itemType() != ModelPart::Wire) {
-			double factor;
-			QString itemSvg = itemBase->retrieveSvg(itemBase->viewLayerID(), svgHash, renderThing.blackOnly, renderThing.dpi, factor);
-			if (itemSvg.isEmpty()) continue;
-
-			TextUtils::fixMuch(itemSvg, false);
-
-			QDomDocument doc;
-			QString errorStr;
-			int errorLine;
-			int errorColumn;
-			if (doc.setContent(itemSvg, &errorStr, &errorLine, &errorColumn)) {
-				bool changed = false;
-				if (renderThing.renderBlocker) {
-					Pad * pad = qobject_cast<Pad *>(itemBase);
-					if (pad && pad->copperBlocker()) {
-						QDomNodeList nodeList = doc.documentElement().elementsByTagName("rect");
-						for (int n = 0; n < nodeList.count(); n++) {
-							QDomElement element = nodeList.at(n).toElement();
-							element.setAttribute("fill-opacity", 1);
-							changed = true;
-						}
-					}
-				}
-
-				foreach (ConnectorItem * ci, itemBase->cachedConnectorItems()) {
-					SvgIdLayer * svgIdLayer = ci->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
-					if (renderThing.hideTerminalPoints && !svgIdLayer->m_terminalId.isEmpty()) {
-						// these tend to be degenerate shapes and can cause trouble at gerber export time
-						if (hideTerminalID(doc, svgIdLayer->m_terminalId)) changed = true;
-					}
-
-					if (ensureStrokeWidth(doc, svgIdLayer->m_svgId, factor)) changed = true;
-
-					if (!ci->hasRubberBandLeg()) continue;
-
-					// at the moment, the legs don't get a partID, but since there are no legs in PCB view, we don't care
-					outputSVG.append(ci->makeLegSvg(offset, renderThing.dpi, renderThing.printerScale, renderThing.blackOnly));
-				}
+			int jobIndex = jobIndexes.value(itemBase, -1);
+			if (jobIndex < 0) continue;
 
-				if (changed) {
-					itemSvg = doc.toString(0);
-				}
+			const SvgFragmentJob & job = jobs.at(jobIndex);
+			if (job.parsed) {
+				outputSVG.append(legSvgs.value(itemBase));
 			}
 
-			QTransform t = itemBase->transform();
-			itemSvg = TextUtils::svgTransform(itemSvg, t, false, QString());
+			QString itemSvg = job.fragment;
 			itemSvg = translateSVG(itemSvg, itemBase->scenePos() - offset, renderThing.dpi, renderThing.printerScale);
-			itemSvg =  QString("<g partID='%1'>%2</g>").arg(itemBase->id()).arg(itemSvg);
+			outputSVG.append(QString("<g partID='%1'>").arg(itemBase->id()));
 			outputSVG.append(itemSvg);
+			outputSVG.append("</g>");
 			renderThing.empty = false;
 
 			/*
@@ -8415,80 +8590,104 @@ void SketchWidget::changeBoardLayers(int layers, bool doEmit) {
 
 void SketchWidget::collectAllNets(QHash<ConnectorItem *, int> & indexer, QList< QList<class ConnectorItem *>* > & allPartConnectorItems, bool includeSingletons, bool bothSides)
 {
-	// get the set of all connectors in the sketch
+	// find all the nets and make a list of nodes (i.e. part ConnectorItems) for each net
+	QList<ConnectorItem *> connectorItems;
+	QSharedPointer<const ConnectivitySnapshot> snapshot = connectivitySnapshot(&connectorItems);
+	foreach (const ConnectivitySnapshot::Net & net, snapshot->nets(includeSingletons, bothSides, includeSymbols())) {
+		QList<ConnectorItem *> * partConnectorItems = new QList<ConnectorItem *>;
+		for (int i = 0; i < net.connectors.count(); i++) {
+			ConnectorItem * ci = connectorItems.at(net.connectors.at(i));
+			partConnectorItems->append(ci);
+			if (!net.onNet.at(i)) {
+				// crossed layer: toss it
+				continue;
+			}
+
+			indexer.insert(ci, indexer.count());
+		}
+
+		allPartConnectorItems.append(partConnectorItems);
+	}
+}
+
+QSharedPointer<const ConnectivitySnapshot> SketchWidget::connectivitySnapshot(QList<ConnectorItem *> * connectorItems)
+{
+	// one pass over the scene; connectorItems, if asked for, maps the snapshot's connector indexes back to the scene
+	QSharedPointer<ConnectivitySnapshot> snapshot(new ConnectivitySnapshot(m_viewID));
+
 	QList<ConnectorItem *> allConnectors;
+	QHash<ConnectorItem *, int> connectorIndexes;
+	QHash<ItemBase *, int> partIndexes;
 	foreach (QGraphicsItem * item, scene()->items()) {
 		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
 		if (!connectorItem) continue;
-		if (!bothSides && connectorItem->attachedToViewLayerID() == ViewLayer::Copper1) continue;
 
+		ItemBase * chief = connectorItem->attachedTo()->layerKinChief();
+		int part = partIndexes.value(chief, -1);
+		if (part < 0) {
+			ConnectivitySnapshot::PartEntry partEntry;
+			partEntry.id = chief->id();
+			partEntry.modelIndex = chief->modelPart() ? chief->modelPart()->modelIndex() : 0;
+			partEntry.itemType = chief->itemType();
+			partEntry.moduleID = chief->moduleID();
+			partEntry.instanceTitle = chief->instanceTitle();
+			partEntry.wireFlags = chief->wireFlags();
+			part = snapshot->addPart(partEntry);
+			partIndexes.insert(chief, part);
+		}
+
+		ConnectivitySnapshot::ConnectorEntry connectorEntry;
+		connectorEntry.part = part;
+		connectorEntry.id = connectorItem->connectorSharedID();
+		connectorEntry.name = connectorItem->connectorSharedName();
+		connectorEntry.viewLayerID = connectorItem->attachedToViewLayerID();
+		connectorEntry.flags = ConnectivitySnapshot::NoConnectorFlag;
+		if (connectorItem->isEverVisible()) connectorEntry.flags |= ConnectivitySnapshot::EverVisibleFlag;
+		if (connectorItem->isHybrid()) connectorEntry.flags |= ConnectivitySnapshot::HybridFlag;
+		connectorEntry.crossLayer = -1;
+		connectorEntry.bus = -1;
+		connectorIndexes.insert(connectorItem, snapshot->addConnector(connectorEntry));
 		allConnectors.append(connectorItem);
 	}
 
-	// find all the nets and make a list of nodes (i.e. part ConnectorItems) for each net
-	while (allConnectors.count() > 0) {
-
-		ConnectorItem * connectorItem = allConnectors.takeFirst();
-		QList<ConnectorItem *> connectorItems;
-		connectorItems.append(connectorItem);
-		ConnectorItem::collectEqualPotential(connectorItems, bothSides, ViewGeometry::NoFlag);
-		if (connectorItems.count() <= 0) {
-			continue;
-		}
-
-		foreach (ConnectorItem * ci, connectorItems) {
-			//if (connectorItems.count(ci) > 1) {
-			//DebugDialog::debug("collect equal potential bug");
-			//}
-			//DebugDialog::debug(QString("from in equal potential %1 %2").arg(ci->connectorSharedName()).arg(ci->attachedToInstanceTitle()));
-			allConnectors.removeOne(ci);
+	QSet< QPair<ItemBase *, Bus *> > buses;
+	for (int c = 0; c < allConnectors.count(); c++) {
+		ConnectorItem * connectorItem = allConnectors.at(c);
+		foreach (ConnectorItem * toConnectorItem, connectorItem->connectedToItems()) {
+			int to = connectorIndexes.value(toConnectorItem, -1);
+			if (to >= 0) snapshot->addConnection(c, to);
 		}
 
-		if (!includeSingletons && (connectorItems.count() <= 1)) {
-			continue;
+		ConnectorItem * crossConnectorItem = connectorItem->getCrossLayerConnectorItem();
+		if (crossConnectorItem) {
+			snapshot->setCrossLayer(c, connectorIndexes.value(crossConnectorItem, -1));
 		}
 
-		QList<ConnectorItem *> * partConnectorItems = new QList<ConnectorItem *>;
-		ConnectorItem::collectParts(connectorItems, *partConnectorItems, includeSymbols(), ViewLayer::NewTopAndBottom);
-
-		for (int i = partConnectorItems->count() - 1; i >= 0; i--) {
-			if (!partConnectorItems->at(i)->attachedTo()->isEverVisible()) {
-				partConnectorItems->removeAt(i);
-			}
-		}
+		Bus * bus = connectorItem->bus();
+		if (bus == NULL) continue;
 
-		if ((partConnectorItems->count() <= 0) || (!includeSingletons && (partConnectorItems->count() <= 1))) {
-			delete partConnectorItems;
-			continue;
-		}
+		// the members of a bus are the same from any of its connectors on the same item
+		QPair<ItemBase *, Bus *> key(connectorItem->attachedTo(), bus);
+		if (buses.contains(key)) continue;
 
-		foreach (ConnectorItem * ci, *partConnectorItems) {
-			//if (partConnectorItems->count(ci) > 1) {
-			//DebugDialog::debug("collect Parts bug");
-			//}
-			if (!connectorItems.contains(ci)) {
-				// crossed layer: toss it
-				//DebugDialog::debug(QString("not in equal potential '%1' '%2' %3")
-				//	.arg(ci->connectorSharedName())
-				//	.arg(ci->attachedToInstanceTitle())
-				//	.arg(ci->attachedToViewLayerID()));
-				continue;
-			}
-			//if (indexer.keys().contains(ci)) {
-			//DebugDialog::debug(QString("connector item already indexed %1 %2").arg(ci->connectorSharedName()).arg(ci->attachedToInstanceTitle()));
-			//}
-			//int c = indexer.count();
-			//DebugDialog::debug(QString("insert indexer %1 '%2' '%3' %4")
-			//.arg(c)
-			//.arg(ci->connectorSharedName())
-			//.arg(ci->attachedToInstanceTitle())
-			//.arg(ci->attachedToViewLayerID()));
-			indexer.insert(ci, indexer.count());
+		buses.insert(key);
+		QList<ConnectorItem *> busConnectedItems;
+		connectorItem->attachedTo()->busConnectorItems(bus, connectorItem, busConnectedItems);
+		QList<int> members;
+		foreach (ConnectorItem * busConnectedItem, busConnectedItems) {
+			int member = connectorIndexes.value(busConnectedItem, -1);
+			if (member >= 0) members.append(member);
 		}
+		if (!members.contains(c)) members.append(c);
+		snapshot->addBus(members);
+	}
 
-		//DebugDialog::debug("________________");
-		allPartConnectorItems.append(partConnectorItems);
+	snapshot->finish();
+	if (connectorItems) {
+		*connectorItems = allConnectors;
 	}
+
+	return snapshot;
 }
 
 ViewLayer::ViewLayerPlacement SketchWidget::getViewLayerPlacement(ModelPart * modelPart, QDomElement & instance, QDomElement & view, ViewGeometry & viewGeometry)
@@ -9090,6 +9289,11 @@ void SketchWidget::getRatsnestColor(QColor & color)
 	color = RatsnestColors::netColor(m_viewID);
 }
 
+RatsnestMemory * SketchWidget::ratsnestMemory()
+{
+	return &m_ratsnestMemory;
+}
+
 VirtualWire * SketchWidget::makeOneRatsnestWire(ConnectorItem * source, ConnectorItem * dest, bool routed, QColor color, bool force) {
 	if (source->attachedTo() == dest->attachedTo()) {
 		if (source == dest) return nullptr;
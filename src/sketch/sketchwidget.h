@@ -31,6 +31,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QHash>
 #include <QMap>
 #include <QTimer>
+#include <QSharedPointer>
 
 #include "../items/paletteitem.h"
 #include "../referencemodel/referencemodel.h"
@@ -40,6 +41,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../viewlayer.h"
 #include "../utils/misc.h"
 #include "../commands.h"
+#include "../utils/graphutils.h"
 
 struct ItemCount {
 	int selCount;
@@ -72,6 +74,13 @@ struct SwapThing {
 	QMap<QString, QString> propsMap;
 };
 
+// one net's share of the routing status; keys are only used for lookups, members may have been deleted since
+struct NetRecord {
+	QList<ConnectorItem *> keys;
+	QList< QPointer<ConnectorItem> > members;
+	RoutingStatus routingStatus;
+};
+
 struct RenderThing {
 	bool selectedItems;
 	double printerScale;
@@ -276,6 +285,7 @@ public:
 	void clearPasteOffset();
 	virtual ViewLayer::ViewLayerPlacement defaultViewLayerPlacement(ModelPart *);
 	void collectAllNets(QHash<class ConnectorItem *, int> & indexer, QList< QList<class ConnectorItem *>* > & allPartConnectorItems, bool includeSingletons, bool bothSides);
+	QSharedPointer<const class ConnectivitySnapshot> connectivitySnapshot(QList<class ConnectorItem *> * connectorItems = NULL);
 	virtual bool routeBothSides();
 	virtual void changeLayer(long id, double z, ViewLayer::ViewLayerID viewLayerID);
 	void ratsnestConnect(ConnectorItem * connectorItem, bool connect);
@@ -307,6 +317,7 @@ public:
 	void renamePins(ItemBase *, const QStringList & oldLabels, const QStringList & newLabels, bool singleRow);
 	void renamePins(long itemID, const QStringList & labels, bool singleRow);
 	void getRatsnestColor(QColor &);
+	RatsnestMemory * ratsnestMemory();
 	VirtualWire * makeOneRatsnestWire(ConnectorItem * source, ConnectorItem * dest, bool routed, QColor color, bool force);
 	double ratsnestOpacity();
 	void setRatsnestOpacity(double);
@@ -431,6 +442,7 @@ protected:
 	void drawBackground( QPainter * painter, const QRectF & rect );
 	void handleConnect(QDomElement & connect, ModelPart *, const QString & fromConnectorID, ViewLayer::ViewLayerID, QStringList & alreadyConnected,
 	                   QHash<long, ItemBase *> & newItems, QUndoCommand * parentCommand, bool seekOutsideConnections);
+	void prefetchPartSvgs(QList<ModelPart *> & modelParts);
 	void setUpSwapReconnect(SwapThing &, ItemBase * itemBase, long newID, bool master);
 	void makeSwapWire(SketchWidget *, ItemBase *, long newID, ConnectorItem * fromConnectorItem, ConnectorItem * toConnectorItem, Connector * newConnector, QUndoCommand * parentCommand);
 	bool swappedGender(ConnectorItem * originalConnectorItem, Connector * newConnector);
@@ -494,6 +506,9 @@ protected:
 	void moveLegBendpointsAux(ConnectorItem * connectorItem, bool undoOnly, QUndoCommand * parentCommand);
 	virtual void rotatePartLabels(double degrees, QTransform &, QPointF center, QUndoCommand * parentCommand);
 	bool checkUpdateRatsnest(QList<ConnectorItem *> & connectorItems);
+	void scoreNet(ConnectorItem *, bool manual, QList<ConnectorItem *> & seeds, QList< QPointer<class VirtualWire> > & ratsToDelete, QList< QList<ConnectorItem *> > & ratnestsToUpdate);
+	void dropNet(int netID, QList<ConnectorItem *> & seeds);
+	void invalidateNetIndex();
 	void makeRatsnestViewGeometry(ViewGeometry & viewGeometry, ConnectorItem * source, ConnectorItem * dest);
 	virtual double getTraceWidth();
 	virtual const QString & traceColor(ViewLayer::ViewLayerPlacement);
@@ -734,6 +749,11 @@ protected:
 	QList< QPointer<ConnectorItem> > m_ratsnestUpdateConnect;
 	QList< QPointer<ConnectorItem> > m_ratsnestCacheDisconnect;
 	QList< QPointer<ConnectorItem> > m_ratsnestCacheConnect;
+	QHash<int, NetRecord> m_netRecords;
+	QHash<ConnectorItem *, int> m_netOf;
+	RoutingStatus m_netTotals;
+	int m_nextNetID = 0;
+	bool m_netIndexValid = false;
 	QList <ItemBase *> m_checkUnder;
 	bool m_addDefaultParts = false;
 	QPointer<ItemBase> m_addedDefaultPart;
@@ -750,6 +770,7 @@ protected:
 	QList< QPointer<ItemBase> > m_squashShapes;
 	QColor m_gridColor;
 	bool m_everZoomed = false;
+	RatsnestMemory m_ratsnestMemory;
 	double m_ratsnestOpacity = 0.0;
 	double m_ratsnestWidth = 0.0;
 
@@ -0,0 +1,310 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "bitmaptracer.h"
+
+#include <QSettings>
+#include <qmath.h>
+
+const QString BitmapTracer::ToleranceSettingName("LogoTraceTolerance");
+const double BitmapTracer::DefaultTolerance = 1.0;
+
+// outline directions: the traced pixels are always on the right hand side
+static const int Right = 0;
+static const int Down = 1;
+static const int Left = 2;
+static const int Up = 3;
+static const int DX[4] = { 1, 0, -1, 0 };
+static const int DY[4] = { 0, 1, 0, -1 };
+
+// bends sharper than 60 degrees are corners and are never rounded off
+static const double MinSmoothCos = 0.5;
+
+// how far (in multiples of the tolerance) a fitted curve may pull away from the outline
+static const double MaxSmoothDeviation = 2;
+
+static inline bool isSet(const QImage & image, int x, int y) {
+	if (x < 0 || y < 0 || x >= image.width() || y >= image.height()) return false;
+
+	const uchar * s = image.constScanLine(y);
+	return (s[x >> 3] >> (~x & 7)) & 1;
+}
+
+static inline int nextDirection(int edges, int d) {
+	// only a saddle (two set pixels touching at a corner) has two ways out: turning right keeps the pixels apart
+	int right = (d + 1) & 3;
+	if (edges & (1 << right)) return right;
+	if (edges & (1 << d)) return d;
+	return (d + 3) & 3;
+}
+
+static double distanceSquared(const QPointF & p, const QPointF & a, const QPointF & b) {
+	double dx = b.x() - a.x();
+	double dy = b.y() - a.y();
+	double lengthSquared = (dx * dx) + (dy * dy);
+	double t = 0;
+	if (lengthSquared > 0) {
+		t = qBound(0.0, (((p.x() - a.x()) * dx) + ((p.y() - a.y()) * dy)) / lengthSquared, 1.0);
+	}
+	double ex = a.x() + (t * dx) - p.x();
+	double ey = a.y() + (t * dy) - p.y();
+	return (ex * ex) + (ey * ey);
+}
+
+static QString number(double v) {
+	return QString::number(qRound(v * 100) / 100.0, 'g', 10);
+}
+
+/////////////////////////////////////////////////////////////////////
+
+BitmapTracer::BitmapTracer(double tolerance) : m_tolerance(tolerance)
+{
+}
+
+const BitmapTracer::Stats & BitmapTracer::stats() const {
+	return m_stats;
+}
+
+double BitmapTracer::savedTolerance() {
+	QSettings settings;
+	bool ok;
+	double tolerance = settings.value(ToleranceSettingName, DefaultTolerance).toDouble(&ok);
+	if (!ok || tolerance < 0) return DefaultTolerance;
+
+	return tolerance;
+}
+
+QList<QPolygonF> BitmapTracer::outlines(const QImage & source)
+{
+	QList<QPolygonF> result;
+	m_stats = Stats();
+	if (source.isNull()) return result;
+
+	QImage image = (source.format() == QImage::Format_Mono) ? source : source.convertToFormat(QImage::Format_Mono);
+	int width = image.width();
+	int height = image.height();
+	int stride = width + 1;
+
+	// one byte per pixel corner: the low nibble holds the edges not yet traced, the high nibble all of them
+	QVector<uchar> edges(stride * (height + 1), 0);
+	uchar * e = edges.data();
+	for (int y = 0; y < height; y++) {
+		bool previous = false;
+		for (int x = 0; x < width; x++) {
+			bool current = isSet(image, x, y);
+			if (current && !previous) m_stats.runs++;
+			previous = current;
+			if (!current) continue;
+
+			// walk clockwise around the pixel, skipping the sides shared with other set pixels
+			if (!isSet(image, x, y - 1)) e[(y * stride) + x] |= 1 << Right;
+			if (!isSet(image, x + 1, y)) e[(y * stride) + x + 1] |= 1 << Down;
+			if (!isSet(image, x, y + 1)) e[((y + 1) * stride) + x + 1] |= 1 << Left;
+			if (!isSet(image, x - 1, y)) e[((y + 1) * stride) + x] |= 1 << Up;
+		}
+	}
+
+	for (int v = 0; v < edges.count(); v++) {
+		e[v] |= e[v] << 4;
+	}
+
+	for (int v = 0; v < edges.count(); v++) {
+		while (e[v] & 0x0f) {
+			// v is the first corner of this outline in scan order, so the outline always turns here
+			int startD = 0;
+			while (((e[v] >> startD) & 1) == 0) startD++;
+
+			int startX = v % stride;
+			int startY = v / stride;
+			int x = startX;
+			int y = startY;
+			int d = startD;
+			QPolygonF outline;
+			outline.append(QPointF(x, y));
+			forever {
+				e[(y * stride) + x] &= ~(1 << d);
+				x += DX[d];
+				y += DY[d];
+				int next = nextDirection(e[(y * stride) + x] >> 4, d);
+				if (x == startX && y == startY && next == startD) break;
+
+				if (next != d) outline.append(QPointF(x, y));
+				d = next;
+			}
+
+			result.append(outline);
+		}
+	}
+
+	return result;
+}
+
+QPolygonF BitmapTracer::simplify(const QPolygonF & outline) const
+{
+	int count = outline.count();
+	if (m_tolerance <= 0 || count <= 4) return outline;
+
+	// Douglas-Peucker on a closed outline: split it at the point farthest from the first point and simplify both halves.
+	// Index count stands for the first point again.
+	int farthest = 0;
+	double farthestDistance = -1;
+	for (int i = 1; i < count; i++) {
+		QPointF delta = outline.at(i) - outline.at(0);
+		double distance = QPointF::dotProduct(delta, delta);
+		if (distance > farthestDistance) {
+			farthestDistance = distance;
+			farthest = i;
+		}
+	}
+
+	QVector<bool> keep(count, false);
+	keep[0] = keep[farthest] = true;
+	double toleranceSquared = m_tolerance * m_tolerance;
+	QVector< QPair<int, int> > spans;
+	spans << qMakePair(0, farthest) << qMakePair(farthest, count);
+	while (!spans.isEmpty()) {
+		QPair<int, int> span = spans.takeLast();
+		const QPointF & a = outline.at(span.first);
+		const QPointF & b = outline.at(span.second % count);
+		int split = -1;
+		double worst = toleranceSquared;
+		for (int i = span.first + 1; i < span.second; i++) {
+			double distance = distanceSquared(outline.at(i), a, b);
+			if (distance > worst) {
+				worst = distance;
+				split = i;
+			}
+		}
+		if (split < 0) continue;
+
+		keep[split] = true;
+		spans << qMakePair(span.first, split) << qMakePair(split, span.second);
+	}
+
+	QPolygonF result;
+	for (int i = 0; i < count; i++) {
+		if (keep.at(i)) result.append(outline.at(i));
+	}
+
+	// specks smaller than the tolerance would collapse to nothing; keep them as traced
+	if (result.count() < 3) return outline;
+
+	return result;
+}
+
+bool BitmapTracer::isSmooth(const QPointF & prev, const QPointF & p, const QPointF & next) const
+{
+	if (m_tolerance <= 0) return false;
+
+	QPointF in = p - prev;
+	QPointF out = next - p;
+	double lengths = qSqrt(QPointF::dotProduct(in, in) * QPointF::dotProduct(out, out));
+	if (lengths <= 0) return false;
+	if (QPointF::dotProduct(in, out) / lengths < MinSmoothCos) return false;
+
+	// the curve from midpoint to midpoint passes (2p - prev - next) / 8 away from p
+	QPointF pull = ((p * 2) - prev - next) / 8;
+	double limit = MaxSmoothDeviation * m_tolerance;
+	return QPointF::dotProduct(pull, pull) <= limit * limit;
+}
+
+void BitmapTracer::appendCommand(QChar command, QString & d) {
+	if (command == m_lastCommand) return;
+
+	d += command;
+	m_lastCommand = command;
+}
+
+void BitmapTracer::appendPoint(const QPointF & p, double scale, QString & d) {
+	if (!d.isEmpty() && !d.at(d.length() - 1).isLetter()) d += ' ';
+	d += number(p.x() * scale);
+	d += ' ';
+	d += number(p.y() * scale);
+}
+
+void BitmapTracer::appendOutline(const QPolygonF & polygon, double scale, QString & d)
+{
+	int count = polygon.count();
+	QVector<bool> smooth(count);
+	int corner = -1;
+	for (int i = 0; i < count; i++) {
+		smooth[i] = isSmooth(polygon.at((i + count - 1) % count), polygon.at(i), polygon.at((i + 1) % count));
+		if (!smooth.at(i) && corner < 0) corner = i;
+	}
+
+	// smooth points become quadratic curves running from the midpoint before them to the midpoint after them
+	auto midpoint = [&polygon, count](int i) {
+		return (polygon.at(i) + polygon.at((i + 1) % count)) / 2;
+	};
+
+	if (corner < 0) {
+		appendCommand('M', d);
+		appendPoint(midpoint(count - 1), scale, d);
+		for (int i = 0; i < count; i++) {
+			appendCommand('Q', d);
+			appendPoint(polygon.at(i), scale, d);
+			appendPoint(midpoint(i), scale, d);
+			m_stats.curves++;
+		}
+	}
+	else {
+		appendCommand('M', d);
+		appendPoint(polygon.at(corner), scale, d);
+		int previous = corner;
+		for (int j = 1; j < count; j++) {
+			int i = (corner + j) % count;
+			if (smooth.at(i)) {
+				if (!smooth.at(previous)) {
+					appendCommand('L', d);
+					appendPoint(midpoint(previous), scale, d);
+					m_stats.lines++;
+				}
+				appendCommand('Q', d);
+				appendPoint(polygon.at(i), scale, d);
+				appendPoint(midpoint(i), scale, d);
+				m_stats.curves++;
+			}
+			else {
+				appendCommand('L', d);
+				appendPoint(polygon.at(i), scale, d);
+				m_stats.lines++;
+			}
+			previous = i;
+		}
+		m_stats.lines++;			// closing back to the corner
+	}
+
+	appendCommand('Z', d);
+}
+
+QString BitmapTracer::pathData(const QImage & image, double scale)
+{
+	QList<QPolygonF> traced = outlines(image);
+
+	QString d;
+	m_lastCommand = QChar();
+	foreach (QPolygonF outline, traced) {
+		appendOutline(simplify(outline), scale, d);
+		m_stats.contours++;
+	}
+
+	m_stats.bytes = d.length();
+	return d;
+}
@@ -0,0 +1,73 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef BITMAPTRACER_H
+#define BITMAPTRACER_H
+
+#include <QImage>
+#include <QList>
+#include <QPolygonF>
+#include <QString>
+#include <QVector>
+
+// Turns a 1-bit image into a single compact svg path instead of one polygon per pixel run.
+// Pixels whose bit is set are traced (the same convention as GroundPlaneGenerator::scanLines).
+// Outlines follow the pixel edges, are simplified to within the tolerance (in pixels) and,
+// where the outline bends gently, fitted with quadratic curves; sharp corners stay sharp.
+// Outer outlines run clockwise and holes counter-clockwise, so either fill rule works.
+
+class BitmapTracer
+{
+public:
+	struct Stats {
+		int runs = 0;				// pixel runs: what the scanline approach starts from
+		int contours = 0;
+		int lines = 0;
+		int curves = 0;
+		int bytes = 0;
+	};
+
+public:
+	BitmapTracer(double tolerance = DefaultTolerance);
+
+	QString pathData(const QImage & image, double scale = 1);
+	QList<QPolygonF> outlines(const QImage & image);
+	QPolygonF simplify(const QPolygonF & outline) const;
+	const Stats & stats() const;
+
+	static double savedTolerance();
+
+public:
+	static const QString ToleranceSettingName;
+	static const double DefaultTolerance;
+
+protected:
+	void appendOutline(const QPolygonF & polygon, double scale, QString & d);
+	bool isSmooth(const QPointF & prev, const QPointF & p, const QPointF & next) const;
+	void appendCommand(QChar command, QString & d);
+	void appendPoint(const QPointF & p, double scale, QString & d);
+
+protected:
+	double m_tolerance;
+	Stats m_stats;
+	QChar m_lastCommand;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "drillplanner.h"
+
+#include <qmath.h>
+#include <algorithm>
+
+// above this many hits per tool, 2-opt only looks this far along the tour for a better edge
+static const int FullTwoOptLimit = 1500;
+static const int TwoOptWindow = 200;
+static const int MaxTwoOptPasses = 50;
+
+static inline double distance(const QPoint & p, const QPoint & q) {
+	return qSqrt(((double) (p.x() - q.x()) * (p.x() - q.x())) + ((double) (p.y() - q.y()) * (p.y() - q.y())));
+}
+
+static inline quint64 hitKey(const QPoint & p) {
+	return ((quint64) (quint32) p.x() << 32) | (quint32) p.y();
+}
+
+/////////////////////////////////////////////////////////////////////
+
+void DrillPlanner::addHit(const QString & aperture, double diameter, const QPoint & hit) {
+	Tool * tool = nullptr;
+	for (int i = 0; i < m_tools.count(); i++) {
+		if (m_tools.at(i).aperture == aperture) {
+			tool = &m_tools[i];
+			break;
+		}
+	}
+
+	if (tool == nullptr) {
+		m_tools.append(Tool());
+		tool = &m_tools.last();
+		tool->aperture = aperture;
+		tool->diameter = diameter;
+	}
+
+	// the same hole can come from more than one layer
+	quint64 key = hitKey(hit);
+	if (tool->seen.contains(key)) return;
+
+	tool->seen.insert(key);
+	tool->hits.append(hit);
+}
+
+void DrillPlanner::clear() {
+	m_tools.clear();
+	m_end = QPoint();
+	m_travelBefore = m_travelAfter = 0;
+}
+
+bool DrillPlanner::isEmpty() const {
+	return m_tools.isEmpty();
+}
+
+int DrillPlanner::toolCount() const {
+	return m_tools.count();
+}
+
+const QList<DrillPlanner::Tool> & DrillPlanner::tools() const {
+	return m_tools;
+}
+
+QPoint DrillPlanner::end() const {
+	return m_end;
+}
+
+double DrillPlanner::travelBefore() const {
+	return m_travelBefore;
+}
+
+double DrillPlanner::travelAfter() const {
+	return m_travelAfter;
+}
+
+void DrillPlanner::plan(const QPoint & start) {
+	QPoint p = start;
+	m_travelBefore = 0;
+	foreach (const Tool & tool, m_tools) {
+		m_travelBefore += travel(p, tool.hits);
+		if (!tool.hits.isEmpty()) p = tool.hits.last();
+	}
+
+	std::stable_sort(m_tools.begin(), m_tools.end(), [](const Tool & t1, const Tool & t2) {
+		return t1.diameter < t2.diameter;
+	});
+
+	p = start;
+	m_travelAfter = 0;
+	for (int i = 0; i < m_tools.count(); i++) {
+		Tool & tool = m_tools[i];
+		nearestNeighbour(p, tool.hits);
+		twoOpt(p, tool.hits);
+		m_travelAfter += travel(p, tool.hits);
+		if (!tool.hits.isEmpty()) p = tool.hits.last();
+	}
+
+	m_end = p;
+}
+
+void DrillPlanner::write(QTextStream & header, QTextStream & body, int firstIndex) const {
+	int ix = firstIndex;
+	foreach (const Tool & tool, m_tools) {
+		header << "T" << ix << tool.aperture << "\n";
+		body << "T" << ix << "\n";
+		foreach (const QPoint & hit, tool.hits) {
+			body << formatHit(hit) << "\n";
+		}
+		ix++;
+	}
+}
+
+QString DrillPlanner::formatHit(const QPoint & hit) {
+	return QString("X%1Y%2").arg(hit.x(), 6, 10, QChar('0')).arg(hit.y(), 6, 10, QChar('0'));
+}
+
+double DrillPlanner::travel(const QPoint & start, const QVector<QPoint> & hits) {
+	double result = 0;
+	QPoint p = start;
+	foreach (const QPoint & hit, hits) {
+		result += distance(p, hit);
+		p = hit;
+	}
+	return result;
+}
+
+void DrillPlanner::nearestNeighbour(const QPoint & start, QVector<QPoint> & hits) {
+	// a plain O(n^2) scan: a tool rarely has more than a few thousand hits
+	QPoint p = start;
+	for (int i = 0; i < hits.count(); i++) {
+		int best = i;
+		double bestDistance = distance(p, hits.at(i));
+		for (int j = i + 1; j < hits.count(); j++) {
+			double d = distance(p, hits.at(j));
+			if (d < bestDistance) {
+				bestDistance = d;
+				best = j;
+			}
+		}
+		if (best != i) std::swap(hits[i], hits[best]);
+		p = hits.at(i);
+	}
+}
+
+void DrillPlanner::twoOpt(const QPoint & start, QVector<QPoint> & hits) {
+	// an open tour: the start is fixed, the end is free.  Reversing tour[i + 1 .. j] swaps
+	// edges (i, i + 1) and (j, j + 1) for (i, j) and (i + 1, j + 1); there is no edge after the last hit
+	QVector<QPoint> tour;
+	tour.reserve(hits.count() + 1);
+	tour.append(start);
+	tour += hits;
+
+	int n = tour.count();
+	int window = (hits.count() > FullTwoOptLimit) ? TwoOptWindow : n;
+	for (int pass = 0; pass < MaxTwoOptPasses; pass++) {
+		bool improved = false;
+		for (int i = 0; i < n - 2; i++) {
+			const QPoint & a = tour.at(i);
+			int last = qMin(n - 1, i + window);
+			for (int j = i + 2; j <= last; j++) {
+				const QPoint & b = tour.at(i + 1);
+				const QPoint & c = tour.at(j);
+				double delta = distance(a, c) - distance(a, b);
+				if (j + 1 < n) {
+					const QPoint & d = tour.at(j + 1);
+					delta += distance(b, d) - distance(c, d);
+				}
+				if (delta < -0.001) {
+					std::reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+					improved = true;
+				}
+			}
+		}
+		if (!improved) break;
+	}
+
+	hits = tour.mid(1);
+}
@@ -0,0 +1,76 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef DRILLPLANNER_H
+#define DRILLPLANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QPoint>
+#include <QVector>
+#include <QList>
+#include <QSet>
+#include <QTextStream>
+
+// Orders the hits in an Excellon drill file so the spindle doesn't wander: tools go smallest diameter first,
+// and the hits of each tool follow a nearest-neighbour tour, tightened with 2-opt, that starts wherever the
+// previous tool left off.  Coordinates are in the file's units (10000ths of an inch); travel is straight-line.
+
+class DrillPlanner
+{
+public:
+	struct Tool {
+		QString aperture;
+		double diameter = 0;
+		QVector<QPoint> hits;
+		QSet<quint64> seen;
+	};
+
+public:
+	DrillPlanner() = default;
+
+	void addHit(const QString & aperture, double diameter, const QPoint & hit);
+	void clear();
+	bool isEmpty() const;
+	int toolCount() const;
+	const QList<Tool> & tools() const;
+
+	void plan(const QPoint & start = QPoint());
+	QPoint end() const;					// where the last tool finishes
+	double travelBefore() const;		// in the order the hits were added
+	double travelAfter() const;
+
+	// writes T<n><aperture> header lines and T<n> + hit body lines, numbering tools from firstIndex
+	void write(QTextStream & header, QTextStream & body, int firstIndex) const;
+
+	static QString formatHit(const QPoint &);
+	static double travel(const QPoint & start, const QVector<QPoint> & hits);
+	static void nearestNeighbour(const QPoint & start, QVector<QPoint> & hits);
+	static void twoOpt(const QPoint & start, QVector<QPoint> & hits);
+
+protected:
+	QList<Tool> m_tools;
+	QPoint m_end;
+	double m_travelBefore = 0;
+	double m_travelAfter = 0;
+};
+
+#endif
@@ -36,6 +36,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 #include "../utils/folderutils.h"
 #include "../version/version.h"
+#include "../utils/tracer.h"
+#include "svgoutline.h"
 
 const QString GerberGenerator::SilkTopSuffix = "_silkTop.gto";
 const QString GerberGenerator::SilkBottomSuffix = "_silkBottom.gbo";
@@ -75,6 +77,7 @@ bool pixelsCollide(QImage * image1, QImage * image2, int x1, int y1, int x2, int
 
 void GerberGenerator::exportToGerber(const QString & prefix, const QString & exportDir, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes)
 {
+	TraceScope trace("gerber export", prefix);
 	if (board == nullptr) {
 		int boardCount;
 		board = sketchWidget->findSelectedBoard(boardCount);
@@ -167,14 +170,7 @@ int GerberGenerator::doCopper(ItemBase * board, PCBSketchWidget * sketchWidget,
 	}
 
 	QMultiHash<long, ConnectorItem *> treatAsCircle;
-	foreach (QGraphicsItem * item, sketchWidget->scene()->collidingItems(board)) {
-		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
-		if (connectorItem == nullptr) continue;
-		if (!connectorItem->isPath()) continue;
-		if (connectorItem->radius() == 0) continue;
-
-		treatAsCircle.insert(connectorItem->attachedToID(), connectorItem);
-	}
+	collectDonuts(board, sketchWidget, treatAsCircle);
 
 	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svg);
 
@@ -239,14 +235,7 @@ int GerberGenerator::doDrill(ItemBase * board, PCBSketchWidget * sketchWidget, c
 
 	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svgDrill);
 	QMultiHash<long, ConnectorItem *> treatAsCircle;
-	foreach (QGraphicsItem * item, sketchWidget->scene()->collidingItems(board)) {
-		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
-		if (connectorItem == nullptr) continue;
-		if (!connectorItem->isPath()) continue;
-		if (connectorItem->radius() == 0) continue;
-
-		treatAsCircle.insert(connectorItem->attachedToID(), connectorItem);
-	}
+	collectDonuts(board, sketchWidget, treatAsCircle);
 
 	svgDrill = clipToBoard(svgDrill, board, "Copper0", SVG2gerber::ForDrill, "", displayMessageBoxes, treatAsCircle);
 	if (svgDrill.isEmpty()) {
@@ -346,7 +335,7 @@ bool GerberGenerator::saveEnd(const QString & layerName, const QString & exportD
 	}
 
 	QTextStream stream(&out);
-	stream << gerber.getGerber();
+	gerber.write(stream);
 	stream.flush();
 	out.close();
 	return true;
@@ -965,74 +954,102 @@ void GerberGenerator::exportPickAndPlace(const QString & prefix, const QString &
 	out.close();
 }
 
+void GerberGenerator::collectDonuts(ItemBase * board, PCBSketchWidget * sketchWidget, QMultiHash<long, ConnectorItem *> & treatAsCircle) {
+	foreach (QGraphicsItem * item, sketchWidget->scene()->collidingItems(board)) {
+		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
+		if (connectorItem == nullptr) continue;
+		if (!connectorItem->isPath()) continue;
+		if (connectorItem->radius() == 0) continue;
+
+		treatAsCircle.insert(connectorItem->attachedToID(), connectorItem);
+	}
+}
+
 void GerberGenerator::handleDonuts(QDomElement & root1, QMultiHash<long, ConnectorItem *> & treatAsCircle) {
-	// most of this would not be necessary if we cached cleaned SVGs
+	// round pads drawn as paths are replaced by circles, which become flashed apertures.
+	// The center comes straight from the path data; paths whose data can't be parsed
+	// fall back to QSvgRenderer, loaded once for all of them
 
-	static const QString unique("%%%%%%%%%%%%%%%%%%%%%%%%_________________________________%%%%%%%%%%%%%%%%%%%%%%%%%%%%%");
+	if (treatAsCircle.count() == 0) return;
 
+	QSet<QString> ids;
+	foreach (ConnectorItem * connectorItem, treatAsCircle) {
+		ItemBase * itemBase = connectorItem->attachedTo();
+		SvgIdLayer * svgIdLayer = connectorItem->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
+		ids.insert(svgIdLayer->m_svgId);
+	}
+
+	QList<QDomElement> paths;
+	QStringList pathIDs;
+	QList<ConnectorItem *> pads;
+	QList<QPointF> centers;
+	QList<int> unresolved;
 	QDomNodeList nodeList = root1.elementsByTagName("path");
-	if (treatAsCircle.count() > 0) {
-		QStringList ids;
-		foreach (ConnectorItem * connectorItem, treatAsCircle.values()) {
-			ItemBase * itemBase = connectorItem->attachedTo();
-			SvgIdLayer * svgIdLayer = connectorItem->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
-			DebugDialog::debug(QString("treat as circle %1").arg(svgIdLayer->m_svgId));
-			ids << svgIdLayer->m_svgId;
+	for (int n = 0; n < nodeList.count(); n++) {
+		QDomElement path = nodeList.at(n).toElement();
+		QString id = path.attribute("id");
+		if (id.isEmpty()) continue;
+		if (!ids.contains(id)) continue;
+
+		ConnectorItem * connectorItem = nullptr;
+		for (QDomElement parent = path.parentNode().toElement(); !parent.isNull(); parent = parent.parentNode().toElement()) {
+			QString pid = parent.attribute("partID");
+			if (pid.isEmpty()) continue;
+
+			QList<ConnectorItem *> connectorItems = treatAsCircle.values(pid.toLong());
+			if (connectorItems.count() == 0) break;
+
+			foreach (ConnectorItem * candidate, connectorItems) {
+				ItemBase * itemBase = candidate->attachedTo();
+				SvgIdLayer * svgIdLayer = candidate->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
+				if (svgIdLayer->m_svgId == id) {
+					connectorItem = candidate;
+					break;
+				}
+			}
+
+			if (connectorItem) break;
 		}
+		if (connectorItem == nullptr) continue;
 
-		for (int n = 0; n < nodeList.count(); n++) {
-			QDomElement path = nodeList.at(n).toElement();
-			QString id = path.attribute("id");
-			if (id.isEmpty()) continue;
-
-			DebugDialog::debug(QString("checking for %1").arg(id));
-			if (!ids.contains(id)) continue;
-
-			QString pid;
-			ConnectorItem * connectorItem = nullptr;
-			for (QDomElement parent = path.parentNode().toElement(); !parent.isNull(); parent = parent.parentNode().toElement()) {
-				pid = parent.attribute("partID");
-				if (pid.isEmpty()) continue;
-
-				QList<ConnectorItem *> connectorItems = treatAsCircle.values(pid.toLong());
-				if (connectorItems.count() == 0) break;
-
-				foreach (ConnectorItem * candidate, connectorItems) {
-					ItemBase * itemBase = candidate->attachedTo();
-					SvgIdLayer * svgIdLayer = candidate->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
-					if (svgIdLayer->m_svgId == id) {
-						connectorItem = candidate;
-						break;
-					}
-				}
+		QRectF bounds = SvgOutline::pathBounds(path);
+		if (bounds.isNull()) {
+			unresolved << paths.count();
+		}
 
-				if (connectorItem) break;
-			}
-			if (connectorItem == nullptr) continue;
-
-			//QString string;
-			//QTextStream stream(&string);
-			//path.save(stream, 0);
-			//DebugDialog::debug("path " + string);
-
-			connectorItem->debugInfo("make path");
-			path.setAttribute("id", unique);
-			QSvgRenderer renderer;
-			renderer.load(root1.ownerDocument().toByteArray());
-			QRectF bounds = renderer.boundsOnElement(unique);
-			path.removeAttribute("id");
-
-			QDomElement circle = root1.ownerDocument().createElement("circle");
-			path.parentNode().insertBefore(circle, path);
-			circle.setAttribute("id", id);
-			QPointF p = bounds.center();
-			circle.setAttribute("cx", QString::number(p.x()));
-			circle.setAttribute("cy", QString::number(p.y()));
-			circle.setAttribute("r", QString::number(connectorItem->radius() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI));
-			circle.setAttribute("stroke-width", QString::number(connectorItem->strokeWidth() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI));
+		paths << path;
+		pathIDs << id;
+		pads << connectorItem;
+		centers << bounds.center();
+	}
+
+	if (unresolved.count() > 0) {
+		static const QString unique("%%%%%%%%%%%%%%%%%%%%%%%%_________________________________%1");
+		foreach (int i, unresolved) {
+			paths[i].setAttribute("id", unique.arg(i));
+		}
 
+		QSvgRenderer renderer;
+		renderer.load(root1.ownerDocument().toByteArray());
+		foreach (int i, unresolved) {
+			centers[i] = renderer.boundsOnElement(unique.arg(i)).center();
 		}
 	}
+
+	for (int i = 0; i < paths.count(); i++) {
+		QDomElement path = paths.at(i);
+		ConnectorItem * connectorItem = pads.at(i);
+		path.removeAttribute("id");
+
+		QDomElement circle = root1.ownerDocument().createElement("circle");
+		path.parentNode().insertBefore(circle, path);
+		circle.setAttribute("id", pathIDs.at(i));
+		QPointF p = centers.at(i);
+		circle.setAttribute("cx", QString::number(p.x()));
+		circle.setAttribute("cy", QString::number(p.y()));
+		circle.setAttribute("r", QString::number(connectorItem->radius() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI));
+		circle.setAttribute("stroke-width", QString::number(connectorItem->strokeWidth() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI));
+	}
 }
 
 QString GerberGenerator::renderTo(const LayerList & layers, ItemBase * board, PCBSketchWidget * sketchWidget, bool & empty) {
@@ -29,6 +29,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/wire.h"
 #include "../processeventblocker.h"
 #include "../autoroute/drc.h"
+#include "../utils/tracer.h"
 
 #include <QBitArray>
 #include <QPainter>
@@ -247,6 +248,7 @@ bool GroundPlaneGenerator::generateGroundPlaneUnit(const QString & boardSvg, QSi
 bool GroundPlaneGenerator::generateGroundPlane(const QString & boardSvg, QSizeF boardImageSize, const QString & svg, QSizeF copperImageSize,
 		QStringList & exceptions, QGraphicsItem * board, double res, const QString & color, double keepoutMils)
 {
+	TraceScope trace("ground fill");
 	GPGParams params;
 	params.boardSvg = boardSvg;
 	params.keepoutMils = keepoutMils;
@@ -76,6 +76,19 @@ QString SVG2gerber::getGerber() {
 	return m_gerber_header + m_gerber_paths;
 }
 
+void SVG2gerber::write(QTextStream & stream) {
+	// saves concatenating header and paths into yet another copy of the file
+	stream << m_gerber_header << m_gerber_paths;
+}
+
+const DrillPlanner & SVG2gerber::holes() {
+	return m_holes;
+}
+
+const DrillPlanner & SVG2gerber::platedHoles() {
+	return m_platedHoles;
+}
+
 int SVG2gerber::renderGerber(bool doubleSided, const QString & mainLayerName, ForWhy forWhy) {
 	if (forWhy != ForDrill) {
 		// human readable description comments
@@ -111,44 +124,39 @@ int SVG2gerber::renderGerber(bool doubleSided, const QString & mainLayerName, Fo
 	if (forWhy == ForDrill) {
 		static const int initialHoleIndex = 1;
 		static const int offset = 100;
-		int initialPlatedIndex = (((m_holeApertures.uniqueKeys().count() + initialHoleIndex - 1) / offset) + 1) * offset;
+		int initialPlatedIndex = (((m_holes.toolCount() + initialHoleIndex - 1) / offset) + 1) * offset;
+
+		// the machine drills in file order: plated holes pick up where the non-plated ones finish
+		m_holes.plan();
+		m_platedHoles.plan(m_holes.end());
+		DebugDialog::debug(QString("drill travel %1 in, unordered %2 in")
+		                   .arg((m_holes.travelAfter() + m_platedHoles.travelAfter()) / 10000, 0, 'f', 2)
+		                   .arg((m_holes.travelBefore() + m_platedHoles.travelBefore()) / 10000, 0, 'f', 2));
+
 		m_gerber_header = "";
-		m_gerber_header += QString("; NON-PLATED HOLES START AT T%1\n").arg(initialHoleIndex);
-		m_gerber_header += QString("; THROUGH (PLATED) HOLES START AT T%1\n").arg(initialPlatedIndex);
+		QTextStream header(&m_gerber_header, QIODevice::Append);
+		QTextStream paths(&m_gerber_paths, QIODevice::Append);
+		header << "; NON-PLATED HOLES START AT T" << initialHoleIndex << "\n";
+		header << "; THROUGH (PLATED) HOLES START AT T" << initialPlatedIndex << "\n";
 
 		// setup drill file header
-		m_gerber_header += "M48\n";
+		header << "M48\n";
 		// set to english (inches) units, with trailing zeros
-		m_gerber_header += "INCH\n";
-
-		int ix = initialHoleIndex;
-		foreach (QString aperture, m_holeApertures.uniqueKeys()) {
-			m_gerber_header += QString("T%1%2\n").arg(ix).arg(aperture);
-			m_gerber_paths += QString("T%1\n").arg(ix);
-			foreach (QString loc, m_holeApertures.values(aperture).toSet()) {
-				m_gerber_paths += loc + "\n";
-			}
-			ix++;
-		}
+		header << "INCH\n";
 
-		ix = initialPlatedIndex;
-		foreach (QString aperture, m_platedApertures.uniqueKeys()) {
-			m_gerber_header += QString("T%1%2\n").arg(ix).arg(aperture);
-			m_gerber_paths += QString("T%1\n").arg(ix);
-			foreach (QString loc, m_platedApertures.values(aperture).toSet()) {
-				m_gerber_paths += loc + "\n";
-			}
-			ix++;
-		}
+		m_holes.write(header, paths, initialHoleIndex);
+		m_platedHoles.write(header, paths, initialPlatedIndex);
 
-		m_gerber_header += "%\n";    // closes the header
+		header << "%\n";    // closes the header
 
 
 		//m_gerber_paths += m_drill_slots;   // from handleOblong, not up to date
 
 		// drill file unload tool and end of program
-		m_gerber_paths += "T00\n";
-		m_gerber_paths += "M30\n";
+		paths << "T00\n";
+		paths << "M30\n";
+		header.flush();
+		paths.flush();
 
 	}
 	else {
@@ -271,8 +279,8 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 	int currentx = -1;
 	int currenty = -1;
 
-	m_holeApertures.clear();
-	m_platedApertures.clear();
+	m_holes.clear();
+	m_platedHoles.clear();
 
 	// iterates through all circles, rects, lines and paths
 	//  1. check if we already have an aperture
@@ -324,12 +332,10 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 		if (forWhy == ForDrill) {
 			if (noDrill) continue;
 
-			QString drill_cx = QString("%1").arg((int) (flipxNoRound(centerx) * 10), 6, 10, QChar('0'));				// drill file is in inches 00.0000, converting mils to 10000ths
-			QString drill_cy = QString("%1").arg((int) (flipyNoRound(centery) * 10), 6, 10, QChar('0'));				// drill file is in inches 00.0000, converting mils to 10000ths
+			QPoint loc((int) (flipxNoRound(centerx) * 10), (int) (flipyNoRound(centery) * 10));		// drill file is in inches 00.0000, converting mils to 10000ths
 			QString aperture = QString("C%1").arg(hole, 0, 'f');
-			QString loc = "X" + drill_cx + "Y" + drill_cy;
-			if (stroke_width == 0) m_holeApertures.insert(aperture, loc);
-			else m_platedApertures.insert(aperture, loc);
+			if (stroke_width == 0) m_holes.addHit(aperture, hole, loc);
+			else m_platedHoles.addHit(aperture, hole, loc);
 			continue;
 		}
 
@@ -508,6 +514,8 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 	}
 
 	// paths - NOTE: this assumes circular aperture
+	auto visitor = SvgFileSplitter::commandVisitor(this, &SVG2gerber::path2gerbCommandSlot);
+	SvgFlattener flattener;			// one flattener, so its path tokenizer is reused from path to path
 	for(int n = 0; n < pathList.length(); n++) {
 		QDomElement path = pathList.item(n).toElement();
 
@@ -518,18 +526,15 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 
 		QString data = path.attribute("d").trimmed();
 
-		const char * slot = SLOT(path2gerbCommandSlot(QChar, bool, QList<double> &, void *));
-
 		PathUserData pathUserData;
 		pathUserData.x = 0;
 		pathUserData.y = 0;
 		pathUserData.pathStarting = true;
 		pathUserData.string = "";
 
-		SvgFlattener flattener;
 		bool invalid = false;
 		try {
-			flattener.parsePath(data, slot, pathUserData, this, true);
+			flattener.parsePath(data, visitor, pathUserData, true);
 		}
 		catch (const QString & msg) {
 			DebugDialog::debug("flattener.parsePath failed " + msg);
@@ -745,7 +750,7 @@ QString SVG2gerber::path2gerber(QDomElement pathElement) {
 	return d;
 }
 
-void SVG2gerber::path2gerbCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+void SVG2gerber::path2gerbCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData) {
 	QString gerb_path;
 	double x, y;
 
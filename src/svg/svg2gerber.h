@@ -26,6 +26,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QMatrix>
 #include <QMultiHash>
+#include <QTextStream>
+
+#include "drillplanner.h"
+#include "svgpathtokenizer.h"
 
 class SVG2gerber : public QObject
 {
@@ -46,6 +50,9 @@ public:
 
 	int convert(const QString & svgStr, bool doubleSided, const QString & mainLayerName, ForWhy, QSizeF boardSize);
 	QString getGerber();
+	void write(QTextStream &);
+	const DrillPlanner & holes();
+	const DrillPlanner & platedHoles();
 
 protected:
 	QDomDocument m_SVGDom;
@@ -53,8 +60,8 @@ protected:
 	QString m_gerber_paths;
 	QString m_drill_slots;
 	QSizeF m_boardSize;
-	QMultiHash<QString, QString> m_platedApertures;
-	QMultiHash<QString, QString> m_holeApertures;
+	DrillPlanner m_platedHoles;
+	DrillPlanner m_holes;
 
 	double m_pathstart_x = 0.0;
 	double m_pathstart_y = 0.0;
@@ -85,7 +92,7 @@ protected:
 
 
 protected slots:
-	void path2gerbCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
+	void path2gerbCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData);
 
 
 };
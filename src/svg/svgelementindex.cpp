@@ -0,0 +1,215 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "svgelementindex.h"
+#include "svgoutline.h"
+#include "../utils/textutils.h"
+
+#include <QRegExp>
+#include <QStringList>
+
+#include <algorithm>
+
+// pixels at GraphicsUtils::SVGDPI, as in ConnectorIndex
+static const double CellSize = 36;
+
+static QString styleValue(const QDomElement & element, const QString & name) {
+	// a style property overrides the presentation attribute
+	QString style = element.attribute("style");
+	if (!style.isEmpty()) {
+		foreach (QString declaration, style.split(';', QString::SkipEmptyParts)) {
+			int colon = declaration.indexOf(':');
+			if (colon < 0) continue;
+			if (declaration.left(colon).trimmed() == name) return declaration.mid(colon + 1).trimmed();
+		}
+	}
+
+	return element.attribute(name);
+}
+
+static QString localName(const QDomElement & element) {
+	QString tagName = element.tagName();
+	int colon = tagName.indexOf(':');
+	if (colon >= 0) tagName = tagName.mid(colon + 1);
+	return tagName;
+}
+
+static bool isContainer(const QString & tagName) {
+	return tagName == "svg" || tagName == "g" || tagName == "a" || tagName == "switch";
+}
+
+static bool isNonRendering(const QString & tagName) {
+	// children are only drawn by reference, if at all
+	return tagName == "defs" || tagName == "symbol" || tagName == "clipPath" || tagName == "mask" ||
+	       tagName == "pattern" || tagName == "marker" || tagName == "linearGradient" || tagName == "radialGradient";
+}
+
+/////////////////////////////////////////////////////////////////////
+
+SvgElementIndex::SvgElementIndex() : m_grid(CellSize)
+{
+}
+
+void SvgElementIndex::build(const QDomElement & root, double scaleX, double scaleY) {
+	clear();
+	m_scale = QTransform::fromScale(scaleX, scaleY);
+	// svg strokes default to none, 1 wide
+	addElement(root, QTransform(), false, 1, true);
+
+	for (int i = 0; i < m_entries.count(); i++) {
+		const QRectF & bounds = m_entries.at(i).bounds;
+		if (bounds.width() > 0 && bounds.height() > 0) {
+			m_grid.insert(i, bounds);
+		}
+	}
+}
+
+void SvgElementIndex::clear() {
+	m_entries.clear();
+	m_grid.clear();
+}
+
+int SvgElementIndex::count() const {
+	return m_entries.count();
+}
+
+SvgElementIndex::Entry & SvgElementIndex::entry(int index) {
+	return m_entries[index];
+}
+
+const SvgElementIndex::Entry & SvgElementIndex::entry(int index) const {
+	return m_entries.at(index);
+}
+
+QList<int> SvgElementIndex::entriesAt(const QPointF & p) const {
+	QList<int> result = m_grid.query(p);
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+bool SvgElementIndex::isPickable(const QString & tagName) {
+	return tagName == "rect" || tagName == "g" || tagName == "svg" || tagName == "circle" || tagName == "ellipse" ||
+	       tagName == "path" || tagName == "line" || tagName == "polyline" || tagName == "polygon" || tagName == "text";
+}
+
+QTransform SvgElementIndex::transformFromString(const QString & transform) {
+	// transformStringToMatrix only takes a single transform; a list applies right to left
+	QTransform result;
+	QRegExp item("[a-zA-Z]+\\s*\\([^)]*\\)");
+	int pos = 0;
+	while ((pos = item.indexIn(transform, pos)) != -1) {
+		result = QTransform(TextUtils::transformStringToMatrix(item.cap(0))) * result;
+		pos += item.matchedLength();
+	}
+
+	return result;
+}
+
+QRectF SvgElementIndex::addElement(const QDomElement & element, const QTransform & parentTransform, bool stroked, double strokeWidth, bool rendered) {
+	QString tagName = localName(element);
+	if (isNonRendering(tagName)) rendered = false;
+
+	int index = -1;
+	if (isPickable(tagName)) {
+		index = m_entries.count();
+		Entry entry;
+		entry.element = element;
+		m_entries.append(entry);
+	}
+
+	QTransform transform = parentTransform;
+	QString transformString = element.attribute("transform");
+	if (!transformString.isEmpty()) {
+		transform = transformFromString(transformString) * parentTransform;
+	}
+
+	QString stroke = styleValue(element, "stroke");
+	if (!stroke.isEmpty()) stroked = (stroke != "none");
+	bool ok;
+	double width = styleValue(element, "stroke-width").remove("px").toDouble(&ok);
+	if (ok) strokeWidth = width;
+
+	QRectF bounds;
+	if (isContainer(tagName) || isNonRendering(tagName)) {
+		QDomElement child = element.firstChildElement();
+		while (!child.isNull()) {
+			QRectF childBounds = addElement(child, transform, stroked, strokeWidth, rendered);
+			if (!childBounds.isNull()) bounds |= childBounds;
+			child = child.nextSiblingElement();
+		}
+	}
+	else if (rendered) {
+		QRectF local = shapeBounds(element, tagName);
+		if (!local.isNull()) {
+			if (stroked && strokeWidth > 0 && tagName != "image") {
+				local.adjust(-strokeWidth / 2, -strokeWidth / 2, strokeWidth / 2, strokeWidth / 2);
+			}
+			bounds = transform.mapRect(local);
+		}
+	}
+
+	if (!rendered) bounds = QRectF();
+	if (index >= 0 && !bounds.isNull()) {
+		m_entries[index].bounds = m_scale.mapRect(bounds);
+	}
+
+	return bounds;
+}
+
+QRectF SvgElementIndex::shapeBounds(const QDomElement & element, const QString & tagName) {
+	if (tagName == "rect" || tagName == "image") {
+		QRectF r(element.attribute("x").toDouble(), element.attribute("y").toDouble(),
+		         element.attribute("width").toDouble(), element.attribute("height").toDouble());
+		if (r.isEmpty()) return QRectF();
+		return r;
+	}
+
+	if (tagName == "circle") {
+		double r = element.attribute("r").toDouble();
+		if (r <= 0) return QRectF();
+		return QRectF(element.attribute("cx").toDouble() - r, element.attribute("cy").toDouble() - r, r * 2, r * 2);
+	}
+
+	if (tagName == "ellipse") {
+		double rx = element.attribute("rx").toDouble();
+		double ry = element.attribute("ry").toDouble();
+		if (rx <= 0 || ry <= 0) return QRectF();
+		return QRectF(element.attribute("cx").toDouble() - rx, element.attribute("cy").toDouble() - ry, rx * 2, ry * 2);
+	}
+
+	if (tagName == "line") {
+		QPointF p1(element.attribute("x1").toDouble(), element.attribute("y1").toDouble());
+		QPointF p2(element.attribute("x2").toDouble(), element.attribute("y2").toDouble());
+		return QRectF(p1, p2).normalized();
+	}
+
+	if (tagName == "path") {
+		return SvgOutline::pathFromData(element.attribute("d")).boundingRect();
+	}
+
+	if (tagName == "polyline" || tagName == "polygon") {
+		// the tokenizer wants a command up front
+		return SvgOutline::pathFromData("M" + element.attribute("points")).boundingRect();
+	}
+
+	// text: QSvgRenderer reports no bounds for it, so neither do we
+	return QRectF();
+}
@@ -0,0 +1,72 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef SVGELEMENTINDEX_H
+#define SVGELEMENTINDEX_H
+
+#include <QDomElement>
+#include <QTransform>
+#include <QRectF>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+
+#include "../utils/spatialgrid.h"
+
+// The bounds of every pickable element of an svg (the tags the parts editor lets you assign a connector to),
+// computed in one walk over the document instead of a QSvgRenderer::boundsOnElement/matrixForElement pair
+// per element.  Bounds follow what the renderer reports: shapes include their stroke, groups are the union
+// of their rendered children, and text is empty.  Elements with empty bounds are listed but not gridded.
+
+class SvgElementIndex
+{
+public:
+	struct Entry {
+		QDomElement element;
+		QRectF bounds;					// scaled; null for text and non-rendered elements
+		bool materialized = false;		// free for the caller to mark
+	};
+
+public:
+	SvgElementIndex();
+
+	void build(const QDomElement & root, double scaleX = 1, double scaleY = 1);
+	void clear();
+	int count() const;
+	Entry & entry(int index);
+	const Entry & entry(int index) const;
+
+	QList<int> entriesAt(const QPointF &) const;		// in document order
+
+	static bool isPickable(const QString & tagName);
+	static QTransform transformFromString(const QString &);
+
+protected:
+	QRectF addElement(const QDomElement &, const QTransform & parentTransform, bool stroked, double strokeWidth, bool rendered);
+	static QRectF shapeBounds(const QDomElement &, const QString & tagName);
+
+protected:
+	QVector<Entry> m_entries;
+	SpatialGrid<int> m_grid;
+	QTransform m_scale;
+};
+
+#endif
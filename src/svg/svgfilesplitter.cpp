@@ -23,9 +23,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/misc.h"
 #include "../utils/textutils.h"
 #include "../debugdialog.h"
-#include "svgpathparser.h"
 #include "svgpathlexer.h"
-#include "svgpathrunner.h"
+#include "svgpathtokenizer.h"
 
 #include <QDomDocument>
 #include <QFile>
@@ -278,11 +277,11 @@ void SvgFileSplitter::painterPathChild(QDomElement & element, QPainterPath & ppa
 	else if (element.nodeName().compare("polygon") == 0 || element.nodeName().compare("polyline") == 0) {
 		QString data = element.attribute("points");
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(painterPathCommandSlot(QChar, bool, QList<double> &, void *));
+			auto visitor = commandVisitor(this, &SvgFileSplitter::painterPathCommandSlot);
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.painterPath = &ppath;
-			if (parsePath(data, slot, pathUserData, this, false)) {
+			if (parsePath(data, visitor, pathUserData, false)) {
 			}
 		}
 	}
@@ -290,14 +289,14 @@ void SvgFileSplitter::painterPathChild(QDomElement & element, QPainterPath & ppa
 		/*
 		QString data = element.attribute("d").trimmed();
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(normalizeCommandSlot(QChar, bool, QList<double> &, void *));
+			auto visitor = commandVisitor(this, &SvgFileSplitter::normalizeCommandSlot);
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.sNewHeight = sNewHeight;
 			pathUserData.sNewWidth = sNewWidth;
 			pathUserData.vbHeight = vbHeight;
 			pathUserData.vbWidth = vbWidth;
-		    if (parsePath(data, slot, pathUserData, this, true)) {
+		    if (parsePath(data, visitor, pathUserData, true)) {
 				element.setAttribute("d", pathUserData.string);
 			}
 		}
@@ -395,14 +394,14 @@ void SvgFileSplitter::normalizeChild(QDomElement & element,
 		normalizeAttribute(element, "stroke-width", sNewWidth, vbWidth);
 		QString data = element.attribute("points");
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(normalizeCommandSlot(QChar, bool, QList<double> &, void *));
+			auto visitor = commandVisitor(this, &SvgFileSplitter::normalizeCommandSlot);
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.sNewHeight = sNewHeight;
 			pathUserData.sNewWidth = sNewWidth;
 			pathUserData.vbHeight = vbHeight;
 			pathUserData.vbWidth = vbWidth;
-			if (parsePath(data, slot, pathUserData, this, false)) {
+			if (parsePath(data, visitor, pathUserData, false)) {
 				pathUserData.string.remove(0, 1);			// get rid of the "M"
 				element.setAttribute("points", pathUserData.string);
 			}
@@ -415,14 +414,14 @@ void SvgFileSplitter::normalizeChild(QDomElement & element,
 		setStrokeOrFill(element, blackOnly, "black", false);
 		QString data = element.attribute("d").trimmed();
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(normalizeCommandSlot(QChar, bool, QList<double> &, void *));
+			auto visitor = commandVisitor(this, &SvgFileSplitter::normalizeCommandSlot);
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.sNewHeight = sNewHeight;
 			pathUserData.sNewWidth = sNewWidth;
 			pathUserData.vbHeight = vbHeight;
 			pathUserData.vbWidth = vbWidth;
-			if (parsePath(data, slot, pathUserData, this, true)) {
+			if (parsePath(data, visitor, pathUserData, true)) {
 				element.setAttribute("d", pathUserData.string);
 			}
 		}
@@ -598,12 +597,12 @@ void SvgFileSplitter::shiftChild(QDomElement & element, double x, double y, bool
 	else if (nodeName.compare("polygon") == 0 || nodeName.compare("polyline") == 0) {
 		QString data = element.attribute("points");
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(shiftCommandSlot(QChar, bool, QList<double> &, void *));
+			auto visitor = commandVisitor(this, &SvgFileSplitter::shiftCommandSlot);
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.x = x;
 			pathUserData.y = y;
-			if (parsePath(data, slot, pathUserData, this, false)) {
+			if (parsePath(data, visitor, pathUserData, false)) {
 				pathUserData.string.remove(0, 1);			// get rid of the "M"
 				element.setAttribute("points", pathUserData.string);
 			}
@@ -612,12 +611,12 @@ void SvgFileSplitter::shiftChild(QDomElement & element, double x, double y, bool
 	else if (nodeName.compare("path") == 0) {
 		QString data = element.attribute("d").trimmed();
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(shiftCommandSlot(QChar, bool, QList<double> &, void *));
+			auto visitor = commandVisitor(this, &SvgFileSplitter::shiftCommandSlot);
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.x = x;
 			pathUserData.y = y;
-			if (parsePath(data, slot, pathUserData, this, true)) {
+			if (parsePath(data, visitor, pathUserData, true)) {
 				element.setAttribute("d", pathUserData.string);
 			}
 		}
@@ -631,7 +630,7 @@ void SvgFileSplitter::shiftChild(QDomElement & element, double x, double y, bool
 	}
 }
 
-void SvgFileSplitter::normalizeCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+void SvgFileSplitter::normalizeCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData) {
 
 	Q_UNUSED(relative);			// just normalizing here, so relative is not used
 
@@ -707,7 +706,7 @@ void SvgFileSplitter::normalizeCommandSlot(QChar command, bool relative, QList<d
 	}
 }
 
-void SvgFileSplitter::painterPathCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+void SvgFileSplitter::painterPathCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData) {
 
 	Q_UNUSED(relative);			// just normalizing here, so relative is not used
 	Q_UNUSED(command)			// note: painterPathCommandSlot is only partially implemented
@@ -730,7 +729,7 @@ void SvgFileSplitter::painterPathCommandSlot(QChar command, bool relative, QList
 
 }
 
-void SvgFileSplitter::shiftCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+void SvgFileSplitter::shiftCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData) {
 
 	Q_UNUSED(relative);			// just normalizing here, so relative is not used
 
@@ -799,7 +798,7 @@ void SvgFileSplitter::shiftCommandSlot(QChar command, bool relative, QList<doubl
 	}
 }
 
-void SvgFileSplitter::standardArgs(bool relative, bool starting, QList<double> & args, PathUserData * pathUserData) {
+void SvgFileSplitter::standardArgs(bool relative, bool starting, const PathArgs & args, PathUserData * pathUserData) {
 	for (int i = 0; i < args.count(); i++) {
 		double d = args[i];
 		if (i % 2 == 0) {
@@ -819,55 +818,17 @@ void SvgFileSplitter::standardArgs(bool relative, bool starting, QList<double> &
 	}
 }
 
-QVector<QVariant> SvgFileSplitter::simpleParsePath(const QString & data) {
-	static QVector<QVariant> emptyStack;
+bool SvgFileSplitter::convertHVPath(const QString & data, QString & converted) {
+	HVConvertData hvData;
+	hvData.x = hvData.y = hvData.subX = hvData.subY = 0;
+	hvData.path = "";
+	if (!m_pathTokenizer.run(data, commandVisitor(this, &SvgFileSplitter::convertHVSlot), &hvData)) return false;
 
-	QString dataCopy(data);
-
-	if (!dataCopy.startsWith('M', Qt::CaseInsensitive)) {
-		dataCopy.prepend('M');
-	}
-	while (dataCopy.at(dataCopy.length() - 1).isSpace()) {
-		dataCopy.remove(dataCopy.length() - 1, 1);
-	}
-	QChar last = dataCopy.at(dataCopy.length() - 1);
-	if (last != 'z' && last != 'Z' && last != SVGPathLexer::FakeClosePathChar) {
-		dataCopy.append(SVGPathLexer::FakeClosePathChar);
-	}
-
-	SVGPathLexer lexer(dataCopy);
-	SVGPathParser parser;
-	if (!parser.parse(lexer)) {
-		//DebugDialog::debug(QString("svg path parse failed %1").arg(dataCopy));
-		return emptyStack;
-	}
-
-	return parser.symStack();
-}
-
-
-bool SvgFileSplitter::parsePath(const QString & dataString, const char * slot, PathUserData & pathUserData, QObject * slotTarget, bool convertHV) {
-	QVector<QVariant> symStack = simpleParsePath(dataString);
-
-	if (convertHV && (dataString.contains("h", Qt::CaseInsensitive) || dataString.contains("v",  Qt::CaseInsensitive)))
-	{
-		SVGPathRunner svgPathRunner;
-		HVConvertData data;
-		data.x = data.y = data.subX = data.subY = 0;
-		data.path = "";
-		connect(&svgPathRunner, SIGNAL(commandSignal(QChar, bool, QList<double> &, void *)),
-		        this, SLOT(convertHVSlot(QChar, bool, QList<double> &, void *)),
-		        Qt::DirectConnection);
-		svgPathRunner.runPath(symStack, &data);
-		return parsePath(data.path, slot, pathUserData, slotTarget, false);
-	}
-
-	SVGPathRunner svgPathRunner;
-	connect(&svgPathRunner, SIGNAL(commandSignal(QChar, bool, QList<double> &, void *)), slotTarget, slot, Qt::DirectConnection);
-	return svgPathRunner.runPath(symStack, &pathUserData);
+	converted = hvData.path;
+	return true;
 }
 
-void SvgFileSplitter::convertHVSlot(QChar command, bool /* relative */, QList<double> & args, void * userData) {
+void SvgFileSplitter::convertHVSlot(QChar command, bool /* relative */, const PathArgs & args, void * userData) {
 	HVConvertData * data = (HVConvertData *) userData;
 
 	switch(command.toLatin1()) {
@@ -31,6 +31,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QRegExp>
 #include <QFile>
 
+#include "svgpathtokenizer.h"
+
 struct PathUserData {
 	QString string;
 	QMatrix transform;
@@ -56,8 +58,18 @@ public:
 	bool normalize(double dpi, const QString & elementID, bool blackOnly, double & factor);
 	QString shift(double x, double y, const QString & elementID, bool shiftTransforms);
 	QString elementString(const QString & elementID);
-	virtual bool parsePath(const QString & data, const char * slot, PathUserData &, QObject * slotTarget, bool convertHV);
-	QVector<QVariant> simpleParsePath(const QString & data);
+	// the visitor receives one path command at a time: command, relative, args, userData
+	template <class Visitor>
+	bool parsePath(const QString & data, Visitor && visitor, PathUserData & pathUserData, bool convertHV) {
+		if (convertHV && (data.contains("h", Qt::CaseInsensitive) || data.contains("v", Qt::CaseInsensitive))) {
+			QString converted;
+			if (!convertHVPath(data, converted)) return false;
+
+			return m_pathTokenizer.run(converted, visitor, &pathUserData);
+		}
+
+		return m_pathTokenizer.run(data, visitor, &pathUserData);
+	}
 	QPainterPath painterPath(double dpi, const QString & elementID);			// note: only partially implemented
 	void shiftChild(QDomElement & element, double x, double y, bool shiftTransforms);
 	bool load(const QString * filename);
@@ -68,6 +80,13 @@ public:
 	void gReplace(const QString & id);
 
 public:
+	template <class T>
+	static auto commandVisitor(T * target, void (T::*method)(QChar, bool, const PathArgs &, void *)) {
+		return [target, method](QChar command, bool relative, const PathArgs & args, void * userData) {
+			(target->*method)(command, relative, args, userData);
+		};
+	}
+
 	static bool getSvgSizeAttributes(const QString & svg, QString & width, QString & height, QString & viewBox);
 	static bool changeStrokeWidth(const QString & svg, double delta, bool absolute, bool changeOpacity, QByteArray &);
 	static void changeStrokeWidth(QDomElement & element, double delta, bool absolute, bool changeOpacity);
@@ -94,7 +113,8 @@ protected:
 	                          double sNewWidth, double sNewHeight,
 	                          double vbWidth, double vbHeight);
 	bool shiftTranslation(QDomElement & element, double x, double y);
-	void standardArgs(bool relative, bool starting, QList<double> & args, PathUserData * pathUserData);
+	void standardArgs(bool relative, bool starting, const PathArgs & args, PathUserData * pathUserData);
+	bool convertHVPath(const QString & data, QString & converted);
 
 protected:
 	static bool shiftAttribute(QDomElement & element, const char * attributeName, double d);
@@ -103,15 +123,16 @@ protected:
 	static void showTextAux(QDomElement & parent, bool & hasText, bool root);
 
 protected slots:
-	void normalizeCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
-	void shiftCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
-	virtual void rotateCommandSlot(QChar, bool, QList<double> &, void *) {}
-	void painterPathCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
-	void convertHVSlot(QChar command, bool relative, QList<double> & args, void * userData);
+	void normalizeCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData);
+	void shiftCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData);
+	virtual void rotateCommandSlot(QChar, bool, const PathArgs &, void *) {}
+	void painterPathCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData);
+	void convertHVSlot(QChar command, bool relative, const PathArgs & args, void * userData);
 
 protected:
 	QByteArray m_byteArray;
 	QDomDocument m_domDocument;
+	SVGPathTokenizer m_pathTokenizer;			// reused by every parsePath on this splitter
 
 };
 
@@ -93,10 +93,10 @@ void SvgFlattener::unRotateChild(QDomElement & element, QMatrix transform) {
 		if(tag == "path") {
 			QString data = element.attribute("d").trimmed();
 			if (!data.isEmpty()) {
-				const char * slot = SLOT(rotateCommandSlot(QChar, bool, QList<double> &, void *));
+				auto visitor = commandVisitor(this, &SvgFlattener::rotateCommandSlot);
 				PathUserData pathUserData;
 				pathUserData.transform = transform;
-				if (parsePath(data, slot, pathUserData, this, true)) {
+				if (parsePath(data, visitor, pathUserData, true)) {
 					element.setAttribute("d", pathUserData.string);
 				}
 			}
@@ -104,10 +104,10 @@ void SvgFlattener::unRotateChild(QDomElement & element, QMatrix transform) {
 		else if ((tag == "polygon") || (tag == "polyline")) {
 			QString data = element.attribute("points");
 			if (!data.isEmpty()) {
-				const char * slot = SLOT(rotateCommandSlot(QChar, bool, QList<double> &, void *));
+				auto visitor = commandVisitor(this, &SvgFlattener::rotateCommandSlot);
 				PathUserData pathUserData;
 				pathUserData.transform = transform;
-				if (parsePath(data, slot, pathUserData, this, false)) {
+				if (parsePath(data, visitor, pathUserData, false)) {
 					pathUserData.string.remove(0, 1);			// get rid of the "M"
 					element.setAttribute("points", pathUserData.string);
 				}
@@ -207,7 +207,7 @@ bool SvgFlattener::hasOtherTransform(QDomElement & element)
 	return (!transform.contains("translate"));
 }
 
-void SvgFlattener::rotateCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+void SvgFlattener::rotateCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData) {
 
 	Q_UNUSED(relative);			// just normalizing here, so relative is not used
 
@@ -45,7 +45,7 @@ protected:
 
 
 protected slots:
-	void rotateCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
+	void rotateCommandSlot(QChar command, bool relative, const PathArgs & args, void * userData);
 
 };
 
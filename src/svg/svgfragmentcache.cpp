@@ -0,0 +1,155 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "svgfragmentcache.h"
+#include "../utils/textutils.h"
+
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QDataStream>
+#include <QtConcurrentMap>
+
+// cost is measured in characters
+QCache<QByteArray, SvgFragmentCache::Entry> SvgFragmentCache::Cache(32 * 1024 * 1024);
+QMutex SvgFragmentCache::CacheMutex;
+
+static const int ParallelThreshold = 4;
+
+/////////////////////////////////////////////////////////////////////
+
+static bool hideTerminalID(QDomDocument & doc, const QString & terminalID) {
+	QDomElement root = doc.documentElement();
+	QDomElement terminal = TextUtils::findElementWithAttribute(root, "id", terminalID);
+	if (terminal.isNull()) return false;
+
+	terminal.setTagName("g");
+	return true;
+}
+
+static bool ensureStrokeWidth(QDomDocument & doc, const QString & connectorID, double factor) {
+	QDomElement root = doc.documentElement();
+	QDomElement connector = TextUtils::findElementWithAttribute(root, "id", connectorID);
+	if (connector.isNull()) return false;
+
+	QString stroke = connector.attribute("stroke");
+	if (stroke.isEmpty()) return false;
+
+	QString strokeWidth = connector.attribute("stroke-width");
+	if (!strokeWidth.isEmpty()) return false;
+
+	TextUtils::getStrokeWidth(connector, factor);       // default stroke width is 1, multiplied by factor
+	return true;
+}
+
+static void normalizeJob(SvgFragmentJob * & job) {
+	SvgFragmentCache::normalize(*job);
+}
+
+/////////////////////////////////////////////////////////////////////
+
+void SvgFragmentCache::makeKey(SvgFragmentJob & job) {
+	QByteArray params;
+	QDataStream stream(&params, QIODevice::WriteOnly);
+	stream << job.hideIDs << job.strokeIDs << job.factor << job.opaqueRects
+	       << job.transform.m11() << job.transform.m12() << job.transform.m21() << job.transform.m22();
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData((const char *) job.itemSvg.constData(), job.itemSvg.size() * (int) sizeof(QChar));
+	hash.addData(params);
+	job.key = hash.result();
+}
+
+bool SvgFragmentCache::lookup(SvgFragmentJob & job) {
+	QMutexLocker locker(&CacheMutex);
+	Entry * entry = Cache.object(job.key);
+	if (entry == NULL) return false;
+
+	job.fragment = entry->fragment;
+	job.parsed = entry->parsed;
+	job.cached = true;
+	return true;
+}
+
+void SvgFragmentCache::normalize(SvgFragmentJob & job) {
+	// must stay free of GUI and scene access: it may run on a worker thread
+	QString itemSvg = job.itemSvg;
+	TextUtils::fixMuch(itemSvg, false);
+
+	QDomDocument doc;
+	QString errorStr;
+	int errorLine;
+	int errorColumn;
+	job.parsed = doc.setContent(itemSvg, &errorStr, &errorLine, &errorColumn);
+	if (job.parsed) {
+		bool changed = false;
+		if (job.opaqueRects) {
+			QDomNodeList nodeList = doc.documentElement().elementsByTagName("rect");
+			for (int n = 0; n < nodeList.count(); n++) {
+				QDomElement element = nodeList.at(n).toElement();
+				element.setAttribute("fill-opacity", 1);
+				changed = true;
+			}
+		}
+
+		foreach (QString id, job.hideIDs) {
+			// these tend to be degenerate shapes and can cause trouble at gerber export time
+			if (hideTerminalID(doc, id)) changed = true;
+		}
+
+		foreach (QString id, job.strokeIDs) {
+			if (ensureStrokeWidth(doc, id, job.factor)) changed = true;
+		}
+
+		if (changed) {
+			itemSvg = doc.toString(0);
+		}
+	}
+
+	job.fragment = TextUtils::svgTransform(itemSvg, job.transform, false, QString());
+
+	QMutexLocker locker(&CacheMutex);
+	Entry * entry = new Entry;
+	entry->fragment = job.fragment;
+	entry->parsed = job.parsed;
+	Cache.insert(job.key, entry, qMax(1, job.fragment.size()));
+}
+
+void SvgFragmentCache::process(QList<SvgFragmentJob> & jobs) {
+	QList<SvgFragmentJob *> misses;
+	for (int i = 0; i < jobs.count(); i++) {
+		SvgFragmentJob & job = jobs[i];
+		makeKey(job);
+		if (!lookup(job)) misses.append(&job);
+	}
+
+	if (misses.count() < ParallelThreshold) {
+		foreach (SvgFragmentJob * job, misses) {
+			normalize(*job);
+		}
+		return;
+	}
+
+	QtConcurrent::blockingMap(misses, normalizeJob);
+}
+
+void SvgFragmentCache::clear() {
+	QMutexLocker locker(&CacheMutex);
+	Cache.clear();
+}
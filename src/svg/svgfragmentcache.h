@@ -0,0 +1,68 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef SVGFRAGMENTCACHE_H
+#define SVGFRAGMENTCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QTransform>
+#include <QCache>
+#include <QMutex>
+#include <QList>
+
+// Everything needed to turn the svg of one item (as returned by ItemBase::retrieveSvg) into the normalized,
+// transformed fragment that SketchWidget::renderToSVG emits.  Filled in on the GUI thread;
+// normalize() only touches the job itself, so misses can be processed on worker threads.
+
+struct SvgFragmentJob {
+	QString itemSvg;
+	QStringList hideIDs;			// terminal points to hide
+	QStringList strokeIDs;			// connectors that need an explicit stroke width
+	double factor = 1;
+	QTransform transform;
+	bool opaqueRects = false;		// copper blocker pads
+
+	QByteArray key;
+	QString fragment;
+	bool parsed = false;
+	bool cached = false;
+};
+
+class SvgFragmentCache
+{
+public:
+	static void makeKey(SvgFragmentJob &);
+	static bool lookup(SvgFragmentJob &);
+	static void normalize(SvgFragmentJob &);
+	static void process(QList<SvgFragmentJob> &);
+	static void clear();
+
+protected:
+	struct Entry {
+		QString fragment;
+		bool parsed;
+	};
+
+	static QCache<QByteArray, Entry> Cache;
+	static QMutex CacheMutex;
+};
+
+#endif
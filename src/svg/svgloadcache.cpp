@@ -0,0 +1,191 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "svgloadcache.h"
+#include "../debugdialog.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+// bump whenever loadAux's fix-up or ConnectorInfo changes, so stale entries stop matching
+static const quint32 CacheFormat = 1;
+static const quint32 CacheMagic = 0x46535643;			// "FSVC"
+static const qint64 MaxFolderSize = 128 * 1024 * 1024;
+
+// cost is measured in bytes
+QCache<QByteArray, SvgLoadEntry> SvgLoadCache::Cache(16 * 1024 * 1024);
+QMutex SvgLoadCache::CacheMutex;
+QString SvgLoadCache::Folder;
+
+/////////////////////////////////////////////////////////////////////
+
+static QDataStream & operator<<(QDataStream & stream, const ConnectorInfo & connectorInfo) {
+	stream << connectorInfo.gotCircle << connectorInfo.radius << connectorInfo.strokeWidth
+	       << connectorInfo.matrix << connectorInfo.terminalMatrix << connectorInfo.legMatrix
+	       << connectorInfo.legColor << connectorInfo.legLine << connectorInfo.legStrokeWidth << connectorInfo.gotPath;
+	return stream;
+}
+
+static QDataStream & operator>>(QDataStream & stream, ConnectorInfo & connectorInfo) {
+	stream >> connectorInfo.gotCircle >> connectorInfo.radius >> connectorInfo.strokeWidth
+	       >> connectorInfo.matrix >> connectorInfo.terminalMatrix >> connectorInfo.legMatrix
+	       >> connectorInfo.legColor >> connectorInfo.legLine >> connectorInfo.legStrokeWidth >> connectorInfo.gotPath;
+	return stream;
+}
+
+/////////////////////////////////////////////////////////////////////
+
+void SvgLoadCache::setFolder(const QString & path) {
+	QMutexLocker locker(&CacheMutex);
+	Folder = path;
+	if (Folder.isEmpty()) return;
+
+	if (!QDir().mkpath(Folder)) {
+		DebugDialog::debug(QString("svg load cache: unable to create %1").arg(Folder));
+		Folder.clear();
+		return;
+	}
+
+	prune();
+}
+
+QByteArray SvgLoadCache::makeKey(const QByteArray & contents, const LoadInfo & loadInfo) {
+	// the filename only shows up in debug messages, so files with the same bytes share an entry
+	QByteArray params;
+	QDataStream stream(&params, QIODevice::WriteOnly);
+	stream << CacheFormat << loadInfo.connectorIDs << loadInfo.terminalIDs << loadInfo.legIDs
+	       << loadInfo.setColor << loadInfo.colorElementID << loadInfo.findNonConnectors << loadInfo.parsePaths;
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(contents);
+	hash.addData(params);
+	return hash.result();
+}
+
+bool SvgLoadCache::lookup(const QByteArray & key, SvgLoadEntry & entry, bool persistent) {
+	QString folder;
+	{
+		QMutexLocker locker(&CacheMutex);
+		SvgLoadEntry * cached = Cache.object(key);
+		if (cached) {
+			entry = *cached;
+			return true;
+		}
+
+		if (!persistent) return false;
+		folder = Folder;
+	}
+
+	// disk access stays outside the lock, so other loads aren't held up behind it
+	if (folder.isEmpty()) return false;
+	if (!read(entryPath(folder, key), entry)) return false;
+
+	QMutexLocker locker(&CacheMutex);
+	Cache.insert(key, new SvgLoadEntry(entry), qMax(1, entry.contents.size()));
+	return true;
+}
+
+void SvgLoadCache::insert(const QByteArray & key, const SvgLoadEntry & entry, bool persistent) {
+	QString folder;
+	{
+		QMutexLocker locker(&CacheMutex);
+		Cache.insert(key, new SvgLoadEntry(entry), qMax(1, entry.contents.size()));
+		folder = Folder;
+	}
+
+	if (!persistent || folder.isEmpty()) return;
+
+	write(entryPath(folder, key), entry);
+}
+
+void SvgLoadCache::clear() {
+	QMutexLocker locker(&CacheMutex);
+	Cache.clear();
+	if (Folder.isEmpty()) return;
+
+	QDir dir(Folder);
+	foreach (QFileInfo fileInfo, dir.entryInfoList(QStringList("*.svgc"), QDir::Files)) {
+		QFile::remove(fileInfo.absoluteFilePath());
+	}
+}
+
+QString SvgLoadCache::entryPath(const QString & folder, const QByteArray & key) {
+	return folder + "/" + QString::fromLatin1(key.toHex()) + ".svgc";
+}
+
+bool SvgLoadCache::read(const QString & path, SvgLoadEntry & entry) {
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) return false;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	quint32 magic, format;
+	stream >> magic >> format;
+	if (magic != CacheMagic || format != CacheFormat) return false;
+
+	stream >> entry.contents >> entry.connectorInfo >> entry.nonConnectorInfo;
+	if (stream.status() != QDataStream::Ok) {
+		// truncated or otherwise damaged; it will be rewritten
+		file.close();
+		QFile::remove(path);
+		return false;
+	}
+
+	return true;
+}
+
+void SvgLoadCache::write(const QString & path, const SvgLoadEntry & entry) {
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) return;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << CacheMagic << CacheFormat << entry.contents << entry.connectorInfo << entry.nonConnectorInfo;
+	file.commit();
+}
+
+void SvgLoadCache::prune() {
+	// entries for part files that have since changed are never hit again; drop the oldest once the folder gets big
+	QDir dir(Folder);
+	QFileInfoList fileInfos = dir.entryInfoList(QStringList("*.svgc"), QDir::Files);
+	qint64 total = 0;
+	foreach (QFileInfo fileInfo, fileInfos) {
+		total += fileInfo.size();
+	}
+	if (total <= MaxFolderSize) return;
+
+	std::sort(fileInfos.begin(), fileInfos.end(), [](const QFileInfo & f1, const QFileInfo & f2) {
+		return f1.lastModified() < f2.lastModified();
+	});
+	foreach (QFileInfo fileInfo, fileInfos) {
+		if (total <= MaxFolderSize / 2) break;
+
+		total -= fileInfo.size();
+		QFile::remove(fileInfo.absoluteFilePath());
+	}
+}
@@ -0,0 +1,67 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef SVGLOADCACHE_H
+#define SVGLOADCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QCache>
+#include <QMutex>
+
+#include "../fsvgrenderer.h"
+
+// What FSvgRenderer::loadAux derives from a part's svg: the fixed-up bytes and the connector geometry found
+// in them.  Kept in memory and, once setFolder() has been called, on disk, so that a warm start skips the
+// fix-up entirely.  Only persistent entries go to disk: svg read from part files, not the strings generated
+// for wires, resistors and the like, which would only fill the folder.  Entries are keyed by a hash of the
+// source bytes and the LoadInfo, so an updated part file simply misses; clear() drops everything, for when
+// the parts themselves are regenerated.
+
+struct SvgLoadEntry {
+	QByteArray contents;
+	QHash<QString, ConnectorInfo> connectorInfo;
+	QHash<QString, ConnectorInfo> nonConnectorInfo;
+};
+
+class SvgLoadCache
+{
+public:
+	static void setFolder(const QString & path);
+	static QByteArray makeKey(const QByteArray & contents, const LoadInfo &);
+	static bool lookup(const QByteArray & key, SvgLoadEntry &, bool persistent);
+	static void insert(const QByteArray & key, const SvgLoadEntry &, bool persistent);
+	static void clear();
+
+protected:
+	static QString entryPath(const QString & folder, const QByteArray & key);
+	static bool read(const QString & path, SvgLoadEntry &);
+	static void write(const QString & path, const SvgLoadEntry &);
+	static void prune();
+
+protected:
+	static QCache<QByteArray, SvgLoadEntry> Cache;
+	static QMutex CacheMutex;
+	static QString Folder;
+};
+
+#endif
@@ -0,0 +1,412 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "svgoutline.h"
+#include "svgpathtokenizer.h"
+#include "../utils/textutils.h"
+#include "../utils/graphicsutils.h"
+
+#include <QDomDocument>
+#include <QCryptographicHash>
+#include <QPainterPathStroker>
+#include <QColor>
+#include <QRegExp>
+#include <qmath.h>
+
+// cost is measured in path elements
+QCache<QByteArray, QPainterPath> SvgOutline::Cache(1024 * 1024);
+QMutex SvgOutline::CacheMutex;
+
+static const QString DefaultFontSize("16");
+
+/////////////////////////////////////////////////////////////////////
+
+static QPointF arcPoint(double cx, double cy, double rx, double ry, double cosPhi, double sinPhi, double t) {
+	return QPointF(cx + (cosPhi * rx * qCos(t)) - (sinPhi * ry * qSin(t)), cy + (sinPhi * rx * qCos(t)) + (cosPhi * ry * qSin(t)));
+}
+
+static QPointF arcTangent(double rx, double ry, double cosPhi, double sinPhi, double t) {
+	return QPointF(-(cosPhi * rx * qSin(t)) - (sinPhi * ry * qCos(t)), -(sinPhi * rx * qSin(t)) + (cosPhi * ry * qCos(t)));
+}
+
+static void arcTo(QPainterPath & path, const QPointF & from, double rx, double ry, double xAxisRotation, bool largeArc, bool sweep, const QPointF & to) {
+	// endpoint to center parameterization, from the svg spec (F.6.5), then one cubic per quarter turn
+	if (from == to) return;
+
+	rx = qAbs(rx);
+	ry = qAbs(ry);
+	if (rx == 0 || ry == 0) {
+		path.lineTo(to);
+		return;
+	}
+
+	double phi = qDegreesToRadians(xAxisRotation);
+	double cosPhi = qCos(phi);
+	double sinPhi = qSin(phi);
+	double dx = (from.x() - to.x()) / 2;
+	double dy = (from.y() - to.y()) / 2;
+	double x1 = (cosPhi * dx) + (sinPhi * dy);
+	double y1 = -(sinPhi * dx) + (cosPhi * dy);
+
+	double lambda = ((x1 * x1) / (rx * rx)) + ((y1 * y1) / (ry * ry));
+	if (lambda > 1) {
+		rx *= qSqrt(lambda);
+		ry *= qSqrt(lambda);
+	}
+
+	double numerator = (rx * rx * ry * ry) - (rx * rx * y1 * y1) - (ry * ry * x1 * x1);
+	double denominator = (rx * rx * y1 * y1) + (ry * ry * x1 * x1);
+	double coefficient = denominator == 0 ? 0 : qSqrt(qMax(0.0, numerator / denominator));
+	if (largeArc == sweep) coefficient = -coefficient;
+
+	double cx1 = coefficient * rx * y1 / ry;
+	double cy1 = -coefficient * ry * x1 / rx;
+	double cx = (cosPhi * cx1) - (sinPhi * cy1) + ((from.x() + to.x()) / 2);
+	double cy = (sinPhi * cx1) + (cosPhi * cy1) + ((from.y() + to.y()) / 2);
+
+	double theta = qAtan2((y1 - cy1) / ry, (x1 - cx1) / rx);
+	double delta = qAtan2((-y1 - cy1) / ry, (-x1 - cx1) / rx) - theta;
+	if (sweep && delta < 0) delta += 2 * M_PI;
+	else if (!sweep && delta > 0) delta -= 2 * M_PI;
+
+	int segments = qMax(1, qCeil(qAbs(delta) / (M_PI / 2) - 0.001));
+	double step = delta / segments;
+	double k = 4.0 / 3.0 * qTan(step / 4);
+	for (int i = 0; i < segments; i++) {
+		double t2 = theta + step;
+		QPointF p2 = (i == segments - 1) ? to : arcPoint(cx, cy, rx, ry, cosPhi, sinPhi, t2);
+		path.cubicTo(arcPoint(cx, cy, rx, ry, cosPhi, sinPhi, theta) + (k * arcTangent(rx, ry, cosPhi, sinPhi, theta)),
+		             p2 - (k * arcTangent(rx, ry, cosPhi, sinPhi, t2)),
+		             p2);
+		theta = t2;
+	}
+}
+
+static bool isFilled(const QString & fill, const QString & fillOpacity) {
+	if (fill.isEmpty() || fill == "none") return false;
+
+	bool ok;
+	double opacity = fillOpacity.toDouble(&ok);
+	if (ok && opacity <= 0) return false;
+
+	if (fill.startsWith("url(")) return true;
+
+	// light colors dropped out of the monochrome bitmap this replaces
+	QColor color(fill);
+	if (!color.isValid()) return true;
+	if (color.alpha() == 0) return false;
+
+	return qGray(color.rgb()) < 128;
+}
+
+static QString styleValue(const QDomElement & element, const QString & name) {
+	// a style property overrides the presentation attribute
+	QString style = element.attribute("style");
+	if (!style.isEmpty()) {
+		foreach (QString declaration, style.split(';', QString::SkipEmptyParts)) {
+			int colon = declaration.indexOf(':');
+			if (colon < 0) continue;
+			if (declaration.left(colon).trimmed() == name) return declaration.mid(colon + 1).trimmed();
+		}
+	}
+
+	return element.attribute(name);
+}
+
+static double firstNumber(const QString & s) {
+	return s.section(QRegExp("[\\s,]+"), 0, 0, QString::SectionSkipEmpty).toDouble();
+}
+
+/////////////////////////////////////////////////////////////////////
+
+SvgOutline::SvgOutline(double strokeExtra) : m_strokeExtra(strokeExtra)
+{
+}
+
+QPainterPath SvgOutline::selectionShape(const QByteArray & svg, double extra) {
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(svg);
+	hash.addData(QByteArray::number(extra));
+	QByteArray key = hash.result();
+
+	{
+		QMutexLocker locker(&CacheMutex);
+		QPainterPath * cached = Cache.object(key);
+		if (cached) return *cached;
+	}
+
+	QPainterPath shape;
+	QString errorStr;
+	int errorLine;
+	int errorColumn;
+	QDomDocument doc;
+	if (doc.setContent(svg, &errorStr, &errorLine, &errorColumn)) {
+		QRectF viewBox;
+		double w, h;
+		if (TextUtils::ensureViewBox(doc, 1, viewBox, true, w, h, true) && w > 0 && h > 0 && viewBox.width() > 0 && viewBox.height() > 0) {
+			// map user units to item pixels; the stroke margin is given in pixels
+			double svgDPI = viewBox.width() / w;
+			QTransform transform = QTransform::fromTranslate(-viewBox.x(), -viewBox.y())
+			                       * QTransform::fromScale(w * GraphicsUtils::SVGDPI / viewBox.width(), h * GraphicsUtils::SVGDPI / viewBox.height());
+			SvgOutline svgOutline(svgDPI * extra / GraphicsUtils::SVGDPI);
+			shape = svgOutline.outline(doc.documentElement(), transform);
+		}
+	}
+
+	QMutexLocker locker(&CacheMutex);
+	Cache.insert(key, new QPainterPath(shape), qMax(1, shape.elementCount()));
+	return shape;
+}
+
+void SvgOutline::clearCache() {
+	QMutexLocker locker(&CacheMutex);
+	Cache.clear();
+}
+
+QPainterPath SvgOutline::outline(const QDomElement & root, const QTransform & transform) {
+	m_pieces.clear();
+	addElement(root, transform);
+	return unite(m_pieces, 0, m_pieces.count());
+}
+
+QPainterPath SvgOutline::unite(QList<QPainterPath> & paths, int from, int to) {
+	// pairwise, so each union works on paths of similar size
+	if (to - from <= 0) return QPainterPath();
+	if (to - from == 1) return paths.at(from).simplified();
+
+	int middle = (from + to) / 2;
+	return unite(paths, from, middle).united(unite(paths, middle, to));
+}
+
+QString SvgOutline::inherited(const QDomElement & element, const QString & attribute, const QString & defaultValue) {
+	QDomElement e = element;
+	while (!e.isNull()) {
+		QString value = styleValue(e, attribute);
+		if (!value.isEmpty() && value != "inherit") return value;
+		e = e.parentNode().toElement();
+	}
+
+	return defaultValue;
+}
+
+void SvgOutline::addElement(const QDomElement & element, const QTransform & parentTransform) {
+	if (styleValue(element, "display") == "none") return;
+	if (styleValue(element, "visibility") == "hidden") return;
+
+	QString tagName = element.tagName();
+	int colon = tagName.indexOf(':');
+	if (colon >= 0) tagName = tagName.mid(colon + 1);
+
+	QTransform transform = parentTransform;
+	QString transformString = element.attribute("transform");
+	if (!transformString.isEmpty()) {
+		transform = QTransform(TextUtils::transformStringToMatrix(transformString)) * parentTransform;
+	}
+
+	QPainterPath path;
+	if (tagName == "svg" || tagName == "g" || tagName == "a" || tagName == "switch") {
+		QDomElement child = element.firstChildElement();
+		while (!child.isNull()) {
+			addElement(child, transform);
+			child = child.nextSiblingElement();
+		}
+		return;
+	}
+
+	if (tagName == "path") {
+		addShape(element, pathFromData(element.attribute("d")), transform, true);
+	}
+	else if (tagName == "rect" || tagName == "image") {
+		double rx = element.attribute("rx").toDouble();
+		double ry = element.attribute("ry", element.attribute("rx")).toDouble();
+		QRectF r(element.attribute("x").toDouble(), element.attribute("y").toDouble(),
+		         element.attribute("width").toDouble(), element.attribute("height").toDouble());
+		if (r.isEmpty()) return;
+
+		if (rx > 0 || ry > 0) path.addRoundedRect(r, rx > 0 ? rx : ry, ry > 0 ? ry : rx);
+		else path.addRect(r);
+		addShape(element, path, transform, true);
+	}
+	else if (tagName == "circle") {
+		double r = element.attribute("r").toDouble();
+		if (r <= 0) return;
+
+		path.addEllipse(QPointF(element.attribute("cx").toDouble(), element.attribute("cy").toDouble()), r, r);
+		addShape(element, path, transform, true);
+	}
+	else if (tagName == "ellipse") {
+		double rx = element.attribute("rx").toDouble();
+		double ry = element.attribute("ry").toDouble();
+		if (rx <= 0 || ry <= 0) return;
+
+		path.addEllipse(QPointF(element.attribute("cx").toDouble(), element.attribute("cy").toDouble()), rx, ry);
+		addShape(element, path, transform, true);
+	}
+	else if (tagName == "line") {
+		path.moveTo(element.attribute("x1").toDouble(), element.attribute("y1").toDouble());
+		path.lineTo(element.attribute("x2").toDouble(), element.attribute("y2").toDouble());
+		addShape(element, path, transform, false);
+	}
+	else if (tagName == "polyline" || tagName == "polygon") {
+		path = pathFromData(element.attribute("points"));
+		if (tagName == "polygon") path.closeSubpath();
+		addShape(element, path, transform, true);
+	}
+	else if (tagName == "text") {
+		// the glyphs themselves would need the font machinery; a box around them is plenty for picking
+		QString text = element.text().simplified();
+		if (text.isEmpty()) return;
+
+		bool ok;
+		double fontSize = inherited(element, "font-size", DefaultFontSize).remove("px").toDouble(&ok);
+		if (!ok) fontSize = DefaultFontSize.toDouble();
+
+		double width = 0.6 * fontSize * text.length();
+		double x = firstNumber(element.attribute("x"));
+		double y = firstNumber(element.attribute("y"));
+		QString anchor = TextUtils::findAnchor(element);
+		if (anchor == "middle") x -= width / 2;
+		else if (anchor == "end") x -= width;
+
+		path.addRect(x, y - (0.8 * fontSize), width, fontSize);
+		addShape(element, path, transform, true);
+	}
+}
+
+void SvgOutline::addShape(const QDomElement & element, const QPainterPath & path, const QTransform & transform, bool closed) {
+	if (path.isEmpty()) return;
+
+	if (closed && isFilled(inherited(element, "fill", "black"), inherited(element, "fill-opacity", ""))) {
+		QPainterPath fill = path;
+		fill.setFillRule(inherited(element, "fill-rule", "nonzero") == "evenodd" ? Qt::OddEvenFill : Qt::WindingFill);
+		m_pieces.append(transform.map(fill));
+	}
+
+	// every element is stroked, as SvgFileSplitter::forceStrokeWidth did for the bitmap
+	bool ok;
+	double strokeWidth = inherited(element, "stroke-width", "0").remove("px").toDouble(&ok);
+	if (!ok || inherited(element, "stroke", "") == "none") strokeWidth = 0;
+
+	QPainterPathStroker stroker;
+	stroker.setWidth(qMax(0.0, strokeWidth + m_strokeExtra));
+	stroker.setCapStyle(Qt::FlatCap);
+	stroker.setJoinStyle(Qt::MiterJoin);
+	m_pieces.append(transform.map(stroker.createStroke(path)));
+}
+
+QRectF SvgOutline::pathBounds(const QDomElement & path) {
+	// what QSvgRenderer::boundsOnElement reports, less the stroke: the path's own transform applies, its parents' don't.
+	// Null if the data doesn't parse or the transform is a list, which transformStringToMatrix doesn't handle
+	QPainterPath painterPath = pathFromData(path.attribute("d"));
+	if (painterPath.isEmpty()) return QRectF();
+
+	QString transformString = path.attribute("transform").trimmed();			// transformStringToMatrix matches the keyword at the start
+	if (transformString.isEmpty()) return painterPath.boundingRect();
+	if (transformString.count('(') > 1) return QRectF();
+
+	return QTransform(TextUtils::transformStringToMatrix(transformString)).map(painterPath).boundingRect();
+}
+
+QPainterPath SvgOutline::pathFromData(const QString & data) {
+	// one tokenizer per thread, reused from path to path
+	static thread_local SVGPathTokenizer tokenizer;
+
+	QPainterPath path;
+	if (!tokenizer.tokenize(data)) return path;
+
+	const QVector<double> & args = tokenizer.args();
+	QPointF current;
+	QPointF start;
+	QPointF control;
+	QChar previous;
+	foreach (const SVGPathTokenizer::Command & command, tokenizer.commands()) {
+		QChar c = command.command.toUpper();
+		int count = SVGPathTokenizer::argCount(c);
+		if (count == 0) {
+			path.closeSubpath();
+			current = start;
+			previous = c;
+			continue;
+		}
+
+		for (int i = command.argIndex; i < command.argIndex + command.argCount; i += count) {
+			const double * a = args.constData() + i;
+			QPointF base = command.relative ? current : QPointF(0, 0);
+			switch (c.unicode()) {
+			case 'M':
+				current = base + QPointF(a[0], a[1]);
+				if (i == command.argIndex) {
+					path.moveTo(current);
+					start = current;
+				}
+				else {
+					path.lineTo(current);				// extra pairs are implicit linetos
+				}
+				break;
+			case 'L':
+				current = base + QPointF(a[0], a[1]);
+				path.lineTo(current);
+				break;
+			case 'H':
+				current.setX(a[0] + base.x());
+				path.lineTo(current);
+				break;
+			case 'V':
+				current.setY(a[0] + base.y());
+				path.lineTo(current);
+				break;
+			case 'C':
+				control = base + QPointF(a[2], a[3]);
+				path.cubicTo(base + QPointF(a[0], a[1]), control, base + QPointF(a[4], a[5]));
+				current = base + QPointF(a[4], a[5]);
+				break;
+			case 'S': {
+				QPointF reflected = (previous == 'C' || previous == 'S') ? (2 * current) - control : current;
+				control = base + QPointF(a[0], a[1]);
+				current = base + QPointF(a[2], a[3]);
+				path.cubicTo(reflected, control, current);
+				break;
+			}
+			case 'Q':
+				control = base + QPointF(a[0], a[1]);
+				current = base + QPointF(a[2], a[3]);
+				path.quadTo(control, current);
+				break;
+			case 'T':
+				control = (previous == 'Q' || previous == 'T') ? (2 * current) - control : current;
+				current = base + QPointF(a[0], a[1]);
+				path.quadTo(control, current);
+				break;
+			case 'A': {
+				QPointF to = base + QPointF(a[5], a[6]);
+				arcTo(path, current, a[0], a[1], a[2], a[3] != 0, a[4] != 0, to);
+				current = to;
+				break;
+			}
+			default:
+				break;
+			}
+			previous = c;
+		}
+	}
+
+	return path;
+}
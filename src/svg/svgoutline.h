@@ -0,0 +1,67 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef SVGOUTLINE_H
+#define SVGOUTLINE_H
+
+#include <QPainterPath>
+#include <QTransform>
+#include <QDomElement>
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QList>
+
+// Builds an item's selection shape straight from the geometry in its svg: filled shapes contribute their
+// outline, and every shape is stroked with its stroke width plus a margin, just as ItemBase::createShape
+// used to force before rendering the whole layer into a bitmap and tracing it into a QRegion.
+// Light fills count as empty, as they did in the bitmap; text contributes an estimated box.
+// Style properties override presentation attributes, and fills and strokes inherit from the parent.
+// Shapes are cached by svg content, so every instance of a part shares one.
+
+class SvgOutline
+{
+public:
+	SvgOutline(double strokeExtra);
+
+	// extra is in pixels at GraphicsUtils::SVGDPI; the result is in the same units
+	static QPainterPath selectionShape(const QByteArray & svg, double extra);
+	static QPainterPath pathFromData(const QString & data);
+	static QRectF pathBounds(const QDomElement & path);
+	static void clearCache();
+
+	QPainterPath outline(const QDomElement & root, const QTransform &);
+
+protected:
+	void addElement(const QDomElement &, const QTransform &);
+	void addShape(const QDomElement &, const QPainterPath &, const QTransform &, bool closed);
+	static QString inherited(const QDomElement &, const QString & attribute, const QString & defaultValue);
+	static QPainterPath unite(QList<QPainterPath> & paths, int from, int to);
+
+protected:
+	double m_strokeExtra;
+	QList<QPainterPath> m_pieces;
+
+	static QCache<QByteArray, QPainterPath> Cache;
+	static QMutex CacheMutex;
+};
+
+#endif
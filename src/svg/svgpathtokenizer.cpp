@@ -0,0 +1,262 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "svgpathtokenizer.h"
+#include "svgpathlexer.h"
+
+// powers of ten that are exact as doubles
+static const double Powers[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int MaxPower = 22;
+static const quint64 MaxExactMantissa = Q_UINT64_C(1) << 53;
+
+static inline bool isDigit(ushort c) {
+	return c >= '0' && c <= '9';
+}
+
+static inline bool isSeparator(ushort c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+/////////////////////////////////////////////////////////////////////
+
+SVGPathTokenizer::SVGPathTokenizer()
+{
+}
+
+const QVector<SVGPathTokenizer::Command> & SVGPathTokenizer::commands() const {
+	return m_commands;
+}
+
+const QVector<double> & SVGPathTokenizer::args() const {
+	return m_args;
+}
+
+int SVGPathTokenizer::argCount(QChar command) {
+	switch (command.unicode()) {
+	case 'M':
+	case 'm':
+	case 'L':
+	case 'l':
+	case 'T':
+	case 't':
+		return 2;
+	case 'H':
+	case 'h':
+	case 'V':
+	case 'v':
+		return 1;
+	case 'C':
+	case 'c':
+		return 6;
+	case 'S':
+	case 's':
+	case 'Q':
+	case 'q':
+		return 4;
+	case 'A':
+	case 'a':
+		return 7;
+	case 'Z':
+	case 'z':
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+bool SVGPathTokenizer::tokenize(const QString & data) {
+	return tokenize(QStringRef(&data));
+}
+
+bool SVGPathTokenizer::tokenize(const QStringRef & data)
+{
+	// QVector::clear() keeps the capacity
+	m_commands.clear();
+	m_args.clear();
+
+	const QChar * chars = data.unicode();
+	int length = data.length();
+	int pos = 0;
+	bool needNumber = false;			// just saw a comma
+	bool closed = false;				// just saw the fake close path character
+	while (true) {
+		while (pos < length && isSeparator(chars[pos].unicode())) pos++;
+		if (pos >= length) break;
+
+		QChar c = chars[pos];
+		int count = argCount(c);
+		if (count >= 0 || c == QLatin1Char(SVGPathLexer::FakeClosePathChar)) {
+			if (needNumber) return false;
+			if (!finishCommand()) return false;
+
+			pos++;
+			if (count < 0) {
+				closed = true;
+				continue;
+			}
+
+			if (m_commands.isEmpty() && c != QLatin1Char('M') && c != QLatin1Char('m')) return false;
+
+			Command command;
+			command.command = c;
+			command.relative = c.isLower();
+			command.argIndex = m_args.count();
+			command.argCount = 0;
+			m_commands.append(command);
+			closed = false;
+			continue;
+		}
+
+		if (m_commands.isEmpty()) {
+			// polygon points: treat as a moveto
+			if (closed) return false;
+
+			Command command;
+			command.command = QLatin1Char('M');
+			command.relative = false;
+			command.argIndex = 0;
+			command.argCount = 0;
+			m_commands.append(command);
+		}
+		else if (closed) {
+			return false;
+		}
+
+		Command & command = m_commands.last();
+		double value;
+		int slot = command.argCount % 7;
+		if ((command.command == QLatin1Char('a') || command.command == QLatin1Char('A')) && (slot == 3 || slot == 4)) {
+			// arc flags are a single digit and need no separator after them
+			ushort f = chars[pos].unicode();
+			if (f != '0' && f != '1') return false;
+
+			value = f - '0';
+			pos++;
+		}
+		else if (!scanNumber(chars, length, pos, value)) {
+			return false;
+		}
+
+		m_args.append(value);
+		command.argCount++;
+		needNumber = false;
+
+		while (pos < length && isSeparator(chars[pos].unicode())) pos++;
+		if (pos < length && chars[pos] == QLatin1Char(',')) {
+			pos++;
+			needNumber = true;
+		}
+	}
+
+	if (needNumber) return false;
+
+	return finishCommand();
+}
+
+bool SVGPathTokenizer::finishCommand() {
+	if (m_commands.isEmpty()) return true;
+
+	const Command & command = m_commands.last();
+	int count = argCount(command.command);
+	if (count == 0) return command.argCount == 0;
+
+	return command.argCount > 0 && command.argCount % count == 0;
+}
+
+bool SVGPathTokenizer::scanNumber(const QChar * chars, int length, int & pos, double & value)
+{
+	int start = pos;
+	bool negative = false;
+	if (pos < length && (chars[pos] == QLatin1Char('-') || chars[pos] == QLatin1Char('+'))) {
+		negative = (chars[pos] == QLatin1Char('-'));
+		pos++;
+	}
+
+	quint64 mantissa = 0;
+	int significant = 0;
+	int dropped = 0;					// integer digits that didn't fit in the mantissa
+	int fraction = 0;					// fraction digits that did
+	bool anyDigits = false;
+	while (pos < length && isDigit(chars[pos].unicode())) {
+		anyDigits = true;
+		if (significant < 19) {
+			mantissa = (mantissa * 10) + (chars[pos].unicode() - '0');
+			if (mantissa > 0) significant++;
+		}
+		else {
+			dropped++;
+		}
+		pos++;
+	}
+	if (pos < length && chars[pos] == QLatin1Char('.')) {
+		pos++;
+		while (pos < length && isDigit(chars[pos].unicode())) {
+			anyDigits = true;
+			if (significant < 19) {
+				mantissa = (mantissa * 10) + (chars[pos].unicode() - '0');
+				if (mantissa > 0) significant++;
+				fraction++;
+			}
+			pos++;
+		}
+	}
+
+	if (!anyDigits) {
+		pos = start;
+		return false;
+	}
+
+	int exponent = 0;
+	if (pos < length && (chars[pos] == QLatin1Char('e') || chars[pos] == QLatin1Char('E'))) {
+		int e = pos + 1;
+		bool negativeExponent = false;
+		if (e < length && (chars[e] == QLatin1Char('-') || chars[e] == QLatin1Char('+'))) {
+			negativeExponent = (chars[e] == QLatin1Char('-'));
+			e++;
+		}
+		if (e < length && isDigit(chars[e].unicode())) {
+			while (e < length && isDigit(chars[e].unicode())) {
+				if (exponent < 10000) exponent = (exponent * 10) + (chars[e].unicode() - '0');
+				e++;
+			}
+			if (negativeExponent) exponent = -exponent;
+			pos = e;
+		}
+	}
+
+	// with an exact mantissa and an exact power of ten a single multiply or divide rounds correctly
+	int power = exponent + dropped - fraction;
+	if (mantissa < MaxExactMantissa && power >= -MaxPower && power <= MaxPower) {
+		value = (power >= 0) ? mantissa * Powers[power] : mantissa / Powers[-power];
+	}
+	else {
+		bool ok;
+		value = QString::fromRawData(chars + start, pos - start).toDouble(&ok);
+		if (!ok) return false;
+
+		return true;
+	}
+
+	if (negative) value = -value;
+	return true;
+}
@@ -0,0 +1,104 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef SVGPATHTOKENIZER_H
+#define SVGPATHTOKENIZER_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+// One command's arguments: a read-only view into the tokenizer's flat argument list,
+// only valid until the visitor returns.
+
+class PathArgs
+{
+public:
+	PathArgs(const double * data, int count) : m_data(data), m_count(count) {}
+
+	int count() const {
+		return m_count;
+	}
+
+	double at(int i) const {
+		return m_data[i];
+	}
+
+	double operator[](int i) const {
+		return m_data[i];
+	}
+
+protected:
+	const double * m_data;
+	int m_count;
+};
+
+// Hand-written replacement for SVGPathLexer + SVGPathParser + SVGPathRunner on the hot paths.
+// It scans path data (or polygon points, which get an implicit moveto) straight from the string into a flat
+// command list and a flat argument list, both reused from one call to the next, and hands each command to a
+// visitor along with a view of its arguments.  As with the parser, the fake close path
+// character is accepted but not reported.  Unlike the parser, exponents and arc flags without separators are fine.
+
+class SVGPathTokenizer
+{
+public:
+	struct Command {
+		QChar command;
+		bool relative;
+		int argIndex;
+		int argCount;
+	};
+
+public:
+	SVGPathTokenizer();
+
+	bool tokenize(const QString & data);
+	bool tokenize(const QStringRef & data);
+	const QVector<Command> & commands() const;
+	const QVector<double> & args() const;
+
+	// calls visitor(QChar command, bool relative, const PathArgs & args, void * userData) once per command;
+	// nothing is called if the data doesn't parse.  The visitor must not tokenize with this tokenizer
+	template <class Visitor>
+	bool run(const QString & data, Visitor && visitor, void * userData) {
+		if (!tokenize(data)) return false;
+
+		const double * args = m_args.constData();
+		const Command * commands = m_commands.constData();
+		for (int i = 0; i < m_commands.count(); i++) {
+			const Command & command = commands[i];
+			visitor(command.command, command.relative, PathArgs(args + command.argIndex, command.argCount), userData);
+		}
+
+		return true;
+	}
+
+	static int argCount(QChar command);
+
+protected:
+	bool finishCommand();
+	static bool scanNumber(const QChar * chars, int length, int & pos, double & value);
+
+protected:
+	QVector<Command> m_commands;
+	QVector<double> m_args;
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "undopayload.h"
+
+#include <QCryptographicHash>
+#include <QMutexLocker>
+
+const int UndoPayload::InlineLimit = 1024;
+
+// an entry that has not been read during the last ColdAge store accesses gets compressed
+const quint64 UndoPayloadStore::ColdAge = 64;
+
+/////////////////////////////////
+
+UndoPayload::UndoPayload()
+{
+}
+
+UndoPayload::UndoPayload(const QString & value)
+{
+	if (value.length() < InlineLimit) {
+		m_inline = value;
+		return;
+	}
+
+	m_key = UndoPayloadStore::singleton()->intern(value);
+}
+
+UndoPayload::UndoPayload(const UndoPayload & other)
+	: m_inline(other.m_inline),
+	m_key(other.m_key)
+{
+	if (!m_key.isEmpty()) {
+		UndoPayloadStore::singleton()->ref(m_key);
+	}
+}
+
+UndoPayload::~UndoPayload()
+{
+	release();
+}
+
+UndoPayload & UndoPayload::operator=(const UndoPayload & other)
+{
+	if (this == &other) return *this;
+
+	if (!other.m_key.isEmpty()) {
+		UndoPayloadStore::singleton()->ref(other.m_key);
+	}
+	release();
+	m_inline = other.m_inline;
+	m_key = other.m_key;
+	return *this;
+}
+
+QString UndoPayload::value() const
+{
+	if (m_key.isEmpty()) return m_inline;
+
+	return UndoPayloadStore::singleton()->value(m_key);
+}
+
+qint64 UndoPayload::memoryUsage() const
+{
+	if (m_key.isEmpty()) return m_inline.size() * (qint64) sizeof(QChar);
+
+	return UndoPayloadStore::singleton()->entryMemoryUsage(m_key);
+}
+
+void UndoPayload::release()
+{
+	m_inline.clear();
+	if (m_key.isEmpty()) return;
+
+	UndoPayloadStore::singleton()->deref(m_key);
+	m_key.clear();
+}
+
+bool UndoPayload::isEmpty() const
+{
+	return m_key.isEmpty() && m_inline.isEmpty();
+}
+
+/////////////////////////////////
+
+UndoPayloadStore::UndoPayloadStore()
+{
+}
+
+UndoPayloadStore * UndoPayloadStore::singleton()
+{
+	static UndoPayloadStore store;
+	return &store;
+}
+
+QByteArray UndoPayloadStore::intern(const QString & value)
+{
+	QByteArray key = QCryptographicHash::hash(QByteArray::fromRawData((const char *) value.constData(), value.size() * (int) sizeof(QChar)), QCryptographicHash::Sha1);
+
+	QMutexLocker locker(&m_mutex);
+	Entry & entry = m_entries[key];
+	if (entry.refCount == 0) {
+		entry.text = value;
+		entry.size = value.size();
+		m_memoryUsage += footprint(entry);
+	}
+	entry.refCount++;
+	touch(entry);
+	return key;
+}
+
+void UndoPayloadStore::ref(const QByteArray & key)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_entries.find(key);
+	if (it == m_entries.end()) return;
+
+	it->refCount++;
+}
+
+void UndoPayloadStore::deref(const QByteArray & key)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_entries.find(key);
+	if (it == m_entries.end()) return;
+
+	if (--it->refCount > 0) return;
+
+	m_memoryUsage -= footprint(*it);
+	m_entries.erase(it);
+}
+
+QString UndoPayloadStore::value(const QByteArray & key)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_entries.find(key);
+	if (it == m_entries.end()) return QString();
+
+	Entry & entry = *it;
+	touch(entry);
+	if (entry.text.isNull()) {
+		// hot again: keep the compressed copy so the entry can go cold without recompressing
+		m_memoryUsage -= footprint(entry);
+		entry.text = QString::fromUtf8(qUncompress(entry.compressed));
+		m_memoryUsage += footprint(entry);
+	}
+
+	return entry.text;
+}
+
+qint64 UndoPayloadStore::entryMemoryUsage(const QByteArray & key)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_entries.constFind(key);
+	if (it == m_entries.constEnd()) return 0;
+
+	// shared entries are charged proportionally to each holder
+	return footprint(*it) / qMax(1, it->refCount);
+}
+
+qint64 UndoPayloadStore::memoryUsage()
+{
+	QMutexLocker locker(&m_mutex);
+	return m_memoryUsage;
+}
+
+qint64 UndoPayloadStore::uncompressedSize()
+{
+	QMutexLocker locker(&m_mutex);
+	qint64 total = 0;
+	foreach (const Entry & entry, m_entries) {
+		total += entry.size * (qint64) sizeof(QChar);
+	}
+	return total;
+}
+
+void UndoPayloadStore::compressColdEntries()
+{
+	QMutexLocker locker(&m_mutex);
+	for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+		Entry & entry = *it;
+		if (entry.text.isNull()) continue;
+		if (m_generation - entry.lastAccess < ColdAge) continue;
+
+		m_memoryUsage -= footprint(entry);
+		if (entry.compressed.isEmpty()) {
+			entry.compressed = qCompress(entry.text.toUtf8());
+		}
+		entry.text = QString();
+		m_memoryUsage += footprint(entry);
+	}
+}
+
+void UndoPayloadStore::touch(Entry & entry)
+{
+	entry.lastAccess = ++m_generation;
+}
+
+qint64 UndoPayloadStore::footprint(const Entry & entry)
+{
+	return entry.text.size() * (qint64) sizeof(QChar) + entry.compressed.size();
+}
@@ -0,0 +1,93 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef UNDOPAYLOAD_H
+#define UNDOPAYLOAD_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+// UndoPayload holds a string value for an undo command (typically a complete svg for ground fill or logo edits).
+// Small strings are kept inline; large strings are interned by content hash in the UndoPayloadStore,
+// so identical old/new values shared across commands are only stored once, and cold entries are compressed.
+
+class UndoPayload
+{
+public:
+	UndoPayload();
+	UndoPayload(const QString &);
+	UndoPayload(const UndoPayload &);
+	~UndoPayload();
+
+	UndoPayload & operator=(const UndoPayload &);
+
+	QString value() const;
+	qint64 memoryUsage() const;
+	void release();
+	bool isEmpty() const;
+
+public:
+	static const int InlineLimit;
+
+protected:
+	QString m_inline;
+	QByteArray m_key;
+};
+
+class UndoPayloadStore
+{
+public:
+	static UndoPayloadStore * singleton();
+
+	QByteArray intern(const QString &);
+	void ref(const QByteArray & key);
+	void deref(const QByteArray & key);
+	QString value(const QByteArray & key);
+	qint64 entryMemoryUsage(const QByteArray & key);
+	qint64 memoryUsage();
+	qint64 uncompressedSize();
+	void compressColdEntries();
+
+protected:
+	UndoPayloadStore();
+
+	struct Entry {
+		QString text;
+		QByteArray compressed;
+		int refCount = 0;
+		int size = 0;
+		quint64 lastAccess = 0;
+	};
+
+	void touch(Entry &);
+	static qint64 footprint(const Entry &);
+
+protected:
+	QHash<QByteArray, Entry> m_entries;
+	QMutex m_mutex;
+	quint64 m_generation = 0;
+	qint64 m_memoryUsage = 0;
+
+	static const quint64 ColdAge;
+};
+
+#endif
@@ -39,12 +39,16 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 
 #include "graphutils.h"
+#include "ratsnesttree.h"
 #include "../fsvgrenderer.h"
 #include "../items/wire.h"
 #include "../items/jumperitem.h"
 #include "../sketch/sketchwidget.h"
 #include "../debugdialog.h"
 
+#include <QPointer>
+#include <algorithm>
+
 
 void ConnectorEdge::setHeadTail(int h, int t) {
 	head = h;
@@ -319,14 +323,8 @@ void GraphUtils::minCut(QList<ConnectorItem *> & connectorItems, QList<SketchWid
 }
 
 
-bool GraphUtils::chooseRatsnestGraph(const QList<ConnectorItem *> * partConnectorItems, ViewGeometry::WireFlags flags, ConnectorPairHash & result) {
-	using namespace boost;
-	typedef adjacency_list < vecS, vecS, undirectedS, property<vertex_distance_t, double>, property < edge_weight_t, double > > Graph;
-	typedef std::pair < int, int >E;
-
-	if (partConnectorItems->count() < 2) return false;
-
-	QList <ConnectorItem *> temp(*partConnectorItems);
+void GraphUtils::collectRatsnestNodes(const QList<ConnectorItem *> * partConnectorItems, QList<ConnectorItem *> & temp) {
+	temp = *partConnectorItems;
 
 	//DebugDialog::debug("__________________");
 	int tix = 0;
@@ -341,6 +339,17 @@ bool GraphUtils::chooseRatsnestGraph(const QList<ConnectorItem *> * partConnecto
 			temp.removeOne(crossConnectorItem);
 		}
 	}
+}
+
+bool GraphUtils::chooseRatsnestGraph(const QList<ConnectorItem *> * partConnectorItems, ViewGeometry::WireFlags flags, ConnectorPairHash & result) {
+	using namespace boost;
+	typedef adjacency_list < vecS, vecS, undirectedS, property<vertex_distance_t, double>, property < edge_weight_t, double > > Graph;
+	typedef std::pair < int, int >E;
+
+	if (partConnectorItems->count() < 2) return false;
+
+	QList <ConnectorItem *> temp;
+	collectRatsnestNodes(partConnectorItems, temp);
 
 	QList<QPointF> locs;
 	foreach (ConnectorItem * connectorItem, temp) {
@@ -436,6 +445,138 @@ bool GraphUtils::chooseRatsnestGraph(const QList<ConnectorItem *> * partConnecto
 	return retval;
 }
 
+///////////////////////////////////////////////////////////
+//
+// incremental ratsnest
+//
+// updateRatsnestGraph produces the same minimum spanning tree as chooseRatsnestGraph, but starts from the previous
+// tree (the existing ratsnest wires); RatsnestTree::update decides which edges can have changed.  Per connector the
+// view's RatsnestMemory remembers where the terminal point was and which zero-weight group (same bus, already wired,
+// or coincident) it belonged to.
+
+RatsnestMemory::RatsnestMemory() : m_swept(0)
+{
+}
+
+RatsnestMemory::NodeKey RatsnestMemory::nodeKey(ConnectorItem * connectorItem) {
+	return NodeKey(connectorItem->attachedTo()->id(), connectorItem->connectorSharedID());
+}
+
+void RatsnestMemory::sweep() {
+	if (m_nodes.count() < 2 * m_swept + 1024) return;
+
+	for (auto it = m_nodes.begin(); it != m_nodes.end(); ) {
+		if (it->connectorItem.isNull()) it = m_nodes.erase(it);
+		else ++it;
+	}
+	m_swept = m_nodes.count();
+}
+
+bool GraphUtils::updateRatsnestGraph(const QList<ConnectorItem *> * partConnectorItems, ViewGeometry::WireFlags flags, const ConnectorPairHash & previous, RatsnestMemory & memory, ConnectorPairHash & result) {
+	if (partConnectorItems->count() < 2) return false;
+
+	QList <ConnectorItem *> temp;
+	collectRatsnestNodes(partConnectorItems, temp);
+
+	int num_nodes = temp.count();
+	QHash<ConnectorItem *, int> indexes;
+	QVector<QPointF> locs(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		ConnectorItem * connectorItem = temp.at(i);
+		indexes.insert(connectorItem, i);
+		ConnectorItem * crossConnectorItem = connectorItem->getCrossLayerConnectorItem();
+		if (crossConnectorItem) indexes.insert(crossConnectorItem, i);
+		locs[i] = connectorItem->sceneAdjustedTerminalPoint(NULL);
+	}
+
+	// zero-weight groups: connectors on the same bus of a part, already connected by wires or traces, or on top of each other
+	UnionFind groups(num_nodes);
+	QHash< QPair<ItemBase *, Bus *>, int> busFirst;
+	for (int i = 0; i < num_nodes; i++) {
+		ConnectorItem * connectorItem = temp.at(i);
+		if (connectorItem->bus() == NULL) continue;
+
+		QPair<ItemBase *, Bus *> key(connectorItem->attachedTo(), connectorItem->bus());
+		int first = busFirst.value(key, -1);
+		if (first < 0) busFirst.insert(key, i);
+		else groups.unite(first, i);
+	}
+
+	// one walk per wired group: every connector a walk reaches is skipped as a starting point
+	QVector<bool> wired(num_nodes, false);
+	for (int i = 0; i < num_nodes; i++) {
+		if (wired[i]) continue;
+
+		QList<ConnectorItem *> cwConnectorItems;
+		cwConnectorItems.append(temp.at(i));
+		ConnectorItem::collectEqualPotential(cwConnectorItems, true, flags);
+		foreach (ConnectorItem * cw, cwConnectorItems) {
+			int j = indexes.value(cw, -1);
+			if (j < 0) continue;
+
+			wired[j] = true;
+			groups.unite(i, j);
+		}
+	}
+
+	// coincident connectors get no ratsnest wire, as in chooseRatsnestGraph
+	QHash< QPair<double, double>, int> locationFirst;
+	for (int i = 0; i < num_nodes; i++) {
+		QPair<double, double> key(locs[i].x(), locs[i].y());
+		int first = locationFirst.value(key, -1);
+		if (first < 0) locationFirst.insert(key, i);
+		else groups.unite(first, i);
+	}
+
+	QVector<int> groupOf(num_nodes);
+	QVector<RatsnestMemory::NodeKey> keys(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		groupOf[i] = groups.find(i);
+		keys[i] = RatsnestMemory::nodeKey(temp.at(i));
+	}
+
+	// what the previous tree was built from
+	QVector<RatsnestTree::Node> nodes(num_nodes);
+	QHash<RatsnestMemory::NodeKey, int> previousGroups;
+	for (int i = 0; i < num_nodes; i++) {
+		RatsnestTree::Node & node = nodes[i];
+		node.location = locs[i];
+		node.group = groupOf[i];
+		node.previousGroup = -1;
+
+		auto it = memory.m_nodes.constFind(keys[i]);
+		node.known = (it != memory.m_nodes.constEnd() && it->connectorItem.data() == temp.at(i));	// not new to this net, nor deleted and restored
+		if (!node.known) continue;
+
+		node.previousLocation = it->location;
+		int group = previousGroups.value(it->groupRep, -1);
+		if (group < 0) {
+			group = previousGroups.count();
+			previousGroups.insert(it->groupRep, group);
+		}
+		node.previousGroup = group;
+	}
+
+	QList<RatsnestTree::Edge> previousEdges;
+	for (auto it = previous.constBegin(); it != previous.constEnd(); ++it) {
+		previousEdges.append(RatsnestTree::Edge(indexes.value(it.key(), -1), indexes.value(it.value(), -1)));
+	}
+
+	foreach (RatsnestTree::Edge edge, RatsnestTree::update(nodes, previousEdges)) {
+		result.insert(temp[edge.first], temp[edge.second]);
+	}
+
+	for (int i = 0; i < num_nodes; i++) {
+		RatsnestMemory::Node & node = memory.m_nodes[keys[i]];
+		node.connectorItem = temp.at(i);
+		node.location = locs[i];
+		node.groupRep = keys[groupOf[i]];
+	}
+	memory.sweep();
+
+	return true;
+}
+
 #define add_edge_d(i, j, g) \
 	add_edge(verts[i], verts[j], g); \
     //partConnectorItems[i]->debugInfo(QString("edge from %1").arg(i));
@@ -24,6 +24,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../connectors/connectoritem.h"
 #include "../routingstatus.h"
 
+#include <QPointer>
+
 struct ConnectorEdge {
 	int head;
 	int tail;
@@ -36,15 +38,42 @@ struct ConnectorEdge {
 	void setHeadTail(int head, int tail);
 };
 
+// what updateRatsnestGraph remembers about the connectors of one view between calls
+class RatsnestMemory
+{
+public:
+	RatsnestMemory();
+
+protected:
+	typedef QPair<qint64, QString> NodeKey;			// part id and connector id; both layers of a connector share a key
+
+	struct Node {
+		QPointer<ConnectorItem> connectorItem;
+		QPointF location;
+		NodeKey groupRep;
+	};
+
+	static NodeKey nodeKey(ConnectorItem *);
+	void sweep();
+
+protected:
+	QHash<NodeKey, Node> m_nodes;
+	int m_swept;
+
+	friend class GraphUtils;
+};
+
 class GraphUtils
 {
 
 public:
 	static bool chooseRatsnestGraph(const QList<ConnectorItem *> * equipotentials, ViewGeometry::WireFlags, ConnectorPairHash & result);
+	static bool updateRatsnestGraph(const QList<ConnectorItem *> * equipotentials, ViewGeometry::WireFlags, const ConnectorPairHash & previous, RatsnestMemory &, ConnectorPairHash & result);
 	static bool scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags, RoutingStatus & routingStatus);
 	static void minCut(QList<ConnectorItem *> & connectorItems, QList<class SketchWidget *> & foreighSketchWidgets, ConnectorItem * source, ConnectorItem * sink, QList<ConnectorEdge *> & cutSet);
 
 protected:
+	static void collectRatsnestNodes(const QList<ConnectorItem *> * equipotentials, QList<ConnectorItem *> & nodes);
 	static void collectBreadboard(ConnectorItem * connectorItem, QList<ConnectorItem *> & partConnectorItems, QList<ConnectorItem *> & ends);
 
 };
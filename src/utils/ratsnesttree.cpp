@@ -0,0 +1,172 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "ratsnesttree.h"
+
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+
+namespace {
+
+struct RatsnestCandidate {
+	int i;
+	int j;
+	double weight;
+
+	bool operator<(const RatsnestCandidate & other) const {
+		if (weight != other.weight) return weight < other.weight;
+		if (i != other.i) return i < other.i;
+		return j < other.j;
+	}
+};
+
+}
+
+double RatsnestTree::weight(const QVector<Node> & nodes, int i, int j) {
+	double dx = nodes.at(i).location.x() - nodes.at(j).location.x();
+	double dy = nodes.at(i).location.y() - nodes.at(j).location.y();
+	return (dx * dx) + (dy * dy);
+}
+
+QList<RatsnestTree::Edge> RatsnestTree::build(const QVector<Node> & nodes) {
+	return span(nodes, QVector<bool>(nodes.count(), true), QList<Edge>());
+}
+
+QList<RatsnestTree::Edge> RatsnestTree::update(const QVector<Node> & nodes, const QList<Edge> & previous, bool * rebuilt) {
+	if (rebuilt) *rebuilt = false;
+
+	int num_nodes = nodes.count();
+
+	// compare against what the previous tree was built from
+	QVector<bool> moved(num_nodes, false);
+	QHash<int, int> newToOld;
+	QHash<int, int> oldToNew;
+	bool merged = false;
+	bool split = false;
+	for (int i = 0; i < num_nodes; i++) {
+		const Node & node = nodes.at(i);
+		if (!node.known) {
+			moved[i] = true;
+			continue;
+		}
+
+		if (node.location != node.previousLocation) moved[i] = true;
+
+		auto old = newToOld.constFind(node.group);
+		if (old == newToOld.constEnd()) newToOld.insert(node.group, node.previousGroup);
+		else if (old.value() != node.previousGroup) merged = true;
+
+		auto group = oldToNew.constFind(node.previousGroup);
+		if (group == oldToNew.constEnd()) oldToNew.insert(node.previousGroup, node.group);
+		else if (group.value() != node.group) split = true;
+	}
+
+	QList<Edge> kept;
+	QSet<Edge> seen;
+	bool cut = false;
+	foreach (Edge edge, previous) {
+		int i = edge.first;
+		int j = edge.second;
+		if (i < 0 || j < 0 || moved[i] || moved[j]) {
+			cut = true;
+			continue;
+		}
+		if (i == j) continue;
+
+		Edge key(qMin(i, j), qMax(i, j));
+		if (seen.contains(key)) continue;
+
+		seen.insert(key);
+		kept.append(key);
+	}
+
+	if (merged && (split || cut)) {
+		if (rebuilt) *rebuilt = true;
+		return build(nodes);
+	}
+
+	return span(nodes, moved, kept);
+}
+
+QList<RatsnestTree::Edge> RatsnestTree::span(const QVector<Node> & nodes, const QVector<bool> & moved, const QList<Edge> & kept) {
+	int num_nodes = nodes.count();
+
+	UnionFind groups(num_nodes);
+	QHash<int, int> groupFirst;
+	for (int i = 0; i < num_nodes; i++) {
+		int first = groupFirst.value(nodes.at(i).group, -1);
+		if (first < 0) groupFirst.insert(nodes.at(i).group, i);
+		else groups.unite(first, i);
+	}
+
+	UnionFind components(groups);
+	foreach (Edge edge, kept) {
+		components.unite(edge.first, edge.second);
+	}
+
+	QVector<RatsnestCandidate> candidates;
+	foreach (Edge edge, kept) {
+		candidates.append({ edge.first, edge.second, weight(nodes, edge.first, edge.second) });
+	}
+
+	// a moved node is paired with every other group
+	QList<int> movedNodes;
+	QHash<int, QList<int> > untouched;			// the unmoved nodes of each component
+	for (int i = 0; i < num_nodes; i++) {
+		if (moved[i]) movedNodes.append(i);
+		else untouched[components.find(i)].append(i);
+	}
+
+	foreach (int i, movedNodes) {
+		for (int j = 0; j < num_nodes; j++) {
+			if (nodes.at(i).group == nodes.at(j).group) continue;
+			if (moved[j] && j < i) continue;
+
+			candidates.append({ qMin(i, j), qMax(i, j), weight(nodes, i, j) });
+		}
+	}
+
+	// unmoved nodes are only paired across the components the kept tree left; when nothing was cut there's a single component and no pairs
+	QList< QList<int> > buckets = untouched.values();
+	for (int a = 0; a < buckets.count(); a++) {
+		for (int b = a + 1; b < buckets.count(); b++) {
+			foreach (int i, buckets.at(a)) {
+				foreach (int j, buckets.at(b)) {
+					candidates.append({ qMin(i, j), qMax(i, j), weight(nodes, i, j) });
+				}
+			}
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	QList<Edge> result;
+	UnionFind tree(groups);
+	foreach (const RatsnestCandidate & candidate, candidates) {
+		if (!tree.unite(candidate.i, candidate.j)) continue;
+
+		result.append(Edge(candidate.i, candidate.j));
+	}
+
+	return result;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef RATSNESTTREE_H
+#define RATSNESTTREE_H
+
+#include <QList>
+#include <QPair>
+#include <QPointF>
+#include <QVector>
+
+// The minimum spanning tree behind a ratsnest, on plain points so it can be checked without a scene.
+// Nodes with the same group are already connected (same bus, or wired) and cost nothing to join.
+// Coincident nodes cost nothing to join either, so they must be given the same group: then every edge of
+// the tree is a returned edge, and the previous tree can be rebuilt from the ratsnest wires alone.
+// The weight of an edge is the squared distance between its ends.
+//
+// update() starts from the previous tree and only looks at the edges that can have changed:
+//		previous tree edges whose ends did not move
+//		every edge touching a node that moved or is new
+//		edges between the components the remaining tree and the groups fall into
+// Any other edge closes a cycle whose other edges are no heavier, so it can't be in the new tree.  That
+// argument needs the path through the old tree to survive, which it doesn't when groups merge while tree
+// edges are cut (by a moved or removed node, or a split group): the merged group can join the two sides of
+// a cut through a heavier kept edge.  In that case the whole tree is rebuilt.  previousGroup must be the
+// group the node had when the previous tree was built.
+
+// disjoint sets over node indexes; the smaller index of a set is its representative
+
+class UnionFind
+{
+public:
+	UnionFind(int count) : m_parent(count) {
+		for (int i = 0; i < count; i++) m_parent[i] = i;
+	}
+
+	int find(int i) {
+		while (m_parent[i] != i) {
+			m_parent[i] = m_parent[m_parent[i]];
+			i = m_parent[i];
+		}
+		return i;
+	}
+
+	bool unite(int i, int j) {
+		i = find(i);
+		j = find(j);
+		if (i == j) return false;
+
+		m_parent[qMax(i, j)] = qMin(i, j);
+		return true;
+	}
+
+protected:
+	QVector<int> m_parent;
+};
+
+class RatsnestTree
+{
+public:
+	struct Node {
+		QPointF location;
+		int group;
+		bool known;					// the node was in the previous tree
+		QPointF previousLocation;
+		int previousGroup;
+	};
+
+	typedef QPair<int, int> Edge;
+
+public:
+	static QList<Edge> build(const QVector<Node> &);
+	static QList<Edge> update(const QVector<Node> &, const QList<Edge> & previous, bool * rebuilt = nullptr);	// -1 marks an end that left
+	static double weight(const QVector<Node> &, int i, int j);
+
+protected:
+	static QList<Edge> span(const QVector<Node> &, const QVector<bool> & moved, const QList<Edge> & kept);
+};
+
+#endif
@@ -21,6 +21,10 @@
 #include <QImage>
 #include <QPainter>
 #include <QBitArray>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 #include "../../src/utils/textutils.h"
 #include "../../src/utils/schematicrectconstants.h"
@@ -92,7 +96,7 @@ void setHiddenAux(QList<ConnectorLocation *> & allConnectorLocations, QList<Conn
 
 /////////////////////////////////
 
-static QRegExp IntegerFinder("\\d+");
+static const QRegExp IntegerFinder("\\d+");
 static const double ImageFactor = 5;
 static const double FudgeDivisor = 300;
 static const QRegExp VersionRegexp("[ -_][vV][\\d]+");
@@ -214,21 +218,83 @@ QString makeTerminal(const ConnectorLocation * connectorLocation, double x, doub
 ///////////////////////////////////////////////////////
 
 
+// cost is one per string
+QCache<QString, double> S2S::WidthCache(64 * 1024);
+QMutex S2S::WidthCacheMutex;
+
+struct S2SBatchJob {
+	QStringList fzpFilePaths;
+	QDir oldSvgDir;
+	QDir newSvgDir;
+	bool fzpzStyle = false;
+	QList<S2SResult> results;
+};
+
+static void runBatchJob(S2SBatchJob & job) {
+	S2S s2s(job.fzpzStyle);
+	s2s.setBatch(true);
+	s2s.setSvgDirs(job.oldSvgDir, job.newSvgDir);
+	foreach (QString fzpFilePath, job.fzpFilePaths) {
+		QElapsedTimer timer;
+		timer.start();
+		S2SResult result;
+		result.fzpFilePath = fzpFilePath;
+		QString schematicFilePath;
+		result.outcome = s2s.convert(fzpFilePath, schematicFilePath);
+		result.schematicFilePath = schematicFilePath;
+		result.messages = s2s.takeMessages();
+		result.elapsed = timer.elapsed();
+		job.results.append(result);
+	}
+}
+
+static bool byFzpFilePath(const S2SResult & r1, const S2SResult & r2) {
+	return r1.fzpFilePath < r2.fzpFilePath;
+}
+
+///////////////////////////////////////////////////////
+
 S2S::S2S(bool fzpzStyle) : QObject(),
 	m_image(new QImage(50 * ImageFactor, 5 * ImageFactor, QImage::Format_Mono)),
     m_fzpzStyle(fzpzStyle)
 {
 }
 
+S2S::~S2S() {
+	delete m_image;
+}
+
 void S2S::message(const QString & msg) {
 	// QTextStream cout(stdout);
 	//  cout << msg;
 	// cout.flush();
 
+	if (m_batch) {
+		m_messages.append(msg);
+		return;
+	}
+
 	qDebug() << msg;
 	emit messageSignal(msg);
 }
 
+void S2S::note(const QString & msg) {
+	// progress detail; a batch drops it, since parallel parts would interleave it
+	if (m_batch) return;
+
+	qDebug() << msg;
+}
+
+void S2S::setBatch(bool batch) {
+	m_batch = batch;
+}
+
+QStringList S2S::takeMessages() {
+	QStringList messages = m_messages;
+	m_messages.clear();
+	return messages;
+}
+
 void S2S::saveFile(const QString & content, const QString & path)
 {
 	QFile file(path);
@@ -241,8 +307,12 @@ void S2S::saveFile(const QString & content, const QString & path)
 }
 
 bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
+	return convert(fzpFilePath, schematicFilePath) == Converted;
+}
+
+S2S::Outcome S2S::convert(QString & fzpFilePath, QString & schematicFilePath) {
 	if (!fzpFilePath.endsWith(".fzp")) {
-		return false;
+		return Skipped;
 	}
 
 	bool createSchematicFile = schematicFilePath.isEmpty();
@@ -262,7 +332,7 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 	QDomDocument dom;
 	if (!dom.setContent(&file, true, &errorStr, &errorLine, &errorColumn)) {
 		message(tr("Failed loading '%1', %2 line:%3 col:%4").arg(fzpFilePath).arg(errorStr).arg(errorLine).arg(errorColumn));
-		return false;
+		return Failed;
 	}
 
 	QDomElement root = dom.documentElement();
@@ -281,23 +351,10 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 
 
 	if (createSchematicFile) {
-		QString schematicFileName;
-		QDomNodeList nodeList = root.elementsByTagName("schematicView");
-		for (int i = 0; i < nodeList.count(); i++) {
-			QDomElement schematicView = nodeList.at(i).toElement();
-			QDomElement layers = schematicView.firstChildElement("layers");
-			schematicFileName = layers.attribute("image");
-			if (!schematicFileName.isEmpty()) break;
-		}
-
+		QString schematicFileName = this->schematicFileName(root);
 		if (schematicFileName.isEmpty()) {
 			message(tr("Schematic not found for '%1'").arg(fzpFilePath));
-			return false;
-		}
-
-		if (m_fzpzStyle) {
-			schematicFileName.replace("/", ".");
-			schematicFileName = "svg." + schematicFileName;
+			return Skipped;
 		}
 
 		schematicFilePath = m_oldSvgDir.absoluteFilePath(schematicFileName);
@@ -305,29 +362,29 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 	}
 
 	if (!ensureTerminalPoints(fzpFilePath, schematicFilePath, root)) {
-		return false;
+		return Failed;
 	}
 
-	qDebug() << schematicFilePath;
+	note(schematicFilePath);
 
 	QSvgRenderer renderer;
 	bool loaded = renderer.load(schematicFilePath);
 	if (!loaded) {
 		message(tr("Unable to load schematic '%1' for '%2'").arg(schematicFilePath).arg(fzpFilePath));
-		return false;
+		return Failed;
 	}
 
 	QList<ConnectorLocation *> connectorLocations = initConnectors(root, renderer, fzpFilePath, schematicFilePath);
 
 	QRectF viewBox = renderer.viewBoxF();
 	if (viewBox.isEmpty()) {
-		qDebug() << "\tempty viewbox";
+		note("\tempty viewbox");
 	}
 	double oldUnit = lrtb(connectorLocations, viewBox);
 
 	if (qAbs(oldUnit - SchematicRectConstants::NewUnit) < (SchematicRectConstants::NewUnit / 25)) {
 		message(tr("Schematic '%1' is already using the 0.1inch standard.").arg(schematicFilePath));
-		return false;
+		return Skipped;
 	}
 
 	setHidden(connectorLocations);
@@ -512,10 +569,34 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 	svg +="</g>\n";
 	svg +="</svg>\n";
 
-	TextUtils::writeUtf8(newSchematicFilePath, svg);
-	qDebug() << newSchematicFilePath;
-	qDebug() << "";
-	return true;
+	if (!TextUtils::writeUtf8(newSchematicFilePath, svg)) {
+		message(tr("Unable to write '%1'").arg(newSchematicFilePath));
+		return Failed;
+	}
+
+	note(newSchematicFilePath);
+	note("");
+	return Converted;
+}
+
+QString S2S::schematicFileName(const QDomElement & fzpRoot) {
+	QString schematicFileName;
+	QDomNodeList nodeList = fzpRoot.elementsByTagName("schematicView");
+	for (int i = 0; i < nodeList.count(); i++) {
+		QDomElement schematicView = nodeList.at(i).toElement();
+		QDomElement layers = schematicView.firstChildElement("layers");
+		schematicFileName = layers.attribute("image");
+		if (!schematicFileName.isEmpty()) break;
+	}
+
+	if (schematicFileName.isEmpty()) return schematicFileName;
+
+	if (m_fzpzStyle) {
+		schematicFileName.replace("/", ".");
+		schematicFileName = "svg." + schematicFileName;
+	}
+
+	return schematicFileName;
 }
 
 
@@ -530,6 +611,13 @@ double S2S::stringWidthMM(double fontSize, const QString & string) {
 	double mm = 25.4 * pixels / 90;
 	*/
 
+	QString key = QString::number(fontSize) + '\n' + string;
+	{
+		QMutexLocker locker(&WidthCacheMutex);
+		double * cached = WidthCache.object(key);
+		if (cached) return *cached;
+	}
+
 	QString svg = TextUtils::makeSVGHeader(25.4, 25.4, 50, 5);
 	svg += QString("<text font=\"%1\" font-size='%2' stroke='none' stroke-width='0' fill='black' x='0' y='%4' text-anchor='start' >%3</text>")
 	       .arg(SchematicRectConstants::FontFamily).arg(fontSize).arg(TextUtils::escapeAnd(string)).arg(2.5);
@@ -559,7 +647,10 @@ double S2S::stringWidthMM(double fontSize, const QString & string) {
 	//    qDebug() << "string width" << mm << (bestX / ImageFactor) << string;
 	//}
 
-	return bestX / ImageFactor;
+	double mm = bestX / ImageFactor;
+	QMutexLocker locker(&WidthCacheMutex);
+	WidthCache.insert(key, new double(mm));
+	return mm;
 }
 
 QList<ConnectorLocation *> S2S::initConnectors(const QDomElement & root, const QSvgRenderer & renderer, const QString & fzpFilename, const QString & svgFilename)
@@ -574,6 +665,7 @@ QList<ConnectorLocation *> S2S::initConnectors(const QDomElement & root, const Q
 	QDomElement connector = connectors.firstChildElement("connector");
 	QBitArray idlist;
 	int noIDCount = 0;
+	QRegExp integerFinder(IntegerFinder);		// local copy so match state is not shared between threads
 	while (!connector.isNull()) {
 		QDomElement schematicView = connector.firstChildElement("views").firstChildElement("schematicView");
 		QString svgID = schematicView.firstChildElement("p").attribute("svgId");
@@ -586,9 +678,9 @@ QList<ConnectorLocation *> S2S::initConnectors(const QDomElement & root, const Q
 			connectorLocation->hidden = false;
 			connectorLocation->displayPinNumber = false;
 			QString id = connector.attribute("id");
-			int ix = IntegerFinder.indexIn(id);
+			int ix = integerFinder.indexIn(id);
 			if (ix > 0) {
-				connectorLocation->id = IntegerFinder.cap(0).toInt();
+				connectorLocation->id = integerFinder.cap(0).toInt();
 				if (idlist.size() < connectorLocation->id + 1) {
 					int oldsize = idlist.size();
 					idlist.resize(connectorLocation->id + 1);
@@ -631,7 +723,7 @@ QList<ConnectorLocation *> S2S::initConnectors(const QDomElement & root, const Q
 	}
 
 	if (noIDCount > 0) {
-		qDebug() << "no id count" << noIDCount;
+		note(QString("no id count %1").arg(noIDCount));
 	}
 
 	bool display = true;
@@ -691,7 +783,7 @@ double S2S::lrtb(QList<ConnectorLocation *> & connectorLocations, const QRectF &
 			m_bottoms << connectorLocation;
 			break;
 		default:
-			qDebug() << "shouldn't happen" << ix;
+			note(QString("shouldn't happen %1").arg(ix));
 		}
 
 	}
@@ -749,13 +841,13 @@ double S2S::lrtb(QList<ConnectorLocation *> & connectorLocations, const QRectF &
 	}
 
 	if (biggest == 0) {
-		qDebug() << "\tbiggest 0" << totalPins;
+		note(QString("\tbiggest 0 %1").arg(totalPins));
 	}
 
 	double oldUnit = biggestIndex * m_fudge;
 
-	qDebug() << QString("\tunit is roughly %1mm, bin:%2 pins:%3 fudge:%4").arg(oldUnit).arg(biggest).arg(totalPins).arg(m_fudge);
-	qDebug() << QString("\tl:%1 t:%2 r:%3 b:%4").arg(m_lefts.count()).arg(m_tops.count()).arg(m_rights.count()).arg(m_bottoms.count());
+	note(QString("\tunit is roughly %1mm, bin:%2 pins:%3 fudge:%4").arg(oldUnit).arg(biggest).arg(totalPins).arg(m_fudge));
+	note(QString("\tl:%1 t:%2 r:%3 b:%4").arg(m_lefts.count()).arg(m_tops.count()).arg(m_rights.count()).arg(m_bottoms.count()));
 
 	return oldUnit;
 }
@@ -814,7 +906,7 @@ bool S2S::ensureTerminalPoints(const QString & fzpFilePath, const QString & svgF
 		QDomElement connector = p.parentNode().parentNode().parentNode().toElement();
 		QString name = connector.attribute("id");
 		if (name.isEmpty()) {
-			qDebug() << "empty name in connector";
+			note("empty name in connector");
 		}
 		else {
 			// assumes the file is well behaved, and the terminalID isn't already in use
@@ -895,3 +987,102 @@ void S2S::setSvgDirs(QDir & oldDir, QDir & newDir) {
 	m_oldSvgDir = oldDir;
 	m_newSvgDir = newDir;
 }
+
+QList<QStringList> S2S::groupBySchematic(QStringList fzpFilePaths, const QDir & oldSvgDir, const QDir & newSvgDir, bool fzpzStyle) {
+	fzpFilePaths.sort();
+
+	// parts drawn from the same schematic share a job: ensureTerminalPoints may rewrite that svg,
+	// and they all write the same output file
+	S2S scanner(fzpzStyle);
+	QMap<QString, int> groupIndexes;
+	QList<QStringList> groups;
+	foreach (QString fzpFilePath, fzpFilePaths) {
+		QString key = fzpFilePath;
+		QFile file(fzpFilePath);
+		QDomDocument dom;
+		if (dom.setContent(&file, true)) {
+			QString schematicFileName = scanner.schematicFileName(dom.documentElement());
+			if (!schematicFileName.isEmpty()) {
+				key = oldSvgDir.absoluteFilePath(schematicFileName);
+				// writeUtf8 won't create the folder, and the workers shouldn't race to
+				QFileInfo info(newSvgDir.absoluteFilePath(schematicFileName));
+				QDir().mkpath(info.absolutePath());
+			}
+		}
+
+		int index = groupIndexes.value(key, -1);
+		if (index < 0) {
+			index = groups.count();
+			groupIndexes.insert(key, index);
+			groups.append(QStringList());
+		}
+		groups[index].append(fzpFilePath);
+	}
+
+	return groups;
+}
+
+QList<S2SResult> S2S::batch(const QStringList & fzpFilePaths, const QDir & oldSvgDir, const QDir & newSvgDir, bool fzpzStyle) {
+	QList<S2SBatchJob> jobs;
+	foreach (QStringList group, groupBySchematic(fzpFilePaths, oldSvgDir, newSvgDir, fzpzStyle)) {
+		S2SBatchJob job;
+		job.fzpFilePaths = group;
+		job.oldSvgDir = oldSvgDir;
+		job.newSvgDir = newSvgDir;
+		job.fzpzStyle = fzpzStyle;
+		jobs.append(job);
+	}
+
+	QtConcurrent::blockingMap(jobs, runBatchJob);
+
+	QList<S2SResult> results;
+	foreach (const S2SBatchJob & job, jobs) {
+		results.append(job.results);
+	}
+	qSort(results.begin(), results.end(), byFzpFilePath);
+	return results;
+}
+
+QStringList S2S::summary(const QList<S2SResult> & results, qint64 elapsed) {
+	QStringList lines;
+	int converted = 0;
+	int skipped = 0;
+	int failed = 0;
+	qint64 work = 0;
+	QString slowest;
+	qint64 slowestElapsed = -1;
+	foreach (const S2SResult & result, results) {
+		QString status;
+		switch (result.outcome) {
+		case Converted:
+			converted++;
+			status = "converted";
+			break;
+		case Skipped:
+			skipped++;
+			status = "skipped";
+			break;
+		default:
+			failed++;
+			status = "failed";
+			break;
+		}
+
+		work += result.elapsed;
+		if (result.elapsed > slowestElapsed) {
+			slowestElapsed = result.elapsed;
+			slowest = result.fzpFilePath;
+		}
+		if (result.outcome == Converted && result.messages.isEmpty()) continue;
+
+		lines << QString("%1 %2: %3").arg(status).arg(QFileInfo(result.fzpFilePath).fileName()).arg(result.messages.join(" "));
+	}
+
+	lines << QString("s2s: %1 parts in %2 ms on %3 threads: %4 converted, %5 skipped, %6 failed")
+	      .arg(results.count()).arg(elapsed).arg(QThreadPool::globalInstance()->maxThreadCount())
+	      .arg(converted).arg(skipped).arg(failed);
+	if (!slowest.isEmpty()) {
+		lines << QString("s2s: %1 ms of work, slowest %2 at %3 ms").arg(work).arg(QFileInfo(slowest).fileName()).arg(slowestElapsed);
+	}
+	return lines;
+}
@@ -7,6 +7,9 @@
 #include <QRectF>
 #include <QDomElement>
 #include <QSvgRenderer>
+#include <QStringList>
+#include <QCache>
+#include <QMutex>
 
 
 struct ConnectorLocation {
@@ -28,14 +31,42 @@ struct ConnectorLocation {
 	};
 };
 
+struct S2SResult {
+	QString fzpFilePath;
+	QString schematicFilePath;
+	int outcome = 0;			// S2S::Outcome
+	QStringList messages;
+	qint64 elapsed = 0;			// ms
+};
+
 class S2S : public QObject
 {
 	Q_OBJECT
+public:
+	enum Outcome {
+		Converted,
+		Skipped,
+		Failed
+	};
+
 public:
 	S2S(bool fzpzStyle);
+	~S2S();
 
 	bool onefzp(QString & fzpFilePath, QString & schematicFilePath);
+	Outcome convert(QString & fzpFilePath, QString & schematicFilePath);
 	void setSvgDirs(QDir & oldDir, QDir & newDir);
+	QString schematicFileName(const QDomElement & fzpRoot);
+	void setBatch(bool);
+	QStringList takeMessages();
+
+	// regenerates the schematics of many parts on the global thread pool; results come back sorted by fzp path,
+	// and parts sharing a schematic svg are converted one after another in that order, so the files written don't
+	// depend on scheduling.  Messages are collected per part rather than emitted.
+	static QList<S2SResult> batch(const QStringList & fzpFilePaths, const QDir & oldSvgDir, const QDir & newSvgDir, bool fzpzStyle);
+	// the jobs batch runs: fzp paths in sorted order, one list per schematic svg; creates the output folders
+	static QList<QStringList> groupBySchematic(QStringList fzpFilePaths, const QDir & oldSvgDir, const QDir & newSvgDir, bool fzpzStyle);
+	static QStringList summary(const QList<S2SResult> &, qint64 elapsed);
 
 
 signals:
@@ -43,6 +74,7 @@ signals:
 
 protected:
 	void message(const QString &);
+	void note(const QString &);
 	void saveFile(const QString & content, const QString & path);
 	double stringWidthMM(double fontSize, const QString & string);
 	QList<ConnectorLocation *> initConnectors(const QDomElement & root, const QSvgRenderer &, const QString & fzpFilename, const QString & svgFilename);
@@ -67,6 +99,12 @@ protected:
 	QDir m_oldSvgDir;
 	QDir m_newSvgDir;
 	QImage * m_image;
+	bool m_batch = false;
+	QStringList m_messages;
+
+	// stringWidthMM renders the text to measure it, and titles and pin names repeat across a library
+	static QCache<QString, double> WidthCache;
+	static QMutex WidthCacheMutex;
 };
 
 
@@ -0,0 +1,186 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QVector>
+#include <QRectF>
+#include <QPointF>
+#include <qmath.h>
+
+// A uniform grid over scene coordinates: each value is filed under every cell its rect overlaps.
+// Lookups only visit the cells under the query, so the cost depends on how crowded those cells are,
+// not on how many values are in the grid.  Values whose rect would cover more than maxCells cells
+// are kept in a separate list that every query checks.
+
+template <class T>
+class SpatialGrid
+{
+public:
+	SpatialGrid(double cellSize = 36, int maxCells = 1024)
+		: m_cellSize(cellSize), m_maxCells(maxCells)
+	{
+	}
+
+	void insert(T value, const QRectF & rect) {
+		remove(value);
+
+		Entry & entry = m_entries[value];
+		entry.rect = rect;
+		int x0, y0, x1, y1;
+		cellRange(rect, x0, y0, x1, y1);
+		if ((qint64) (x1 - x0 + 1) * (y1 - y0 + 1) > m_maxCells) {
+			entry.large = true;
+			m_large.insert(value);
+			return;
+		}
+
+		entry.large = false;
+		for (int x = x0; x <= x1; x++) {
+			for (int y = y0; y <= y1; y++) {
+				m_cells[cellKey(x, y)].append(value);
+			}
+		}
+	}
+
+	void remove(T value) {
+		auto it = m_entries.find(value);
+		if (it == m_entries.end()) return;
+
+		if (it->large) {
+			m_large.remove(value);
+		}
+		else {
+			int x0, y0, x1, y1;
+			cellRange(it->rect, x0, y0, x1, y1);
+			for (int x = x0; x <= x1; x++) {
+				for (int y = y0; y <= y1; y++) {
+					auto cell = m_cells.find(cellKey(x, y));
+					if (cell == m_cells.end()) continue;
+
+					cell->removeOne(value);
+					if (cell->isEmpty()) m_cells.erase(cell);
+				}
+			}
+		}
+
+		m_entries.erase(it);
+	}
+
+	bool contains(T value) const {
+		return m_entries.contains(value);
+	}
+
+	QRectF rect(T value) const {
+		return m_entries.value(value).rect;
+	}
+
+	int count() const {
+		return m_entries.count();
+	}
+
+	void clear() {
+		m_entries.clear();
+		m_cells.clear();
+		m_large.clear();
+	}
+
+	// values whose rect contains the point
+	QList<T> query(const QPointF & p) const {
+		QList<T> result;
+		const QVector<T> cell = m_cells.value(cellKey(cellIndex(p.x()), cellIndex(p.y())));
+		foreach (T value, cell) {
+			if (m_entries.value(value).rect.contains(p)) result.append(value);
+		}
+		foreach (T value, m_large) {
+			if (m_entries.value(value).rect.contains(p)) result.append(value);
+		}
+		return result;
+	}
+
+	// values whose rect intersects the rect
+	QList<T> query(const QRectF & r) const {
+		QList<T> result;
+		int x0, y0, x1, y1;
+		cellRange(r, x0, y0, x1, y1);
+		bool single = (x0 == x1 && y0 == y1);
+		QSet<T> seen;
+		for (int x = x0; x <= x1; x++) {
+			for (int y = y0; y <= y1; y++) {
+				auto cell = m_cells.constFind(cellKey(x, y));
+				if (cell == m_cells.constEnd()) continue;
+
+				foreach (T value, *cell) {
+					if (!single) {
+						if (seen.contains(value)) continue;
+						seen.insert(value);
+					}
+					if (intersects(m_entries.value(value).rect, r)) result.append(value);
+				}
+			}
+		}
+		foreach (T value, m_large) {
+			if (intersects(m_entries.value(value).rect, r)) result.append(value);
+		}
+		return result;
+	}
+
+protected:
+	struct Entry {
+		QRectF rect;
+		bool large = false;
+	};
+
+	int cellIndex(double v) const {
+		return qFloor(v / m_cellSize);
+	}
+
+	void cellRange(const QRectF & r, int & x0, int & y0, int & x1, int & y1) const {
+		QRectF n = r.normalized();
+		x0 = cellIndex(n.left());
+		y0 = cellIndex(n.top());
+		x1 = cellIndex(n.right());
+		y1 = cellIndex(n.bottom());
+	}
+
+	static qint64 cellKey(int x, int y) {
+		return ((qint64) x << 32) | (quint32) y;
+	}
+
+	static bool intersects(const QRectF & r1, const QRectF & r2) {
+		// unlike QRectF::intersects, touching edges and zero-size rects count
+		QRectF n1 = r1.normalized();
+		QRectF n2 = r2.normalized();
+		return n1.left() <= n2.right() && n2.left() <= n1.right() && n1.top() <= n2.bottom() && n2.top() <= n1.bottom();
+	}
+
+protected:
+	double m_cellSize;
+	int m_maxCells;
+	QHash<T, Entry> m_entries;
+	QHash<qint64, QVector<T> > m_cells;
+	QSet<T> m_large;
+};
+
+#endif
@@ -929,9 +929,10 @@ QList<double> TextUtils::getTransformFloats(const QString & transform) {
 	QList<double> list;
 	int pos = 0;
 
-	while ((pos = TextUtils::floatingPointMatcher.indexIn(transform, pos)) != -1) {
-		list << transform.mid(pos, TextUtils::floatingPointMatcher.matchedLength()).toDouble();
-		pos += TextUtils::floatingPointMatcher.matchedLength();
+	QRegExp floatingPointMatcher(TextUtils::floatingPointMatcher);		// local copy so match state is not shared between threads
+	while ((pos = floatingPointMatcher.indexIn(transform, pos)) != -1) {
+		list << transform.mid(pos, floatingPointMatcher.matchedLength()).toDouble();
+		pos += floatingPointMatcher.matchedLength();
 	}
 
 #ifndef QT_NO_DEBUG
@@ -968,8 +969,9 @@ void TextUtils::gWrap(QDomDocument & domDocument, const QHash<QString, QString>
 bool TextUtils::fixInternalUnits(QString & svg)
 {
 	// float detector is a little weak
-	static QRegExp findInternalUnits("[\"']([\\d,\\.]+)(px|mm|cm|in|pt|pc)[\"']");
-	static QRegExp findStrokeWidth("stroke-width:([\\d,\\.]+)(px|mm|cm|in|pt|pc)");
+	// not static: QRegExp keeps match state, and this is called from render worker threads
+	QRegExp findInternalUnits("[\"']([\\d,\\.]+)(px|mm|cm|in|pt|pc)[\"']");
+	QRegExp findStrokeWidth("stroke-width:([\\d,\\.]+)(px|mm|cm|in|pt|pc)");
 
 	int sw = 0;
 	int iu = 0;
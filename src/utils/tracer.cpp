@@ -0,0 +1,204 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "tracer.h"
+#include "../debugdialog.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+bool Tracer::Enabled = false;
+bool Tracer::Paused = false;
+bool Tracer::Initialized = false;
+QString Tracer::Path;
+QElapsedTimer Tracer::Timer;
+QList<Tracer::Span> Tracer::Spans;
+QHash<Qt::HANDLE, int> Tracer::Threads;
+QMutex Tracer::Mutex;
+
+static void saveTrace() {
+	Tracer::save();
+}
+
+/////////////////////////////////////////////////////////////////////
+
+void Tracer::init() {
+	// first call is from the gui thread, during startup
+	if (Initialized) return;
+
+	Initialized = true;
+	QByteArray path = qgetenv("FRITZING_TRACE");
+	if (!path.isEmpty()) {
+		start(QString::fromLocal8Bit(path));
+	}
+}
+
+bool Tracer::enabled() {
+	if (!Initialized) init();
+
+	return Enabled && !Paused;
+}
+
+void Tracer::start(const QString & path) {
+	QMutexLocker locker(&Mutex);
+	Initialized = true;
+	if (Enabled) return;
+
+	Enabled = true;
+	Path = path;
+	Timer.start();
+	if (!Path.isEmpty()) {
+		qAddPostRoutine(saveTrace);
+	}
+}
+
+void Tracer::pause(bool paused) {
+	QMutexLocker locker(&Mutex);
+	Paused = paused;
+}
+
+qint64 Tracer::now() {
+	return Timer.nsecsElapsed() / 1000;
+}
+
+int Tracer::threadIndex() {
+	// called with the mutex held
+	Qt::HANDLE handle = QThread::currentThreadId();
+	auto it = Threads.constFind(handle);
+	if (it != Threads.constEnd()) return it.value();
+
+	int index = Threads.count();
+	Threads.insert(handle, index);
+	return index;
+}
+
+void Tracer::addSpan(const char * name, qint64 start, qint64 duration, const QString & detail) {
+	QMutexLocker locker(&Mutex);
+	Span span;
+	span.name = name;
+	span.start = start;
+	span.duration = duration;
+	span.thread = threadIndex();
+	span.detail = detail;
+	Spans.append(span);
+}
+
+QList<Tracer::Total> Tracer::totals() {
+	QMutexLocker locker(&Mutex);
+	QList<Total> totals;
+	QHash<const char *, int> indexes;
+	foreach (const Span & span, Spans) {
+		int index = indexes.value(span.name, -1);
+		if (index < 0) {
+			index = totals.count();
+			indexes.insert(span.name, index);
+			Total total;
+			total.name = span.name;
+			totals.append(total);
+		}
+		totals[index].count++;
+		totals[index].microseconds += span.duration;
+	}
+
+	return totals;
+}
+
+void Tracer::clear() {
+	QMutexLocker locker(&Mutex);
+	Spans.clear();
+}
+
+bool Tracer::save() {
+	QMutexLocker locker(&Mutex);
+	if (Path.isEmpty()) return false;
+
+	qint64 pid = QCoreApplication::applicationPid();
+	QJsonArray events;
+	foreach (Qt::HANDLE handle, Threads.keys()) {
+		int index = Threads.value(handle);
+		QJsonObject args;
+		args.insert("name", index == 0 ? QString("main") : QString("thread %1").arg(index));
+		QJsonObject event;
+		event.insert("name", "thread_name");
+		event.insert("ph", "M");
+		event.insert("pid", pid);
+		event.insert("tid", index);
+		event.insert("args", args);
+		events.append(event);
+	}
+
+	foreach (const Span & span, Spans) {
+		QJsonObject event;
+		event.insert("name", span.name);
+		event.insert("cat", "fritzing");
+		event.insert("ph", "X");
+		event.insert("ts", span.start);
+		event.insert("dur", span.duration);
+		event.insert("pid", pid);
+		event.insert("tid", span.thread);
+		if (!span.detail.isEmpty()) {
+			QJsonObject args;
+			args.insert("detail", span.detail);
+			event.insert("args", args);
+		}
+		events.append(event);
+	}
+
+	QJsonObject root;
+	root.insert("traceEvents", events);
+	root.insert("displayTimeUnit", "ms");
+
+	QFile file(Path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		DebugDialog::debug(QString("unable to write trace %1").arg(Path));
+		return false;
+	}
+
+	file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+	file.close();
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+
+TraceScope::TraceScope(const char * name) : m_name(name), m_start(-1)
+{
+	if (Tracer::enabled()) m_start = Tracer::now();
+}
+
+TraceScope::TraceScope(const char * name, const QString & detail) : m_name(name), m_start(-1)
+{
+	if (!Tracer::enabled()) return;
+
+	m_detail = detail;
+	m_start = Tracer::now();
+}
+
+TraceScope::~TraceScope()
+{
+	if (m_start < 0) return;
+
+	Tracer::addSpan(m_name, m_start, Tracer::now() - m_start, m_detail);
+}
@@ -0,0 +1,89 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+
+// Scoped performance tracing.  Set the environment variable FRITZING_TRACE to a file path and every
+// TraceScope becomes a named span, with its thread, in a Chrome trace written when the application exits
+// (open it in chrome://tracing or https://ui.perfetto.dev).  With tracing off a TraceScope costs a branch.
+
+class Tracer
+{
+public:
+	struct Total {
+		QString name;
+		int count = 0;
+		qint64 microseconds = 0;
+	};
+
+public:
+	static bool enabled();
+	static void start(const QString & path);		// enable without the environment variable
+	static void pause(bool paused);					// stop or resume recording; the clock and the trace file are kept
+	static void addSpan(const char * name, qint64 start, qint64 duration, const QString & detail);
+	static qint64 now();							// microseconds since tracing started
+	static QList<Total> totals();					// per span name, in order of first appearance
+	static bool save();
+	static void clear();
+
+protected:
+	struct Span {
+		const char * name;
+		qint64 start;
+		qint64 duration;
+		int thread;
+		QString detail;
+	};
+
+	static void init();
+	static int threadIndex();
+
+protected:
+	static bool Enabled;
+	static bool Paused;
+	static bool Initialized;
+	static QString Path;
+	static QElapsedTimer Timer;
+	static QList<Span> Spans;
+	static QHash<Qt::HANDLE, int> Threads;
+	static QMutex Mutex;
+};
+
+class TraceScope
+{
+public:
+	TraceScope(const char * name);
+	TraceScope(const char * name, const QString & detail);
+	~TraceScope();
+
+protected:
+	const char * m_name;
+	qint64 m_start;
+	QString m_detail;
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#include "wireshape.h"
+#include "graphicsutils.h"
+
+#include <qmath.h>
+
+// the stroker approximates round caps and offset curves; stay well clear of its error
+static const double StrokeSlack = 0.5;
+static const int MaxFlattenDepth = 16;
+
+/////////////////////////////////////////////////////////////////////
+
+static double distanceFromChord(const QPointF & p, const QPointF & a, const QPointF & b) {
+	return qSqrt(std::get<2>(GraphicsUtils::distanceFromLine(p.x(), p.y(), a.x(), a.y(), b.x(), b.y())));
+}
+
+static void flattenAux(const QPointF & p0, const QPointF & cp0, const QPointF & cp1, const QPointF & p1, double tolerance, int depth, QPolygonF & polygon) {
+	// the curve lies in the hull of its control points, so once both are within tolerance of the chord, so is the curve
+	if (depth >= MaxFlattenDepth || qMax(distanceFromChord(cp0, p0, p1), distanceFromChord(cp1, p0, p1)) <= tolerance) {
+		polygon.append(p1);
+		return;
+	}
+
+	// split at t = 0.5
+	QPointF p01 = (p0 + cp0) / 2;
+	QPointF p12 = (cp0 + cp1) / 2;
+	QPointF p23 = (cp1 + p1) / 2;
+	QPointF p012 = (p01 + p12) / 2;
+	QPointF p123 = (p12 + p23) / 2;
+	QPointF mid = (p012 + p123) / 2;
+	flattenAux(p0, p01, p012, mid, tolerance, depth + 1, polygon);
+	flattenAux(mid, p123, p23, p1, tolerance, depth + 1, polygon);
+}
+
+/////////////////////////////////////////////////////////////////////
+
+QPolygonF WireShape::flatten(const QPointF & p0, const QPointF & cp0, const QPointF & cp1, const QPointF & p1, double tolerance) {
+	// every vertex is a point on the curve, and the curve is within tolerance of the polyline
+	QPolygonF polygon;
+	polygon.append(p0);
+	flattenAux(p0, cp0, cp1, p1, tolerance, 0, polygon);
+	return polygon;
+}
+
+void WireShape::setGeometry(const QLineF & line, bool curved, const QPointF & cp0, const QPointF & cp1, const QPen & pen) {
+	if (line == m_line && curved == m_curved && pen.capStyle() == m_pen.capStyle() && pen.joinStyle() == m_pen.joinStyle() && pen.miterLimit() == m_pen.miterLimit()) {
+		if (!curved || (cp0 == m_cp0 && cp1 == m_cp1)) return;
+	}
+
+	clear();
+	m_line = line;
+	m_curved = curved;
+	m_cp0 = cp0;
+	m_cp1 = cp1;
+	m_pen = pen;
+}
+
+void WireShape::clear() {
+	m_centerline.clear();
+	for (int i = 0; i < 2; i++) {
+		m_strokes[i].width = -1;
+		m_strokes[i].path = QPainterPath();
+	}
+}
+
+const QPolygonF & WireShape::centerline() {
+	if (m_centerline.isEmpty()) {
+		if (m_curved) {
+			m_centerline = flatten(m_line.p1(), m_cp0, m_cp1, m_line.p2(), FlattenTolerance);
+		}
+		else {
+			m_centerline << m_line.p1() << m_line.p2();
+		}
+	}
+
+	return m_centerline;
+}
+
+const QPainterPath & WireShape::stroke(double width) {
+	for (int i = 0; i < 2; i++) {
+		if (m_strokes[i].width == width) return m_strokes[i].path;
+	}
+
+	QPainterPath path;
+	if (m_line != QLineF()) {
+		path.moveTo(m_line.p1());
+		if (m_curved) {
+			path.cubicTo(m_cp0, m_cp1, m_line.p2());
+		}
+		else {
+			path.lineTo(m_line.p2());
+		}
+	}
+
+	Stroke & stroke = m_strokes[m_nextStroke];
+	m_nextStroke = (m_nextStroke + 1) % 2;
+	stroke.width = width;
+	stroke.path = GraphicsUtils::shapeFromPath(path, m_pen, width, false);
+	return stroke.path;
+}
+
+double WireShape::distance(const QPointF & p) {
+	const QPolygonF & polygon = centerline();
+	double result = distanceFromChord(p, polygon.at(0), polygon.at(0));
+	for (int i = 1; i < polygon.count(); i++) {
+		result = qMin(result, distanceFromChord(p, polygon.at(i - 1), polygon.at(i)));
+	}
+	return result;
+}
+
+bool WireShape::contains(const QPointF & p, double width) {
+	if (m_line == QLineF()) return false;
+
+	double half = qMax(width, 0.0) / 2;
+	double d = distance(p);
+	if (d > half + FlattenTolerance + StrokeSlack) return false;
+
+	// a straight wire with round caps is exactly the set of points within half its width of the line
+	if (!m_curved && m_pen.capStyle() == Qt::RoundCap && d < half - StrokeSlack) return true;
+
+	return stroke(width).contains(p);
+}
+
+bool WireShape::intersects(const QPainterPath & area, double width) {
+	if (m_line == QLineF()) return false;
+
+	double half = qMax(width, 0.0) / 2;
+	if (!touchesRect(area.boundingRect(), half + FlattenTolerance + StrokeSlack)) return false;
+
+	if (width > 0) {
+		// centerline vertices are on the wire, so inside its stroke
+		foreach (QPointF p, centerline()) {
+			if (area.contains(p)) return true;
+		}
+	}
+
+	return stroke(width).intersects(area);
+}
+
+bool WireShape::touchesRect(const QRectF & rect, double margin) {
+	QRectF r = rect.normalized().adjusted(-margin, -margin, margin, margin);
+	const QPolygonF & polygon = centerline();
+	double x1, y1, x2, y2;
+	for (int i = 1; i < polygon.count(); i++) {
+		const QPointF & a = polygon.at(i - 1);
+		const QPointF & b = polygon.at(i);
+		if (GraphicsUtils::liangBarskyLineClip(a.x(), a.y(), b.x(), b.y(), r.left(), r.right(), r.top(), r.bottom(), x1, y1, x2, y2)) return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,73 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2007-2019 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+
+#ifndef WIRESHAPE_H
+#define WIRESHAPE_H
+
+#include <QLineF>
+#include <QPointF>
+#include <QPolygonF>
+#include <QPainterPath>
+#include <QPen>
+
+// The hit-test geometry of one wire: its centerline (a curved wire is flattened once, to within
+// FlattenTolerance) and its stroked outlines, which are built on first use and kept until the
+// geometry or pen changes.  contains() and intersects() give the same answers as testing against
+// stroke(width), but settle most queries from the centerline without stroking anything.
+
+class WireShape
+{
+public:
+	void setGeometry(const QLineF & line, bool curved, const QPointF & cp0, const QPointF & cp1, const QPen & pen);
+	void clear();
+
+	const QPolygonF & centerline();
+	const QPainterPath & stroke(double width);
+	bool contains(const QPointF & p, double width);
+	bool intersects(const QPainterPath & area, double width);
+	double distance(const QPointF & p);
+
+public:
+	static QPolygonF flatten(const QPointF & p0, const QPointF & cp0, const QPointF & cp1, const QPointF & p1, double tolerance);
+
+public:
+	static constexpr double FlattenTolerance = 0.1;
+
+protected:
+	struct Stroke {
+		double width = -1;
+		QPainterPath path;
+	};
+
+	bool touchesRect(const QRectF & rect, double margin);
+
+protected:
+	QLineF m_line;
+	bool m_curved = false;
+	QPointF m_cp0;
+	QPointF m_cp1;
+	QPen m_pen;
+	QPolygonF m_centerline;
+	Stroke m_strokes[2];		// a wire is asked for its shape and its hover shape
+	int m_nextStroke = 0;
+};
+
+#endif
@@ -22,9 +22,16 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils/misc.h"
 #include "utils/folderutils.h"
 #include "commands.h"
+#include "undopayload.h"
+#include "debugdialog.h"
 
 #include <QCoreApplication>
 #include <QTextStream>
+#include <QSettings>
+#include <QSharedPointer>
+
+const QString WaitPushUndoStack::MemoryBudgetSettingName("undoMemoryBudgetMB");
+static const qint64 DefaultMemoryBudgetMB = 512;
 
 CommandTimer::CommandTimer(QUndoCommand * command, int delayMS, WaitPushUndoStack * undoStack) : QTimer()
 {
@@ -46,10 +53,71 @@ void CommandTimer::timedout() {
 
 /////////////////////////////////
 
+// Every command goes on the stack inside a HistoryStep.  QUndoStack only drops commands from the bottom
+// through its undo limit, which can't be changed once there are commands, so to get rid of the oldest
+// steps the stack is cleared and the steps still wanted are pushed back in fresh HistorySteps.
+// While silent, a step neither executes nor merges: its command has already been done or undone.
+
+class HistoryStep : public QUndoCommand
+{
+public:
+	HistoryStep(QSharedPointer<QUndoCommand> command) : QUndoCommand(command->text()), m_command(command), m_silent(false) {
+	}
+
+	void undo() {
+		if (m_silent) return;
+
+		m_command->undo();
+		setObsolete(m_command->isObsolete());
+	}
+
+	void redo() {
+		if (m_silent) return;
+
+		m_command->redo();
+		setObsolete(m_command->isObsolete());
+	}
+
+	int id() const {
+		return m_command->id();
+	}
+
+	bool mergeWith(const QUndoCommand * other) {
+		const HistoryStep * step = dynamic_cast<const HistoryStep *>(other);
+		if (step == NULL || m_silent || step->m_silent) return false;
+		if (!m_command->mergeWith(step->m_command.data())) return false;
+
+		setText(m_command->text());
+		return true;
+	}
+
+	QSharedPointer<QUndoCommand> command() const {
+		return m_command;
+	}
+
+	void setSilent(bool silent) {
+		m_silent = silent;
+	}
+
+protected:
+	QSharedPointer<QUndoCommand> m_command;
+	bool m_silent;
+};
+
+/////////////////////////////////
+
 WaitPushUndoStack::WaitPushUndoStack(QObject * parent) :
 	QUndoStack(parent)
 {
 	m_temporary = NULL;
+	m_reportedUsage = 0;
+	m_budgetPending = false;
+
+	// a budget of zero means the undo stack is never trimmed
+	QSettings settings;
+	m_memoryBudget = settings.value(MemoryBudgetSettingName, DefaultMemoryBudgetMB).toLongLong() * 1024 * 1024;
+
+	connect(this, SIGNAL(indexChanged(int)), this, SLOT(syncMemoryUsage()));
 #ifndef QT_NO_DEBUG
 	QString path = FolderUtils::getTopLevelUserDataStorePath();
 	path += "/undostack.txt";
@@ -66,6 +134,8 @@ WaitPushUndoStack::~WaitPushUndoStack() {
 
 void WaitPushUndoStack::push(QUndoCommand * cmd)
 {
+	emit aboutToPush(cmd);
+
 #ifndef QT_NO_DEBUG
 	writeUndo(cmd, 0, NULL);
 #endif
@@ -74,7 +144,7 @@ void WaitPushUndoStack::push(QUndoCommand * cmd)
 		return;
 	}
 
-	QUndoStack::push(cmd);
+	QUndoStack::push(new HistoryStep(QSharedPointer<QUndoCommand>(cmd)));
 }
 
 
@@ -143,6 +213,135 @@ void WaitPushUndoStack::deleteTemporary() {
 	}
 }
 
+void WaitPushUndoStack::setMemoryBudget(qint64 bytes) {
+	m_memoryBudget = bytes;
+	enforceMemoryBudget();
+}
+
+qint64 WaitPushUndoStack::memoryBudget() const {
+	return m_memoryBudget;
+}
+
+qint64 WaitPushUndoStack::memoryUsage() {
+	qint64 total = 0;
+	foreach (qint64 usage, m_stepUsage) {
+		total += usage;
+	}
+	return total;
+}
+
+void WaitPushUndoStack::syncMemoryUsage() {
+	// commands may have been appended, merged, discarded from the redo end, or cleared;
+	// only steps past the first mismatch are re-measured.  The last step is always re-measured since it may have been merged into.
+	int count = this->count();
+	int i = 0;
+	int limit = qMin(count, m_steps.count()) - 1;
+	while (i < limit && stepCommand(i) == m_steps.at(i)) i++;
+
+	m_steps.resize(i);
+	m_stepUsage.resize(i);
+	for (; i < count; i++) {
+		const QUndoCommand * cmd = stepCommand(i);
+		m_steps.append(cmd);
+		m_stepUsage.append(commandMemoryUsage(cmd));
+	}
+
+	UndoPayloadStore::singleton()->compressColdEntries();
+
+	qint64 usage = memoryUsage();
+	if (usage != m_reportedUsage) {
+		m_reportedUsage = usage;
+		emit memoryUsageChanged(usage);
+	}
+
+	if (m_memoryBudget > 0 && usage > m_memoryBudget && !m_budgetPending) {
+		// not from inside push() or undo(), which are still emitting
+		m_budgetPending = true;
+		QMetaObject::invokeMethod(this, "enforceMemoryBudget", Qt::QueuedConnection);
+	}
+}
+
+void WaitPushUndoStack::enforceMemoryBudget() {
+	m_budgetPending = false;
+	if (m_memoryBudget <= 0) return;
+
+	// drop the oldest steps until usage is back under 90% of the budget, so every following push doesn't rebuild the stack;
+	// the step that is current and everything after it are kept
+	qint64 live = memoryUsage();
+	qint64 target = m_memoryBudget - m_memoryBudget / 10;
+	int drop = 0;
+	while (live > target && drop < index()) {
+		live -= m_stepUsage.at(drop);
+		drop++;
+	}
+
+	if (drop == 0) return;
+
+	DebugDialog::debug(QString("undo stack over budget: dropping the oldest %1 steps, %2 bytes left, budget %3").arg(drop).arg(live).arg(m_memoryBudget));
+	dropOldestSteps(drop);
+}
+
+void WaitPushUndoStack::dropOldestSteps(int drop) {
+	int count = this->count();
+	int index = this->index();
+	int cleanIndex = this->cleanIndex();
+
+	QList< QSharedPointer<QUndoCommand> > kept;
+	for (int i = drop; i < count; i++) {
+		const HistoryStep * step = dynamic_cast<const HistoryStep *>(command(i));
+		if (step == NULL) return;			// pushed past WaitPushUndoStack::push; leave the stack alone
+
+		kept.append(step->command());
+	}
+
+	// observers see one change at the end, not the stack emptying and refilling
+	bool blocked = blockSignals(true);
+	clear();			// deletes the dropped commands; the kept ones live on in their new steps
+
+	QList<HistoryStep *> steps;
+	for (int i = 0; i < kept.count(); i++) {
+		if (i + drop == cleanIndex) setClean();
+
+		HistoryStep * step = new HistoryStep(kept.at(i));
+		step->setSilent(true);
+		QUndoStack::push(step);
+		steps.append(step);
+	}
+	if (count == cleanIndex) setClean();
+	if (cleanIndex < drop) resetClean();		// the clean state was dropped, or was already unreachable
+
+	setIndex(index - drop);
+	foreach (HistoryStep * step, steps) {
+		step->setSilent(false);
+	}
+	blockSignals(blocked);
+
+	m_steps.remove(0, drop);
+	m_stepUsage.remove(0, drop);
+
+	emit indexChanged(this->index());
+	emit cleanChanged(isClean());
+	emit canUndoChanged(canUndo());
+	emit canRedoChanged(canRedo());
+	emit undoTextChanged(undoText());
+	emit redoTextChanged(redoText());
+}
+
+const QUndoCommand * WaitPushUndoStack::stepCommand(int index) const {
+	const QUndoCommand * cmd = command(index);
+	const HistoryStep * step = dynamic_cast<const HistoryStep *>(cmd);
+	return (step == NULL) ? cmd : step->command().data();
+}
+
+qint64 WaitPushUndoStack::commandMemoryUsage(const QUndoCommand * cmd) {
+	const BaseCommand * bcmd = dynamic_cast<const BaseCommand *>(cmd);
+	qint64 usage = (bcmd == NULL) ? sizeof(QUndoCommand) + cmd->text().size() * (qint64) sizeof(QChar) : bcmd->memoryUsage();
+	for (int i = 0; i < cmd->childCount(); i++) {
+		usage += commandMemoryUsage(cmd->child(i));
+	}
+	return usage;
+}
+
 #ifndef QT_NO_DEBUG
 void WaitPushUndoStack::writeUndo(const QUndoCommand * cmd, int indent, const BaseCommand * parent)
 {
@@ -26,6 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMutex>
 #include <QFile>
 #include <QPointer>
+#include <QVector>
 
 class WaitPushUndoStack : public QUndoStack
 {
@@ -42,6 +43,22 @@ public:
 	void addTimer(QTimer *);
 	void push(QUndoCommand *);
 	bool hasTimers();
+	void setMemoryBudget(qint64 bytes);
+	qint64 memoryBudget() const;
+	qint64 memoryUsage();
+
+	static qint64 commandMemoryUsage(const QUndoCommand *);
+
+public:
+	static const QString MemoryBudgetSettingName;
+
+signals:
+	void memoryUsageChanged(qint64 bytes);
+	void aboutToPush(const QUndoCommand *);
+
+protected slots:
+	void syncMemoryUsage();
+	void enforceMemoryBudget();
 
 #ifndef QT_NO_DEBUG
 public:
@@ -55,12 +72,19 @@ protected:
 	void clearDeadTimers();
 	void clearLiveTimers();
 	void clearTimers(QList<QTimer *> &);
+	const QUndoCommand * stepCommand(int index) const;
+	void dropOldestSteps(int count);
 
 protected:
 	QList<QTimer *> m_deadTimers;
 	QList<QTimer *> m_liveTimers;
 	QMutex m_mutex;
 	QUndoCommand * m_temporary;
+	QVector<const QUndoCommand *> m_steps;
+	QVector<qint64> m_stepUsage;   // parallel to m_steps
+	qint64 m_memoryBudget;
+	qint64 m_reportedUsage;
+	bool m_budgetPending;
 };
 
 
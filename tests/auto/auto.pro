@@ -1,4 +1,5 @@
 TEMPLATE = subdirs
 
-SUBDIRS = test_svg
+SUBDIRS = test_svg \
+	test_utils
 
@@ -0,0 +1,172 @@
+#include <boost/test/unit_test.hpp>
+
+#include "svg/bitmaptracer.h"
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPolygonF>
+
+static QImage blankImage(int width, int height) {
+	QImage image(width, height, QImage::Format_Mono);
+	image.fill(0);
+	return image;
+}
+
+static void fillRect(QImage & image, int x0, int y0, int width, int height) {
+	for (int y = y0; y < y0 + height; y++) {
+		for (int x = x0; x < x0 + width; x++) {
+			image.setPixel(x, y, 1);
+		}
+	}
+}
+
+static void fillCircle(QImage & image, double cx, double cy, double r) {
+	for (int y = 0; y < image.height(); y++) {
+		for (int x = 0; x < image.width(); x++) {
+			double dx = x + 0.5 - cx;
+			double dy = y + 0.5 - cy;
+			if ((dx * dx) + (dy * dy) <= r * r) image.setPixel(x, y, 1);
+		}
+	}
+}
+
+static int countSet(const QImage & image) {
+	int count = 0;
+	for (int y = 0; y < image.height(); y++) {
+		for (int x = 0; x < image.width(); x++) {
+			if (image.pixelIndex(x, y) == 1) count++;
+		}
+	}
+	return count;
+}
+
+// signed: clockwise outlines (in y-down coordinates) are positive
+static double signedArea(const QPolygonF & polygon) {
+	double total = 0;
+	for (int i = 0; i < polygon.count(); i++) {
+		QPointF p0 = polygon.at(i);
+		QPointF p1 = polygon.at((i + 1) % polygon.count());
+		total += (p0.x() * p1.y()) - (p1.x() * p0.y());
+	}
+	return total / 2;
+}
+
+BOOST_AUTO_TEST_CASE( bitmaptracer_rect )
+{
+	QImage image = blankImage(20, 20);
+	fillRect(image, 2, 3, 10, 6);
+
+	BitmapTracer tracer(0);
+	QList<QPolygonF> outlines = tracer.outlines(image);
+	BOOST_REQUIRE_EQUAL(outlines.count(), 1);
+	BOOST_REQUIRE_EQUAL(outlines.at(0).count(), 4);
+	BOOST_REQUIRE(outlines.at(0).at(0) == QPointF(2, 3));
+	BOOST_REQUIRE_EQUAL(signedArea(outlines.at(0)), 60);
+	BOOST_REQUIRE_EQUAL(tracer.stats().runs, 6);
+
+	QString d = tracer.pathData(image);
+	BOOST_REQUIRE(d == "M2 3L12 3 12 9 2 9Z");
+}
+
+BOOST_AUTO_TEST_CASE( bitmaptracer_holes_and_saddles )
+{
+	QImage image = blankImage(30, 30);
+	fillRect(image, 5, 5, 10, 10);
+	image.setPixel(8, 8, 0);
+	image.setPixel(9, 9, 0);							// set pixels touching only at a corner are apart, so this is one hole
+	image.setPixel(20, 20, 1);
+	image.setPixel(21, 21, 1);							// two specks touching at a corner stay apart
+
+	BitmapTracer tracer(0);
+	QList<QPolygonF> outlines = tracer.outlines(image);
+	BOOST_REQUIRE_EQUAL(outlines.count(), 4);
+
+	double total = 0;
+	int holes = 0;
+	foreach (QPolygonF outline, outlines) {
+		double area = signedArea(outline);
+		if (area < 0) holes++;
+		total += area;
+	}
+	BOOST_REQUIRE_EQUAL(holes, 1);
+	BOOST_REQUIRE_EQUAL(total, countSet(image));
+}
+
+BOOST_AUTO_TEST_CASE( bitmaptracer_tolerance )
+{
+	QImage image = blankImage(200, 200);
+	fillCircle(image, 100, 100, 80);
+	int pixels = countSet(image);
+
+	BitmapTracer exact(0);
+	QList<QPolygonF> outlines = exact.outlines(image);
+	BOOST_REQUIRE_EQUAL(outlines.count(), 1);
+
+	BitmapTracer tracer(1);
+	QPolygonF simplified = tracer.simplify(outlines.at(0));
+	BOOST_REQUIRE(simplified.count() < outlines.at(0).count() / 4);
+
+	BOOST_REQUIRE(qAbs(signedArea(simplified) - pixels) < pixels * 0.01);
+
+	QString d = tracer.pathData(image);
+	BOOST_REQUIRE_EQUAL(tracer.stats().contours, 1);
+	BOOST_REQUIRE(tracer.stats().curves > 0);
+	BOOST_REQUIRE_EQUAL(d.count('M'), 1);
+	BOOST_REQUIRE_EQUAL(d.count('Z'), 1);
+
+	// a square keeps its corners
+	image = blankImage(50, 50);
+	fillRect(image, 10, 10, 30, 30);
+	d = tracer.pathData(image);
+	BOOST_REQUIRE_EQUAL(tracer.stats().curves, 0);
+	BOOST_REQUIRE_EQUAL(tracer.stats().lines, 4);
+}
+
+static QImage logoImage() {
+	// a 600x600 logo-like image: rings, bars and a field of dots
+	QImage image = blankImage(600, 600);
+	fillCircle(image, 300, 300, 280);
+	QImage inner = blankImage(600, 600);
+	fillCircle(inner, 300, 300, 240);
+	for (int y = 0; y < 600; y++) {
+		for (int x = 0; x < 600; x++) {
+			if (inner.pixelIndex(x, y) == 1) image.setPixel(x, y, 0);
+		}
+	}
+	for (int i = 0; i < 8; i++) {
+		fillRect(image, 120 + (i * 45), 150, 25, 300);
+	}
+	for (int x = 90; x < 510; x += 12) {
+		fillCircle(image, x, 480, 4);
+	}
+	return image;
+}
+
+BOOST_AUTO_TEST_CASE( bitmaptracer_logo )
+{
+	QImage image = logoImage();
+	BitmapTracer tracer(BitmapTracer::DefaultTolerance);
+	QString d = tracer.pathData(image);
+
+	// runs are merged into outlines, and the stats describe the data handed back
+	const BitmapTracer::Stats & stats = tracer.stats();
+	BOOST_REQUIRE(stats.contours < stats.runs / 20);
+	BOOST_REQUIRE_EQUAL(stats.bytes, d.length());
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( bitmaptracer_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	QImage image = logoImage();
+
+	QElapsedTimer timer;
+	timer.start();
+	BitmapTracer tracer(BitmapTracer::DefaultTolerance);
+	QString d = tracer.pathData(image);
+	qint64 elapsed = timer.elapsed();
+
+	const BitmapTracer::Stats & stats = tracer.stats();
+	BOOST_TEST_MESSAGE(QString("traced %1 pixel runs to %2 outlines, %3 lines, %4 curves, %5 bytes in %6 ms")
+	                   .arg(stats.runs).arg(stats.contours).arg(stats.lines).arg(stats.curves).arg(stats.bytes).arg(elapsed).toStdString());
+	BOOST_REQUIRE_EQUAL(stats.bytes, d.length());
+}
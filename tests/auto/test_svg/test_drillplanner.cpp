@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+
+#include "svg/drillplanner.h"
+
+#include <QElapsedTimer>
+#include <QPoint>
+#include <QString>
+#include <QSet>
+
+#include <algorithm>
+#include <random>
+
+// a grid of holes at 0.1 inch pitch, added in shuffled order
+static QVector<QPoint> shuffledGrid(int columns, int rows, unsigned seed) {
+	QVector<QPoint> hits;
+	for (int x = 0; x < columns; x++) {
+		for (int y = 0; y < rows; y++) {
+			hits.append(QPoint(1000 + (x * 1000), 1000 + (y * 1000)));
+		}
+	}
+	std::shuffle(hits.begin(), hits.end(), std::mt19937(seed));
+	return hits;
+}
+
+static QSet<QString> hitSet(const QVector<QPoint> & hits) {
+	QSet<QString> result;
+	foreach (const QPoint & hit, hits) result.insert(DrillPlanner::formatHit(hit));
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( drillplanner_grid )
+{
+	QVector<QPoint> grid = shuffledGrid(20, 20, 1);
+
+	DrillPlanner planner;
+	foreach (const QPoint & hit, grid) {
+		planner.addHit("C0.038000", 0.038, hit);
+	}
+	planner.addHit("C0.038000", 0.038, grid.first());		// duplicates are dropped
+	BOOST_REQUIRE_EQUAL(planner.tools().first().hits.count(), 400);
+
+	planner.plan();
+	const QVector<QPoint> & ordered = planner.tools().first().hits;
+	BOOST_REQUIRE_EQUAL(ordered.count(), 400);
+	BOOST_REQUIRE(hitSet(ordered) == hitSet(grid));
+
+	// from the origin to the nearest corner, then at best one pitch per hole
+	double best = DrillPlanner::travel(QPoint(), QVector<QPoint>() << QPoint(1000, 1000)) + (399 * 1000);
+	BOOST_TEST_MESSAGE(QString("20x20 grid: travel %1 in, unordered %2 in, lower bound %3 in")
+	                   .arg(planner.travelAfter() / 10000).arg(planner.travelBefore() / 10000).arg(best / 10000).toStdString());
+	BOOST_REQUIRE(planner.travelAfter() < planner.travelBefore() / 8);		// the shuffled order is only ~10x the lower bound
+	BOOST_REQUIRE(planner.travelAfter() < best * 1.15);
+	BOOST_REQUIRE(planner.end() == ordered.last());
+}
+
+BOOST_AUTO_TEST_CASE( drillplanner_tools )
+{
+	DrillPlanner planner;
+	QVector<QPoint> large = shuffledGrid(5, 4, 2);
+	QVector<QPoint> small = shuffledGrid(4, 5, 3);
+	foreach (const QPoint & hit, large) planner.addHit("C0.125000", 0.125, hit);
+	foreach (const QPoint & hit, small) planner.addHit("C0.028000", 0.028, hit);
+	planner.addHit("C0.040000", 0.04, QPoint(123, 4567));
+
+	planner.plan();
+	BOOST_REQUIRE_EQUAL(planner.toolCount(), 3);
+	BOOST_REQUIRE(planner.tools().at(0).aperture == "C0.028000");
+	BOOST_REQUIRE(planner.tools().at(1).aperture == "C0.040000");
+	BOOST_REQUIRE(planner.tools().at(2).aperture == "C0.125000");
+
+	QString headerString, bodyString;
+	QTextStream header(&headerString);
+	QTextStream body(&bodyString);
+	planner.write(header, body, 100);
+	header.flush();
+	body.flush();
+	BOOST_REQUIRE(headerString == "T100C0.028000\nT101C0.040000\nT102C0.125000\n");
+	BOOST_REQUIRE(bodyString.contains("T101\nX000123Y004567\nT102\n"));
+	BOOST_REQUIRE_EQUAL(bodyString.count('\n'), 3 + 20 + 1 + 20);
+}
+
+BOOST_AUTO_TEST_CASE( drillplanner_windowed )
+{
+	// past FullTwoOptLimit, so 2-opt runs windowed
+	QVector<QPoint> grid = shuffledGrid(60, 40, 4);
+	DrillPlanner planner;
+	foreach (const QPoint & hit, grid) planner.addHit("C0.038000", 0.038, hit);
+
+	planner.plan();
+	BOOST_REQUIRE(hitSet(planner.tools().first().hits) == hitSet(grid));
+	BOOST_REQUIRE(planner.travelAfter() < (grid.count() * 1000) * 1.3);
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( drillplanner_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	QVector<QPoint> grid = shuffledGrid(60, 40, 4);
+	DrillPlanner planner;
+	foreach (const QPoint & hit, grid) planner.addHit("C0.038000", 0.038, hit);
+
+	QElapsedTimer timer;
+	timer.start();
+	planner.plan();
+	qint64 planMs = timer.elapsed();
+
+	BOOST_TEST_MESSAGE(QString("%1 hits planned in %2 ms: travel %3 in, unordered %4 in")
+	                   .arg(grid.count()).arg(planMs).arg(planner.travelAfter() / 10000).arg(planner.travelBefore() / 10000).toStdString());
+	BOOST_REQUIRE(hitSet(planner.tools().first().hits) == hitSet(grid));
+}
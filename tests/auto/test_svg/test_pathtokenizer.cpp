@@ -0,0 +1,191 @@
+#include "svg/svgpathtokenizer.h"
+#include "svg/svgpathparser.h"
+#include "svg/svgpathlexer.h"
+
+/*
+Checking SVGPathTokenizer against SVGPathParser, and timing both
+*/
+
+#include <QElapsedTimer>
+#include <QVariant>
+
+#include <boost/test/unit_test.hpp>
+
+// the tokenizer's output laid out like the parser's symStack
+static QList<QVariant> tokenizerStack(SVGPathTokenizer & tokenizer) {
+	QList<QVariant> stack;
+	foreach (SVGPathTokenizer::Command command, tokenizer.commands()) {
+		stack.append(command.command);
+		for (int i = 0; i < command.argCount; i++) {
+			stack.append(tokenizer.args().at(command.argIndex + i));
+		}
+	}
+	return stack;
+}
+
+struct CountingVisitor {
+	int commands = 0;
+	double sum = 0;
+
+	void operator()(QChar, bool, const PathArgs & args, void *) {
+		commands++;
+		for (int i = 0; i < args.count(); i++) sum += args[i];
+	}
+};
+
+BOOST_AUTO_TEST_CASE( pathtokenizer_matches_parser )
+{
+	const QStringList inputs = {
+		"m0,0x",
+		"m5,9.9x",
+		"m-5,-9.9x",
+		"m-4 -9.8x",
+		"m-3-9.7x",
+		"m0,0z",
+		"m1,-2a2.6,3.5,0,0,1,-5.2,0x",
+		"m2 -2a2.6 3.5 0 0 1 -5.2 0x",
+		"m3-2a2.6 3.5 0 0 1-5.2 0x",
+		"m4-2a2.6-3.5 0 0 1-5.2 0x",
+		"m-2+9.7x",
+		"M10,20 L30,40 30,50 H 7 V8 C1 2 3 4 5 6 S1 2 3 4 Q1 2 3 4 T5 6 Z",
+		"M 0.5.5 l .25 -.125 z m 1 1 l 2 2 z",
+	};
+
+	SVGPathTokenizer tokenizer;
+	for (int inp = 0; inp < inputs.size(); ++inp) {
+		QString data = inputs.at(inp);
+		SVGPathLexer lexer(data);
+		SVGPathParser parser;
+		BOOST_REQUIRE_MESSAGE(parser.parse(lexer), "parser failed on input " << inp);
+		QList<QVariant> expected = parser.symStack().toList();
+
+		BOOST_REQUIRE_MESSAGE(tokenizer.tokenize(data), "tokenizer failed on input " << inp);
+		QList<QVariant> actual = tokenizerStack(tokenizer);
+		BOOST_REQUIRE_MESSAGE(actual.count() == expected.count(), "stack sizes differ on input " << inp);
+		for (int i = 0; i < expected.count(); i++) {
+			BOOST_REQUIRE_MESSAGE(actual.at(i).type() == expected.at(i).type() && actual.at(i) == expected.at(i),
+			                      "entry " << i << " differs on input " << inp);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( pathtokenizer_extras_and_errors )
+{
+	SVGPathTokenizer tokenizer;
+
+	// polygon points get an implicit moveto
+	BOOST_REQUIRE(tokenizer.tokenize(QString("1,2 3,4 5,6")));
+	BOOST_REQUIRE_EQUAL(tokenizer.commands().count(), 1);
+	BOOST_REQUIRE(tokenizer.commands().at(0).command == QChar('M'));
+	BOOST_REQUIRE_EQUAL(tokenizer.commands().at(0).argCount, 6);
+
+	// exponents and packed arc flags
+	BOOST_REQUIRE(tokenizer.tokenize(QString("M1e-1 2E+2a1 1 0 015 6")));
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(0), 0.1);
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(1), 200);
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(5), 0);
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(6), 1);
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(7), 5);
+
+	// long numbers take the slow road but still come out right
+	BOOST_REQUIRE(tokenizer.tokenize(QString("M123456789012345678901234 0.000000000000000000000001")));
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(0), 123456789012345678901234.0);
+	BOOST_REQUIRE_EQUAL(tokenizer.args().at(1), 1e-24);
+
+	const QStringList bad = {
+		"L1 2",				// no moveto
+		"M1",				// odd argument count
+		"M1 2 Z 3",			// closepath takes nothing
+		"M1,,2",
+		"M1 2,",
+		"M1 2 k3 4",
+		"M1 2x 3 4",
+		"M1 2 a1 1 0 2 1 5 6",	// not a flag
+	};
+	int visits = 0;
+	auto visitor = [&visits](QChar, bool, const PathArgs &, void *) { visits++; };
+	foreach (QString data, bad) {
+		BOOST_REQUIRE_MESSAGE(!tokenizer.run(data, visitor, nullptr), "accepted " << data.toStdString());
+	}
+	BOOST_REQUIRE_EQUAL(visits, 0);
+}
+
+BOOST_AUTO_TEST_CASE( pathtokenizer_visitor_args )
+{
+	// each visit sees exactly its own command's arguments, straight out of args()
+	SVGPathTokenizer tokenizer;
+	QList<QChar> commands;
+	QList<double> seen;
+	auto visitor = [&commands, &seen](QChar command, bool relative, const PathArgs & args, void * userData) {
+		BOOST_REQUIRE(userData == nullptr);
+		BOOST_REQUIRE(relative == command.isLower());
+		commands.append(command);
+		for (int i = 0; i < args.count(); i++) seen.append(args.at(i));
+	};
+	BOOST_REQUIRE(tokenizer.run(QString("M1 2 l3 4 5 6 H7 z"), visitor, nullptr));
+	BOOST_REQUIRE(commands == (QList<QChar>() << 'M' << 'l' << 'H' << 'z'));
+	BOOST_REQUIRE(seen == (QList<double>() << 1 << 2 << 3 << 4 << 5 << 6 << 7));
+	BOOST_REQUIRE_EQUAL(seen.count(), tokenizer.args().count());
+}
+
+// a gerber-sized path: lots of short commands
+static QString longPath() {
+	QString data = "M0,0";
+	for (int i = 0; i < 20000; i++) {
+		data += QString(" L%1,%2 c1.5-2.25 3.125,4 -5.5 6.75 h%3 v-%4").arg(i * 0.01).arg(i * -0.02).arg(i % 7).arg(i % 11);
+	}
+	data += "z";
+	return data;
+}
+
+BOOST_AUTO_TEST_CASE( pathtokenizer_long_path )
+{
+	QString data = longPath();
+	SVGPathLexer lexer(data);
+	SVGPathParser parser;
+	BOOST_REQUIRE(parser.parse(lexer));
+
+	SVGPathTokenizer tokenizer;
+	CountingVisitor visitor;
+	BOOST_REQUIRE(tokenizer.run(data, visitor, nullptr));
+	BOOST_REQUIRE(tokenizerStack(tokenizer) == parser.symStack().toList());
+	BOOST_REQUIRE_EQUAL(visitor.commands, tokenizer.commands().count());
+
+	// a second run reuses the tokenizer's buffers
+	BOOST_REQUIRE(tokenizer.run(data, visitor, nullptr));
+	BOOST_REQUIRE_EQUAL(visitor.commands, tokenizer.commands().count() * 2);
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( pathtokenizer_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	QString data = longPath();
+
+	const int Rounds = 5;
+	QElapsedTimer timer;
+
+	timer.start();
+	int parsed = 0;
+	for (int round = 0; round < Rounds; round++) {
+		SVGPathLexer lexer(data);
+		SVGPathParser parser;
+		BOOST_REQUIRE(parser.parse(lexer));
+		parsed += parser.symStack().count();
+	}
+	qint64 parserTime = timer.elapsed();
+
+	timer.restart();
+	SVGPathTokenizer tokenizer;
+	CountingVisitor visitor;
+	for (int round = 0; round < Rounds; round++) {
+		BOOST_REQUIRE(tokenizer.run(data, visitor, nullptr));
+	}
+	qint64 tokenizerTime = timer.elapsed();
+
+	BOOST_REQUIRE_EQUAL(parsed / Rounds, tokenizer.commands().count() + tokenizer.args().count());
+
+	double megabytes = (data.length() * Rounds) / (1024.0 * 1024.0);
+	BOOST_TEST_MESSAGE("path data: " << data.length() << " chars, " << tokenizer.commands().count() << " commands");
+	BOOST_TEST_MESSAGE("lexer + parser: " << parserTime << " ms (" << megabytes * 1000 / qMax(parserTime, qint64(1)) << " MB/s)");
+	BOOST_TEST_MESSAGE("tokenizer + visitor: " << tokenizerTime << " ms (" << megabytes * 1000 / qMax(tokenizerTime, qint64(1)) << " MB/s)");
+}
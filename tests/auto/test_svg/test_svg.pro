@@ -17,7 +17,7 @@
 absolute_boost = 1
 include($$absolute_path(../../../pri/boostdetect.pri))
 
-QT += core xml svg
+QT += core gui widgets xml svg
 
 HEADERS += $$files(*.h)
 SOURCES += $$files(*.cpp)
@@ -29,11 +29,25 @@ HEADERS += $$files(../../../src/svg/svgpathlexer.h)
 HEADERS += $$files(../../../src/utils/textutils.h)
 HEADERS += $$files(../../../src/svg/svgpathgrammar_p.h)
 HEADERS += $$files(../../../src/svg/svgpathparser.h)
+HEADERS += $$files(../../../src/svg/bitmaptracer.h)
+HEADERS += $$files(../../../src/svg/svgpathtokenizer.h)
+HEADERS += $$files(../../../src/svg/svgoutline.h)
+HEADERS += $$files(../../../src/svg/drillplanner.h)
+HEADERS += $$files(../../../src/svg/svgelementindex.h)
+HEADERS += $$files(../../../src/utils/graphicsutils.h)
+HEADERS += $$files(../../../src/utils/wireshape.h)
 
 SOURCES += $$files(../../../src/svg/svgtext.cpp)
 SOURCES += $$files(../../../src/svg/svgpathlexer.cpp)
 SOURCES += $$files(../../../src/svg/svgpathparser.cpp)
 SOURCES += $$files(../../../src/svg/svgpathgrammar.cpp)
+SOURCES += $$files(../../../src/svg/bitmaptracer.cpp)
+SOURCES += $$files(../../../src/svg/svgpathtokenizer.cpp)
+SOURCES += $$files(../../../src/svg/svgoutline.cpp)
+SOURCES += $$files(../../../src/svg/drillplanner.cpp)
+SOURCES += $$files(../../../src/svg/svgelementindex.cpp)
+SOURCES += $$files(../../../src/utils/graphicsutils.cpp)
+SOURCES += $$files(../../../src/utils/wireshape.cpp)
 SOURCES += $$files(../../../src/utils/textutils.cpp)
 #INCLUDEPATH += $$top_srcdir
 # unix:QMAKE_POST_LINK = $$PWD/generated/test_svg
@@ -0,0 +1,185 @@
+#include <boost/test/unit_test.hpp>
+
+#include "svg/svgelementindex.h"
+
+#include <QElapsedTimer>
+#include <QDomDocument>
+#include <QSvgRenderer>
+#include <QMatrix>
+#include <QHash>
+#include <QString>
+
+static bool nearRect(const QRectF & r1, const QRectF & r2) {
+	return qAbs(r1.left() - r2.left()) < 0.1 && qAbs(r1.top() - r2.top()) < 0.1 &&
+	       qAbs(r1.right() - r2.right()) < 0.1 && qAbs(r1.bottom() - r2.bottom()) < 0.1;
+}
+
+// what PEMainWindow::getPixelBounds used to ask the renderer for, before scaling
+static QRectF rendererBounds(QSvgRenderer & renderer, const QString & id) {
+	return renderer.matrixForElement(id).mapRect(renderer.boundsOnElement(id));
+}
+
+static int entryWithID(const SvgElementIndex & index, const QString & id) {
+	for (int i = 0; i < index.count(); i++) {
+		if (index.entry(i).element.attribute("id") == id) return i;
+	}
+	return -1;
+}
+
+BOOST_AUTO_TEST_CASE( svgelementindex_bounds )
+{
+	QString body =
+	    "<rect id='board' x='0' y='0' width='400' height='300' fill='green'/>"
+	    "<g id='header' transform='translate(100,50)' stroke='black' stroke-width='4'>"
+	    "<circle id='connector0pin' cx='10' cy='10' r='8' fill='none'/>"
+	    "<circle id='connector1pin' cx='40' cy='10' r='8' fill='none' style='stroke-width:6'/>"
+	    "<g id='scaled' transform='scale(2)'>"
+	    "<rect id='connector2pad' x='5' y='30' width='10' height='6' stroke='none'/>"
+	    "<line id='leg' x1='0' y1='50' x2='20' y2='50'/>"
+	    "</g>"
+	    "</g>"
+	    "<path id='outline' d='M200,200 h50 v20 h-50 z' transform='translate(10,0) scale(1,2)' fill='red'/>"
+	    "<polygon id='arrow' points='300,10 320,30 280,30' fill='blue'/>"
+	    "<text id='label' x='10' y='290' font-size='12'>U1</text>"
+	    "<defs><rect id='hidden' x='0' y='0' width='10' height='10'/></defs>";
+	QByteArray svg = QString("<svg xmlns='http://www.w3.org/2000/svg' width='4in' height='3in' viewBox='0 0 400 300'>%1</svg>").arg(body).toUtf8();
+
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(svg, true));
+	QSvgRenderer renderer(svg);
+	BOOST_REQUIRE(renderer.isValid());
+
+	SvgElementIndex index;
+	index.build(doc.documentElement());
+
+	QStringList ids;
+	ids << "board" << "header" << "connector0pin" << "connector1pin" << "scaled" << "connector2pad" << "leg" << "outline" << "arrow";
+	foreach (QString id, ids) {
+		int i = entryWithID(index, id);
+		BOOST_REQUIRE(i >= 0);
+		QRectF expected = rendererBounds(renderer, id);
+		BOOST_REQUIRE_MESSAGE(nearRect(index.entry(i).bounds, expected),
+		                      QString("%1: index %2 %3 %4 %5, renderer %6 %7 %8 %9").arg(id)
+		                      .arg(index.entry(i).bounds.left()).arg(index.entry(i).bounds.top()).arg(index.entry(i).bounds.right()).arg(index.entry(i).bounds.bottom())
+		                      .arg(expected.left()).arg(expected.top()).arg(expected.right()).arg(expected.bottom()).toStdString());
+	}
+
+	// listed, so the parts editor still visits them, but never picked
+	BOOST_REQUIRE(index.entry(entryWithID(index, "label")).bounds.isNull());
+	BOOST_REQUIRE(index.entry(entryWithID(index, "hidden")).bounds.isNull());
+
+	// the root and the board both cover the corner; document order, outermost first
+	QList<int> at = index.entriesAt(QPointF(1, 1));
+	BOOST_REQUIRE_EQUAL(at.count(), 2);
+	BOOST_REQUIRE(index.entry(at.at(0)).element.tagName() == "svg");
+	BOOST_REQUIRE(index.entry(at.at(1)).element.attribute("id") == "board");
+
+	at = index.entriesAt(QPointF(110, 60));
+	BOOST_REQUIRE(at.contains(entryWithID(index, "connector0pin")));
+	BOOST_REQUIRE(at.contains(entryWithID(index, "header")));
+	BOOST_REQUIRE(!at.contains(entryWithID(index, "connector1pin")));
+
+	// scaled to pixels, the way PEMainWindow maps the viewBox to the default size
+	index.build(doc.documentElement(), 0.9, 0.9);
+	QRectF expected = rendererBounds(renderer, "board");
+	BOOST_REQUIRE(nearRect(index.entry(entryWithID(index, "board")).bounds, QRectF(expected.topLeft() * 0.9, expected.size() * 0.9)));
+}
+
+BOOST_AUTO_TEST_CASE( svgelementindex_transform_list )
+{
+	QTransform transform = SvgElementIndex::transformFromString("translate(10,20) scale(2) rotate(90)");
+	QPointF p = transform.map(QPointF(1, 0));
+	// rotate first, then scale, then translate
+	BOOST_REQUIRE(qAbs(p.x() - 10) < 0.001 && qAbs(p.y() - 22) < 0.001);
+	BOOST_REQUIRE(SvgElementIndex::transformFromString("").isIdentity());
+}
+
+// an Inkscape-style breadboard image: 20000 small shapes in nested groups
+static QByteArray nestedGroups(int & count) {
+	QString body;
+	count = 0;
+	for (int g = 0; g < 100; g++) {
+		body += QString("<g transform='translate(%1,%2)'>").arg((g % 10) * 100).arg((g / 10) * 100);
+		for (int i = 0; i < 200; i++) {
+			double x = (i % 20) * 5;
+			double y = (i / 20) * 10;
+			if (i % 2) body += QString("<rect id='e%1' x='%2' y='%3' width='4' height='8' fill='#c0c0c0' stroke='#000' stroke-width='0.5'/>").arg(count++).arg(x).arg(y);
+			else body += QString("<path id='e%1' d='M%2,%3 l4,0 l0,8 l-4,0 z' fill='#808080'/>").arg(count++).arg(x).arg(y);
+		}
+		body += "</g>";
+	}
+	return QString("<svg xmlns='http://www.w3.org/2000/svg' width='10in' height='10in' viewBox='0 0 1000 1000'>%1</svg>").arg(body).toUtf8();
+}
+
+BOOST_AUTO_TEST_CASE( svgelementindex_nested_groups )
+{
+	int count;
+	QByteArray svg = nestedGroups(count);
+
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(svg, true));
+
+	SvgElementIndex index;
+	index.build(doc.documentElement());
+	BOOST_REQUIRE_EQUAL(index.count(), 1 + 100 + count);
+
+	int hits = 0;
+	for (int y = 0; y < 1000; y += 10) {
+		for (int x = 0; x < 1000; x += 10) {
+			hits += index.entriesAt(QPointF(x + 1, y + 1)).count();
+		}
+	}
+	BOOST_REQUIRE(hits > 0);
+
+	QHash<QString, int> byID;
+	for (int i = 0; i < index.count(); i++) {
+		byID.insert(index.entry(i).element.attribute("id"), i);
+	}
+
+	// the old way: one renderer lookup per element
+	QSvgRenderer renderer(svg);
+	const int Sampled = 1000;
+	for (int n = 0; n < Sampled; n++) {
+		QString id = QString("e%1").arg(n * (count / Sampled));
+		QRectF expected = rendererBounds(renderer, id);
+		BOOST_REQUIRE(nearRect(index.entry(byID.value(id)).bounds, expected));
+	}
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( svgelementindex_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	int count;
+	QByteArray svg = nestedGroups(count);
+
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(svg, true));
+
+	QElapsedTimer timer;
+	timer.start();
+	SvgElementIndex index;
+	index.build(doc.documentElement());
+	qint64 indexMs = timer.elapsed();
+
+	timer.restart();
+	int hits = 0;
+	for (int y = 0; y < 1000; y += 10) {
+		for (int x = 0; x < 1000; x += 10) {
+			hits += index.entriesAt(QPointF(x + 1, y + 1)).count();
+		}
+	}
+	qint64 queryMs = timer.elapsed();
+	BOOST_REQUIRE(hits > 0);
+
+	// the old way: one renderer lookup per element
+	QSvgRenderer renderer(svg);
+	const int Sampled = 1000;
+	timer.restart();
+	for (int n = 0; n < Sampled; n++) {
+		rendererBounds(renderer, QString("e%1").arg(n * (count / Sampled)));
+	}
+	qint64 rendererMs = timer.elapsed();
+
+	BOOST_TEST_MESSAGE(QString("%1 elements indexed in %2 ms, 10000 point queries in %3 ms; renderer bounds for %4 elements in %5 ms")
+	                   .arg(index.count()).arg(indexMs).arg(queryMs).arg(Sampled).arg(rendererMs).toStdString());
+}
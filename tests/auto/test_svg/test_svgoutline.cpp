@@ -0,0 +1,253 @@
+#include <boost/test/unit_test.hpp>
+
+#include "svg/svgoutline.h"
+
+#include <QElapsedTimer>
+#include <QDomDocument>
+#include <QSvgRenderer>
+#include <QPainterPath>
+#include <QString>
+
+static bool near(const QPointF & p, double x, double y) {
+	return qAbs(p.x() - x) < 0.1 && qAbs(p.y() - y) < 0.1;
+}
+
+// one inch square, 90 user units to the inch, so user units are item pixels
+static QByteArray inchSvg(const QString & body, const QString & viewBox = "0 0 90 90") {
+	return QString("<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='1in' viewBox='%1'>%2</svg>").arg(viewBox, body).toUtf8();
+}
+
+BOOST_AUTO_TEST_CASE( svgoutline_path_data )
+{
+	QPainterPath square = SvgOutline::pathFromData("M0 0 h10 v10 H0 z");
+	BOOST_REQUIRE(square.contains(QPointF(5, 5)));
+	BOOST_REQUIRE(square.boundingRect() == QRectF(0, 0, 10, 10));
+
+	QPainterPath arc = SvgOutline::pathFromData("M0 10 A10 10 0 0 1 20 10");
+	BOOST_REQUIRE(near(arc.currentPosition(), 20, 10));
+	BOOST_REQUIRE(near(arc.pointAtPercent(0.5), 10, 0));
+
+	QPainterPath smooth = SvgOutline::pathFromData("m10 10 c0 -5 10 -5 10 0 s10 5 10 0 t10 0");
+	BOOST_REQUIRE(near(smooth.currentPosition(), 40, 10));
+
+	QPainterPath polygon = SvgOutline::pathFromData("0,0 10,0 10,10");
+	BOOST_REQUIRE_EQUAL(polygon.elementCount(), 3);
+
+	BOOST_REQUIRE(SvgOutline::pathFromData("L 10 10").isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( svgoutline_selection_shape )
+{
+	QByteArray svg = inchSvg("<rect x='10' y='10' width='30' height='30' fill='white' stroke='black' stroke-width='2'/>"
+	                         "<circle cx='70' cy='70' r='10' fill='#000'/>"
+	                         "<line x1='0' y1='80' x2='40' y2='80' stroke='black'/>"
+	                         "<g transform='translate(50,0)'><rect x='0' y='0' width='10' height='10' fill='none'/></g>"
+	                         "<defs><rect x='0' y='0' width='90' height='90'/></defs>");
+
+	// stroke width 2 plus a 20 pixel margin: 11 pixels either side of each edge
+	QPainterPath shape = SvgOutline::selectionShape(svg, 20);
+	BOOST_REQUIRE(shape.contains(QPointF(10, 25)));
+	BOOST_REQUIRE(shape.contains(QPointF(20.5, 25)));
+	BOOST_REQUIRE(!shape.contains(QPointF(25, 25)));		// light fill doesn't count
+	BOOST_REQUIRE(shape.contains(QPointF(70, 70)));
+	BOOST_REQUIRE(shape.contains(QPointF(20, 85)));
+	BOOST_REQUIRE(!shape.contains(QPointF(20, 60)));
+	BOOST_REQUIRE(shape.contains(QPointF(60, 5)));			// translated group
+	BOOST_REQUIRE(!shape.contains(QPointF(85, 30)));		// defs are not drawn
+
+	BOOST_REQUIRE(SvgOutline::selectionShape(svg, 20) == shape);
+
+	// user units scale to pixels, and so does the margin
+	QPainterPath scaled = SvgOutline::selectionShape(inchSvg("<rect x='100' y='100' width='300' height='300'/>", "0 0 1000 1000"), 20);
+	BOOST_REQUIRE(scaled.contains(QPointF(22.5, 22.5)));
+	BOOST_REQUIRE(scaled.contains(QPointF(0.5, 22.5)));
+	BOOST_REQUIRE(!scaled.contains(QPointF(48, 22.5)));
+
+	BOOST_REQUIRE(SvgOutline::selectionShape("not svg", 20).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( svgoutline_style_properties )
+{
+	QByteArray svg = inchSvg("<rect x='10' y='10' width='30' height='30' fill='white' style='fill:#000;stroke:none'/>"
+	                         "<g style='fill:#fff'><circle cx='70' cy='20' r='10'/></g>"
+	                         "<g fill='#fff'><circle cx='70' cy='50' r='10' style='fill: black'/></g>"
+	                         "<line x1='0' y1='80' x2='40' y2='80' style='stroke:black; stroke-width: 10px'/>"
+	                         "<rect x='50' y='70' width='10' height='10' fill='black' style='display:none'/>");
+
+	QPainterPath shape = SvgOutline::selectionShape(svg, 2);
+	BOOST_REQUIRE(shape.contains(QPointF(25, 25)));			// style overrides the fill attribute
+	BOOST_REQUIRE(!shape.contains(QPointF(70, 20)));		// light fill inherited from the group's style
+	BOOST_REQUIRE(shape.contains(QPointF(70, 50)));
+	BOOST_REQUIRE(shape.contains(QPointF(20, 85)));			// stroke width 10 plus a 2 pixel margin
+	BOOST_REQUIRE(!shape.contains(QPointF(20, 87.5)));
+	BOOST_REQUIRE(!shape.contains(QPointF(55, 75)));
+}
+
+// a schematic symbol: a body, 64 pins and their labels
+static QByteArray schematicSymbol() {
+	QString body = "<rect x='300' y='100' width='400' height='3300' fill='#FFFFFF' stroke='#000000' stroke-width='10'/>";
+	for (int i = 0; i < 32; i++) {
+		double y = 200 + (i * 100);
+		body += QString("<line x1='0' y1='%1' x2='300' y2='%1' stroke='#555555' stroke-width='9.7222'/>").arg(y);
+		body += QString("<line x1='700' y1='%1' x2='1000' y2='%1' stroke='#555555' stroke-width='9.7222'/>").arg(y);
+		body += QString("<text x='320' y='%1' font-size='50' fill='#555555'>D%2</text>").arg(y + 15).arg(i);
+		body += QString("<text x='680' y='%1' font-size='50' fill='#555555' text-anchor='end'>A%2</text>").arg(y + 15).arg(i);
+	}
+	return QString("<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='3.5in' viewBox='0 0 1000 3500'>%1</svg>").arg(body).toUtf8();
+}
+
+BOOST_AUTO_TEST_CASE( svgoutline_schematic_symbol )
+{
+	QByteArray svg = schematicSymbol();
+
+	SvgOutline::clearCache();
+	QPainterPath shape = SvgOutline::selectionShape(svg, 20);
+	BOOST_REQUIRE(shape.contains(QPointF(15, 18)));		// first pin
+	BOOST_REQUIRE(SvgOutline::selectionShape(svg, 20) == shape);		// every instance shares the cached shape
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( svgoutline_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	QByteArray svg = schematicSymbol();
+
+	SvgOutline::clearCache();
+	QElapsedTimer timer;
+	timer.start();
+	QPainterPath shape = SvgOutline::selectionShape(svg, 20);
+	qint64 buildMs = timer.elapsed();
+
+	timer.restart();
+	const int Instances = 100;
+	for (int i = 0; i < Instances; i++) {
+		SvgOutline::selectionShape(svg, 20);
+	}
+	qint64 cachedMs = timer.elapsed();
+
+	timer.restart();
+	int hits = 0;
+	for (int y = 0; y < 315; y += 3) {
+		for (int x = 0; x < 90; x += 3) {
+			if (shape.contains(QPointF(x, y))) hits++;
+		}
+	}
+	qint64 containsMs = timer.elapsed();
+
+	BOOST_TEST_MESSAGE(QString("selection shape of %1 elements: built in %2 ms, %3 cached instances in %4 ms, %5 contains() in %6 ms")
+	                   .arg(shape.elementCount()).arg(buildMs).arg(Instances).arg(cachedMs).arg(30 * 105).arg(containsMs).toStdString());
+	BOOST_REQUIRE(hits > 0);
+}
+
+// a ring pad the way THT footprints draw them: two arcs, a hole cut out of the middle
+static QString ringPad(const QString & id, double cx, double cy, const QString & transform = QString()) {
+	QString t = transform.isEmpty() ? QString() : QString(" transform='%1'").arg(transform);
+	return QString("<path id='%1'%2 fill='none' stroke='#F7BD13' stroke-width='8' d='M%3,%4 a16,16 0 1 1 32,0 a16,16 0 1 1 -32,0z'/>")
+	       .arg(id, t).arg(cx - 16).arg(cy);
+}
+
+BOOST_AUTO_TEST_CASE( svgoutline_path_bounds )
+{
+	QString body = ringPad("pad0", 50, 50)
+	             + ringPad("pad1", 50, 50, "translate(100,20)")
+	             + ringPad("pad2", 50, 50, "rotate(90,0,0)")
+	             + "<g transform='translate(500,0)'>" + ringPad("pad3", 10, 10, "matrix(1,0,0,1,30,40)") + "</g>";
+	QByteArray svg = QString("<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='1in' viewBox='0 0 1000 1000'>%1</svg>").arg(body).toUtf8();
+
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(svg));
+	QSvgRenderer renderer(svg);
+	BOOST_REQUIRE(renderer.isValid());
+
+	QDomNodeList nodeList = doc.documentElement().elementsByTagName("path");
+	BOOST_REQUIRE_EQUAL(nodeList.count(), 4);
+	for (int n = 0; n < nodeList.count(); n++) {
+		QDomElement path = nodeList.at(n).toElement();
+		QRectF bounds = SvgOutline::pathBounds(path);
+		QRectF expected = renderer.boundsOnElement(path.attribute("id"));
+		BOOST_REQUIRE(near(bounds.center(), expected.center().x(), expected.center().y()));
+	}
+
+	// the parent group's translation is not included, as with boundsOnElement
+	BOOST_REQUIRE(near(SvgOutline::pathBounds(nodeList.at(3).toElement()).center(), 40, 50));
+
+	// left to the renderer
+	QDomElement broken = doc.createElement("path");
+	broken.setAttribute("d", "L 10 10");
+	BOOST_REQUIRE(SvgOutline::pathBounds(broken).isNull());
+	broken.setAttribute("d", "M0 0 h10 v10 H0 z");
+	broken.setAttribute("transform", "rotate(90) scale(2)");
+	BOOST_REQUIRE(SvgOutline::pathBounds(broken).isNull());
+
+	// whitespace around a single transform
+	broken.setAttribute("transform", " translate(5,0) ");
+	BOOST_REQUIRE(near(SvgOutline::pathBounds(broken).center(), 10, 5));
+}
+
+// a header-heavy board: 24 40-pin dual-row headers, 960 ring pads
+static QByteArray headerBoard() {
+	QString body;
+	for (int h = 0; h < 24; h++) {
+		body += QString("<g transform='translate(%1,%2)'>").arg((h % 6) * 400).arg((h / 6) * 2200);
+		for (int i = 0; i < 40; i++) {
+			body += ringPad(QString("connector%1pin").arg(i), (i % 2) * 100 + 50, (i / 2) * 100 + 50, (h % 2) ? "rotate(180,100,1000)" : QString());
+		}
+		body += "</g>";
+	}
+	return QString("<svg xmlns='http://www.w3.org/2000/svg' width='24in' height='9in' viewBox='0 0 2400 8800'>%1</svg>").arg(body).toUtf8();
+}
+
+// what GerberGenerator::handleDonuts used to do: reload the whole layer to find each pad
+static const QString unique("%%%%%%%%%%%%%%%%%%%%%%%%_________________________________%%%%%%%%%%%%%%%%%%%%%%%%%%%%%");
+
+BOOST_AUTO_TEST_CASE( svgoutline_pad_centers )
+{
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(headerBoard()));
+	QDomNodeList nodeList = doc.documentElement().elementsByTagName("path");
+	BOOST_REQUIRE_EQUAL(nodeList.count(), 960);
+
+	for (int n = 0; n < nodeList.count(); n += 47) {
+		QDomElement path = nodeList.at(n).toElement();
+		QPointF center = SvgOutline::pathBounds(path).center();
+		QString id = path.attribute("id");
+		path.setAttribute("id", unique);
+		QSvgRenderer renderer;
+		renderer.load(doc.toByteArray());
+		QPointF expected = renderer.boundsOnElement(unique).center();
+		path.setAttribute("id", id);
+		BOOST_REQUIRE(near(center, expected.x(), expected.y()));
+	}
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( svgoutline_pad_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(headerBoard()));
+	QDomNodeList nodeList = doc.documentElement().elementsByTagName("path");
+
+	QElapsedTimer timer;
+	timer.start();
+	QList<QPointF> centers;
+	for (int n = 0; n < nodeList.count(); n++) {
+		centers << SvgOutline::pathBounds(nodeList.at(n).toElement()).center();
+	}
+	qint64 analyticMs = timer.elapsed();
+
+	const int Sampled = 20;
+	timer.restart();
+	for (int n = 0; n < Sampled; n++) {
+		QDomElement path = nodeList.at(n * 47).toElement();
+		QString id = path.attribute("id");
+		path.setAttribute("id", unique);
+		QSvgRenderer renderer;
+		renderer.load(doc.toByteArray());
+		QPointF expected = renderer.boundsOnElement(unique).center();
+		path.setAttribute("id", id);
+		BOOST_REQUIRE(near(centers.at(n * 47), expected.x(), expected.y()));
+	}
+	qint64 reloadMs = timer.elapsed();
+
+	BOOST_TEST_MESSAGE(QString("%1 pad centers from path data in %2 ms; %3 pads by renderer reload in %4 ms (%5 ms projected for all)")
+	                   .arg(nodeList.count()).arg(analyticMs).arg(Sampled).arg(reloadMs).arg(reloadMs * nodeList.count() / Sampled).toStdString());
+}
@@ -0,0 +1,203 @@
+#include <boost/test/unit_test.hpp>
+
+#include "utils/wireshape.h"
+#include "utils/graphicsutils.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QPen>
+#include <QString>
+#include <qmath.h>
+
+struct TestWire {
+	QLineF line;
+	bool curved;
+	QPointF cp0;
+	QPointF cp1;
+	double width;
+};
+
+// a small deterministic generator, so failures can be reproduced
+static double nextRandom(quint32 & seed) {
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) / double(1 << 24);
+}
+
+static QPen wirePen() {
+	QPen pen(QBrush(Qt::black), 1, Qt::SolidLine, Qt::RoundCap);
+	return pen;
+}
+
+// breadboard-like jumble of wires, most of them curvy
+static QList<TestWire> makeWires(int count, double extent, quint32 seed) {
+	QList<TestWire> wires;
+	for (int i = 0; i < count; i++) {
+		TestWire wire;
+		QPointF p0(nextRandom(seed) * extent, nextRandom(seed) * extent);
+		QPointF p1 = p0 + QPointF((nextRandom(seed) - 0.5) * 200, (nextRandom(seed) - 0.5) * 200);
+		wire.line = QLineF(p0, p1);
+		wire.curved = (i % 4) != 0;
+		wire.cp0 = p0 + QPointF((nextRandom(seed) - 0.5) * 150, (nextRandom(seed) - 0.5) * 150);
+		wire.cp1 = p1 + QPointF((nextRandom(seed) - 0.5) * 150, (nextRandom(seed) - 0.5) * 150);
+		wire.width = 2 + nextRandom(seed) * 8;
+		wires.append(wire);
+	}
+	return wires;
+}
+
+// what Wire::shapeAux did on every call before the shape was kept
+static QPainterPath naiveShape(const TestWire & wire) {
+	QPainterPath path;
+	path.moveTo(wire.line.p1());
+	if (wire.curved) {
+		path.cubicTo(wire.cp0, wire.cp1, wire.line.p2());
+	}
+	else {
+		path.lineTo(wire.line.p2());
+	}
+	return GraphicsUtils::shapeFromPath(path, wirePen(), wire.width, false);
+}
+
+static QPointF pointOnCurve(const TestWire & wire, double t) {
+	double u = 1 - t;
+	return u * u * u * wire.line.p1() + 3 * u * u * t * wire.cp0 + 3 * u * t * t * wire.cp1 + t * t * t * wire.line.p2();
+}
+
+static double distanceToPolyline(const QPolygonF & polygon, const QPointF & p) {
+	double result = 1e9;
+	for (int i = 1; i < polygon.count(); i++) {
+		const QPointF & a = polygon.at(i - 1);
+		const QPointF & b = polygon.at(i);
+		result = qMin(result, qSqrt(std::get<2>(GraphicsUtils::distanceFromLine(p.x(), p.y(), a.x(), a.y(), b.x(), b.y()))));
+	}
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( wireshape_flatten_error_bound )
+{
+	QList<TestWire> wires = makeWires(50, 500, 7);
+	foreach (TestWire wire, wires) {
+		if (!wire.curved) continue;
+
+		QPolygonF polygon = WireShape::flatten(wire.line.p1(), wire.cp0, wire.cp1, wire.line.p2(), WireShape::FlattenTolerance);
+		BOOST_REQUIRE(polygon.count() >= 2);
+		BOOST_REQUIRE(polygon.first() == wire.line.p1());
+		BOOST_REQUIRE(polygon.last() == wire.line.p2());
+
+		for (double t = 0; t <= 1; t += 0.001) {
+			BOOST_REQUIRE(distanceToPolyline(polygon, pointOnCurve(wire, t)) <= WireShape::FlattenTolerance + 1e-6);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( wireshape_matches_stroked_path )
+{
+	QList<TestWire> wires = makeWires(200, 400, 11);
+	quint32 seed = 23;
+	foreach (TestWire wire, wires) {
+		WireShape shape;
+		shape.setGeometry(wire.line, wire.curved, wire.cp0, wire.cp1, wirePen());
+		QPainterPath naive = naiveShape(wire);
+		QRectF bounds = naive.boundingRect().adjusted(-10, -10, 10, 10);
+
+		for (int i = 0; i < 300; i++) {
+			QPointF p(bounds.left() + nextRandom(seed) * bounds.width(), bounds.top() + nextRandom(seed) * bounds.height());
+			BOOST_REQUIRE_EQUAL(shape.contains(p, wire.width), naive.contains(p));
+		}
+
+		for (int i = 0; i < 30; i++) {
+			QPainterPath area;
+			area.addRect(QRectF(bounds.left() + nextRandom(seed) * bounds.width(), bounds.top() + nextRandom(seed) * bounds.height(),
+			                    nextRandom(seed) * 40, nextRandom(seed) * 40));
+			BOOST_REQUIRE_EQUAL(shape.intersects(area, wire.width), area.intersects(naive));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( wireshape_follows_geometry_changes )
+{
+	WireShape shape;
+	shape.setGeometry(QLineF(0, 0, 100, 0), false, QPointF(), QPointF(), wirePen());
+	BOOST_REQUIRE(shape.contains(QPointF(50, 1), 4));
+
+	shape.setGeometry(QLineF(0, 50, 100, 50), false, QPointF(), QPointF(), wirePen());
+	BOOST_REQUIRE(!shape.contains(QPointF(50, 1), 4));
+	BOOST_REQUIRE(shape.contains(QPointF(50, 51), 4));
+
+	// bending it: the middle of the curve is at (50, 12.5)
+	shape.setGeometry(QLineF(0, 50, 100, 50), true, QPointF(30, 0), QPointF(70, 0), wirePen());
+	BOOST_REQUIRE(!shape.contains(QPointF(50, 51), 4));
+	BOOST_REQUIRE(shape.contains(QPointF(50, 13), 4));
+
+	// a wider pen on the same geometry
+	BOOST_REQUIRE(!shape.contains(QPointF(50, 20), 4));
+	BOOST_REQUIRE(shape.contains(QPointF(50, 20), 20));
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( wireshape_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	// 2000 curvy wires on a breadboard; hover means point tests, rubber-band selection means rect tests,
+	// each against every wire whose bounding rect is hit, as the scene does
+	QList<TestWire> wires = makeWires(2000, 2000, 5);
+	QList<QRectF> bounds;
+	foreach (TestWire wire, wires) {
+		bounds.append(naiveShape(wire).controlPointRect());
+	}
+
+	quint32 seed = 3;
+	QList<QPointF> points;
+	for (int i = 0; i < 2000; i++) {
+		points.append(QPointF(nextRandom(seed) * 2000, nextRandom(seed) * 2000));
+	}
+	QList<QPainterPath> areas;
+	for (int i = 0; i < 20; i++) {
+		QPainterPath area;
+		area.addRect(QRectF(nextRandom(seed) * 1800, nextRandom(seed) * 1800, 200, 200));
+		areas.append(area);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	int naiveHits = 0;
+	foreach (QPointF p, points) {
+		for (int i = 0; i < wires.count(); i++) {
+			if (!bounds.at(i).contains(p)) continue;
+			if (naiveShape(wires.at(i)).contains(p)) naiveHits++;
+		}
+	}
+	foreach (QPainterPath area, areas) {
+		for (int i = 0; i < wires.count(); i++) {
+			if (!bounds.at(i).intersects(area.boundingRect())) continue;
+			if (area.intersects(naiveShape(wires.at(i)))) naiveHits++;
+		}
+	}
+	qint64 naiveMs = timer.elapsed();
+
+	QList<WireShape> shapes;
+	foreach (TestWire wire, wires) {
+		WireShape shape;
+		shape.setGeometry(wire.line, wire.curved, wire.cp0, wire.cp1, wirePen());
+		shapes.append(shape);
+	}
+
+	timer.restart();
+	int hits = 0;
+	foreach (QPointF p, points) {
+		for (int i = 0; i < wires.count(); i++) {
+			if (!bounds.at(i).contains(p)) continue;
+			if (shapes[i].contains(p, wires.at(i).width)) hits++;
+		}
+	}
+	foreach (QPainterPath area, areas) {
+		for (int i = 0; i < wires.count(); i++) {
+			if (!bounds.at(i).intersects(area.boundingRect())) continue;
+			if (shapes[i].intersects(area, wires.at(i).width)) hits++;
+		}
+	}
+	qint64 shapeMs = timer.elapsed();
+
+	BOOST_REQUIRE_EQUAL(hits, naiveHits);
+	BOOST_TEST_MESSAGE(QString("%1 wires, %2 hover points and %3 selection rects: stroking every time %4 ms, WireShape %5 ms")
+	                   .arg(wires.count()).arg(points.count()).arg(areas.count()).arg(naiveMs).arg(shapeMs).toStdString());
+}
@@ -0,0 +1,443 @@
+#include <boost/test/unit_test.hpp>
+
+#include "connectors/connectivitysnapshot.h"
+#include "utils/textutils.h"
+
+#ifdef QUAZIP_INSTALLED
+#include <quazip5/quazip.h>
+#include <quazip5/quazipfile.h>
+#else
+#include "lib/quazip/quazip.h"
+#include "lib/quazip/quazipfile.h"
+#endif
+
+#include <QDir>
+#include <QDirIterator>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QtAlgorithms>
+
+// A snapshot together with the bus lists it was built from, one list per connector on a bus,
+// the way ItemBase::busConnectorItems hands them out during a walk.
+struct TestSketch {
+	QString name;
+	QSharedPointer<ConnectivitySnapshot> snapshot;
+	QHash<int, QList<int> > busLists;
+};
+
+struct TestSketchBuilder {
+	TestSketchBuilder(const QString & name, ViewLayer::ViewID viewID) {
+		sketch.name = name;
+		sketch.snapshot = QSharedPointer<ConnectivitySnapshot>(new ConnectivitySnapshot(viewID));
+	}
+
+	int part(long modelIndex, ModelPart::ItemType itemType, ViewGeometry::WireFlags wireFlags = ViewGeometry::NoFlag) {
+		ConnectivitySnapshot::PartEntry partEntry;
+		partEntry.id = modelIndex;
+		partEntry.modelIndex = modelIndex;
+		partEntry.itemType = itemType;
+		partEntry.wireFlags = wireFlags;
+		return sketch.snapshot->addPart(partEntry);
+	}
+
+	int connector(int part, const QString & id, const QString & layer) {
+		QString key = connectorKey(part, id, layer);
+		int c = connectors.value(key, -1);
+		if (c >= 0) return c;
+
+		ConnectivitySnapshot::ConnectorEntry connectorEntry;
+		connectorEntry.part = part;
+		connectorEntry.id = id;
+		connectorEntry.name = id;
+		connectorEntry.viewLayerID = (layer == "copper1") ? ViewLayer::Copper1 : (layer == "copper0") ? ViewLayer::Copper0 : ViewLayer::UnknownLayer;
+		connectorEntry.flags = ConnectivitySnapshot::EverVisibleFlag;
+		connectorEntry.crossLayer = -1;
+		connectorEntry.bus = -1;
+		c = sketch.snapshot->addConnector(connectorEntry);
+		connectors.insert(key, c);
+		if (!layers[part].contains(layer)) layers[part].append(layer);
+		return c;
+	}
+
+	int findConnector(int part, const QString & id, const QString & layer) const {
+		return connectors.value(connectorKey(part, id, layer), -1);
+	}
+
+	static QString connectorKey(int part, const QString & id, const QString & layer) {
+		return QString::number(part) + '\t' + id + '\t' + layer;
+	}
+
+	void connect(int c1, int c2) {
+		// connections are symmetric in the scene
+		if (c1 == c2 || connections.contains(qMakePair(c1, c2))) return;
+
+		connections.insert(qMakePair(c1, c2));
+		connections.insert(qMakePair(c2, c1));
+		sketch.snapshot->addConnection(c1, c2);
+		sketch.snapshot->addConnection(c2, c1);
+	}
+
+	void bus(const QList<int> & members) {
+		if (members.isEmpty()) return;
+
+		foreach (int member, members) {
+			sketch.busLists.insert(member, members);
+		}
+		sketch.snapshot->addBus(members);
+	}
+
+	TestSketch finish() {
+		sketch.snapshot->finish();
+		return sketch;
+	}
+
+	TestSketch sketch;
+	QHash<QString, int> connectors;
+	QHash<int, QStringList> layers;
+	QSet< QPair<int, int> > connections;
+};
+
+// ConnectorItem::collectEqualPotential as it was before buses were closed over:
+// every kept connector lists its bus again, and membership is a linear search
+static QList<int> referenceWalk(const TestSketch & sketch, const QList<int> & connectors, bool crossLayers, ViewGeometry::WireFlags skipFlags) {
+	const ConnectivitySnapshot & snapshot = *sketch.snapshot;
+	QList<int> tempItems = connectors;
+	QList<int> result;
+	for (int i = 0; i < tempItems.count(); i++) {
+		int c = tempItems.at(i);
+		bool fromWire = snapshot.isWire(c);
+		if (fromWire) {
+			if (snapshot.part(snapshot.connector(c).part).wireFlags & skipFlags) continue;
+		}
+		else if (crossLayers) {
+			int cross = snapshot.connector(c).crossLayer;
+			if (cross >= 0 && !tempItems.contains(cross)) tempItems.append(cross);
+		}
+
+		result.append(c);
+
+		foreach (int to, snapshot.connectedTo(c)) {
+			if (tempItems.contains(to)) continue;
+			if ((skipFlags & ViewGeometry::NormalFlag) && !fromWire && !snapshot.isWire(to)) continue;
+
+			tempItems.append(to);
+		}
+
+		foreach (int member, sketch.busLists.value(c)) {
+			if (!tempItems.contains(member)) tempItems.append(member);
+		}
+	}
+
+	return result;
+}
+
+static void requireSameWalks(const TestSketch & sketch, bool crossLayers, ViewGeometry::WireFlags skipFlags) {
+	const ConnectivitySnapshot & snapshot = *sketch.snapshot;
+	for (int c = 0; c < snapshot.connectorCount(); c++) {
+		QList<int> start;
+		start.append(c);
+		QList<int> expected = referenceWalk(sketch, start, crossLayers, skipFlags);
+		QList<int> actual = snapshot.equalPotential(start, crossLayers, skipFlags);
+		BOOST_REQUIRE_EQUAL(actual.count(), actual.toSet().count());
+		qSort(expected);
+		qSort(actual);
+		if (expected != actual) {
+			BOOST_FAIL(QString("%1: walks from connector %2 differ, %3 connectors expected, %4 found")
+			           .arg(sketch.name).arg(c).arg(expected.count()).arg(actual.count()).toStdString());
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// the bundled example sketches
+
+static QString partsFolder() {
+	QString parts = QString::fromLocal8Bit(qgetenv("FRITZING_PARTS_DIR"));
+	if (!parts.isEmpty()) return parts;
+
+	// the usual checkout has fritzing-parts next to fritzing-app
+	QDir dir(FRITZING_SOURCE_DIR);
+	if (dir.cdUp() && dir.cd("fritzing-parts")) return dir.absolutePath();
+
+	return QString();
+}
+
+static void indexFzps(const QString & folder, QHash<QString, QByteArray> & fzps) {
+	if (folder.isEmpty()) return;
+
+	QDirIterator it(folder, QStringList("*.fzp"), QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext()) {
+		QFile file(it.next());
+		if (!file.open(QFile::ReadOnly)) continue;
+
+		QByteArray fzp = file.readAll();
+		QString moduleID = TextUtils::parseForModuleID(QString::fromUtf8(fzp));
+		if (!moduleID.isEmpty() && !fzps.contains(moduleID)) fzps.insert(moduleID, fzp);
+	}
+}
+
+static bool readBundle(const QString & fzzPath, QByteArray & fz, QHash<QString, QByteArray> & fzps) {
+	QuaZip zip(fzzPath);
+	if (!zip.open(QuaZip::mdUnzip)) return false;
+
+	QuaZipFile file(&zip);
+	for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+		QString name = zip.getCurrentFileName();
+		if (!file.open(QIODevice::ReadOnly)) continue;
+
+		QByteArray contents = file.readAll();
+		file.close();
+		if (name.endsWith(".fz")) {
+			fz = contents;
+		}
+		else if (name.endsWith(".fzp")) {
+			fzps.insert(TextUtils::parseForModuleID(QString::fromUtf8(contents)), contents);
+		}
+	}
+
+	return !fz.isEmpty();
+}
+
+static TestSketch buildSketch(const QString & name, const QDomDocument & fz, const QHash<QString, QByteArray> & fzps, const QString & viewName, ViewLayer::ViewID viewID) {
+	TestSketchBuilder builder(name + " " + viewName, viewID);
+	QHash<long, int> parts;
+	QHash<long, QDomDocument> fzpDocs;
+
+	// parts and their connectors; connectors that never connect only come from the fzp
+	QDomElement instance = fz.documentElement().firstChildElement("instances").firstChildElement("instance");
+	for (; !instance.isNull(); instance = instance.nextSiblingElement("instance")) {
+		QDomElement view = instance.firstChildElement("views").firstChildElement(viewName);
+		if (view.isNull()) continue;
+
+		long modelIndex = instance.attribute("modelIndex").toLong();
+		QString moduleID = instance.attribute("moduleIdRef");
+		bool isWire = (moduleID == "WireModuleID");
+		ViewGeometry::WireFlags wireFlags = static_cast<ViewGeometry::WireFlags>(view.firstChildElement("geometry").attribute("wireFlags").toInt());
+		int part = builder.part(modelIndex, isWire ? ModelPart::Wire : ModelPart::Part, wireFlags);
+		parts.insert(modelIndex, part);
+
+		QDomDocument fzp;
+		if (fzp.setContent(fzps.value(moduleID))) {
+			fzpDocs.insert(modelIndex, fzp);
+			QDomElement connector = fzp.documentElement().firstChildElement("connectors").firstChildElement("connector");
+			for (; !connector.isNull(); connector = connector.nextSiblingElement("connector")) {
+				QDomElement p = connector.firstChildElement("views").firstChildElement(viewName).firstChildElement("p");
+				for (; !p.isNull(); p = p.nextSiblingElement("p")) {
+					QString layer = p.attribute("layer");
+					if (isWire && layer != view.attribute("layer")) continue;
+
+					builder.connector(part, connector.attribute("id"), layer);
+				}
+			}
+		}
+
+		QDomElement connector = view.firstChildElement("connectors").firstChildElement("connector");
+		for (; !connector.isNull(); connector = connector.nextSiblingElement("connector")) {
+			builder.connector(part, connector.attribute("connectorId"), connector.attribute("layer"));
+		}
+	}
+
+	// connections
+	instance = fz.documentElement().firstChildElement("instances").firstChildElement("instance");
+	for (; !instance.isNull(); instance = instance.nextSiblingElement("instance")) {
+		int part = parts.value(instance.attribute("modelIndex").toLong(), -1);
+		if (part < 0) continue;
+
+		QDomElement view = instance.firstChildElement("views").firstChildElement(viewName);
+		QDomElement connector = view.firstChildElement("connectors").firstChildElement("connector");
+		for (; !connector.isNull(); connector = connector.nextSiblingElement("connector")) {
+			int from = builder.findConnector(part, connector.attribute("connectorId"), connector.attribute("layer"));
+			QDomElement connect = connector.firstChildElement("connects").firstChildElement("connect");
+			for (; !connect.isNull(); connect = connect.nextSiblingElement("connect")) {
+				int toPart = parts.value(connect.attribute("modelIndex").toLong(), -1);
+				if (toPart < 0) continue;
+
+				int to = builder.findConnector(toPart, connect.attribute("connectorId"), connect.attribute("layer"));
+				if (to >= 0) builder.connect(from, to);
+			}
+		}
+	}
+
+	// cross-layer pairs and buses, per copper layer as the layer kin have them
+	ConnectivitySnapshot & snapshot = *builder.sketch.snapshot;
+	for (int c = 0; c < snapshot.connectorCount(); c++) {
+		if (snapshot.connector(c).viewLayerID != ViewLayer::Copper0) continue;
+
+		int cross = builder.findConnector(snapshot.connector(c).part, snapshot.connector(c).id, "copper1");
+		if (cross < 0) continue;
+
+		snapshot.setCrossLayer(c, cross);
+		snapshot.setCrossLayer(cross, c);
+	}
+
+	foreach (long modelIndex, fzpDocs.keys()) {
+		int part = parts.value(modelIndex);
+		QDomElement bus = fzpDocs.value(modelIndex).documentElement().firstChildElement("buses").firstChildElement("bus");
+		for (; !bus.isNull(); bus = bus.nextSiblingElement("bus")) {
+			foreach (QString layer, builder.layers.value(part)) {
+				QList<int> members;
+				QDomElement nodeMember = bus.firstChildElement("nodeMember");
+				for (; !nodeMember.isNull(); nodeMember = nodeMember.nextSiblingElement("nodeMember")) {
+					int member = builder.findConnector(part, nodeMember.attribute("connectorId"), layer);
+					if (member >= 0) members.append(member);
+				}
+				builder.bus(members);
+			}
+		}
+	}
+
+	return builder.finish();
+}
+
+BOOST_AUTO_TEST_CASE( connectivity_bus_closure_matches_example_sketches )
+{
+	QHash<QString, QByteArray> fzps;
+	indexFzps(QString(FRITZING_SOURCE_DIR) + "/resources/parts", fzps);
+	indexFzps(partsFolder(), fzps);
+
+	int sketchCount = 0;
+	int busCount = 0;
+	QDirIterator it(QString(FRITZING_SOURCE_DIR) + "/sketches", QStringList("*.fzz"), QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext()) {
+		QString fzzPath = it.next();
+		QByteArray fzContents;
+		QHash<QString, QByteArray> sketchFzps = fzps;
+		BOOST_REQUIRE_MESSAGE(readBundle(fzzPath, fzContents, sketchFzps), fzzPath.toStdString());
+
+		QDomDocument fz;
+		BOOST_REQUIRE_MESSAGE(fz.setContent(fzContents), fzzPath.toStdString());
+
+		QString name = QFileInfo(fzzPath).completeBaseName();
+		QList<TestSketch> sketches;
+		sketches << buildSketch(name, fz, sketchFzps, "breadboardView", ViewLayer::BreadboardView);
+		sketches << buildSketch(name, fz, sketchFzps, "schematicView", ViewLayer::SchematicView);
+		sketches << buildSketch(name, fz, sketchFzps, "pcbView", ViewLayer::PCBView);
+		foreach (TestSketch sketch, sketches) {
+			requireSameWalks(sketch, true, ViewGeometry::NoFlag);
+			requireSameWalks(sketch, false, ViewGeometry::NormalFlag);
+			requireSameWalks(sketch, true, ViewGeometry::RatsnestFlag | ViewGeometry::PCBTraceFlag);
+			busCount += sketch.snapshot->busCount();
+		}
+		sketchCount++;
+	}
+
+	BOOST_REQUIRE(sketchCount > 0);
+	BOOST_TEST_MESSAGE(QString("%1 example sketches, %2 bus classes, parts from '%3'").arg(sketchCount).arg(busCount).arg(partsFolder()).toStdString());
+}
+
+/////////////////////////////////////////////////////////////////////
+// breadboards and wide headers, where walks used to explode
+
+// strips of 5 holes and power rails on a breadboard, wide headers with half their pins on a ground bus,
+// and wires between random holes
+static TestSketch makeBreadboard(int strips, int rails, int railLength, int headers, int pins, int wires) {
+	TestSketchBuilder builder("breadboard", ViewLayer::BreadboardView);
+
+	int breadboard = builder.part(1, ModelPart::Breadboard);
+	QList<int> holes;
+	for (int strip = 0; strip < strips; strip++) {
+		QList<int> members;
+		for (int hole = 0; hole < 5; hole++) {
+			members.append(builder.connector(breadboard, QString("pin%1_%2").arg(strip).arg(hole), "breadboard"));
+		}
+		builder.bus(members);
+		holes.append(members);
+	}
+	for (int rail = 0; rail < rails; rail++) {
+		QList<int> members;
+		for (int hole = 0; hole < railLength; hole++) {
+			members.append(builder.connector(breadboard, QString("rail%1_%2").arg(rail).arg(hole), "breadboard"));
+		}
+		builder.bus(members);
+		holes.append(members);
+	}
+
+	quint32 seed = 17;
+	for (int h = 0; h < headers; h++) {
+		int header = builder.part(100 + h, ModelPart::Part);
+		QList<int> ground;
+		for (int pin = 0; pin < pins; pin++) {
+			int c = builder.connector(header, QString("connector%1").arg(pin), "breadboard");
+			if (pin % 2 == 0) ground.append(c);
+			seed = seed * 1664525u + 1013904223u;
+			if (seed % 3 == 0) builder.connect(c, holes.at((seed >> 8) % holes.count()));
+		}
+		builder.bus(ground);
+	}
+
+	for (int w = 0; w < wires; w++) {
+		int wire = builder.part(1000 + w, ModelPart::Wire, (w % 5 == 0) ? ViewGeometry::RatsnestFlag : ViewGeometry::NormalFlag);
+		int end0 = builder.connector(wire, "connector0", "breadboardWire");
+		int end1 = builder.connector(wire, "connector1", "breadboardWire");
+		QList<int> ends;
+		ends << end0 << end1;
+		builder.bus(ends);
+		seed = seed * 1664525u + 1013904223u;
+		builder.connect(end0, holes.at((seed >> 8) % holes.count()));
+		seed = seed * 1664525u + 1013904223u;
+		builder.connect(end1, holes.at((seed >> 8) % holes.count()));
+	}
+
+	return builder.finish();
+}
+
+BOOST_AUTO_TEST_CASE( connectivity_bus_closure_matches_breadboard )
+{
+	TestSketch sketch = makeBreadboard(20, 2, 25, 1, 40, 20);
+	requireSameWalks(sketch, true, ViewGeometry::NoFlag);
+	requireSameWalks(sketch, false, ViewGeometry::NormalFlag);
+	requireSameWalks(sketch, true, ViewGeometry::RatsnestFlag);
+
+	// buses only merge through shared members; here every strip, rail, ground bus and wire is its own class
+	BOOST_REQUIRE_EQUAL(sketch.snapshot->busCount(), 20 + 2 + 1 + 20);
+}
+
+BOOST_AUTO_TEST_CASE( connectivity_bus_closure_full_breadboard )
+{
+	// a full-size breadboard with four 100-pin headers; walking from a sample of connectors keeps the reference bearable
+	TestSketch sketch = makeBreadboard(120, 4, 50, 4, 100, 200);
+	const ConnectivitySnapshot & snapshot = *sketch.snapshot;
+	const int step = snapshot.connectorCount() / 20;
+
+	for (int c = 0; c < snapshot.connectorCount(); c += step) {
+		QList<int> expected = referenceWalk(sketch, QList<int>() << c, true, ViewGeometry::NoFlag);
+		QList<int> actual = snapshot.equalPotential(QList<int>() << c, true, ViewGeometry::NoFlag);
+		BOOST_REQUIRE(actual.toSet() == expected.toSet());
+	}
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( connectivity_bus_closure_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	TestSketch sketch = makeBreadboard(120, 4, 50, 4, 100, 200);
+	const ConnectivitySnapshot & snapshot = *sketch.snapshot;
+	const int step = snapshot.connectorCount() / 20;
+
+	QElapsedTimer timer;
+	timer.start();
+	qint64 expected = 0;
+	for (int c = 0; c < snapshot.connectorCount(); c += step) {
+		expected += referenceWalk(sketch, QList<int>() << c, true, ViewGeometry::NoFlag).count();
+	}
+	qint64 referenceMs = timer.elapsed();
+
+	timer.restart();
+	qint64 actual = 0;
+	for (int c = 0; c < snapshot.connectorCount(); c += step) {
+		actual += snapshot.equalPotential(QList<int>() << c, true, ViewGeometry::NoFlag).count();
+	}
+	qint64 closureMs = timer.elapsed();
+
+	BOOST_REQUIRE_EQUAL(actual, expected);
+	BOOST_TEST_MESSAGE(QString("%1 connectors in %2 bus classes, %3 walks: listing buses on every visit %4 ms, bus closure %5 ms")
+	                   .arg(snapshot.connectorCount()).arg(snapshot.busCount()).arg((snapshot.connectorCount() + step - 1) / step)
+	                   .arg(referenceMs).arg(closureMs).toStdString());
+}
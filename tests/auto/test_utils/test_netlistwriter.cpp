@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+
+#include "model/netlistwriter.h"
+#include "connectors/ercdata.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+#include <QHash>
+#include <QTemporaryDir>
+
+static XmlNetlistWriter::Connector connector(const QString & id, const QString & label, ErcData * ercData = NULL) {
+	XmlNetlistWriter::Connector c;
+	c.id = id;
+	c.name = id.toUpper();
+	c.partID = QString::number(qHash(label));
+	c.partLabel = label;
+	c.partTitle = label + " title";
+	c.ercData = ercData;
+	return c;
+}
+
+static ErcData * ercData(const QString & ignore, const QString & eType) {
+	QDomDocument doc;
+	QDomElement erc = doc.createElement("erc");
+	erc.setAttribute("ignore", ignore);
+	erc.setAttribute("etype", eType);
+	return new ErcData(erc);
+}
+
+BOOST_AUTO_TEST_CASE( netlistwriter_xml )
+{
+	QScopedPointer<ErcData> always(ercData("always", "VCC"));
+	QScopedPointer<ErcData> ifUnconnected(ercData("ifUnconnected", "ground"));
+
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	XmlNetlistWriter writer(&buffer, "test.fzz");
+	writer.writeNet(QList<XmlNetlistWriter::Connector>() << connector("connector0", "R1") << connector("connector1", "LED1", always.data()));
+	writer.writeNet(QList<XmlNetlistWriter::Connector>() << connector("connector2", "U1", ifUnconnected.data()));
+	writer.writeNet(QList<XmlNetlistWriter::Connector>() << connector("connector1", "R1") << connector("connector3", "U1", ifUnconnected.data()));
+	BOOST_REQUIRE(writer.finish());
+
+	QDomDocument doc;
+	BOOST_REQUIRE(doc.setContent(buffer.data()));
+	QDomElement root = doc.documentElement();
+	BOOST_REQUIRE(root.tagName() == "netlist");
+	BOOST_REQUIRE(root.attribute("sketch") == "test.fzz");
+
+	// the ignored connector is dropped, and so is the net left empty by an unconnected one
+	QDomNodeList nets = root.elementsByTagName("net");
+	BOOST_REQUIRE_EQUAL(nets.count(), 2);
+	QDomNodeList first = nets.at(0).toElement().elementsByTagName("connector");
+	BOOST_REQUIRE_EQUAL(first.count(), 1);
+	QDomElement c = first.at(0).toElement();
+	BOOST_REQUIRE(c.attribute("id") == "connector0");
+	BOOST_REQUIRE(c.attribute("name") == "CONNECTOR0");
+	QDomElement part = c.firstChildElement("part");
+	BOOST_REQUIRE(part.attribute("label") == "R1");
+	BOOST_REQUIRE(part.attribute("title") == "R1 title");
+	BOOST_REQUIRE(part.attribute("id") == QString::number(qHash(QString("R1"))));
+
+	// a connector marked ifUnconnected stays when the net has others
+	BOOST_REQUIRE_EQUAL(nets.at(1).toElement().elementsByTagName("connector").count(), 2);
+	QDomNodeList erc = nets.at(1).toElement().elementsByTagName("erc");
+	BOOST_REQUIRE_EQUAL(erc.count(), 1);
+	BOOST_REQUIRE(erc.at(0).toElement().attribute("etype") == "ground");
+}
+
+BOOST_AUTO_TEST_CASE( netlistwriter_spice_expand )
+{
+	QHash<QString, int> connectorNets;
+	connectorNets.insert("connector0", 0);
+	connectorNets.insert("connector1", 3);
+	auto property = [](const QString & name) {
+		return name == "resistance" ? QString("220") : QString();
+	};
+
+	BOOST_REQUIRE(SpiceNetlistWriter::expand("R{instanceTitle} {net connector0} {net connector1} {resistance}\n", "R1", connectorNets, property)
+	              == "R1 0 3 220\n");
+	BOOST_REQUIRE(SpiceNetlistWriter::expand("X{instancetitle} {net connector2} {tolerance}", "My Part", connectorNets, property)
+	              == "XMy_Part  ");
+}
+
+BOOST_AUTO_TEST_CASE( netlistwriter_spice_stream )
+{
+	QTemporaryDir dir;
+	BOOST_REQUIRE(dir.isValid());
+	QFile model(QDir(dir.path()).absoluteFilePath("model.lib"));
+	BOOST_REQUIRE(model.open(QIODevice::WriteOnly));
+	model.close();
+	QList<QDir> folders;
+	folders << QDir(dir.path() + "/missing") << QDir(dir.path());
+
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	SpiceNetlistWriter writer(&buffer, "sketch", folders);
+	writer.write("R1 0 3 220\n");
+	writer.write(".inc");								// a line split across parts
+	writer.write("lude model.lib\n.include missing.lib\n");
+	writer.write("\n");
+	BOOST_REQUIRE(writer.finish());
+
+	QString expected = "sketch\n"
+	                   "R1 0 3 220\n"
+	                   ".INCLUDE " + QDir::toNativeSeparators(QDir(dir.path()).absoluteFilePath("model.lib")) + "\n"
+	                   ".include missing.lib\n"
+	                   "\n"
+	                   "\n"
+	                   ".TRAN 1ms 100ms\n"
+	                   "* .AC DEC 100 100 1MEG\n"
+	                   ".END\n";
+	BOOST_REQUIRE(QString::fromUtf8(buffer.data()) == expected);
+
+	// without includes the text goes out as written
+	QBuffer plain;
+	plain.open(QIODevice::WriteOnly);
+	SpiceNetlistWriter plainWriter(&plain, "sketch", folders);
+	plainWriter.write("V1 1 0 5\n");
+	BOOST_REQUIRE(plainWriter.finish());
+	BOOST_REQUIRE(QString::fromUtf8(plain.data()) == "sketch\nV1 1 0 5\n.TRAN 1ms 100ms\n* .AC DEC 100 100 1MEG\n.END\n");
+}
@@ -0,0 +1,173 @@
+#include <boost/test/unit_test.hpp>
+
+#include "utils/ratsnesttree.h"
+
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+#include <random>
+
+// plain Kruskal over every pair, with each group joined for free
+static double kruskalWeight(const QVector<RatsnestTree::Node> & nodes) {
+	UnionFind tree(nodes.count());
+	QList< QPair<double, RatsnestTree::Edge> > edges;
+	for (int i = 0; i < nodes.count(); i++) {
+		for (int j = i + 1; j < nodes.count(); j++) {
+			if (nodes.at(i).group == nodes.at(j).group) tree.unite(i, j);
+			else edges.append(qMakePair(RatsnestTree::weight(nodes, i, j), RatsnestTree::Edge(i, j)));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+
+	double total = 0;
+	for (int e = 0; e < edges.count(); e++) {
+		if (tree.unite(edges.at(e).second.first, edges.at(e).second.second)) total += edges.at(e).first;
+	}
+	return total;
+}
+
+// the edges plus the groups must join every node without a cycle, at the weight Kruskal finds
+static void checkTree(const QVector<RatsnestTree::Node> & nodes, const QList<RatsnestTree::Edge> & edges) {
+	UnionFind tree(nodes.count());
+	int components = nodes.count();
+	for (int i = 0; i < nodes.count(); i++) {
+		for (int j = i + 1; j < nodes.count(); j++) {
+			if (nodes.at(i).group == nodes.at(j).group && tree.unite(i, j)) components--;
+		}
+	}
+
+	double total = 0;
+	foreach (RatsnestTree::Edge edge, edges) {
+		BOOST_REQUIRE(tree.unite(edge.first, edge.second));
+		components--;
+		total += RatsnestTree::weight(nodes, edge.first, edge.second);
+	}
+
+	BOOST_REQUIRE_EQUAL(components, nodes.count() > 0 ? 1 : 0);
+	BOOST_REQUIRE_EQUAL(total, kruskalWeight(nodes));
+}
+
+static RatsnestTree::Node node(double x, double y, int group) {
+	RatsnestTree::Node node;
+	node.location = QPointF(x, y);
+	node.group = group;
+	node.known = false;
+	node.previousGroup = -1;
+	return node;
+}
+
+// as updateRatsnestGraph does: nodes on the same bus or wire, or on top of each other, share a group
+static void joinGroups(QVector<RatsnestTree::Node> & nodes, const QVector<int> & wired) {
+	UnionFind groups(nodes.count());
+	for (int i = 0; i < nodes.count(); i++) {
+		for (int j = i + 1; j < nodes.count(); j++) {
+			if (wired.at(i) == wired.at(j) || nodes.at(i).location == nodes.at(j).location) groups.unite(i, j);
+		}
+	}
+	for (int i = 0; i < nodes.count(); i++) {
+		nodes[i].group = groups.find(i);
+	}
+}
+
+static void carry(RatsnestTree::Node & node, const RatsnestTree::Node & previous) {
+	node.known = true;
+	node.previousLocation = previous.location;
+	node.previousGroup = previous.group;
+}
+
+BOOST_AUTO_TEST_CASE( ratsnesttree_merge_and_move )
+{
+	// i - m - j are close together, k hangs off i
+	QVector<RatsnestTree::Node> before;
+	before << node(0, 0, 0) << node(1, 0, 1) << node(2, 0, 2) << node(0, 10, 3);
+	QList<RatsnestTree::Edge> previous = RatsnestTree::build(before);
+	checkTree(before, previous);
+	BOOST_REQUIRE_EQUAL(previous.count(), 3);
+
+	// m moves away while j and k are wired together: the kept i - k edge joins both sides of the cut,
+	// but i - j is now the cheaper way to reach that group
+	QVector<RatsnestTree::Node> after = before;
+	for (int i = 0; i < after.count(); i++) carry(after[i], before.at(i));
+	after[1].location = QPointF(50, 50);
+	after[3].group = 2;
+
+	bool rebuilt;
+	QList<RatsnestTree::Edge> edges = RatsnestTree::update(after, previous, &rebuilt);
+	BOOST_REQUIRE(rebuilt);
+	checkTree(after, edges);
+	BOOST_REQUIRE(edges.contains(RatsnestTree::Edge(0, 2)));
+}
+
+BOOST_AUTO_TEST_CASE( ratsnesttree_matches_kruskal )
+{
+	std::mt19937 random(20190601);
+	auto pick = [&random](int count) { return std::uniform_int_distribution<int>(0, count - 1)(random); };
+
+	int updates = 0;
+	int rebuilds = 0;
+	for (int trial = 0; trial < 300; trial++) {
+		// a small grid, so equal weights and coincident nodes are common
+		QVector<RatsnestTree::Node> nodes;
+		QVector<int> wired;
+		int count = 2 + pick(20);
+		for (int i = 0; i < count; i++) {
+			nodes << node(pick(9), pick(9), -1);
+			wired << pick(count);
+		}
+		joinGroups(nodes, wired);
+		QList<RatsnestTree::Edge> edges = RatsnestTree::build(nodes);
+		checkTree(nodes, edges);
+		int nextWire = count;
+
+		for (int step = 0; step < 20; step++) {
+			QVector<RatsnestTree::Node> next;
+			QVector<int> nextWired;
+			QVector<int> newIndex(nodes.count(), -1);
+			int left = 0;
+			for (int i = 0; i < nodes.count(); i++) {
+				if (nodes.count() - left > 2 && pick(12) == 0) {
+					left++;				// left the net
+					continue;
+				}
+
+				RatsnestTree::Node moved = nodes.at(i);
+				carry(moved, nodes.at(i));
+				if (pick(6) == 0) moved.location = QPointF(pick(9), pick(9));
+				newIndex[i] = next.count();
+				next << moved;
+				nextWired << (pick(10) == 0 ? nextWire++ : wired.at(i));		// maybe unwired from its group
+			}
+			if (pick(3) == 0) {
+				// two groups are wired together
+				int from = nextWired.at(pick(next.count()));
+				int to = nextWired.at(pick(next.count()));
+				for (int i = 0; i < next.count(); i++) {
+					if (nextWired.at(i) == from) nextWired[i] = to;
+				}
+			}
+			while (pick(4) == 0) {
+				next << node(pick(9), pick(9), -1);
+				nextWired << (pick(2) == 0 ? nextWire++ : nextWired.at(pick(nextWired.count())));
+			}
+			joinGroups(next, nextWired);
+
+			QList<RatsnestTree::Edge> previous;
+			foreach (RatsnestTree::Edge edge, edges) {
+				previous << RatsnestTree::Edge(newIndex.at(edge.first), newIndex.at(edge.second));
+			}
+
+			bool rebuilt;
+			edges = RatsnestTree::update(next, previous, &rebuilt);
+			checkTree(next, edges);
+			nodes = next;
+			wired = nextWired;
+			updates++;
+			if (rebuilt) rebuilds++;
+		}
+	}
+
+	// most updates should stay incremental
+	BOOST_REQUIRE(rebuilds > 0);
+	BOOST_REQUIRE(rebuilds < updates / 2);
+}
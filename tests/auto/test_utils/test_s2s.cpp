@@ -0,0 +1,143 @@
+#include <boost/test/unit_test.hpp>
+
+#include "utils/s2s.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+// none of these parts gets as far as measuring text, which needs a QGuiApplication
+static QString fzp(const QString & schematic) {
+	QString views;
+	if (!schematic.isEmpty()) {
+		views = QString("<views><schematicView><layers image='%1'><layer layerId='schematic'/></layers></schematicView></views>").arg(schematic);
+	}
+	return QString("<?xml version='1.0' encoding='UTF-8'?><module moduleId='test'><title>Test</title>%1</module>").arg(views);
+}
+
+static QString writeFile(const QDir & dir, const QString & name, const QString & content) {
+	QFile file(dir.absoluteFilePath(name));
+	BOOST_REQUIRE(file.open(QIODevice::WriteOnly));
+	file.write(content.toUtf8());
+	file.close();
+	return file.fileName();
+}
+
+struct S2SParts {
+	S2SParts() {
+		BOOST_REQUIRE(dir.isValid());
+		QDir root(dir.path());
+		root.mkpath("core");
+		root.mkpath("old");
+		root.mkpath("new");
+		QDir core(root.absoluteFilePath("core"));
+		oldSvgDir = QDir(root.absoluteFilePath("old"));
+		newSvgDir = QDir(root.absoluteFilePath("new"));
+
+		// given out of order: the batch sorts them
+		paths << writeFile(core, "c.fzp", fzp("schematic/shared.svg"))
+		      << writeFile(core, "notes.txt", "not a part")
+		      << writeFile(core, "a.fzp", fzp("schematic/shared.svg"))
+		      << writeFile(core, "d.fzp", fzp(""))
+		      << writeFile(core, "b.fzp", fzp("schematic/own.svg"))
+		      << writeFile(core, "broken.fzp", "<module");
+	}
+
+	QString path(const QString & name) const {
+		foreach (QString p, paths) {
+			if (QFileInfo(p).fileName() == name) return p;
+		}
+		return QString();
+	}
+
+	QTemporaryDir dir;
+	QDir oldSvgDir;
+	QDir newSvgDir;
+	QStringList paths;
+};
+
+BOOST_AUTO_TEST_CASE( s2s_groups_by_schematic )
+{
+	S2SParts parts;
+	QList<QStringList> groups = S2S::groupBySchematic(parts.paths, parts.oldSvgDir, parts.newSvgDir, false);
+
+	// in path order, with the two parts drawn from shared.svg in one job
+	BOOST_REQUIRE_EQUAL(groups.count(), 5);
+	BOOST_REQUIRE(groups.at(0) == (QStringList() << parts.path("a.fzp") << parts.path("c.fzp")));
+	BOOST_REQUIRE(groups.at(1) == QStringList(parts.path("b.fzp")));
+	BOOST_REQUIRE(groups.at(2) == QStringList(parts.path("broken.fzp")));
+	BOOST_REQUIRE(groups.at(3) == QStringList(parts.path("d.fzp")));
+	BOOST_REQUIRE(groups.at(4) == QStringList(parts.path("notes.txt")));
+
+	// created up front, so the workers don't race to
+	BOOST_REQUIRE(QFileInfo(parts.newSvgDir.absoluteFilePath("schematic")).isDir());
+}
+
+BOOST_AUTO_TEST_CASE( s2s_batch_outcomes )
+{
+	S2SParts parts;
+	QList<S2SResult> results = S2S::batch(parts.paths, parts.oldSvgDir, parts.newSvgDir, false);
+
+	QStringList names;
+	foreach (S2SResult result, results) {
+		names << QFileInfo(result.fzpFilePath).fileName();
+	}
+	BOOST_REQUIRE(names == (QStringList() << "a.fzp" << "b.fzp" << "broken.fzp" << "c.fzp" << "d.fzp" << "notes.txt"));
+
+	// the schematics don't exist
+	BOOST_REQUIRE_EQUAL(results.at(0).outcome, (int) S2S::Failed);
+	BOOST_REQUIRE(results.at(0).schematicFilePath == parts.oldSvgDir.absoluteFilePath("schematic/shared.svg"));
+	BOOST_REQUIRE_EQUAL(results.at(0).messages.count(), 1);
+	BOOST_REQUIRE_EQUAL(results.at(1).outcome, (int) S2S::Failed);
+	BOOST_REQUIRE_EQUAL(results.at(3).outcome, (int) S2S::Failed);
+
+	BOOST_REQUIRE_EQUAL(results.at(2).outcome, (int) S2S::Failed);
+	BOOST_REQUIRE(results.at(2).messages.count() == 1 && results.at(2).messages.first().startsWith("Failed loading"));
+
+	BOOST_REQUIRE_EQUAL(results.at(4).outcome, (int) S2S::Skipped);
+	BOOST_REQUIRE(results.at(4).messages.count() == 1 && results.at(4).messages.first().startsWith("Schematic not found"));
+
+	BOOST_REQUIRE_EQUAL(results.at(5).outcome, (int) S2S::Skipped);
+	BOOST_REQUIRE(results.at(5).messages.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( s2s_summary )
+{
+	QList<S2SResult> results;
+	S2SResult result;
+	result.fzpFilePath = "/parts/core/x.fzp";
+	result.outcome = S2S::Converted;
+	result.elapsed = 5;
+	results << result;
+
+	result.fzpFilePath = "/parts/core/y.fzp";
+	result.outcome = S2S::Skipped;
+	result.messages = QStringList("already standard");
+	result.elapsed = 20;
+	results << result;
+
+	result.fzpFilePath = "/parts/core/z.fzp";
+	result.outcome = S2S::Failed;
+	result.messages = QStringList() << "unable" << "to write";
+	result.elapsed = 7;
+	results << result;
+
+	result.fzpFilePath = "/parts/core/w.fzp";
+	result.outcome = S2S::Converted;
+	result.messages = QStringList("hidden pins");
+	result.elapsed = 1;
+	results << result;
+
+	// parts converted without a word are left out of the listing
+	QStringList expected;
+	expected << "skipped y.fzp: already standard"
+	         << "failed z.fzp: unable to write"
+	         << "converted w.fzp: hidden pins"
+	         << QString("s2s: 4 parts in 30 ms on %1 threads: 2 converted, 1 skipped, 1 failed").arg(QThreadPool::globalInstance()->maxThreadCount())
+	         << "s2s: 33 ms of work, slowest y.fzp at 20 ms";
+	BOOST_REQUIRE(S2S::summary(results, 30) == expected);
+
+	BOOST_REQUIRE(S2S::summary(QList<S2SResult>(), 0).count() == 1);
+}
@@ -0,0 +1,113 @@
+#include <boost/test/unit_test.hpp>
+
+#include "utils/spatialgrid.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QRectF>
+#include <QtAlgorithms>
+
+// a breadboard-like field: rows of small connector rects on a 9 pixel pitch
+static QList<QRectF> makeField(int columns, int rows) {
+	QList<QRectF> rects;
+	for (int x = 0; x < columns; x++) {
+		for (int y = 0; y < rows; y++) {
+			rects.append(QRectF(x * 9.0, y * 9.0, 4.5, 4.5));
+		}
+	}
+	return rects;
+}
+
+static QList<int> bruteForce(const QList<QRectF> & rects, const QPointF & p) {
+	QList<int> result;
+	for (int i = 0; i < rects.count(); i++) {
+		if (rects.at(i).contains(p)) result.append(i);
+	}
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( spatialgrid_matches_brute_force )
+{
+	QList<QRectF> rects = makeField(40, 40);
+	rects.append(QRectF(-100, -100, 10000, 10000));		// big enough to be kept out of the cells
+
+	SpatialGrid<int> grid(36, 1024);
+	for (int i = 0; i < rects.count(); i++) {
+		grid.insert(i, rects.at(i));
+	}
+	BOOST_REQUIRE_EQUAL(grid.count(), rects.count());
+
+	for (double x = -5; x < 370; x += 1.3) {
+		for (double y = -5; y < 370; y += 2.9) {
+			QPointF p(x, y);
+			QList<int> expected = bruteForce(rects, p);
+			QList<int> actual = grid.query(p);
+			qSort(actual);
+			BOOST_REQUIRE(expected == actual);
+		}
+	}
+
+	QList<int> inRect = grid.query(QRectF(0, 0, 20, 20));
+	BOOST_REQUIRE_EQUAL(inRect.count(), 3 * 3 + 1);
+}
+
+BOOST_AUTO_TEST_CASE( spatialgrid_move_and_remove )
+{
+	SpatialGrid<int> grid;
+	grid.insert(1, QRectF(0, 0, 5, 5));
+	grid.insert(2, QRectF(100, 100, 5, 5));
+	BOOST_REQUIRE_EQUAL(grid.query(QPointF(2, 2)).count(), 1);
+
+	// re-inserting moves the value
+	grid.insert(1, QRectF(200, 200, 5, 5));
+	BOOST_REQUIRE(grid.query(QPointF(2, 2)).isEmpty());
+	BOOST_REQUIRE_EQUAL(grid.query(QPointF(202, 202)).count(), 1);
+
+	grid.remove(1);
+	BOOST_REQUIRE(grid.query(QPointF(202, 202)).isEmpty());
+	BOOST_REQUIRE(!grid.contains(1));
+	BOOST_REQUIRE(grid.contains(2));
+	BOOST_REQUIRE_EQUAL(grid.count(), 1);
+}
+
+// drag latency: a 40 pin part moving over a large breadboard field,
+// every mouse move looks up what is under each of its pins.  Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( spatialgrid_drag_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	QList<QRectF> rects = makeField(300, 100);			// 30000 female connectors
+
+	SpatialGrid<int> grid;
+	for (int i = 0; i < rects.count(); i++) {
+		grid.insert(i, rects.at(i));
+	}
+
+	const int Pins = 40;
+	const int Moves = 200;
+
+	QElapsedTimer timer;
+	timer.start();
+	int hits = 0;
+	for (int move = 0; move < Moves; move++) {
+		for (int pin = 0; pin < Pins; pin++) {
+			QPointF p(move * 7.3 + (pin % 20) * 9.0 + 2, (pin / 20) * 27.0 + 2);
+			hits += grid.query(p).count();
+		}
+	}
+	qint64 gridMs = timer.elapsed();
+
+	timer.restart();
+	int bruteHits = 0;
+	for (int move = 0; move < Moves / 10; move++) {
+		for (int pin = 0; pin < Pins; pin++) {
+			QPointF p(move * 7.3 + (pin % 20) * 9.0 + 2, (pin / 20) * 27.0 + 2);
+			bruteHits += bruteForce(rects, p).count();
+		}
+	}
+	qint64 bruteMs = timer.elapsed() * 10;
+
+	BOOST_TEST_MESSAGE(QString("drag over %1 connectors, %2 moves x %3 pins: grid %4 ms, linear scan ~%5 ms")
+	                   .arg(rects.count()).arg(Moves).arg(Pins).arg(gridMs).arg(bruteMs).toStdString());
+	BOOST_REQUIRE(hits > 0);
+	BOOST_REQUIRE(bruteHits > 0);
+	BOOST_REQUIRE(gridMs <= bruteMs);
+}
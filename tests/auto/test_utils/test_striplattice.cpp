@@ -0,0 +1,160 @@
+#include <boost/test/unit_test.hpp>
+
+#include "items/striplattice.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QVector>
+
+// the old recursive flood fill, for comparison
+static void flood(const StripLattice & lattice, int x, int y, int group, QVector<int> & groups) {
+	QList<int> stack;
+	stack << (y * lattice.columns()) + x;
+	while (!stack.isEmpty()) {
+		int i = stack.takeLast();
+		if (groups.at(i) >= 0) continue;
+
+		groups[i] = group;
+		int cx = i % lattice.columns();
+		int cy = i / lattice.columns();
+		if (lattice.hasLink(cx, cy, true) && !lattice.isCut(cx, cy, true)) stack << i + 1;
+		if (lattice.hasLink(cx, cy, false) && !lattice.isCut(cx, cy, false)) stack << i + lattice.columns();
+		if (lattice.hasLink(cx - 1, cy, true) && !lattice.isCut(cx - 1, cy, true)) stack << i - 1;
+		if (lattice.hasLink(cx, cy - 1, false) && !lattice.isCut(cx, cy - 1, false)) stack << i - lattice.columns();
+	}
+}
+
+static QVector<int> floodGroups(const StripLattice & lattice, int & groupCount) {
+	QVector<int> groups(lattice.columns() * lattice.rows(), -1);
+	groupCount = 0;
+	for (int y = 0; y < lattice.rows(); y++) {
+		for (int x = 0; x < lattice.columns(); x++) {
+			if (groups.at((y * lattice.columns()) + x) >= 0) continue;
+
+			flood(lattice, x, y, groupCount++, groups);
+		}
+	}
+	return groups;
+}
+
+BOOST_AUTO_TEST_CASE( striplattice_cut_string )
+{
+	StripLattice lattice;
+	lattice.resize(3, 2);
+	BOOST_REQUIRE(lattice.hasLink(1, 1, true));
+	BOOST_REQUIRE(!lattice.hasLink(2, 1, true));
+	BOOST_REQUIRE(!lattice.hasLink(0, 1, false));
+
+	lattice.setCutString("0.0h 2.0v junk 1.1h 5.5h ");
+	BOOST_REQUIRE(lattice.isCut(0, 0, true));
+	BOOST_REQUIRE(lattice.isCut(2, 0, false));
+	BOOST_REQUIRE(lattice.isCut(1, 1, true));
+	BOOST_REQUIRE(!lattice.isCut(0, 0, false));
+	BOOST_REQUIRE_EQUAL(lattice.cutString().toStdString(), std::string("0.0h 2.0v 1.1h "));
+
+	BOOST_REQUIRE_EQUAL(lattice.linkString(false).toStdString(), std::string("0.0v 1.0v 2.0v "));
+
+	int x, y;
+	BOOST_REQUIRE(StripLattice::parseXY("20.30PerfboardModuleID", x, y));
+	BOOST_REQUIRE_EQUAL(x, 20);
+	BOOST_REQUIRE_EQUAL(y, 30);
+	BOOST_REQUIRE(StripLattice::parseXY("a1b.c12.7", x, y));
+	BOOST_REQUIRE_EQUAL(x, 12);
+	BOOST_REQUIRE_EQUAL(y, 7);
+	BOOST_REQUIRE(!StripLattice::parseXY("12.", x, y));
+}
+
+BOOST_AUTO_TEST_CASE( striplattice_groups_match_flood_fill )
+{
+	StripLattice lattice;
+	lattice.resize(23, 17);
+
+	// default layouts: all horizontal links cut gives one group per column
+	int groupCount;
+	lattice.setAllCut(true, true);
+	lattice.groups(groupCount);
+	BOOST_REQUIRE_EQUAL(groupCount, 23);
+
+	lattice.setAllCut(true, false);
+	lattice.setAllCut(false, true);
+	lattice.groups(groupCount);
+	BOOST_REQUIRE_EQUAL(groupCount, 17);
+
+	qsrand(35);
+	for (int round = 0; round < 20; round++) {
+		for (int y = 0; y < lattice.rows(); y++) {
+			for (int x = 0; x < lattice.columns(); x++) {
+				lattice.setCut(x, y, true, qrand() % 3 == 0);
+				lattice.setCut(x, y, false, qrand() % 3 != 0);
+			}
+		}
+
+		int expectedCount;
+		QVector<int> expected = floodGroups(lattice, expectedCount);
+		QVector<int> actual = lattice.groups(groupCount);
+		BOOST_REQUIRE_EQUAL(groupCount, expectedCount);
+		BOOST_REQUIRE(actual == expected);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( striplattice_large_board )
+{
+	const int Size = 199;			// Perfboard::MaxXDimension
+
+	StripLattice lattice;
+	lattice.resize(Size, Size);
+	lattice.setCutString(lattice.linkString(true));
+	int groupCount;
+	lattice.groups(groupCount);
+	BOOST_REQUIRE_EQUAL(groupCount, Size);
+
+	for (int i = 0; i < 200; i++) {
+		int x = (i * 37) % Size;
+		int y = (i * 91) % (Size - 1);
+		lattice.setCut(x, y, false, !lattice.isCut(x, y, false));
+	}
+	QVector<int> actual = lattice.groups(groupCount);
+
+	int floodCount;
+	QVector<int> expected = floodGroups(lattice, floodCount);
+	BOOST_REQUIRE_EQUAL(floodCount, groupCount);
+	BOOST_REQUIRE(actual == expected);
+	BOOST_REQUIRE(lattice.memoryUsage() < 1024 * 1024);
+}
+
+// creation time, memory and strip-cut latency of a max-size board's lattice alone; the ConnectorItems
+// a real board also carries are timed by the -benchmark service.  Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( striplattice_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	const int Size = 199;			// Perfboard::MaxXDimension
+
+	QElapsedTimer timer;
+	timer.start();
+	StripLattice lattice;
+	lattice.resize(Size, Size);
+	lattice.setCutString(lattice.linkString(true));
+	int groupCount;
+	lattice.groups(groupCount);
+	qint64 createMs = timer.elapsed();
+	BOOST_REQUIRE_EQUAL(groupCount, Size);
+
+	const int Cuts = 200;
+	timer.restart();
+	for (int i = 0; i < Cuts; i++) {
+		int x = (i * 37) % Size;
+		int y = (i * 91) % (Size - 1);
+		lattice.setCut(x, y, false, !lattice.isCut(x, y, false));
+		lattice.groups(groupCount);
+	}
+	double cutMs = timer.nsecsElapsed() / 1000000.0 / Cuts;
+
+	timer.restart();
+	int floodCount;
+	floodGroups(lattice, floodCount);
+	qint64 floodMs = timer.elapsed();
+	BOOST_REQUIRE_EQUAL(floodCount, groupCount);
+
+	BOOST_TEST_MESSAGE(QString("%1 x %1 stripboard: created in %2 ms, %3 bytes, %4 ms per strip cut (flood fill %5 ms)")
+	                   .arg(Size).arg(createMs).arg(lattice.memoryUsage()).arg(cutMs).arg(floodMs).toStdString());
+	BOOST_REQUIRE(lattice.memoryUsage() < 1024 * 1024);
+}
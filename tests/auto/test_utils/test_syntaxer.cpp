@@ -0,0 +1,178 @@
+#include <boost/test/unit_test.hpp>
+
+#include "program/syntaxer.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QVector>
+
+static const char * SyntaxXml =
+    "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<language name='Test' extensions='*.ino'>\n"
+    "<highlighting>\n"
+    "<list name='keywords'><item> if </item><item> else </item><item> return </item><item> for </item></list>\n"
+    "<list name='types'><item> int </item><item> void </item><item> uint8_t </item></list>\n"
+    "<list name='functions'><item> digitalWrite </item><item> delay </item><item> #define </item></list>\n"
+    "<contexts>\n"
+    "<context attribute='Normal Text' name='Normal'>\n"
+    "<keyword attribute='Keyword' String='keywords'/>\n"
+    "<keyword attribute='Data Types' String='types'/>\n"
+    "<keyword attribute='Functions' String='functions'/>\n"
+    "<DetectChar attribute='String' context='String' char='&quot;'/>\n"
+    "</context>\n"
+    "<context attribute='String' name='String'><HlCStringChar attribute='String Char'/></context>\n"
+    "</contexts>\n"
+    "</highlighting>\n"
+    "<general>\n"
+    "<comments casesensitive='1'><comment start='//'/><comment start='/*' end='*/'/></comments>\n"
+    "</general>\n"
+    "</language>\n";
+
+static bool loadTestSyntax(Syntaxer & syntaxer) {
+	QTemporaryFile file;
+	if (!file.open()) return false;
+
+	file.write(SyntaxXml);
+	file.close();
+	return syntaxer.loadSyntax(file.fileName());
+}
+
+static QString spanString(const QString & text, const QVector<SyntaxSpan> & spans) {
+	QString result;
+	foreach (const SyntaxSpan & span, spans) {
+		result += QString("%1:%2 ").arg(span.list).arg(text.mid(span.start, span.length));
+	}
+	return result.trimmed();
+}
+
+BOOST_AUTO_TEST_CASE( syntaxer_keywords )
+{
+	Syntaxer syntaxer;
+	BOOST_REQUIRE(loadTestSyntax(syntaxer));
+	BOOST_REQUIRE_EQUAL(syntaxer.listNames().count(), 3);
+	BOOST_REQUIRE_EQUAL(syntaxer.keywordList("return"), 0);
+	BOOST_REQUIRE_EQUAL(syntaxer.keywordList("uint8_t"), 1);
+	BOOST_REQUIRE_EQUAL(syntaxer.keywordList("#define"), 2);
+	BOOST_REQUIRE_EQUAL(syntaxer.keywordList("Return"), -1);
+	BOOST_REQUIRE_EQUAL(syntaxer.keywordList("ret"), -1);
+
+	QVector<SyntaxSpan> spans;
+	QString text("for (int i = 0; i < 10; i++) digitalWrite(intPin, delay);");
+	BOOST_REQUIRE_EQUAL(syntaxer.highlight(text, -1, spans), 0);
+	BOOST_REQUIRE_EQUAL(spanString(text, spans).toStdString(), std::string("0:for 1:int 2:digitalWrite 2:delay"));
+}
+
+BOOST_AUTO_TEST_CASE( syntaxer_comments_and_strings )
+{
+	Syntaxer syntaxer;
+	BOOST_REQUIRE(loadTestSyntax(syntaxer));
+
+	QVector<SyntaxSpan> spans;
+	QString text("if (x) return \"a // \\\" b\"; // else int");
+	BOOST_REQUIRE_EQUAL(syntaxer.highlight(text, 0, spans), 0);
+	BOOST_REQUIRE_EQUAL(spanString(text, spans).toStdString(), std::string("0:if 0:return -1:\"a // \\\" b\" -2:// else int"));
+
+	// a multi-line comment carries its state to the next block
+	text = "int a; /* void";
+	int state = syntaxer.highlight(text, 0, spans);
+	BOOST_REQUIRE(state > 0);
+	BOOST_REQUIRE_EQUAL(spanString(text, spans).toStdString(), std::string("1:int -2:/* void"));
+
+	text = "still comment return";
+	BOOST_REQUIRE_EQUAL(syntaxer.highlight(text, state, spans), state);
+	BOOST_REQUIRE_EQUAL(spans.count(), 1);
+
+	text = "end */ return";
+	BOOST_REQUIRE_EQUAL(syntaxer.highlight(text, state, spans), 0);
+	BOOST_REQUIRE_EQUAL(spanString(text, spans).toStdString(), std::string("-2:end */ 0:return"));
+
+	// empty blocks keep the state of the block above
+	BOOST_REQUIRE_EQUAL(syntaxer.highlight(QString(), state, spans), state);
+
+	// so does an unterminated string
+	text = "\"open";
+	state = syntaxer.highlight(text, 0, spans);
+	BOOST_REQUIRE(state > 0);
+	text = "close\" else";
+	BOOST_REQUIRE_EQUAL(syntaxer.highlight(text, state, spans), 0);
+	BOOST_REQUIRE_EQUAL(spanString(text, spans).toStdString(), std::string("-1:close\" 0:else"));
+}
+
+// a 6000 line sketch: defines, block comments, keywords and strings that look like comments
+static QStringList largeSketch() {
+	QStringList lines;
+	for (int i = 0; i < 1000; i++) {
+		lines << QString("#define PIN_%1 %1").arg(i);
+		lines << "/* blink the led";
+		lines << QString("   on pin %1 */").arg(i);
+		lines << QString("void loop%1() { if (ready) digitalWrite(PIN_%1, HIGH); else delay(100); }").arg(i);
+		lines << QString("    Serial.println(\"value \\\"%1\\\" // not a comment\"); // done").arg(i);
+		lines << "";
+	}
+	return lines;
+}
+
+BOOST_AUTO_TEST_CASE( syntaxer_block_states )
+{
+	Syntaxer syntaxer;
+	BOOST_REQUIRE(loadTestSyntax(syntaxer));
+
+	QStringList lines = largeSketch();
+
+	QVector<SyntaxSpan> spans;
+	QVector<int> states(lines.count());
+	int state = -1;
+	for (int i = 0; i < lines.count(); i++) {
+		state = syntaxer.highlight(lines.at(i), state, spans);
+		states[i] = state;
+	}
+	BOOST_REQUIRE_EQUAL(state, 0);
+
+	// opening a comment at the top invalidates everything below, closing it again only as far as the states differ
+	lines[0] = "/* " + lines.at(0);
+	state = -1;
+	int rehighlighted = 0;
+	for (int i = 0; i < lines.count(); i++) {
+		state = syntaxer.highlight(lines.at(i), state, spans);
+		rehighlighted++;
+		if (i > 0 && state == states.at(i)) break;
+	}
+	BOOST_REQUIRE_EQUAL(rehighlighted, 2);
+}
+
+// Timing only; run it with --run_test=@benchmark
+BOOST_AUTO_TEST_CASE( syntaxer_benchmark, * boost::unit_test::label("benchmark") * boost::unit_test::disabled() )
+{
+	Syntaxer syntaxer;
+	BOOST_REQUIRE(loadTestSyntax(syntaxer));
+	QStringList lines = largeSketch();
+
+	QVector<SyntaxSpan> spans;
+	QVector<int> states(lines.count());
+	QElapsedTimer timer;
+	timer.start();
+	int state = -1;
+	int spanCount = 0;
+	for (int i = 0; i < lines.count(); i++) {
+		state = syntaxer.highlight(lines.at(i), state, spans);
+		states[i] = state;
+		spanCount += spans.count();
+	}
+	qint64 fullMs = timer.elapsed();
+
+	timer.restart();
+	lines[0] = "/* " + lines.at(0);
+	state = -1;
+	int rehighlighted = 0;
+	for (int i = 0; i < lines.count(); i++) {
+		state = syntaxer.highlight(lines.at(i), state, spans);
+		rehighlighted++;
+		if (i > 0 && state == states.at(i)) break;
+	}
+	qint64 commentMs = timer.elapsed();
+
+	BOOST_TEST_MESSAGE(QString("%1 lines, %2 spans: highlighted in %3 ms; opening a comment rehighlighted %4 blocks in %5 ms")
+	                   .arg(lines.count()).arg(spanCount).arg(fullMs).arg(rehighlighted).arg(commentMs).toStdString());
+}
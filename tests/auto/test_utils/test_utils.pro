@@ -0,0 +1,59 @@
+# /*******************************************************************
+# Part of the Fritzing project - http://fritzing.org
+# Copyright (c) 2019 Fritzing
+# Fritzing is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# Fritzing is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+# You should have received a copy of the GNU General Public License
+# along with Fritzing. If not, see <http://www.gnu.org/licenses/>.
+# ********************************************************************/
+
+# specify absolute path so that unit test compiles will find the folder
+absolute_boost = 1
+include($$absolute_path(../../../pri/boostdetect.pri))
+
+QT += core gui widgets xml svg concurrent
+
+HEADERS += $$files(*.h)
+SOURCES += $$files(*.cpp)
+
+INCLUDEPATH += $$absolute_path(../../../src)
+
+# the connectivity tests read the bundled example sketches
+DEFINES += FRITZING_SOURCE_DIR=\\\"$$absolute_path(../../..)\\\"
+
+HEADERS += $$files(../../../src/utils/spatialgrid.h)
+HEADERS += $$files(../../../src/utils/ratsnesttree.h)
+SOURCES += $$files(../../../src/utils/ratsnesttree.cpp)
+HEADERS += $$files(../../../src/items/striplattice.h)
+SOURCES += $$files(../../../src/items/striplattice.cpp)
+HEADERS += $$files(../../../src/program/keywordtable.h)
+SOURCES += $$files(../../../src/program/keywordtable.cpp)
+HEADERS += $$files(../../../src/program/syntaxer.h)
+SOURCES += $$files(../../../src/program/syntaxer.cpp)
+HEADERS += $$files(../../../src/utils/textutils.h)
+SOURCES += $$files(../../../src/utils/textutils.cpp)
+HEADERS += $$files(../../../src/model/netlistwriter.h)
+SOURCES += $$files(../../../src/model/netlistwriter.cpp)
+HEADERS += $$files(../../../src/connectors/ercdata.h)
+SOURCES += $$files(../../../src/connectors/ercdata.cpp)
+HEADERS += $$files(../../../src/utils/s2s.h)
+SOURCES += $$files(../../../src/utils/s2s.cpp)
+HEADERS += $$files(../../../src/utils/schematicrectconstants.h)
+SOURCES += $$files(../../../src/utils/schematicrectconstants.cpp)
+HEADERS += $$files(../../../src/connectors/connectivitysnapshot.h)
+SOURCES += $$files(../../../src/connectors/connectivitysnapshot.cpp)
+
+contains(DEFINES, QUAZIP_INSTALLED) {
+	LIBS += -lquazip5
+} else {
+	HEADERS += $$files(../../../src/lib/quazip/*.h)
+	SOURCES += $$files(../../../src/lib/quazip/*.c)
+	SOURCES += $$files(../../../src/lib/quazip/*.cpp)
+	LIBS += -lz
+}